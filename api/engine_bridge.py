@@ -0,0 +1,414 @@
+import asyncio
+import json
+import logging
+from collections import deque
+from typing import Any
+
+import tank_sim
+
+from .simulation import (
+    MAX_SESSIONS,
+    BroadcastSession,
+    ClientMailbox,
+    SessionManager,
+    clamp_speed,
+)
+
+logger = logging.getLogger(__name__)
+
+# Fields of a state message, as stored per sample in a SharedSessionStore
+STATE_FIELDS = (
+    "time",
+    "tank_level",
+    "setpoint",
+    "inlet_flow",
+    "outlet_flow",
+    "valve_position",
+    "error",
+    "controller_output",
+)
+
+# How long checkpoint() waits for the engine to hand over its sessions
+EXPORT_TIMEOUT_SECONDS = 10.0
+EXPORT_POLL_SECONDS = 0.01
+
+
+class EngineSession(BroadcastSession):
+    """
+    A session stepped by the native SessionEngine thread.
+
+    Commands are queued to the engine and take effect at its next tick;
+    frames arrive already encoded through EngineSessionManager. Each
+    subscriber holds one engine reference (join/leave), so the engine
+    destroys the simulation with the last of them. References are counted
+    here and released for subscribers dropped by publish() and, at the
+    latest, by stop(). A session restored from a checkpoint holds one more
+    until it stops.
+    """
+
+    def __init__(
+        self,
+        session_id: str,
+        engine: tank_sim.SessionEngine,
+        websocket=None,
+        name: str | None = None,
+        config: tank_sim.SimulatorConfig | None = None,
+    ):
+        super().__init__(session_id, websocket, name)
+        self.engine = engine
+        # Checks checkpointed snapshots before they reach the engine
+        self.config = config
+        # Private sessions get a name no shared session can have
+        self.key = tank_sim.SessionEngine.session_key(
+            f"shared:{name}" if name is not None else f"private:{session_id}"
+        )
+        # (time, state message) pairs, parsed only when history is requested
+        self.history: deque = deque(maxlen=7200)  # 2 hours at 1 Hz
+        # Engine references held (joins not yet matched by a leave)
+        self.joined = 0
+        # Of those, the one a restored session holds without subscribers
+        self.held = 0
+        for _ in self.subscribers:
+            self._join()
+
+    def _join(self):
+        self.engine.join(self.key)
+        self.joined += 1
+
+    def _release(self, count: int):
+        for _ in range(count):
+            self.engine.leave(self.key)
+        self.joined -= count
+
+    def _command(self, command_type, index: int = 0, value: float = 0.0, gains=None):
+        command = tank_sim.OperatorCommand()
+        command.type = command_type
+        command.index = index
+        command.value = value
+        if gains is not None:
+            command.gains = gains
+        self.engine.submit(self.key, command)
+
+    def set_setpoint(self, value: float):
+        """Set the controller setpoint."""
+        self._command(tank_sim.CommandType.SET_SETPOINT, value=value)
+
+    def set_pid_gains(self, gains: tank_sim.PIDGains):
+        """Set PID controller gains."""
+        self._command(tank_sim.CommandType.SET_GAINS, gains=gains)
+
+    def set_inlet_flow(self, value: float):
+        """Set inlet flow rate."""
+        self._command(tank_sim.CommandType.SET_INPUT, value=value)
+
+    def set_speed(self, value: float):
+        """
+        Run at value times real time (inf = as fast as possible); the engine
+        paces it, with at most one frame per tick.
+
+        Raises:
+            ValueError: If value is not positive.
+        """
+        self._command(tank_sim.CommandType.SET_SPEED, value=clamp_speed(value))
+
+    def set_inlet_mode(
+        self, mode: str, min_flow: float, max_flow: float, variance: float = 0.05
+    ):
+        """Brownian inlet flow is stepped in Python and not available here."""
+        raise ValueError("inlet_mode is not supported by the native engine")
+
+    def reset(self):
+        """Reset simulation to initial conditions and clear history."""
+        self._command(tank_sim.CommandType.RESET)
+        self.history.clear()
+
+    def receive(self, time: float, message: str):
+        """Record and broadcast one frame drained from the engine."""
+        self.history.append((time, message))
+        self.publish(message)
+
+    def publish(self, message: str):
+        """Broadcast; failed subscribers dropped here give up their engine reference."""
+        super().publish(message)
+        self._release(self.joined - self.held - len(self.subscribers))
+
+    def get_history(self, duration: int = 3600) -> list[dict[str, Any]]:
+        """Get historical data points."""
+        duration = max(1, min(duration, 7200))
+        num_entries = min(duration, len(self.history))
+        if num_entries == 0:
+            return []
+        return [json.loads(m)["data"] for _, m in list(self.history)[-num_entries:]]
+
+    def get_history_since(self, time: float) -> list[dict[str, Any]]:
+        """Get the historical data points after a simulation time (catch-up after drops)."""
+        messages = []
+        for frame_time, message in reversed(self.history):
+            if frame_time <= time:
+                break
+            messages.append(message)
+        return [json.loads(m)["data"] for m in reversed(messages)]
+
+    def add_to_checkpoint(
+        self, writer: tank_sim.CheckpointWriter, snapshot: bytes, speed: float
+    ):
+        """Add this session's exported state, speed and history to a checkpoint."""
+        history = [tank_sim.SessionSample(**json.loads(m)["data"]) for _, m in self.history]
+        writer.add_snapshot(
+            self.name or self.session_id,
+            snapshot,
+            history,
+            metadata=json.dumps({"speed": speed}).encode(),
+        )
+
+    def restore_checkpoint(self, checkpoint: tank_sim.SessionCheckpoint, index: int):
+        """
+        Continue a checkpointed session in the engine (before start()).
+
+        The session holds the imported engine reference itself, so it runs
+        without subscribers and stop() ends it.
+
+        Raises:
+            ValueError: If the checkpoint was taken with another configuration.
+        """
+        snapshot = checkpoint.snapshot(index)
+        # A shard drops the router's connection over a snapshot it cannot restore
+        tank_sim.Simulator(self.config).restore_state(snapshot)
+        metadata = checkpoint.metadata(index)
+        speed = clamp_speed(json.loads(metadata).get("speed", 1.0)) if metadata else 1.0
+        self.engine.import_session(self.key, snapshot, 1, speed)
+        self.joined += 1
+        self.held = 1
+        for sample in checkpoint.history(index).samples():
+            data = {field: getattr(sample, field) for field in STATE_FIELDS}
+            message = json.dumps({"type": "state", "data": data}, separators=(",", ":"))
+            self.history.append((sample.time, message))
+
+    def add_subscriber(self, websocket) -> ClientMailbox:
+        """Start broadcasting to another connection."""
+        mailbox = super().add_subscriber(websocket)
+        self._join()
+        return mailbox
+
+    async def remove_subscriber(self, websocket):
+        """Stop broadcasting to a connection; unknown connections are ignored."""
+        if self.mailbox(websocket) is not None:
+            self._release(1)
+        await super().remove_subscriber(websocket)
+
+    def start(self):
+        """Start the subscribers' sender tasks."""
+        self.start_broadcast()
+
+    async def stop(self):
+        """Stop the sender tasks and release every engine reference still held."""
+        await self.stop_broadcast()
+        self._release(self.joined)
+        logger.info(f"Session {self.session_id}: stopped")
+
+
+class EngineSessionManager(SessionManager):
+    """
+    SessionManager whose sessions are stepped by one native engine thread.
+
+    Instead of an asyncio loop per session, the engine ticks every session
+    and signals an eventfd registered with loop.add_reader. Each wakeup
+    drains the frames of all sessions (and of any ticks the loop was too
+    busy for) in one call and posts them to the subscribers' mailboxes, so
+    the event loop wakes once per tick however many sessions run.
+    """
+
+    def __init__(
+        self,
+        config: tank_sim.SimulatorConfig,
+        tick_period: float = 1.0,
+        realtime_cpu: int | None = None,
+        speculation_ticks: int = 0,
+    ):
+        super().__init__(config)
+        self.tick_period = tick_period
+        # CPU for a SCHED_FIFO engine thread (-1: unpinned); None: normal thread
+        self.realtime_cpu = realtime_cpu
+        # Ticks the engine may compute each session ahead while idle; 0: off
+        self.speculation_ticks = speculation_ticks
+        self.engine = self._create_engine(config)
+        self._by_key: dict[int, EngineSession] = {}
+        self._loop: asyncio.AbstractEventLoop | None = None
+
+    def _create_engine(self, config: tank_sim.SimulatorConfig):
+        return tank_sim.SessionEngine(config, MAX_SESSIONS)
+
+    def _new_session(
+        self, session_id: str, websocket, name: str | None = None
+    ) -> EngineSession:
+        session = EngineSession(
+            session_id, self.engine, websocket, name=name, config=self.config
+        )
+        self._by_key[session.key] = session
+        return session
+
+    def start(self):
+        """Start the engine thread and watch its descriptor from the running loop."""
+        self._loop = asyncio.get_running_loop()
+        self._start_engine()
+        self._loop.add_reader(self.engine.fileno(), self._on_frames_ready)
+
+    def _start_engine(self):
+        self.engine.enable_speculation(self.speculation_ticks)
+        if self.realtime_cpu is None:
+            self.engine.start(self.tick_period)
+        else:
+            self.engine.start(self.tick_period, realtime=True, cpu=self.realtime_cpu)
+        logger.info(f"Native engine started (tick {self.tick_period} s)")
+
+    async def close(self):
+        """Stop the engine thread and destroy every session."""
+        if self._loop is not None:
+            self._loop.remove_reader(self.engine.fileno())
+            self._loop = None
+        self._stop_engine()
+        await super().close()
+
+    def _stop_engine(self):
+        self.engine.stop()
+
+    def _on_frames_ready(self):
+        """Dispatch every frame published since the last wakeup."""
+        for key, time, message in self.engine.drain():
+            session = self._by_key.get(key)
+            if session is not None:
+                session.receive(time, message)
+
+    async def destroy_session(self, session_id: str):
+        """Stop and remove a session."""
+        session = self.sessions.get(session_id)
+        if session is not None:
+            self._by_key.pop(session.key, None)
+        await super().destroy_session(session_id)
+
+    def pacing_stats(self) -> dict[str, Any] | None:
+        """Tick lateness of the engine thread (microseconds)."""
+        stats = self.engine.pacing_stats
+        return {
+            "ticks": stats.ticks,
+            "skipped": stats.skipped,
+            "mean_lateness_micros": stats.mean_lateness_micros,
+            "p99_lateness_micros": stats.percentile_micros(0.99),
+            "max_lateness_micros": stats.max_lateness_micros,
+            "realtime": stats.realtime,
+            "speculation": self._speculation_stats(),
+        }
+
+    def _speculation_stats(self) -> dict[str, int] | None:
+        if self.speculation_ticks == 0:
+            return None
+        stats = self.engine.speculation_stats
+        return {
+            "lookahead_ticks": self.speculation_ticks,
+            "computed_steps": stats.computed_steps,
+            "served_ticks": stats.served_ticks,
+            "discarded_ticks": stats.discarded_ticks,
+        }
+
+    async def checkpoint(self, path: str) -> int:
+        """
+        Write every shared session to a checkpoint file, e.g. on shutdown.
+
+        Each session is exported from the engine, which removes it after the
+        commands queued before, so this is the last call before close().
+        Sessions the engine does not hand over within EXPORT_TIMEOUT_SECONDS
+        are left out. restore() imports them into the engine again.
+
+        Returns:
+            Sessions written (no file is written when there are none).
+
+        Raises:
+            RuntimeError: If the file cannot be written.
+        """
+        sessions = {}
+        for session_id in self.shared.values():
+            session = self.sessions[session_id]
+            if session.joined > 0:
+                self.engine.export_session(session.key)
+                sessions[session.key] = session
+
+        loop = asyncio.get_running_loop()
+        deadline = loop.time() + EXPORT_TIMEOUT_SECONDS
+        exports = {}
+        while len(exports) < len(sessions) and loop.time() < deadline:
+            await asyncio.sleep(EXPORT_POLL_SECONDS)
+            for key, speed, snapshot in self.engine.take_exports():
+                if key in sessions:
+                    exports[key] = (speed, snapshot)
+        if len(exports) < len(sessions):
+            logger.warning(
+                f"{len(sessions) - len(exports)} sessions not exported in time, "
+                "not checkpointed"
+            )
+
+        writer = tank_sim.CheckpointWriter()
+        for key, (speed, snapshot) in exports.items():
+            session = sessions[key]
+            # The engine references left with the session
+            session.joined = session.held = 0
+            if snapshot is not None:
+                session.add_to_checkpoint(writer, snapshot, speed)
+        if len(writer) == 0:
+            return 0
+        size = await asyncio.to_thread(writer.write, path)
+        logger.info(f"Checkpointed {len(writer)} shared sessions ({size} bytes)")
+        return len(writer)
+
+
+class ShardedSessionManager(EngineSessionManager):
+    """
+    EngineSessionManager whose sessions run in tank_engine_shard processes.
+
+    A ShardRouter places every session on one shard by consistent hashing
+    and forwards its frames; the shards tick on their own clocks, so this
+    process only watches the router's descriptor. drain_shard() moves a
+    shard's sessions to the others live, e.g. before restarting it.
+    """
+
+    def __init__(self, config: tank_sim.SimulatorConfig, socket_paths: list[str]):
+        self.socket_paths = list(socket_paths)
+        super().__init__(config)
+
+    def _create_engine(self, config: tank_sim.SimulatorConfig):
+        return tank_sim.ShardRouter(self.socket_paths)
+
+    def _start_engine(self):
+        logger.info(f"Shard router started ({self.engine.shard_count} shards)")
+
+    def _stop_engine(self):
+        pass
+
+    def pacing_stats(self) -> dict[str, Any] | None:
+        """The shards pace their own ticks (tank_engine_shard prints them)."""
+        return None
+
+    def drain_shard(self, shard: int) -> int:
+        """Move every session off a shard; returns the migrations started."""
+        return self.engine.drain_shard(shard)
+
+
+def read_shared_session(
+    store: tank_sim.SharedSessionStore, name: str, since: float | None = None
+) -> dict[str, Any] | None:
+    """
+    Read a shared session from the store, whichever process steps it.
+
+    Returns the latest state message data and the history after `since`
+    (all retained history when None), or None if no process exports the
+    session.
+    """
+    key = tank_sim.SessionEngine.session_key(f"shared:{name}")
+    frame = store.latest(key)
+    if frame is None:
+        return None
+    state = json.loads(tank_sim.FrameEncoder().encode_json(frame))["data"]
+    samples = store.history(key) if since is None else store.history(key, since)
+    return {
+        "state": state,
+        "history": [{field: getattr(s, field) for field in STATE_FIELDS} for s in samples],
+    }
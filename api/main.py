@@ -1,5 +1,6 @@
 import json
 import logging
+import math
 import os
 from contextlib import asynccontextmanager
 
@@ -9,8 +10,13 @@ from fastapi.responses import JSONResponse
 
 import tank_sim
 
+from .engine_bridge import (
+    EngineSessionManager,
+    ShardedSessionManager,
+    read_shared_session,
+)
 from .models import ConfigResponse
-from .simulation import SessionManager
+from .simulation import MAX_SESSIONS, SessionManager
 
 # Configure logging
 logging.basicConfig(
@@ -22,14 +28,58 @@ logger = logging.getLogger(__name__)
 # Global session manager instance
 session_manager: SessionManager | None = None
 
+# Shared-memory session telemetry, when SESSION_STORE names a segment
+session_store: tank_sim.SharedSessionStore | None = None
+
 
 @asynccontextmanager
 async def lifespan(app: FastAPI):
     """Manages application startup and shutdown."""
-    global session_manager
+    global session_manager, session_store
+    # CHECKPOINT_PATH keeps the shared sessions across restarts: they are
+    # written there on shutdown and resumed (then the file removed) on startup
+    checkpoint_path = os.getenv("CHECKPOINT_PATH")
     try:
         config = tank_sim.create_default_config()
-        session_manager = SessionManager(config)
+        # SIMULATION_ENGINE=native steps every session on one C++ thread;
+        # sharded spreads them over the tank_engine_shard processes
+        # listening on ENGINE_SHARDS (comma-separated socket paths)
+        engine = os.getenv("SIMULATION_ENGINE", "python")
+        if engine == "native":
+            # ENGINE_REALTIME_CPU runs the engine thread SCHED_FIFO with locked
+            # memory, pinned to that CPU (-1: unpinned), when permitted;
+            # ENGINE_SPECULATION_TICKS lets it compute sessions that far ahead
+            realtime_cpu = os.getenv("ENGINE_REALTIME_CPU")
+            session_manager = EngineSessionManager(
+                config,
+                realtime_cpu=int(realtime_cpu) if realtime_cpu else None,
+                speculation_ticks=int(os.getenv("ENGINE_SPECULATION_TICKS", "0")),
+            )
+        elif engine == "sharded":
+            paths = [p for p in os.getenv("ENGINE_SHARDS", "").split(",") if p]
+            if not paths:
+                raise ValueError("SIMULATION_ENGINE=sharded needs ENGINE_SHARDS")
+            session_manager = ShardedSessionManager(config, paths)
+        else:
+            session_manager = SessionManager(config)
+        # SESSION_STORE=/name lets every worker read the sessions exported
+        # by the engine process(es) through POSIX shared memory
+        store_name = os.getenv("SESSION_STORE")
+        if store_name:
+            session_store = tank_sim.SharedSessionStore(store_name, MAX_SESSIONS)
+            # Shards export their own sessions (tank_engine_shard --store)
+            if type(session_manager) is EngineSessionManager:
+                session_store.reclaim_dead()
+                session_manager.engine.attach_store(session_store)
+            logger.info(f"Session store {store_name} attached")
+        session_manager.start()
+        if checkpoint_path and os.path.exists(checkpoint_path):
+            try:
+                session_manager.restore(checkpoint_path)
+                os.unlink(checkpoint_path)
+            except RuntimeError as e:
+                logger.error(f"Checkpoint {checkpoint_path} not restored: {e}")
+                os.replace(checkpoint_path, checkpoint_path + ".corrupt")
         logger.info("Application started successfully")
     except Exception as e:
         logger.error(f"Failed to initialize session manager: {e}")
@@ -37,10 +87,15 @@ async def lifespan(app: FastAPI):
 
     yield
 
-    # Shutdown: destroy all active sessions
+    # Shutdown: checkpoint the shared sessions, then destroy all sessions
     if session_manager is not None:
-        for session_id in list(session_manager.sessions.keys()):
-            await session_manager.destroy_session(session_id)
+        if checkpoint_path:
+            try:
+                await session_manager.checkpoint(checkpoint_path)
+            except RuntimeError as e:
+                logger.error(f"Checkpoint {checkpoint_path} not written: {e}")
+        await session_manager.close()
+    session_store = None
     logger.info("Application shutting down")
 
 
@@ -81,6 +136,14 @@ async def health_check():
         "active_sessions": session_manager.active_session_count
         if session_manager
         else 0,
+        "active_subscribers": session_manager.subscriber_count
+        if session_manager
+        else 0,
+        "dropped_frames": session_manager.dropped_frame_count
+        if session_manager
+        else 0,
+        # Native engine only: tick lateness histogram summary
+        "pacing": session_manager.pacing_stats() if session_manager else None,
     }
 
 
@@ -118,16 +181,39 @@ async def get_config():
         return JSONResponse(status_code=500, content={"error": str(e)})
 
 
+@app.get("/api/shared/{name}")
+async def get_shared_session(name: str, since: float | None = None):
+    """
+    Latest state and history of the shared session named in the path, read
+    from the session store so any worker can answer for any engine process.
+    Pass ?since=<time> to get only the history after a simulation time.
+    """
+    if session_store is None:
+        return JSONResponse(
+            status_code=503,
+            content={"error": "No session store configured (set SESSION_STORE)"},
+        )
+    snapshot = read_shared_session(session_store, name, since)
+    if snapshot is None:
+        return JSONResponse(
+            status_code=404, content={"error": f"Shared session not found: {name}"}
+        )
+    return snapshot
+
+
 # WebSocket endpoint — each connection gets its own simulation session
 @app.websocket("/ws")
 async def websocket_endpoint(websocket: WebSocket):
     """
     WebSocket endpoint for real-time simulation.
-    Each connection gets its own independent simulation instance.
+    Each connection gets its own independent simulation instance, unless it
+    connects with ?session=<name>: connections with the same name share one
+    simulation, see each other's commands and receive the same broadcast.
 
     Sends:
     - {"type": "state", "data": {...}} — 1 Hz state updates
     - {"type": "history", "data": [...]} — response to history request
+    - {"type": "stats", "data": {"sent", "dropped", "pending"}} — this client's frame counters
     - {"type": "error", "message": "..."} — error messages
 
     Receives:
@@ -136,7 +222,15 @@ async def websocket_endpoint(websocket: WebSocket):
     - {"type": "inlet_flow", "value": <float>}
     - {"type": "inlet_mode", "mode": <str>, "min": <float>, "max": <float>, "variance": <float>}
     - {"type": "reset"}
+    - {"type": "speed", "value": <float> | "max"} — simulated seconds per tick
+      (0.01 to 3600; "max" runs as fast as the server allows)
     - {"type": "history", "duration": <int>}
+    - {"type": "history", "since": <float>} — frames after a simulation time
+    - {"type": "stats"}
+
+    State updates are conflated per client: a client that reads slower than
+    the simulation runs gets only the newest state, counts the rest as
+    dropped, and can catch up with a "since" history request.
     """
     await websocket.accept()
     logger.info("Client connected to WebSocket")
@@ -148,9 +242,13 @@ async def websocket_endpoint(websocket: WebSocket):
         await websocket.close()
         return
 
-    # Create a session for this connection
+    # Create a session for this connection, or join a shared one
+    session_name = websocket.query_params.get("session")
     try:
-        session = session_manager.create_session(websocket)
+        if session_name:
+            session = session_manager.join_shared_session(session_name, websocket)
+        else:
+            session = session_manager.create_session(websocket)
     except RuntimeError as e:
         await websocket.send_json({"type": "error", "message": str(e)})
         await websocket.close()
@@ -228,15 +326,33 @@ async def websocket_endpoint(websocket: WebSocket):
                 elif msg_type == "reset":
                     session.reset()
 
+                elif msg_type == "speed":
+                    value = message.get("value")
+                    if value is None:
+                        await websocket.send_json(
+                            {"type": "error", "message": "Missing 'value' field"}
+                        )
+                    else:
+                        session.set_speed(math.inf if value == "max" else float(value))
+
                 elif msg_type == "history":
-                    duration = message.get("duration", 3600)
-                    try:
-                        duration = int(duration)
-                    except (ValueError, TypeError):
-                        duration = 3600
-                    history_data = session.get_history(duration)
+                    since = message.get("since")
+                    if since is not None:
+                        history_data = session.get_history_since(float(since))
+                    else:
+                        duration = message.get("duration", 3600)
+                        try:
+                            duration = int(duration)
+                        except (ValueError, TypeError):
+                            duration = 3600
+                        history_data = session.get_history(duration)
                     await websocket.send_json({"type": "history", "data": history_data})
 
+                elif msg_type == "stats":
+                    mailbox = session.mailbox(websocket)
+                    stats = mailbox.stats() if mailbox is not None else {}
+                    await websocket.send_json({"type": "stats", "data": stats})
+
                 else:
                     await websocket.send_json(
                         {
@@ -260,4 +376,4 @@ async def websocket_endpoint(websocket: WebSocket):
     except Exception as e:
         logger.error(f"WebSocket error: {e}")
     finally:
-        await session_manager.destroy_session(session.session_id)
+        await session_manager.leave_session(session.session_id, websocket)
@@ -1,5 +1,7 @@
 import asyncio
+import json
 import logging
+import math
 import uuid
 from collections import deque
 from typing import Any
@@ -11,26 +13,234 @@ import tank_sim
 logger = logging.getLogger(__name__)
 
 MAX_SESSIONS = 100
+MAX_SUBSCRIBERS_PER_SESSION = 1000
+HISTORY_CAPACITY = 7200  # 2 hours at 1 Hz
+TICK_PERIOD = 1.0  # seconds
+# Restored sessions that nobody rejoins within this time are destroyed
+RESTORE_GRACE_SECONDS = 300.0
+# Session speed factors (simulator steps per tick); "max" runs the per-tick
+# budget, as the native engine does
+MIN_SPEED = 0.01
+MAX_STEPS_PER_TICK = 3600
+
+EMPTY_STATE: dict[str, float] = {
+    "time": 0.0,
+    "tank_level": 0.0,
+    "setpoint": 0.0,
+    "inlet_flow": 0.0,
+    "outlet_flow": 0.0,
+    "valve_position": 0.0,
+    "error": 0.0,
+    "controller_output": 0.0,
+}
+
+
+def frame_to_state(frame) -> dict[str, float]:
+    """Convert a TelemetryFrame to the state dict sent to the frontend."""
+    has_loop = frame.loop_count > 0
+    return {
+        "time": frame.time,
+        "tank_level": frame.tank_level,
+        "setpoint": frame.setpoint[0] if has_loop else 0.0,
+        "inlet_flow": frame.inlet_flow,
+        "outlet_flow": frame.outlet_flow,
+        "valve_position": frame.valve_position,
+        "error": frame.error[0] if has_loop else 0.0,
+        "controller_output": frame.controller_output[0] if has_loop else 0.0,
+    }
+
+
+def sample_to_state(sample) -> dict[str, float]:
+    """Convert a SessionSample (stored or restored history) to a state dict."""
+    return {key: getattr(sample, key) for key in EMPTY_STATE}
+
+
+def clamp_speed(value: float) -> float:
+    """
+    Speed factor for a session, clamped to MIN_SPEED .. MAX_STEPS_PER_TICK.
+
+    Raises:
+        ValueError: If the value is not a positive number (inf is allowed).
+    """
+    if not value > 0.0:
+        raise ValueError('Speed must be a positive number or "max"')
+    return min(max(value, MIN_SPEED), float(MAX_STEPS_PER_TICK))
 
 
-class SessionSimulation:
+class ClientMailbox:
     """
-    Per-WebSocket-connection simulation instance.
-    Each session owns its own Simulator, history, inlet mode, and async loop.
+    Conflating mailbox and sender task for one WebSocket connection.
+
+    post() never blocks: it replaces any message the sender has not taken
+    yet and counts the replaced one as dropped. The sender task sends the
+    newest message whenever the socket is free, so a slow client receives
+    fewer frames instead of slowing the simulation loop, and can fill the
+    gap with a history request.
+    """
+
+    def __init__(self, websocket, session_id: str):
+        self.websocket = websocket
+        self.session_id = session_id
+        self.sent = 0
+        self.dropped = 0
+        self.closed = False
+        self._latest: str | None = None
+        self._ready = asyncio.Event()
+        self._task: asyncio.Task | None = None
+
+    def post(self, message: str):
+        """Offer the newest message, replacing an unsent one."""
+        if self.closed:
+            return
+        if self._latest is not None:
+            self.dropped += 1
+        self._latest = message
+        self._ready.set()
+
+    async def _send_loop(self):
+        try:
+            while True:
+                await self._ready.wait()
+                self._ready.clear()
+                message, self._latest = self._latest, None
+                if message is None:
+                    continue
+                await self.websocket.send_text(message)
+                self.sent += 1
+        except asyncio.CancelledError:
+            raise
+        except Exception as e:
+            self.closed = True
+            logger.warning(f"Session {self.session_id}: subscriber send failed: {e}")
+
+    def stats(self) -> dict[str, int]:
+        """Frames sent and dropped for this connection."""
+        return {
+            "sent": self.sent,
+            "dropped": self.dropped,
+            "pending": int(self._latest is not None),
+        }
+
+    def start(self):
+        """Start the sender task."""
+        if self._task is None:
+            self._task = asyncio.create_task(self._send_loop())
+
+    async def stop(self):
+        """Stop the sender task, discarding any unsent message."""
+        self.closed = True
+        if self._task is not None:
+            self._task.cancel()
+            try:
+                await self._task
+            except asyncio.CancelledError:
+                pass
+            self._task = None
+
+
+class BroadcastSession:
     """
+    The WebSocket connections watching one session.
 
-    def __init__(self, session_id: str, config: tank_sim.SimulatorConfig, websocket):
+    A private session has a single subscriber. A shared session (joined by
+    name) broadcasts to every subscriber: the state message is encoded once
+    per tick and the same immutable string is handed to each connection, so
+    a viewer costs one send, not a simulation or a serialization.
+
+    publish() only posts to each subscriber's ClientMailbox and never waits
+    for a socket, so a slow viewer cannot make the simulation fall behind.
+    """
+
+    def __init__(self, session_id: str, websocket=None, name: str | None = None):
         self.session_id = session_id
+        self.name = name
+        self.subscribers: list[ClientMailbox] = []
+        if websocket is not None:
+            self.subscribers.append(ClientMailbox(websocket, session_id))
+        self._broadcasting = False
+
+    def add_subscriber(self, websocket) -> ClientMailbox:
+        """Start broadcasting to another connection."""
+        if len(self.subscribers) >= MAX_SUBSCRIBERS_PER_SESSION:
+            raise RuntimeError(
+                f"Session {self.session_id} already has "
+                f"{MAX_SUBSCRIBERS_PER_SESSION} subscribers"
+            )
+        mailbox = ClientMailbox(websocket, self.session_id)
+        self.subscribers.append(mailbox)
+        if self._broadcasting:
+            mailbox.start()
+        return mailbox
+
+    def mailbox(self, websocket) -> ClientMailbox | None:
+        """The mailbox of a connection, or None if it is not subscribed."""
+        for mailbox in self.subscribers:
+            if mailbox.websocket is websocket:
+                return mailbox
+        return None
+
+    async def remove_subscriber(self, websocket):
+        """Stop broadcasting to a connection; unknown connections are ignored."""
+        mailbox = self.mailbox(websocket)
+        if mailbox is not None:
+            self.subscribers.remove(mailbox)
+            await mailbox.stop()
+
+    def publish(self, message: str):
+        """Post one encoded message to every subscriber's mailbox without waiting."""
+        for mailbox in self.subscribers:
+            mailbox.post(message)
+        if any(mailbox.closed for mailbox in self.subscribers):
+            self.subscribers = [m for m in self.subscribers if not m.closed]
+            logger.warning(f"Session {self.session_id}: dropped failed subscribers")
+
+    def start_broadcast(self):
+        """Start the subscribers' sender tasks, and those of later subscribers."""
+        self._broadcasting = True
+        for mailbox in self.subscribers:
+            mailbox.start()
+
+    async def stop_broadcast(self):
+        """Stop the sender tasks."""
+        self._broadcasting = False
+        for mailbox in self.subscribers:
+            await mailbox.stop()
+
+
+class SessionSimulation(BroadcastSession):
+    """
+    One simulation stepped by its own asyncio loop.
+    Each session owns its own Simulator, history, inlet mode, and async loop.
+    """
+
+    def __init__(
+        self,
+        session_id: str,
+        config: tank_sim.SimulatorConfig,
+        websocket=None,
+        name: str | None = None,
+    ):
+        super().__init__(session_id, websocket, name)
         self.config = config
-        self.websocket = websocket
         self.simulator: tank_sim.Simulator | None = None
-        self.history: deque = deque(maxlen=7200)  # 2 hours at 1 Hz
+        # TelemetryFrames, converted to dicts only when history is requested
+        self.history: deque = deque(maxlen=HISTORY_CAPACITY)
+        # History from before a restart (CompressedHistory), decoded into
+        # state dicts on the first history request and dropped once the
+        # live history is full
+        self.earlier_history: tank_sim.CompressedHistory | None = None
+        self._earlier_states: list[dict[str, float]] | None = None
+        # Renders state messages in native code, no per-tick dict or json.dumps
+        self.encoder = tank_sim.FrameEncoder()
         self.inlet_mode: str = "constant"
         self.inlet_mode_params: dict[str, float] = {
             "min": 0.8,
             "max": 1.2,
             "variance": 0.05,
         }
+        # Steps per tick on average; the credit carries fractions of a step
+        self.speed: float = 1.0
+        self._step_credit: float = 0.0
         self._task: asyncio.Task | None = None
         self._initialize()
 
@@ -46,67 +256,32 @@ class SessionSimulation:
     def get_state(self) -> dict[str, Any]:
         """Get current simulation state snapshot."""
         if self.simulator is None:
-            return {
-                "time": 0.0,
-                "tank_level": 0.0,
-                "setpoint": 0.0,
-                "inlet_flow": 0.0,
-                "outlet_flow": 0.0,
-                "valve_position": 0.0,
-                "error": 0.0,
-                "controller_output": 0.0,
-            }
+            return dict(EMPTY_STATE)
 
         try:
-            state = self.simulator.get_state()
-            tank_level = state[0]
-            setpoint = self.simulator.get_setpoint(0)
-            inlet_flow = self.simulator.get_inputs()[0]
-            valve_position = self.simulator.get_inputs()[1]
-            error = self.simulator.get_error(0)
-            controller_output = self.simulator.get_controller_output(0)
-            time = self.simulator.get_time()
-
-            k_v = self.config.model_params.k_v
-            outlet_flow = (
-                k_v * valve_position * (tank_level**0.5) if tank_level > 0 else 0.0
-            )
-
-            return {
-                "time": float(time),
-                "tank_level": float(tank_level),
-                "setpoint": float(setpoint),
-                "inlet_flow": float(inlet_flow),
-                "outlet_flow": float(outlet_flow),
-                "valve_position": float(valve_position),
-                "error": float(error),
-                "controller_output": float(controller_output),
-            }
+            return frame_to_state(self.simulator.get_telemetry())
         except Exception as e:
             logger.error(f"Session {self.session_id}: error getting state: {e}")
-            return {
-                "time": 0.0,
-                "tank_level": 0.0,
-                "setpoint": 0.0,
-                "inlet_flow": 0.0,
-                "outlet_flow": 0.0,
-                "valve_position": 0.0,
-                "error": 0.0,
-                "controller_output": 0.0,
-            }
+            return dict(EMPTY_STATE)
 
-    def step(self):
-        """Advance simulation by one time step."""
+    def step(self, steps: int = 1):
+        """
+        Advance simulation by one or more time steps (one batch in C++).
+
+        A Brownian inlet moves once per batch, by as much as it would over
+        all of its steps, so warped sessions wander at the same rate per
+        simulated second.
+        """
         if self.simulator is None:
             return
 
         try:
             if self.inlet_mode == "brownian":
                 current_inlet_flow = self.simulator.get_inputs()[0]
-                new_inlet_flow = self.apply_brownian_inlet(current_inlet_flow)
+                new_inlet_flow = self.apply_brownian_inlet(current_inlet_flow, steps)
                 self.simulator.set_input(0, new_inlet_flow)
 
-            self.simulator.step()
+            self.simulator.step(steps)
         except Exception as e:
             logger.error(f"Session {self.session_id}: error during step: {e}")
 
@@ -118,6 +293,7 @@ class SessionSimulation:
         try:
             self.simulator.reset()
             self.history.clear()
+            self._drop_earlier_history()
             self.inlet_mode = "constant"
             self.inlet_mode_params = {
                 "min": 0.8,
@@ -155,6 +331,15 @@ class SessionSimulation:
         except Exception as e:
             logger.error(f"Session {self.session_id}: error setting inlet flow: {e}")
 
+    def set_speed(self, value: float):
+        """
+        Run at value times real time (inf = as fast as possible).
+
+        Raises:
+            ValueError: If value is not positive.
+        """
+        self.speed = clamp_speed(value)
+
     def set_inlet_mode(
         self, mode: str, min_flow: float, max_flow: float, variance: float = 0.05
     ):
@@ -166,34 +351,125 @@ class SessionSimulation:
             "variance": variance,
         }
 
-    def apply_brownian_inlet(self, current_flow: float) -> float:
-        """Apply Brownian motion to inlet flow."""
-        increment = np.random.normal(0.0, self.inlet_mode_params["variance"])
+    def apply_brownian_inlet(self, current_flow: float, steps: int = 1) -> float:
+        """
+        Apply Brownian motion to inlet flow over a number of steps.
+
+        "variance" is the standard deviation of one step's increment; the
+        sum of `steps` independent increments has sqrt(steps) times that.
+        """
+        scale = self.inlet_mode_params["variance"] * math.sqrt(steps)
+        increment = np.random.normal(0.0, scale)
         new_flow = current_flow + increment
         min_flow = self.inlet_mode_params["min"]
         max_flow = self.inlet_mode_params["max"]
         new_flow = np.clip(new_flow, min_flow, max_flow)
         return float(new_flow)
 
+    def _earlier(self) -> list[dict[str, float]]:
+        """Restored history that still fits before the live history."""
+        if self.earlier_history is None:
+            return []
+        if self._earlier_states is None:
+            self._earlier_states = [
+                sample_to_state(s) for s in self.earlier_history.samples()
+            ]
+        room = HISTORY_CAPACITY - len(self.history)
+        return self._earlier_states[-room:] if room > 0 else []
+
+    def _drop_earlier_history(self):
+        self.earlier_history = None
+        self._earlier_states = None
+
     def get_history(self, duration: int = 3600) -> list[dict[str, Any]]:
         """Get historical data points."""
-        duration = max(1, min(duration, 7200))
+        duration = max(1, min(duration, HISTORY_CAPACITY))
         num_entries = min(duration, len(self.history))
-        if num_entries == 0:
-            return []
-        return list(self.history)[-num_entries:]
+        states = [frame_to_state(f) for f in list(self.history)[-num_entries:]]
+        if num_entries < duration:
+            earlier = self._earlier()[-(duration - num_entries) :]
+            states = earlier + states
+        return states
+
+    def get_history_since(self, time: float) -> list[dict[str, Any]]:
+        """Get the historical data points after a simulation time (catch-up after drops)."""
+        frames = []
+        for frame in reversed(self.history):
+            if frame.time <= time:
+                return [frame_to_state(f) for f in reversed(frames)]
+            frames.append(frame)
+        earlier = [s for s in self._earlier() if s["time"] > time]
+        return earlier + [frame_to_state(f) for f in reversed(frames)]
+
+    def add_to_checkpoint(self, writer: tank_sim.CheckpointWriter):
+        """Add this session's state, history and inlet mode to a checkpoint."""
+        metadata = {
+            "speed": self.speed,
+            "inlet_mode": self.inlet_mode,
+            "inlet_mode_params": self.inlet_mode_params,
+        }
+        writer.add(
+            self.name or self.session_id,
+            self.simulator,
+            self.history,
+            earlier=self.earlier_history,
+            metadata=json.dumps(metadata).encode(),
+        )
+
+    def restore_checkpoint(self, checkpoint: tank_sim.SessionCheckpoint, index: int):
+        """
+        Continue a checkpointed session in this one (before start()).
+
+        Raises:
+            ValueError: If the checkpoint was taken with another configuration.
+        """
+        checkpoint.restore(index, self.simulator)
+        self.earlier_history = checkpoint.history(index)
+        self._earlier_states = None
+        metadata = checkpoint.metadata(index)
+        if metadata:
+            state = json.loads(metadata)
+            self.speed = clamp_speed(state.get("speed", self.speed))
+            self.inlet_mode = state.get("inlet_mode", self.inlet_mode)
+            self.inlet_mode_params.update(state.get("inlet_mode_params", {}))
 
     async def simulation_loop(self):
-        """Main simulation loop running at 1 Hz, sending state to this session's websocket."""
+        """
+        Main simulation loop running at 1 Hz, broadcasting state to the subscribers.
+
+        Each tick takes `speed` steps on average in one simulator call and
+        publishes one frame, so fast sessions do not raise the frame rate
+        and slow ones skip the ticks on which they do not step.
+        """
         logger.info(f"Session {self.session_id}: simulation loop started")
+        loop = asyncio.get_running_loop()
+        deadline = loop.time()
         try:
             while True:
-                await asyncio.sleep(1.0)
+                # Absolute deadlines: the tick's own work does not delay the
+                # next one. Ticks missed while the loop was busy are skipped.
+                deadline += TICK_PERIOD
+                delay = deadline - loop.time()
+                if delay > 0:
+                    await asyncio.sleep(delay)
+                else:
+                    deadline += (-delay // TICK_PERIOD) * TICK_PERIOD
+                self._step_credit += self.speed
+                steps = min(math.floor(self._step_credit), MAX_STEPS_PER_TICK)
+                if steps < 1:
+                    continue
+                self._step_credit -= steps
                 try:
-                    self.step()
-                    state = self.get_state()
-                    self.history.append(state)
-                    await self.websocket.send_json({"type": "state", "data": state})
+                    self.step(steps)
+                    frame = self.simulator.get_telemetry()
+                    self.history.append(frame)
+                    if (
+                        self.earlier_history is not None
+                        and len(self.history) == HISTORY_CAPACITY
+                    ):
+                        self._drop_earlier_history()
+                    message = self.encoder.encode_json(frame).decode()
+                    self.publish(message)
                 except Exception as e:
                     logger.error(
                         f"Session {self.session_id}: error in loop iteration: {e}"
@@ -203,11 +479,13 @@ class SessionSimulation:
             raise
 
     def start(self):
-        """Start the simulation loop as an asyncio task."""
+        """Start the simulation loop and the subscribers' sender tasks."""
         self._task = asyncio.create_task(self.simulation_loop())
+        self.start_broadcast()
 
     async def stop(self):
-        """Stop the simulation loop."""
+        """Stop the simulation loop and the sender tasks."""
+        await self.stop_broadcast()
         if self._task is not None:
             self._task.cancel()
             try:
@@ -220,15 +498,35 @@ class SessionSimulation:
 
 class SessionManager:
     """
-    Manages per-connection simulation sessions.
+    Manages simulation sessions: private ones per connection and shared
+    ones that many connections join by name.
     Created once at startup, holds shared config.
     """
 
     def __init__(self, config: tank_sim.SimulatorConfig):
         self.config = config
-        self.sessions: dict[str, SessionSimulation] = {}
+        self.sessions: dict[str, BroadcastSession] = {}
+        self.shared: dict[str, str] = {}  # session name -> session id
+        self._restore_expiry: asyncio.Task | None = None
 
-    def create_session(self, websocket) -> SessionSimulation:
+    def _new_session(
+        self, session_id: str, websocket, name: str | None = None
+    ) -> SessionSimulation:
+        """Construct a session; subclasses change how sessions are stepped."""
+        return SessionSimulation(session_id, self.config, websocket, name=name)
+
+    def start(self):
+        """Start background work shared by all sessions (none here)."""
+
+    async def close(self):
+        """Destroy every session."""
+        if self._restore_expiry is not None:
+            self._restore_expiry.cancel()
+            self._restore_expiry = None
+        for session_id in list(self.sessions.keys()):
+            await self.destroy_session(session_id)
+
+    def create_session(self, websocket) -> BroadcastSession:
         """Create a new session for a WebSocket connection."""
         if len(self.sessions) >= MAX_SESSIONS:
             raise RuntimeError(
@@ -236,21 +534,150 @@ class SessionManager:
             )
 
         session_id = str(uuid.uuid4())
-        session = SessionSimulation(session_id, self.config, websocket)
+        session = self._new_session(session_id, websocket)
         self.sessions[session_id] = session
         session.start()
         logger.info(f"Session created: {session_id} (active: {len(self.sessions)})")
         return session
 
+    def join_shared_session(self, name: str, websocket) -> BroadcastSession:
+        """Subscribe a connection to the shared session with this name, creating it if needed."""
+        session_id = self.shared.get(name)
+        if session_id is not None:
+            session = self.sessions[session_id]
+            session.add_subscriber(websocket)
+            logger.info(
+                f"Session {session_id} ({name}): subscriber joined "
+                f"(subscribers: {len(session.subscribers)})"
+            )
+            return session
+
+        if len(self.sessions) >= MAX_SESSIONS:
+            raise RuntimeError(
+                f"Maximum sessions ({MAX_SESSIONS}) reached, rejecting connection"
+            )
+
+        session_id = str(uuid.uuid4())
+        session = self._new_session(session_id, websocket, name=name)
+        self.sessions[session_id] = session
+        self.shared[name] = session_id
+        session.start()
+        logger.info(
+            f"Shared session created: {name} -> {session_id} "
+            f"(active: {len(self.sessions)})"
+        )
+        return session
+
+    async def leave_session(self, session_id: str, websocket):
+        """Unsubscribe a connection; the session is destroyed with its last subscriber."""
+        session = self.sessions.get(session_id)
+        if session is None:
+            return
+        await session.remove_subscriber(websocket)
+        if not session.subscribers:
+            await self.destroy_session(session_id)
+
     async def destroy_session(self, session_id: str):
         """Stop and remove a session."""
         session = self.sessions.pop(session_id, None)
         if session is not None:
+            if session.name is not None:
+                self.shared.pop(session.name, None)
             await session.stop()
             logger.info(
                 f"Session destroyed: {session_id} (active: {len(self.sessions)})"
             )
 
+    async def checkpoint(self, path: str) -> int:
+        """
+        Write every shared session to a checkpoint file, e.g. on shutdown.
+
+        Sessions are captured here, between ticks; compressing and writing
+        runs on native threads off the event loop. Private sessions are not
+        written: their connection is gone after a restart.
+
+        Returns:
+            Sessions written (no file is written when there are none).
+
+        Raises:
+            RuntimeError: If the file cannot be written.
+        """
+        writer = tank_sim.CheckpointWriter()
+        for session_id in self.shared.values():
+            self.sessions[session_id].add_to_checkpoint(writer)
+        if len(writer) == 0:
+            return 0
+        size = await asyncio.to_thread(writer.write, path)
+        logger.info(f"Checkpointed {len(writer)} shared sessions ({size} bytes)")
+        return len(writer)
+
+    def restore(self, path: str, grace: float = RESTORE_GRACE_SECONDS) -> int:
+        """
+        Resume the shared sessions of a checkpoint file, e.g. on startup.
+
+        Each session continues from its checkpointed state and keeps its
+        history. Sessions run without subscribers until clients rejoin them
+        by name; those nobody rejoins within grace seconds are destroyed.
+        Names that already exist and sessions that do not fit the current
+        configuration are skipped.
+
+        Returns:
+            Sessions restored.
+
+        Raises:
+            RuntimeError: If the file is missing or not a valid checkpoint.
+        """
+        checkpoint = tank_sim.SessionCheckpoint(path)
+        restored = []
+        for index in range(len(checkpoint)):
+            name = checkpoint.name(index)
+            if name in self.shared:
+                continue
+            if len(self.sessions) >= MAX_SESSIONS:
+                logger.warning(
+                    f"Maximum sessions ({MAX_SESSIONS}) reached, "
+                    f"{len(checkpoint) - index} checkpointed sessions not restored"
+                )
+                break
+            session_id = str(uuid.uuid4())
+            session = self._new_session(session_id, None, name=name)
+            try:
+                session.restore_checkpoint(checkpoint, index)
+            except ValueError as e:
+                logger.warning(f"Checkpointed session {name} not restored: {e}")
+                continue
+            self.sessions[session_id] = session
+            self.shared[name] = session_id
+            session.start()
+            restored.append(session_id)
+        if restored:
+            self._restore_expiry = asyncio.create_task(
+                self._expire_restored(restored, grace)
+            )
+        logger.info(f"Restored {len(restored)} shared sessions from {path}")
+        return len(restored)
+
+    async def _expire_restored(self, session_ids: list[str], grace: float):
+        """Destroy restored sessions that nobody rejoined."""
+        await asyncio.sleep(grace)
+        self._restore_expiry = None
+        for session_id in session_ids:
+            session = self.sessions.get(session_id)
+            if session is not None and not session.subscribers:
+                await self.destroy_session(session_id)
+
+    def pacing_stats(self) -> dict[str, Any] | None:
+        """Tick lateness of a native engine thread; None for asyncio sessions."""
+        return None
+
     @property
     def active_session_count(self) -> int:
         return len(self.sessions)
+
+    @property
+    def subscriber_count(self) -> int:
+        return sum(len(s.subscribers) for s in self.sessions.values())
+
+    @property
+    def dropped_frame_count(self) -> int:
+        return sum(m.dropped for s in self.sessions.values() for m in s.subscribers)
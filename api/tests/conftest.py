@@ -5,7 +5,12 @@ This module provides shared fixtures for testing the FastAPI backend,
 including mocked tank_sim module and FastAPI test client setup.
 """
 
+import hashlib
+import json
+import os
+import pickle
 import sys
+from types import SimpleNamespace
 from unittest.mock import MagicMock
 
 import httpx
@@ -25,15 +30,18 @@ class MockSimulator:
         self.time = 0.0
         self.step_count = 0
 
-    def step(self):
-        """Simulate one step forward."""
-        self.time += 1.0
-        self.step_count += 1
-        # Simple simulation: inlet - outlet
-        outlet = 0.15 * self.inputs[1] * (self.state[0] ** 0.5)
-        net_flow = self.inputs[0] - outlet
-        self.state[0] = max(0, self.state[0] + net_flow * 1.0)
-        self.error[0] = self.setpoint[0] - self.state[0]
+    def step(self, steps=1):
+        """Simulate one or more steps forward."""
+        if steps < 1:
+            raise ValueError("stepMany requires at least one step")
+        for _ in range(steps):
+            self.time += 1.0
+            self.step_count += 1
+            # Simple simulation: inlet - outlet
+            outlet = 0.15 * self.inputs[1] * (self.state[0] ** 0.5)
+            net_flow = self.inputs[0] - outlet
+            self.state[0] = max(0, self.state[0] + net_flow * 1.0)
+            self.error[0] = self.setpoint[0] - self.state[0]
 
     def get_state(self):
         """Get tank level."""
@@ -59,6 +67,22 @@ class MockSimulator:
         """Get simulation time."""
         return self.time
 
+    def get_telemetry(self):
+        """Get the latest frame."""
+        return SimpleNamespace(
+            step=self.step_count,
+            time=self.time,
+            tank_level=self.state[0],
+            inlet_flow=self.inputs[0],
+            outlet_flow=0.15 * self.inputs[1] * (self.state[0] ** 0.5),
+            valve_position=self.inputs[1],
+            loop_count=1,
+            setpoint=list(self.setpoint),
+            error=list(self.error),
+            controller_output=list(self.controller_output),
+        )
+
+
     def set_setpoint(self, controller_idx, value):
         """Set controller setpoint."""
         self.setpoint[controller_idx] = value
@@ -81,6 +105,388 @@ class MockSimulator:
         self.time = 0.0
         self.step_count = 0
 
+    def capture_state(self):
+        """Snapshot the dynamic state."""
+        return pickle.dumps(
+            (self.state, self.setpoint, self.inputs, self.error,
+             self.controller_output, self.time, self.step_count)
+        )
+
+    def restore_state(self, data):
+        """Continue from a snapshot."""
+        (self.state, self.setpoint, self.inputs, self.error,
+         self.controller_output, self.time, self.step_count) = pickle.loads(data)
+
+
+SAMPLE_FIELDS = (
+    "time",
+    "tank_level",
+    "setpoint",
+    "inlet_flow",
+    "outlet_flow",
+    "valve_position",
+    "error",
+    "controller_output",
+)
+
+
+def frame_to_sample(frame):
+    """The SessionSample of a frame (loop 0)."""
+    return SimpleNamespace(
+        time=frame.time,
+        tank_level=frame.tank_level,
+        setpoint=frame.setpoint[0],
+        inlet_flow=frame.inlet_flow,
+        outlet_flow=frame.outlet_flow,
+        valve_position=frame.valve_position,
+        error=frame.error[0],
+        controller_output=frame.controller_output[0],
+    )
+
+
+class MockCompressedHistory:
+    def __init__(self, samples=()):
+        self._samples = [tuple(getattr(s, f) for f in SAMPLE_FIELDS) for s in samples]
+
+    def __len__(self):
+        return len(self._samples)
+
+    def samples(self):
+        return [SimpleNamespace(**dict(zip(SAMPLE_FIELDS, s))) for s in self._samples]
+
+
+class MockCheckpointWriter:
+    """Pickles what the native writer would compress and write."""
+
+    def __init__(self):
+        self._sessions = []
+
+    def add(self, name, simulator, history, earlier=None, metadata=b""):
+        samples = (earlier.samples() if earlier is not None else []) + [
+            frame_to_sample(f) for f in history
+        ]
+        self._sessions.append(
+            (name, metadata, simulator.capture_state(),
+             MockCompressedHistory(samples[-7200:])._samples)
+        )
+
+    def add_snapshot(self, name, snapshot, history, metadata=b""):
+        self._sessions.append(
+            (name, metadata, snapshot, MockCompressedHistory(history)._samples)
+        )
+
+    def __len__(self):
+        return len(self._sessions)
+
+    def write(self, path, threads=0):
+        data = pickle.dumps(self._sessions)
+        with open(path, "wb") as f:
+            f.write(data)
+        return len(data)
+
+
+class MockSessionCheckpoint:
+    def __init__(self, path):
+        try:
+            with open(path, "rb") as f:
+                self._sessions = pickle.load(f)
+        except (OSError, pickle.UnpicklingError, EOFError) as e:
+            raise RuntimeError(f"Cannot read checkpoint {path}: {e}")
+
+    def __len__(self):
+        return len(self._sessions)
+
+    def name(self, index):
+        return self._sessions[index][0]
+
+    def metadata(self, index):
+        return self._sessions[index][1]
+
+    def restore(self, index, simulator):
+        simulator.restore_state(self._sessions[index][2])
+
+    def snapshot(self, index):
+        return self._sessions[index][2]
+
+    def history(self, index):
+        history = MockCompressedHistory()
+        history._samples = self._sessions[index][3]
+        return history
+
+
+class MockFrameEncoder:
+    def encode_json(self, frame):
+        """Render the state message the way the native encoder does."""
+        data = {
+            "time": frame.time,
+            "tank_level": frame.tank_level,
+            "setpoint": frame.setpoint[0],
+            "inlet_flow": frame.inlet_flow,
+            "outlet_flow": frame.outlet_flow,
+            "valve_position": frame.valve_position,
+            "error": frame.error[0],
+            "controller_output": frame.controller_output[0],
+        }
+        message = {"type": "state", "data": data}
+        return json.dumps(message, separators=(",", ":")).encode()
+
+
+class MockCommandType:
+    SET_SETPOINT = "SET_SETPOINT"
+    SET_INPUT = "SET_INPUT"
+    SET_GAINS = "SET_GAINS"
+    RESET = "RESET"
+    SET_SPEED = "SET_SPEED"
+
+
+class MockOperatorCommand:
+    def __init__(self):
+        self.type = None
+        self.index = 0
+        self.value = 0.0
+        self.gains = None
+        self.id = 0
+
+
+class MockSessionEngine:
+    """
+    Steps MockSimulators when a test calls tick(), and signals a pipe the
+    way the native engine signals its eventfd.
+    """
+
+    def __init__(self, config, max_sessions=1000):
+        self.config = config
+        self.max_sessions = max_sessions
+        self.speculation_ticks = 0
+        self.sessions = {}  # key -> [simulator, subscribers]
+        self.speeds = {}  # key -> [speed, step credit]
+        self.running = False
+        self.ticks = 0
+        self.lost = 0
+        self._requests = []
+        self._imports = []
+        self._exports = []
+        self._frames = []
+        self._encoder = MockFrameEncoder()
+        self.store = None
+        self._read_fd, self._write_fd = os.pipe()
+        os.set_blocking(self._read_fd, False)
+
+    @staticmethod
+    def session_key(name):
+        return int.from_bytes(hashlib.sha1(name.encode()).digest()[:8], "little")
+
+    def start(self, tick_period=1.0, catch_up=None, realtime=False, cpu=-1):
+        self.running = True
+        self.realtime_cpu = cpu if realtime else None
+
+    def stop(self):
+        self.running = False
+
+    @property
+    def pacing_stats(self):
+        return SimpleNamespace(
+            ticks=self.ticks,
+            skipped=0,
+            mean_lateness_micros=50.0,
+            max_lateness_micros=900.0,
+            realtime=False,
+            percentile_micros=lambda fraction: 128.0,
+        )
+
+    def fileno(self):
+        return self._read_fd
+
+    def attach_store(self, store):
+        self.store = store
+
+    def enable_speculation(self, ticks):
+        if not 0 <= ticks <= 600:
+            raise ValueError("Speculation lookahead must be in 0..600 ticks")
+        self.speculation_ticks = ticks
+
+    @property
+    def speculation_stats(self):
+        return SimpleNamespace(
+            computed_steps=0, served_ticks=0, discarded_ticks=0
+        )
+
+    def join(self, session_key):
+        self._requests.append(("join", session_key, None))
+
+    def leave(self, session_key):
+        self._requests.append(("leave", session_key, None))
+
+    def submit(self, session_key, command):
+        self._requests.append(("command", session_key, command))
+
+    def export_session(self, session_key):
+        self._requests.append(("export", session_key, None))
+
+    def take_exports(self):
+        exports, self._exports = self._exports, []
+        return exports
+
+    def import_session(self, session_key, snapshot, subscribers=1, speed=1.0):
+        if subscribers < 1:
+            raise ValueError("An imported session needs a subscriber")
+        self._imports.append((session_key, snapshot, subscribers, speed))
+
+    def _apply(self, simulator, command):
+        if command.type == MockCommandType.SET_SETPOINT:
+            simulator.set_setpoint(command.index, command.value)
+        elif command.type == MockCommandType.SET_INPUT:
+            simulator.set_input(command.index, command.value)
+        elif command.type == MockCommandType.SET_GAINS:
+            simulator.set_controller_gains(command.index, command.gains)
+        elif command.type == MockCommandType.RESET:
+            simulator.reset()
+
+    def tick(self):
+        """Apply imports and queued requests, step every session and signal the reader."""
+        imports, self._imports = self._imports, []
+        for key, snapshot, subscribers, speed in imports:
+            if key not in self.sessions:
+                simulator = MockSimulator(self.config)
+                simulator.restore_state(snapshot)
+                self.sessions[key] = [simulator, subscribers]
+                self.speeds[key] = [speed, 0.0]
+        requests, self._requests = self._requests, []
+        for kind, key, command in requests:
+            session = self.sessions.get(key)
+            if kind == "join":
+                if session is not None:
+                    session[1] += 1
+                elif len(self.sessions) < self.max_sessions:
+                    self.sessions[key] = [MockSimulator(self.config), 1]
+            elif kind == "leave" and session is not None:
+                session[1] -= 1
+                if session[1] == 0:
+                    del self.sessions[key]
+                    self.speeds.pop(key, None)
+                    if self.store is not None:
+                        self.store.release(key)
+            elif kind == "export":
+                pacing = self.speeds.pop(key, [1.0, 0.0])
+                if session is None:
+                    self._exports.append((key, 1.0, None))
+                else:
+                    del self.sessions[key]
+                    self._exports.append((key, pacing[0], session[0].capture_state()))
+            elif kind == "command" and command.type == MockCommandType.SET_SPEED:
+                if session is not None and command.value == command.value:
+                    speed = min(max(command.value, 0.01), 3600.0)
+                    self.speeds.setdefault(key, [1.0, 0.0])[0] = speed
+            elif kind == "command" and session is not None:
+                self._apply(session[0], command)
+                if self.store is not None and command.type == MockCommandType.RESET:
+                    self.store.release(key)
+
+        for key, (simulator, _) in self.sessions.items():
+            pacing = self.speeds.setdefault(key, [1.0, 0.0])
+            pacing[1] += pacing[0]
+            steps = min(int(pacing[1]), 3600)
+            if steps < 1:
+                continue
+            pacing[1] -= steps
+            simulator.step(steps)
+            frame = simulator.get_telemetry()
+            message = self._encoder.encode_json(frame).decode()
+            self._frames.append((key, frame.time, message))
+            if self.store is not None:
+                self.store.publish(key, frame)
+        self.ticks += 1
+        os.write(self._write_fd, b"\x01")
+
+    def drain(self, max_frames=0):
+        try:
+            os.read(self._read_fd, 4096)
+        except BlockingIOError:
+            pass
+        frames, self._frames = self._frames, []
+        return frames
+
+    @property
+    def session_count(self):
+        return len(self.sessions)
+
+
+class MockShardRouter(MockSessionEngine):
+    """
+    Plays the router and its shard processes with one in-process engine:
+    tick() stands for the shards' ticks. A router has no thread of its
+    own, so start() and stop() must not be called.
+    """
+
+    def __init__(self, socket_paths):
+        super().__init__(sys.modules["tank_sim"].create_default_config())
+        self.shard_count = len(socket_paths)
+        self.drained = []
+
+    def start(self, tick_period=1.0):
+        raise AssertionError("Shards tick on their own")
+
+    def stop(self):
+        raise AssertionError("Shards tick on their own")
+
+    def drain_shard(self, shard):
+        self.drained.append(shard)
+        return len(self.sessions)
+
+    def export_session(self, session_key):
+        super().export_session(session_key)
+        return True
+
+
+class MockSharedSessionStore:
+    """
+    In-process stand-in for the shared-memory segment: stores with the same
+    name see the same sessions.
+    """
+
+    _segments = {}  # name -> {session_key: [frames]}
+
+    def __init__(self, name, slots):
+        self.name = name
+        self.slot_count = slots
+        self._sessions = MockSharedSessionStore._segments.setdefault(name, {})
+
+    @classmethod
+    def attach(cls, name):
+        if name not in cls._segments:
+            raise RuntimeError(f"No session store {name}")
+        return cls(name, 0)
+
+    @staticmethod
+    def unlink(name):
+        return MockSharedSessionStore._segments.pop(name, None) is not None
+
+    def publish(self, session_key, frame):
+        self._sessions.setdefault(session_key, []).append(frame)
+
+    def release(self, session_key):
+        self._sessions.pop(session_key, None)
+
+    def reclaim_dead(self):
+        return 0
+
+    def sessions(self):
+        return [
+            {"session_key": key, "slot": slot, "owner_pid": os.getpid(), "frames": len(f)}
+            for slot, (key, f) in enumerate(self._sessions.items())
+        ]
+
+    def latest(self, session_key):
+        frames = self._sessions.get(session_key)
+        return frames[-1] if frames else None
+
+    def history(self, session_key, since=float("-inf")):
+        return [
+            frame_to_sample(f)
+            for f in self._sessions.get(session_key, [])
+            if f.time > since
+        ]
+
 
 # Install mock BEFORE any imports - this runs at module import time
 if "tank_sim" not in sys.modules:
@@ -104,6 +510,16 @@ if "tank_sim" not in sys.modules:
     mock_module.SimulatorConfig = MagicMock(return_value=mock_config)
     mock_module.create_default_config = MagicMock(return_value=mock_config)
     mock_module.Simulator = MockSimulator
+    mock_module.FrameEncoder = MockFrameEncoder
+    mock_module.SessionEngine = MockSessionEngine
+    mock_module.SharedSessionStore = MockSharedSessionStore
+    mock_module.ShardRouter = MockShardRouter
+    mock_module.SessionSample = SimpleNamespace
+    mock_module.CompressedHistory = MockCompressedHistory
+    mock_module.CheckpointWriter = MockCheckpointWriter
+    mock_module.SessionCheckpoint = MockSessionCheckpoint
+    mock_module.OperatorCommand = MockOperatorCommand
+    mock_module.CommandType = MockCommandType
 
     # Mock PIDGains — supports both PIDGains() and PIDGains(Kc, tau_I, tau_D)
     class MockPIDGains:
@@ -128,6 +128,24 @@ def test_brownian_variance_effect(session):
     )
 
 
+def test_brownian_increment_scales_with_warped_steps(session, monkeypatch):
+    """A batch of steps moves the inlet by the spread of that many steps, once."""
+    scales = []
+
+    def normal(mean, scale):
+        scales.append(scale)
+        return 0.0
+
+    monkeypatch.setattr(np.random, "normal", normal)
+    session.set_inlet_mode("brownian", min_flow=0.5, max_flow=1.5, variance=0.05)
+
+    session.step()
+    session.step(100)
+
+    assert scales == pytest.approx([0.05, 0.5])
+    session.simulator.step.assert_called_with(100)
+
+
 def test_constant_mode_disables_brownian(session):
     """Verify inlet flow stops changing after switching to constant mode."""
     session.set_inlet_mode("brownian", min_flow=0.5, max_flow=1.5, variance=0.1)
@@ -4,6 +4,9 @@ Concurrency tests for the tank dynamics simulator API.
 Tests that multiple WebSocket sessions operate independently under concurrent load.
 """
 
+import asyncio
+import json
+
 import pytest
 from starlette.testclient import TestClient
 
@@ -124,3 +127,458 @@ def test_history_per_session(client):
                 if data["type"] == "history":
                     assert isinstance(data["data"], list)
                     break
+
+
+def test_shared_session_viewers_see_same_simulation(client):
+    """Connections joining the same named session share one simulator."""
+    with (
+        client.websocket_connect("/ws?session=plant") as ws1,
+        client.websocket_connect("/ws?session=plant") as ws2,
+        client.websocket_connect("/ws") as ws3,
+    ):
+        health = client.get("/api/health").json()
+        assert health["active_sessions"] == 2
+        assert health["active_subscribers"] == 3
+
+        ws1.receive_json()
+        ws2.receive_json()
+        ws3.receive_json()
+
+        # A command from one viewer is visible to the other, not to ws3
+        ws1.send_json({"type": "setpoint", "value": 4.0})
+        state1 = ws1.receive_json()
+        state2 = ws2.receive_json()
+        state3 = ws3.receive_json()
+        assert state1 == state2
+        assert state2["data"]["setpoint"] == 4.0
+        assert state3["data"]["setpoint"] == 2.5
+
+        # The shared simulation survives one viewer leaving
+        ws1.close()
+        assert ws2.receive_json()["type"] == "state"
+
+
+class RecordingWebSocket:
+    def __init__(self, fail: bool = False):
+        self.sent = []
+        self.fail = fail
+        self.gate = asyncio.Event()
+        self.gate.set()
+
+    async def send_text(self, message):
+        await self.gate.wait()
+        if self.fail:
+            raise ConnectionError("client went away")
+        self.sent.append(message)
+
+
+async def settle():
+    """Let the sender tasks run."""
+    for _ in range(5):
+        await asyncio.sleep(0)
+
+
+@pytest.mark.asyncio
+async def test_publish_hands_one_message_to_every_subscriber():
+    """One encoded message object goes to all viewers; failed viewers are dropped."""
+    import tank_sim
+
+    from api.simulation import SessionManager
+
+    manager = SessionManager(tank_sim.create_default_config())
+    viewers = [RecordingWebSocket(), RecordingWebSocket()]
+    broken = RecordingWebSocket(fail=True)
+    session = manager.join_shared_session("plant", viewers[0])
+    assert manager.join_shared_session("plant", viewers[1]) is session
+    manager.join_shared_session("plant", broken)
+    assert manager.active_session_count == 1
+
+    message = '{"type":"state"}'
+    session.publish(message)
+    await settle()
+    assert viewers[0].sent[0] is message
+    assert viewers[1].sent[0] is message
+    session.publish(message)
+    assert broken not in [m.websocket for m in session.subscribers]
+
+    # The session lives until its last subscriber leaves
+    await manager.leave_session(session.session_id, viewers[0])
+    assert manager.active_session_count == 1
+    await manager.leave_session(session.session_id, viewers[1])
+    assert manager.active_session_count == 0
+    assert manager.shared == {}
+
+
+@pytest.mark.asyncio
+async def test_stalled_client_gets_newest_frame_and_counts_drops():
+    """A blocked socket never blocks publishing; it later receives only the newest frame."""
+    import tank_sim
+
+    from api.simulation import SessionManager
+
+    manager = SessionManager(tank_sim.create_default_config())
+    fast = RecordingWebSocket()
+    slow = RecordingWebSocket()
+    slow.gate.clear()
+    session = manager.join_shared_session("plant", fast)
+    manager.join_shared_session("plant", slow)
+
+    for k in range(10):
+        session.publish(f"frame {k}")
+        await settle()
+
+    assert fast.sent == [f"frame {k}" for k in range(10)]
+    slow_stats = session.mailbox(slow).stats()
+    assert slow.sent == []
+    assert slow_stats["dropped"] == 8  # frame 0 is in flight, 9 is pending
+    assert slow_stats["pending"] == 1
+    assert session.mailbox(fast).stats()["dropped"] == 0
+    assert manager.dropped_frame_count == 8
+
+    slow.gate.set()
+    await settle()
+    assert slow.sent == ["frame 0", "frame 9"]
+
+    await manager.destroy_session(session.session_id)
+
+
+def test_client_stats_and_history_catch_up(client):
+    """A client can read its counters and fetch the frames after a time."""
+    with client.websocket_connect("/ws") as ws:
+        first = ws.receive_json()
+        ws.receive_json()
+
+        ws.send_json({"type": "history", "since": first["data"]["time"]})
+        ws.send_json({"type": "stats"})
+        replies = {}
+        for _ in range(6):
+            data = ws.receive_json()
+            replies[data["type"]] = data
+            if "history" in replies and "stats" in replies:
+                break
+
+        times = [entry["time"] for entry in replies["history"]["data"]]
+        assert times and all(t > first["data"]["time"] for t in times)
+        assert replies["stats"]["data"]["sent"] >= 2
+        assert replies["stats"]["data"]["dropped"] == 0
+
+
+@pytest.mark.asyncio
+async def test_native_engine_wakes_once_for_all_sessions():
+    """One engine signal dispatches the tick's frame of every session."""
+    import tank_sim
+
+    from api.engine_bridge import EngineSessionManager
+
+    manager = EngineSessionManager(tank_sim.create_default_config())
+    manager.start()
+    private = RecordingWebSocket()
+    viewers = [RecordingWebSocket(), RecordingWebSocket()]
+    manager.create_session(private)
+    shared = manager.join_shared_session("plant", viewers[0])
+    manager.join_shared_session("plant", viewers[1])
+
+    manager.engine.tick()
+    await settle()
+    assert manager.engine.session_count == 2
+    assert len(private.sent) == 1
+    assert viewers[0].sent[0] is viewers[1].sent[0]
+
+    # Two ticks behind: one drain, and the mailbox keeps only the newest
+    manager.engine.tick()
+    manager.engine.tick()
+    await settle()
+    assert len(private.sent) == 2
+    assert json.loads(private.sent[-1])["data"]["time"] == 3.0
+    assert manager.dropped_frame_count == 3
+    assert len(shared.history) == 3
+
+    await manager.close()
+    assert manager.active_session_count == 0
+
+
+@pytest.mark.asyncio
+async def test_native_engine_reports_tick_lateness():
+    """The native engine can run real-time and reports its pacing; asyncio sessions do not."""
+    import tank_sim
+
+    from api.engine_bridge import EngineSessionManager
+    from api.simulation import SessionManager
+
+    manager = EngineSessionManager(tank_sim.create_default_config(), realtime_cpu=2)
+    manager.start()
+    assert manager.engine.realtime_cpu == 2
+    manager.engine.tick()
+    stats = manager.pacing_stats()
+    assert stats["ticks"] == 1
+    assert stats["p99_lateness_micros"] == 128.0
+    assert stats["realtime"] is False
+    await manager.close()
+
+    assert SessionManager(tank_sim.create_default_config()).pacing_stats() is None
+
+
+@pytest.mark.asyncio
+async def test_native_engine_speculation_is_configured_and_reported():
+    """The lookahead reaches the engine before it starts and shows up under pacing."""
+    import tank_sim
+
+    from api.engine_bridge import EngineSessionManager
+
+    manager = EngineSessionManager(tank_sim.create_default_config(), speculation_ticks=30)
+    manager.start()
+    assert manager.engine.speculation_ticks == 30
+    manager.engine.tick()
+    speculation = manager.pacing_stats()["speculation"]
+    assert speculation["lookahead_ticks"] == 30
+    assert speculation["served_ticks"] == 0
+    await manager.close()
+
+    plain = EngineSessionManager(tank_sim.create_default_config())
+    plain.start()
+    assert plain.pacing_stats()["speculation"] is None
+    await plain.close()
+
+
+@pytest.mark.asyncio
+async def test_native_engine_commands_history_and_teardown():
+    """Commands are queued to the engine; the last leave destroys its simulation."""
+    import tank_sim
+
+    from api.engine_bridge import EngineSessionManager
+
+    manager = EngineSessionManager(tank_sim.create_default_config())
+    manager.start()
+    ws = RecordingWebSocket()
+    session = manager.create_session(ws)
+
+    session.set_setpoint(4.0)
+    manager.engine.tick()
+    manager.engine.tick()
+    await settle()
+    assert json.loads(ws.sent[-1])["data"]["setpoint"] == 4.0
+    history = session.get_history()
+    assert [entry["time"] for entry in history] == [1.0, 2.0]
+    assert session.get_history_since(1.0) == history[1:]
+    with pytest.raises(ValueError):
+        session.set_inlet_mode("brownian", 0.8, 1.2)
+
+    await manager.leave_session(session.session_id, ws)
+    manager.engine.tick()
+    assert manager.active_session_count == 0
+    assert manager.engine.session_count == 0
+    await manager.close()
+
+
+@pytest.mark.asyncio
+async def test_native_engine_references_are_released_with_dropped_subscribers():
+    """Subscribers pruned by publish() and sessions destroyed outright leave the engine."""
+    import tank_sim
+
+    from api.engine_bridge import EngineSessionManager
+
+    manager = EngineSessionManager(tank_sim.create_default_config())
+    manager.start()
+    good, failing = RecordingWebSocket(), RecordingWebSocket(fail=True)
+    session = manager.join_shared_session("plant", good)
+    manager.join_shared_session("plant", failing)
+    manager.engine.tick()
+    assert manager.engine.sessions[session.key][1] == 2
+
+    # The failed send closes its mailbox; the next publish drops it
+    await settle()
+    manager.engine.tick()
+    await settle()
+    assert session.joined == 1
+    manager.engine.tick()
+    assert manager.engine.sessions[session.key][1] == 1
+
+    # Destroying the session releases the remaining reference
+    await manager.destroy_session(session.session_id)
+    manager.engine.tick()
+    assert manager.engine.session_count == 0
+    await manager.close()
+
+
+@pytest.mark.asyncio
+async def test_native_engine_paces_each_session_at_its_speed():
+    """The engine batches fast sessions' steps and skips slow ones' ticks, one frame at most."""
+    import math
+
+    import tank_sim
+
+    from api.engine_bridge import EngineSessionManager
+
+    manager = EngineSessionManager(tank_sim.create_default_config())
+    manager.start()
+    fast = manager.create_session(RecordingWebSocket())
+    slow = manager.create_session(RecordingWebSocket())
+    fast.set_speed(10.0)
+    slow.set_speed(0.5)
+    for _ in range(4):
+        manager.engine.tick()
+    await settle()
+    assert [entry["time"] for entry in fast.get_history()] == [10.0, 20.0, 30.0, 40.0]
+    assert [entry["time"] for entry in slow.get_history()] == [1.0, 2.0]
+
+    fast.set_speed(math.inf)
+    manager.engine.tick()
+    await settle()
+    assert fast.get_history(1)[0]["time"] == 40.0 + 3600.0
+    with pytest.raises(ValueError):
+        slow.set_speed(0.0)
+    await manager.close()
+
+
+@pytest.mark.asyncio
+async def test_sharded_manager_leaves_ticking_to_the_shards():
+    """The sharded manager only watches the router; the shards tick."""
+    import tank_sim
+
+    from api.engine_bridge import ShardedSessionManager
+
+    manager = ShardedSessionManager(
+        tank_sim.create_default_config(), ["/tmp/shard0.sock", "/tmp/shard1.sock"]
+    )
+    manager.start()
+    ws = RecordingWebSocket()
+    session = manager.create_session(ws)
+    session.set_setpoint(4.0)
+    manager.engine.tick()
+    manager.engine.tick()
+    await settle()
+    assert json.loads(ws.sent[-1])["data"]["setpoint"] == 4.0
+    assert manager.drain_shard(0) == 1
+    assert manager.engine.drained == [0]
+
+    await manager.leave_session(session.session_id, ws)
+    manager.engine.tick()
+    assert manager.engine.session_count == 0
+    await manager.close()
+
+
+@pytest.mark.asyncio
+async def test_shared_session_readable_from_another_store():
+    """A worker opening the same store reads the engine's shared sessions."""
+    import tank_sim
+
+    from api.engine_bridge import EngineSessionManager, read_shared_session
+
+    store = tank_sim.SharedSessionStore("/tank_sim_api_test", 8)
+    try:
+        manager = EngineSessionManager(tank_sim.create_default_config())
+        manager.engine.attach_store(store)
+        manager.start()
+        ws = RecordingWebSocket()
+        session = manager.join_shared_session("plant", ws)
+        session.set_setpoint(3.5)
+        for _ in range(3):
+            manager.engine.tick()
+
+        # Another worker: its own store object, no engine
+        reader = tank_sim.SharedSessionStore("/tank_sim_api_test", 8)
+        snapshot = read_shared_session(reader, "plant")
+        assert snapshot["state"]["time"] == 3.0
+        assert snapshot["state"]["setpoint"] == 3.5
+        assert [entry["time"] for entry in snapshot["history"]] == [1.0, 2.0, 3.0]
+        assert len(read_shared_session(reader, "plant", since=2.0)["history"]) == 1
+        assert read_shared_session(reader, "other") is None
+
+        await manager.leave_session(session.session_id, ws)
+        manager.engine.tick()
+        assert read_shared_session(reader, "plant") is None
+        await manager.close()
+    finally:
+        tank_sim.SharedSessionStore.unlink("/tank_sim_api_test")
+
+
+@pytest.mark.asyncio
+async def test_shared_sessions_survive_a_restart(tmp_path):
+    """Shared sessions resume from a checkpoint; unclaimed ones expire."""
+    import tank_sim
+
+    from api.simulation import SessionManager
+
+    path = str(tmp_path / "sessions.ckp")
+    manager = SessionManager(tank_sim.create_default_config())
+    session = manager.join_shared_session("plant", RecordingWebSocket())
+    manager.create_session(RecordingWebSocket())  # private: not checkpointed
+    session.set_setpoint(3.0)
+    session.set_inlet_mode("brownian", 0.9, 1.1, 0.01)
+    for _ in range(3):
+        session.step()
+        session.history.append(session.simulator.get_telemetry())
+    assert await manager.checkpoint(path) == 1
+    await manager.close()
+
+    restarted = SessionManager(tank_sim.create_default_config())
+    assert restarted.restore(path, grace=0.05) == 1
+    session = restarted.sessions[restarted.shared["plant"]]
+    assert session.get_state()["time"] == 3.0
+    assert session.get_state()["setpoint"] == 3.0
+    assert session.inlet_mode == "brownian"
+    assert [s["time"] for s in session.get_history()] == [1.0, 2.0, 3.0]
+    assert [s["time"] for s in session.get_history_since(1.0)] == [2.0, 3.0]
+    session.step()
+    session.history.append(session.simulator.get_telemetry())
+    assert [s["time"] for s in session.get_history(3)] == [2.0, 3.0, 4.0]
+    assert [s["time"] for s in session.get_history_since(2.5)] == [3.0, 4.0]
+    ws = RecordingWebSocket()
+    assert restarted.join_shared_session("plant", ws) is session
+    await asyncio.sleep(0.1)
+    assert restarted.active_session_count == 1  # rejoined: kept
+    await restarted.close()
+
+    unclaimed = SessionManager(tank_sim.create_default_config())
+    assert unclaimed.restore(path, grace=0.05) == 1
+    await asyncio.sleep(0.1)
+    assert unclaimed.active_session_count == 0
+    await unclaimed.close()
+
+
+@pytest.mark.asyncio
+async def test_native_engine_sessions_survive_a_restart(tmp_path):
+    """The engine hands its shared sessions over for a checkpoint and imports them again."""
+    import tank_sim
+
+    from api.engine_bridge import EngineSessionManager
+
+    path = str(tmp_path / "sessions.ckp")
+    manager = EngineSessionManager(tank_sim.create_default_config())
+    manager.start()
+    session = manager.join_shared_session("plant", RecordingWebSocket())
+    manager.create_session(RecordingWebSocket())  # private: not checkpointed
+    session.set_setpoint(3.0)
+    session.set_speed(2.0)
+    for _ in range(3):
+        manager.engine.tick()
+    await settle()
+
+    checkpoint = asyncio.create_task(manager.checkpoint(path))
+    await settle()
+    manager.engine.tick()
+    assert await checkpoint == 1
+    assert manager.engine.session_count == 1  # the private session
+    assert session.joined == 0
+    await manager.close()
+
+    restarted = EngineSessionManager(tank_sim.create_default_config())
+    restarted.start()
+    assert restarted.restore(path, grace=0.05) == 1
+    session = restarted.sessions[restarted.shared["plant"]]
+    assert [s["time"] for s in session.get_history()] == [2.0, 4.0, 6.0]
+    restarted.engine.tick()
+    await settle()
+    assert restarted.engine.session_count == 1
+    latest = session.get_history(1)[0]
+    assert latest["time"] == 8.0  # continued at its speed
+    assert latest["setpoint"] == 3.0
+    restarted.engine.tick()
+    assert restarted.engine.session_count == 1  # kept without subscribers
+
+    # Nobody rejoined: the expiry releases the restored session's reference
+    await asyncio.sleep(0.1)
+    restarted.engine.tick()
+    assert restarted.active_session_count == 0
+    assert restarted.engine.session_count == 0
+    await restarted.close()
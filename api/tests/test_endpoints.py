@@ -48,6 +48,13 @@ def test_get_config(client):
     assert data["history_capacity"] > 0
 
 
+def test_shared_session_without_store_returns_503(client):
+    """Verify GET /api/shared/{name} needs SESSION_STORE to be configured."""
+    response = client.get("/api/shared/plant")
+    assert response.status_code == 503
+    assert "SESSION_STORE" in response.json()["error"]
+
+
 def test_404_unknown_endpoint(client):
     """Verify requests to non-existent endpoints return 404."""
     response = client.get("/api/nonexistent")
@@ -164,6 +164,22 @@ def test_websocket_invalid_command_type(client):
         assert "Unknown" in data.get("message", "")
 
 
+def test_websocket_speed_command(client):
+    """A faster session advances several steps per state message; zero is rejected."""
+    with client.websocket_connect("/ws") as ws:
+        ws.receive_json()
+
+        ws.send_json({"type": "speed", "value": 0})
+        data = ws.receive_json()
+        while data["type"] == "state":
+            data = ws.receive_json()
+        assert data["type"] == "error"
+
+        ws.send_json({"type": "speed", "value": 20})
+        times = [ws.receive_json()["data"]["time"] for _ in range(3)]
+        assert times[2] - times[1] == pytest.approx(20.0)
+
+
 def test_websocket_session_isolation(client):
     """Two WebSocket connections should have independent simulation state."""
     with (
@@ -15,9 +15,22 @@
 #include <pybind11/eigen.h>
 #include <pybind11/stl.h>
 
+#include <cstring>
+#include <limits>
+
+#include "control_graph.h"
+#include "engine_thread.h"
+#include "frame_delta.h"
+#include "frame_encoder.h"
+#include "gain_schedule.h"
+#include "history_codec.h"
+#include "parameter_estimator.h"
+#include "shard_router.h"
+#include "shared_session_store.h"
 #include "simulator.h"
 #include "tank_model.h"
 #include "pid_controller.h"
+#include "session_checkpoint.h"
 #include "stepper.h"
 
 namespace py = pybind11;
@@ -30,6 +43,103 @@ std::string get_version() {
     return "0.1.0";
 }
 
+/**
+ * @brief One Python consumer of a simulator's telemetry stream.
+ *
+ * Holds the consumer's cursor; the simulator is kept alive by the binding.
+ */
+struct TelemetrySubscription {
+    const tank_sim::Simulator *sim;
+    tank_sim::Simulator::TelemetryRing::Cursor cursor;
+};
+
+/**
+ * @brief A SessionEngine ticked on its own thread, as seen from Python.
+ *
+ * Python is the engine's single request producer (calls hold the GIL) and
+ * reads the frame ring with its own cursor after each signal.
+ */
+struct PyEngine {
+    std::unique_ptr<tank_sim::SessionEngine> engine;
+    tank_sim::SessionEngine::RequestQueue *queue;
+    tank_sim::SessionEngine::FrameRing::Cursor cursor;
+    tank_sim::TickSignal signal;
+    std::unique_ptr<tank_sim::EngineThread> thread;   // Destroyed first: stops ticking
+
+    PyEngine(const tank_sim::Simulator::Config &config, int max_sessions)
+        : engine(std::make_unique<tank_sim::SessionEngine>(config, max_sessions)),
+          queue(&engine->addProducer()), cursor(engine->frames().subscribe()) {}
+
+    void push(tank_sim::SessionEngine::Request::Type type, std::uint64_t key,
+              const tank_sim::OperatorCommand &command = tank_sim::OperatorCommand{}) {
+        if (!queue->tryPush(tank_sim::SessionEngine::Request{type, key, command})) {
+            throw std::runtime_error("Engine request queue is full");
+        }
+    }
+};
+
+/**
+ * @brief Sessions collected from Python for one SessionCheckpoint::write().
+ */
+struct PyCheckpointWriter {
+    std::vector<tank_sim::SessionCheckpoint::Session> sessions;
+};
+
+/**
+ * @brief A snapshot as Python bytes (raw native layout, same host only).
+ */
+py::bytes snapshotBytes(const tank_sim::SimulatorSnapshot &snapshot) {
+    return py::bytes(reinterpret_cast<const char *>(&snapshot), sizeof(snapshot));
+}
+
+/**
+ * @brief The snapshot in bytes made by snapshotBytes().
+ * @throws std::invalid_argument if the size does not match
+ */
+tank_sim::SimulatorSnapshot snapshotFromBytes(const py::bytes &data) {
+    const std::string bytes = data;
+    tank_sim::SimulatorSnapshot snapshot;
+    if (bytes.size() != sizeof(snapshot)) {
+        throw std::invalid_argument("Not a simulator snapshot");
+    }
+    std::memcpy(&snapshot, bytes.data(), sizeof(snapshot));
+    return snapshot;
+}
+
+/**
+ * @brief Exported sessions as (session_key, speed, snapshot) tuples.
+ *
+ * The snapshot is None for sessions the engine did not have.
+ */
+py::list exportTuples(const std::vector<tank_sim::SessionEngine::Transfer> &transfers) {
+    py::list exports;
+    for (const auto &transfer : transfers) {
+        py::object snapshot = py::none();
+        if (transfer.subscribers > 0) {
+            snapshot = snapshotBytes(transfer.snapshot);
+        }
+        exports.append(py::make_tuple(transfer.sessionKey, transfer.speed, snapshot));
+    }
+    return exports;
+}
+
+/**
+ * @brief Transfer that imports a snapshot with the given subscribers.
+ * @throws std::invalid_argument if there are no subscribers or no snapshot
+ */
+tank_sim::SessionEngine::Transfer importTransfer(std::uint64_t key, const py::bytes &snapshot,
+                                                 int subscribers, double speed) {
+    if (subscribers < 1) {
+        throw std::invalid_argument("An imported session needs a subscriber");
+    }
+    tank_sim::SessionEngine::Transfer transfer;
+    transfer.sessionKey = key;
+    transfer.subscribers = subscribers;
+    transfer.snapshot = snapshotFromBytes(snapshot);
+    transfer.speed = speed;
+    return transfer;
+}
+
 /**
  * @brief pybind11 module definition
  *
@@ -55,90 +165,1469 @@ PYBIND11_MODULE(_tank_sim, m) {
         This module is not intended for direct import. Use the tank_sim
         package instead:
 
-            import tank_sim
-            print(tank_sim.get_version())
+            import tank_sim
+            print(tank_sim.get_version())
+
+        Full class bindings (Simulator, SimulatorConfig, etc.) will be
+        added in subsequent development tasks.
+    )pbdoc";
+
+    // Module version function
+    m.def("get_version", &get_version, R"pbdoc(
+        Get the version of the tank_sim module.
+
+        Returns:
+            str: Version string in semantic versioning format (e.g., "0.1.0").
+    )pbdoc");
+
+    // ========================================================================
+    // TankModel::Parameters binding
+    // ========================================================================
+    py::class_<tank_sim::TankModel::Parameters>(m, "TankModelParameters", R"pbdoc(
+        Configuration parameters for the tank physics model.
+
+        This class represents the physical characteristics of the tank system.
+        All parameters are read-write and can be modified at any time.
+
+        Attributes:
+            area (float): Cross-sectional area of the tank in m².
+                         Must be positive. Larger area means slower level changes.
+            k_v (float): Valve discharge coefficient in m^2.5/s.
+                        Determines the relationship between valve position and outlet flow.
+                        For the standard tank, k_v = 1.2649.
+            max_height (float): Maximum tank height in meters.
+                               Physical limit of the tank. Typically 5.0 m.
+
+        Example:
+            >>> params = TankModelParameters()
+            >>> params.area = 120.0
+            >>> params.k_v = 1.2649
+            >>> params.max_height = 5.0
+    )pbdoc")
+        .def(py::init<>())
+        .def_readwrite("area", &tank_sim::TankModel::Parameters::area,
+                      "Cross-sectional area (m²)")
+        .def_readwrite("k_v", &tank_sim::TankModel::Parameters::k_v,
+                      "Valve discharge coefficient (m^2.5/s)")
+        .def_readwrite("max_height", &tank_sim::TankModel::Parameters::max_height,
+                      "Maximum tank height (m)");
+
+    // ========================================================================
+    // PIDController::Gains binding
+    // ========================================================================
+    py::class_<tank_sim::PIDController::Gains>(m, "PIDGains", R"pbdoc(
+        PID controller gain parameters.
+
+        This class contains the three tuning parameters for a PID controller:
+        proportional, integral, and derivative gains. All parameters are read-write
+        and can be modified at any time for dynamic retuning.
+
+        Attributes:
+            Kc (float): Proportional gain (dimensionless).
+                       Controls the immediate response to error. Negative values
+                       implement reverse-acting control (e.g., for outlet valve).
+                       Typical range: -5.0 to +5.0 depending on system dynamics.
+            tau_I (float): Integral time constant in seconds.
+                          Controls long-term error correction. Larger values mean
+                          slower integral action. Set to 0 to disable integral action.
+                          Typical range: 5.0 to 50.0 seconds.
+            tau_D (float): Derivative time constant in seconds.
+                          Provides predictive damping based on error rate of change.
+                          Set to 0 to disable derivative action.
+                          Typical range: 0.5 to 5.0 seconds.
+
+        Example:
+            >>> gains = PIDGains()
+            >>> gains.Kc = -1.0      # Reverse-acting
+            >>> gains.tau_I = 10.0   # 10 second integral
+            >>> gains.tau_D = 1.0    # 1 second derivative
+    )pbdoc")
+        .def(py::init<>())
+        .def_readwrite("Kc", &tank_sim::PIDController::Gains::Kc,
+                      "Proportional gain (dimensionless)")
+        .def_readwrite("tau_I", &tank_sim::PIDController::Gains::tau_I,
+                      "Integral time constant (seconds)")
+        .def_readwrite("tau_D", &tank_sim::PIDController::Gains::tau_D,
+                      "Derivative time constant (seconds)");
+
+    // ========================================================================
+    // SignalRef / ControlLink bindings
+    // ========================================================================
+    py::enum_<tank_sim::SignalRef::Source>(m, "SignalSource", R"pbdoc(
+        Where a signal is read from.
+
+        Values:
+            STATE: state vector element (e.g. 0 = tank level)
+            INPUT: input vector element (0 = inlet flow, 1 = valve position)
+            CONTROLLER_OUTPUT: output of another controller (by controller index)
+    )pbdoc")
+        .value("STATE", tank_sim::SignalRef::Source::State)
+        .value("INPUT", tank_sim::SignalRef::Source::Input)
+        .value("CONTROLLER_OUTPUT", tank_sim::SignalRef::Source::ControllerOutput);
+
+    py::class_<tank_sim::SignalRef>(m, "SignalRef", R"pbdoc(
+        Reference to a scalar signal in the simulator.
+
+        Attributes:
+            source (SignalSource): Which vector the signal lives in.
+            index (int): Element index (or controller index for CONTROLLER_OUTPUT).
+
+        Example:
+            >>> inlet = SignalRef(SignalSource.INPUT, 0)
+    )pbdoc")
+        .def(py::init<>())
+        .def(py::init([](tank_sim::SignalRef::Source source, int index) {
+                 return tank_sim::SignalRef{source, index};
+             }),
+             py::arg("source"), py::arg("index"))
+        .def_readwrite("source", &tank_sim::SignalRef::source, "Signal source")
+        .def_readwrite("index", &tank_sim::SignalRef::index, "Signal index");
+
+    py::enum_<tank_sim::ControlLink::Type>(m, "ControlLinkType", R"pbdoc(
+        Kind of control link.
+
+        Values:
+            CASCADE: setpoint[target] = gain * master_output + bias
+            RATIO: setpoint[target] = gain * signal + bias
+            FEEDFORWARD: output[target] += gain * (signal - bias)
+    )pbdoc")
+        .value("CASCADE", tank_sim::ControlLink::Type::Cascade)
+        .value("RATIO", tank_sim::ControlLink::Type::Ratio)
+        .value("FEEDFORWARD", tank_sim::ControlLink::Type::Feedforward);
+
+    py::class_<tank_sim::ControlLink>(m, "ControlLink", R"pbdoc(
+        Connection between a signal and a controller (cascade, ratio, feedforward).
+
+        The simulator sorts controllers once at construction so every master
+        is computed before the loops it drives. Cycles are rejected.
+
+        Attributes:
+            type (ControlLinkType): Link kind.
+            source (SignalRef): Signal driving the link. Must be a
+                               CONTROLLER_OUTPUT for CASCADE links.
+            target (int): Index of the driven controller.
+            gain (float): Ratio or feedforward gain.
+            bias (float): Setpoint offset (cascade/ratio) or the signal's
+                         nominal value (feedforward).
+
+        Example:
+            >>> link = ControlLink()
+            >>> link.type = ControlLinkType.FEEDFORWARD
+            >>> link.source = SignalRef(SignalSource.INPUT, 0)  # inlet flow
+            >>> link.target = 0
+            >>> link.gain = 0.4
+            >>> link.bias = 1.0  # nominal inlet flow
+    )pbdoc")
+        .def(py::init<>())
+        .def_readwrite("type", &tank_sim::ControlLink::type, "Link kind")
+        .def_readwrite("source", &tank_sim::ControlLink::source, "Driving signal")
+        .def_readwrite("target", &tank_sim::ControlLink::target, "Driven controller index")
+        .def_readwrite("gain", &tank_sim::ControlLink::gain, "Ratio or feedforward gain")
+        .def_readwrite("bias", &tank_sim::ControlLink::bias, "Offset or nominal signal value");
+
+    // ========================================================================
+    // Gain scheduling bindings
+    // ========================================================================
+    py::class_<tank_sim::GainSchedule::Point>(m, "GainSchedulePoint", R"pbdoc(
+        One breakpoint of a gain schedule table.
+
+        Attributes:
+            x (float): Value of the scheduling variable at this breakpoint.
+            gains (PIDGains): Gains to use when the variable equals x.
+    )pbdoc")
+        .def(py::init<>())
+        .def(py::init([](double x, const tank_sim::PIDController::Gains& gains) {
+                 return tank_sim::GainSchedule::Point{x, gains};
+             }),
+             py::arg("x"), py::arg("gains"))
+        .def_readwrite("x", &tank_sim::GainSchedule::Point::x, "Breakpoint value")
+        .def_readwrite("gains", &tank_sim::GainSchedule::Point::gains, "Gains at breakpoint");
+
+    py::class_<tank_sim::GainScheduleConfig>(m, "GainScheduleConfig", R"pbdoc(
+        Gain schedule attached to one controller.
+
+        Each step the controller's Kc, tau_I and tau_D are linearly
+        interpolated from the table at the current value of the scheduling
+        variable (clamped outside the table). The integral state is rescaled
+        so that gain changes are bumpless. Scheduled gains override
+        set_controller_gains() on the next step.
+
+        Attributes:
+            controller (int): Index of the scheduled controller.
+            variable (SignalRef): Scheduling variable (STATE or INPUT source).
+            table (list[GainSchedulePoint]): Breakpoints, strictly increasing x.
+
+        Example:
+            >>> schedule = GainScheduleConfig()
+            >>> schedule.controller = 0
+            >>> schedule.variable = SignalRef(SignalSource.STATE, 0)  # level
+            >>> schedule.table = [
+            ...     GainSchedulePoint(1.0, PIDGains()),
+            ...     GainSchedulePoint(4.0, PIDGains()),
+            ... ]
+    )pbdoc")
+        .def(py::init<>())
+        .def_readwrite("controller", &tank_sim::GainScheduleConfig::controller,
+                      "Scheduled controller index")
+        .def_readwrite("variable", &tank_sim::GainScheduleConfig::variable,
+                      "Scheduling variable")
+        .def_readwrite("table", &tank_sim::GainScheduleConfig::table,
+                      "Gain table breakpoints");
+
+    // ========================================================================
+    // MPC bindings
+    // ========================================================================
+    py::enum_<tank_sim::Simulator::ControllerType>(m, "ControllerType", R"pbdoc(
+        Control law used by a controller.
+
+        Values:
+            PID: Discrete PID with anti-windup (default).
+            MPC: Linear model predictive control on the tank model.
+    )pbdoc")
+        .value("PID", tank_sim::Simulator::ControllerType::PID)
+        .value("MPC", tank_sim::Simulator::ControllerType::MPC);
+
+    py::class_<tank_sim::MPCController::Settings>(m, "MPCSettings", R"pbdoc(
+        Tuning and solver settings for an MPC controller.
+
+        Attributes:
+            horizon (int): Prediction horizon in samples.
+            control_horizon (int): Number of free output moves (1 to horizon).
+                                  Later moves are held at the last free value.
+            output_weight (float): Weight on squared level error.
+            move_weight (float): Weight on squared output moves.
+            rho (float): Initial ADMM penalty parameter.
+            max_iterations (int): ADMM iteration cap per solve.
+            tolerance (float): ADMM primal/dual residual tolerance.
+
+        Example:
+            >>> settings = MPCSettings()
+            >>> settings.horizon = 40
+            >>> settings.move_weight = 0.1
+    )pbdoc")
+        .def(py::init<>())
+        .def_readwrite("horizon", &tank_sim::MPCController::Settings::horizon,
+                      "Prediction horizon (samples)")
+        .def_readwrite("control_horizon", &tank_sim::MPCController::Settings::controlHorizon,
+                      "Number of free output moves")
+        .def_readwrite("output_weight", &tank_sim::MPCController::Settings::outputWeight,
+                      "Weight on squared level error")
+        .def_readwrite("move_weight", &tank_sim::MPCController::Settings::moveWeight,
+                      "Weight on squared output moves")
+        .def_readwrite("rho", &tank_sim::MPCController::Settings::rho,
+                      "Initial ADMM penalty parameter")
+        .def_readwrite("max_iterations", &tank_sim::MPCController::Settings::maxIterations,
+                      "ADMM iteration cap per solve")
+        .def_readwrite("tolerance", &tank_sim::MPCController::Settings::tolerance,
+                      "ADMM residual tolerance");
+
+    py::class_<tank_sim::MPCController::SolveStats>(m, "MPCSolveStats", R"pbdoc(
+        Latency and convergence statistics of an MPC controller.
+
+        Attributes:
+            solves (int): Number of QP solves so far.
+            last_micros (float): Wall time of the last solve in microseconds.
+            mean_micros (float): Mean wall time per solve in microseconds.
+            max_micros (float): Worst wall time per solve in microseconds.
+            last_iterations (int): ADMM iterations used by the last solve.
+            last_converged (bool): Whether the last solve met the tolerance.
+    )pbdoc")
+        .def_readonly("solves", &tank_sim::MPCController::SolveStats::solves)
+        .def_readonly("last_micros", &tank_sim::MPCController::SolveStats::lastMicros)
+        .def_readonly("mean_micros", &tank_sim::MPCController::SolveStats::meanMicros)
+        .def_readonly("max_micros", &tank_sim::MPCController::SolveStats::maxMicros)
+        .def_readonly("last_iterations", &tank_sim::MPCController::SolveStats::lastIterations)
+        .def_readonly("last_converged", &tank_sim::MPCController::SolveStats::lastConverged);
+
+    py::class_<tank_sim::LevelEstimator::Settings>(m, "EstimatorSettings", R"pbdoc(
+        Noise model of the level estimator (extended Kalman filter).
+
+        Attributes:
+            process_noise (float): Process noise variance Q (m² per step).
+            measurement_noise (float): Sensor noise variance R (m²). Usually
+                                      the square of sensor_noise_std.
+            initial_variance (float): Initial estimate variance P0 (m²).
+    )pbdoc")
+        .def(py::init<>())
+        .def_readwrite("process_noise", &tank_sim::LevelEstimator::Settings::processNoise,
+                      "Process noise variance (m² per step)")
+        .def_readwrite("measurement_noise", &tank_sim::LevelEstimator::Settings::measurementNoise,
+                      "Sensor noise variance (m²)")
+        .def_readwrite("initial_variance", &tank_sim::LevelEstimator::Settings::initialVariance,
+                      "Initial estimate variance (m²)");
+
+    py::class_<tank_sim::TankIdentifier::Settings>(m, "IdentifierSettings", R"pbdoc(
+        Recursive least-squares settings of the online model identifier.
+
+        Attributes:
+            forgetting_factor (float): lambda in (0, 1]; memory of about
+                                      1 / (1 - lambda) steps.
+            initial_covariance (float): Prior variance of each parameter.
+            max_covariance_trace (float): Covariance windup limit.
+    )pbdoc")
+        .def(py::init<>())
+        .def_readwrite("forgetting_factor", &tank_sim::TankIdentifier::Settings::forgettingFactor,
+                      "RLS forgetting factor")
+        .def_readwrite("initial_covariance", &tank_sim::TankIdentifier::Settings::initialCovariance,
+                      "Prior parameter variance")
+        .def_readwrite("max_covariance_trace", &tank_sim::TankIdentifier::Settings::maxCovarianceTrace,
+                      "Upper bound on the covariance trace");
+
+    py::class_<tank_sim::TankIdentifier::Estimate>(m, "IdentifiedModel", R"pbdoc(
+        Tank model identified online from level and input data.
+
+        Fields are NaN until the estimate is physically meaningful.
+
+        Attributes:
+            area (float): Identified cross-sectional area (m²).
+            k_v (float): Identified valve coefficient (m^2.5/s).
+            time_constant (float): Linearized time constant at the current
+                                  operating point (s).
+            samples (int): Number of samples used.
+    )pbdoc")
+        .def_readonly("area", &tank_sim::TankIdentifier::Estimate::area)
+        .def_readonly("k_v", &tank_sim::TankIdentifier::Estimate::k_v)
+        .def_readonly("time_constant", &tank_sim::TankIdentifier::Estimate::timeConstant)
+        .def_readonly("samples", &tank_sim::TankIdentifier::Estimate::samples);
+
+    py::class_<tank_sim::LoopPerformance::Settings>(m, "PerformanceSettings", R"pbdoc(
+        Thresholds of the per-loop step-response indices.
+
+        Attributes:
+            settling_band (float): Settling band as a fraction of |step|.
+            rise_low (float): Lower rise-time threshold (fraction of step).
+            rise_high (float): Upper rise-time threshold (fraction of step).
+    )pbdoc")
+        .def(py::init<>())
+        .def_readwrite("settling_band", &tank_sim::LoopPerformance::Settings::settlingBand,
+                      "Settling band (fraction of |step|)")
+        .def_readwrite("rise_low", &tank_sim::LoopPerformance::Settings::riseLow,
+                      "Rise-time start threshold (fraction of step)")
+        .def_readwrite("rise_high", &tank_sim::LoopPerformance::Settings::riseHigh,
+                      "Rise-time end threshold (fraction of step)");
+
+    py::class_<tank_sim::LoopPerformance::Snapshot>(m, "LoopPerformance", R"pbdoc(
+        Control-performance indices of one loop since its last setpoint change.
+
+        Step-response indices are NaN until they have occurred, and stay
+        NaN/zero when the interval started with no setpoint step.
+
+        Attributes:
+            elapsed (float): Time since the interval started (s).
+            step (float): Setpoint minus measurement at the start.
+            iae (float): Integral of absolute error.
+            ise (float): Integral of squared error.
+            itae (float): Integral of time-weighted absolute error.
+            overshoot (float): Peak overshoot as a fraction of |step|.
+            rise_time (float): Rise time (s).
+            settling_time (float): Settling time (s).
+            valve_travel (float): Accumulated |du| of the controller output.
+    )pbdoc")
+        .def_readonly("elapsed", &tank_sim::LoopPerformance::Snapshot::elapsed)
+        .def_readonly("step", &tank_sim::LoopPerformance::Snapshot::step)
+        .def_readonly("iae", &tank_sim::LoopPerformance::Snapshot::iae)
+        .def_readonly("ise", &tank_sim::LoopPerformance::Snapshot::ise)
+        .def_readonly("itae", &tank_sim::LoopPerformance::Snapshot::itae)
+        .def_readonly("overshoot", &tank_sim::LoopPerformance::Snapshot::overshoot)
+        .def_readonly("rise_time", &tank_sim::LoopPerformance::Snapshot::riseTime)
+        .def_readonly("settling_time", &tank_sim::LoopPerformance::Snapshot::settlingTime)
+        .def_readonly("valve_travel", &tank_sim::LoopPerformance::Snapshot::valveTravel);
+
+    py::class_<tank_sim::LoopHealth::Settings>(m, "LoopHealthSettings", R"pbdoc(
+        Settings of the per-loop oscillation and performance detectors.
+
+        Attributes:
+            window (int): Samples in the sliding spectral/AR window.
+            crossings (int): Oscillation periods used for the regularity.
+            noise_band (float): Error hysteresis for zero crossings; loops
+                               quieter than this are never flagged.
+            regularity_threshold (float): Regularity above which crossings
+                                         count as periodic.
+            spectral_threshold (float): Share of variance in the spectral
+                                       peak needed for an oscillation.
+            ar_order (int): AR model order of the Harris index fit.
+            delay (int): Process delay in samples for the benchmark.
+            harris_threshold (float): Harris index below which a loop is
+                                     flagged as poor.
+    )pbdoc")
+        .def(py::init<>())
+        .def_readwrite("window", &tank_sim::LoopHealth::Settings::window,
+                      "Sliding window length (samples)")
+        .def_readwrite("crossings", &tank_sim::LoopHealth::Settings::crossings,
+                      "Periods used for the regularity factor")
+        .def_readwrite("noise_band", &tank_sim::LoopHealth::Settings::noiseBand,
+                      "Zero-crossing hysteresis and quiet-signal band")
+        .def_readwrite("regularity_threshold", &tank_sim::LoopHealth::Settings::regularityThreshold,
+                      "Regularity factor oscillation threshold")
+        .def_readwrite("spectral_threshold", &tank_sim::LoopHealth::Settings::spectralThreshold,
+                      "Spectral peak share oscillation threshold")
+        .def_readwrite("ar_order", &tank_sim::LoopHealth::Settings::arOrder,
+                      "AR model order")
+        .def_readwrite("delay", &tank_sim::LoopHealth::Settings::delay,
+                      "Process delay (samples)")
+        .def_readwrite("harris_threshold", &tank_sim::LoopHealth::Settings::harrisThreshold,
+                      "Harris index poor-performance threshold");
+
+    py::class_<tank_sim::LoopHealth::Status>(m, "LoopHealthStatus", R"pbdoc(
+        Oscillation and performance flags of one loop.
+
+        Values that are not yet available (too few crossings, window not
+        full, quiet loop) are NaN.
+
+        Attributes:
+            oscillating (bool): Regular, spectrally concentrated oscillation.
+            poor_performance (bool): Harris index below threshold.
+            period (float): Mean zero-crossing period (s).
+            regularity (float): Zero-crossing regularity factor.
+            peak_period (float): Period of the spectral peak (s).
+            peak_fraction (float): Share of variance in the spectral peak.
+            harris_index (float): Minimum-variance / actual error variance.
+            error_std_dev (float): Error standard deviation over the window.
+            samples (int): Samples since the last reset.
+    )pbdoc")
+        .def_readonly("oscillating", &tank_sim::LoopHealth::Status::oscillating)
+        .def_readonly("poor_performance", &tank_sim::LoopHealth::Status::poorPerformance)
+        .def_readonly("period", &tank_sim::LoopHealth::Status::period)
+        .def_readonly("regularity", &tank_sim::LoopHealth::Status::regularity)
+        .def_readonly("peak_period", &tank_sim::LoopHealth::Status::peakPeriod)
+        .def_readonly("peak_fraction", &tank_sim::LoopHealth::Status::peakFraction)
+        .def_readonly("harris_index", &tank_sim::LoopHealth::Status::harrisIndex)
+        .def_readonly("error_std_dev", &tank_sim::LoopHealth::Status::errorStdDev)
+        .def_readonly("samples", &tank_sim::LoopHealth::Status::samples);
+
+    py::enum_<tank_sim::AlarmEvaluator::Type>(m, "AlarmType", R"pbdoc(
+        Kind of limit alarm.
+
+        Values:
+            HIGH: raised above limit, cleared below limit - deadband
+            LOW: raised below limit, cleared above limit + deadband
+            RATE_OF_CHANGE: raised when |d/dt| exceeds limit (per second)
+    )pbdoc")
+        .value("HIGH", tank_sim::AlarmEvaluator::Type::High)
+        .value("LOW", tank_sim::AlarmEvaluator::Type::Low)
+        .value("RATE_OF_CHANGE", tank_sim::AlarmEvaluator::Type::RateOfChange);
+
+    py::class_<tank_sim::AlarmEvaluator::Alarm>(m, "AlarmConfig", R"pbdoc(
+        Configuration of one limit alarm.
+
+        Attributes:
+            signal (SignalRef): Watched signal.
+            type (AlarmType): Limit kind.
+            limit (float): Trip limit (signal units, or per second).
+            deadband (float): Clear hysteresis. Default 0.
+            on_delay (float): Seconds the condition must persist. Default 0.
+            off_delay (float): Seconds the clear condition must persist.
+                              Default 0.
+
+        Example:
+            >>> high = AlarmConfig()
+            >>> high.signal = SignalRef(SignalSource.STATE, 0)
+            >>> high.type = AlarmType.HIGH
+            >>> high.limit = 4.5
+            >>> high.deadband = 0.1
+            >>> high.on_delay = 5.0
+    )pbdoc")
+        .def(py::init<>())
+        .def_readwrite("signal", &tank_sim::AlarmEvaluator::Alarm::signal, "Watched signal")
+        .def_readwrite("type", &tank_sim::AlarmEvaluator::Alarm::type, "Limit kind")
+        .def_readwrite("limit", &tank_sim::AlarmEvaluator::Alarm::limit, "Trip limit")
+        .def_readwrite("deadband", &tank_sim::AlarmEvaluator::Alarm::deadband,
+                      "Clear hysteresis")
+        .def_readwrite("on_delay", &tank_sim::AlarmEvaluator::Alarm::onDelay,
+                      "Raise delay (s)")
+        .def_readwrite("off_delay", &tank_sim::AlarmEvaluator::Alarm::offDelay,
+                      "Clear delay (s)");
+
+    py::class_<tank_sim::AlarmEvent>(m, "AlarmEvent", R"pbdoc(
+        One alarm transition.
+
+        Attributes:
+            alarm (int): Index of the alarm in SimulatorConfig.alarms.
+            active (bool): True when raised, False when cleared.
+            time (float): Simulation time of the transition (s).
+            value (float): Evaluated value (signal, or |rate| for rate alarms).
+    )pbdoc")
+        .def_readonly("alarm", &tank_sim::AlarmEvent::alarm)
+        .def_readonly("active", &tank_sim::AlarmEvent::active)
+        .def_readonly("time", &tank_sim::AlarmEvent::time)
+        .def_readonly("value", &tank_sim::AlarmEvent::value);
+
+    py::class_<tank_sim::TelemetryFrame>(m, "TelemetryFrame", R"pbdoc(
+        Consistent snapshot of the simulator after a step.
+
+        Per-loop lists hold the first loop_count controllers in config order.
+
+        Attributes:
+            step (int): Steps since construction or reset.
+            time (float): Simulation time (s).
+            tank_level (float): True level (m).
+            measured_level (float): Level as read by the controllers (m).
+            inlet_flow (float): Inlet flow (m³/s).
+            outlet_flow (float): Outlet flow (m³/s).
+            valve_position (float): Valve position (0-1).
+            loop_count (int): Number of loops in the frame.
+            active_alarms (int): Number of active alarms.
+            setpoint (list[float]): Setpoint of each loop.
+            error (list[float]): Error of each loop.
+            controller_output (list[float]): Output of each loop.
+    )pbdoc")
+        .def_readonly("step", &tank_sim::TelemetryFrame::step)
+        .def_readonly("time", &tank_sim::TelemetryFrame::time)
+        .def_readonly("tank_level", &tank_sim::TelemetryFrame::tankLevel)
+        .def_readonly("measured_level", &tank_sim::TelemetryFrame::measuredLevel)
+        .def_readonly("inlet_flow", &tank_sim::TelemetryFrame::inletFlow)
+        .def_readonly("outlet_flow", &tank_sim::TelemetryFrame::outletFlow)
+        .def_readonly("valve_position", &tank_sim::TelemetryFrame::valvePosition)
+        .def_readonly("loop_count", &tank_sim::TelemetryFrame::loopCount)
+        .def_readonly("active_alarms", &tank_sim::TelemetryFrame::activeAlarms)
+        .def_property_readonly("setpoint", [](const tank_sim::TelemetryFrame &f) {
+            return std::vector<double>(f.setpoint.begin(), f.setpoint.begin() + f.loopCount);
+        })
+        .def_property_readonly("error", [](const tank_sim::TelemetryFrame &f) {
+            return std::vector<double>(f.error.begin(), f.error.begin() + f.loopCount);
+        })
+        .def_property_readonly("controller_output", [](const tank_sim::TelemetryFrame &f) {
+            return std::vector<double>(f.controllerOutput.begin(),
+                                       f.controllerOutput.begin() + f.loopCount);
+        });
+
+    py::class_<tank_sim::FrameEncoder>(m, "FrameEncoder", R"pbdoc(
+        Renders TelemetryFrames into wire formats in native code.
+
+        encode_json() produces the WebSocket state message the frontend
+        expects ({"type": "state", "data": {...}}) with shortest round-trip
+        numbers; encode_binary() produces a fixed little-endian record
+        (16-byte header, then float64 scalars and per-loop values).
+
+        The *_view methods return a read-only memoryview of the encoder's
+        own buffer, avoiding the copy into bytes; the view is only valid
+        until the next call on the same encoder.
+
+        Example:
+            >>> encoder = FrameEncoder()
+            >>> await websocket.send_bytes(encoder.encode_binary(sim.get_telemetry()))
+    )pbdoc")
+        .def(py::init<>())
+        .def("encode_json", [](tank_sim::FrameEncoder &encoder,
+                               const tank_sim::TelemetryFrame &frame) {
+                 const std::string_view json = encoder.json(frame);
+                 return py::bytes(json.data(), json.size());
+             }, py::arg("frame"), R"pbdoc(
+            Render the JSON state message.
+
+            Args:
+                frame (TelemetryFrame): Frame to encode (first loop's values).
+
+            Returns:
+                bytes: UTF-8 JSON text.
+        )pbdoc")
+        .def("encode_binary", [](tank_sim::FrameEncoder &encoder,
+                                 const tank_sim::TelemetryFrame &frame) {
+                 const std::string_view record = encoder.binary(frame);
+                 return py::bytes(record.data(), record.size());
+             }, py::arg("frame"), R"pbdoc(
+            Render the binary record.
+
+            Args:
+                frame (TelemetryFrame): Frame to encode.
+
+            Returns:
+                bytes: Little-endian record of binary_size(frame.loop_count) bytes.
+        )pbdoc")
+        .def("json_view", [](tank_sim::FrameEncoder &encoder,
+                             const tank_sim::TelemetryFrame &frame) {
+                 const std::string_view json = encoder.json(frame);
+                 return py::memoryview::from_memory(json.data(),
+                                                    static_cast<py::ssize_t>(json.size()));
+             }, py::arg("frame"), py::keep_alive<0, 1>(),
+             "Like encode_json, as a view valid until the next call")
+        .def("binary_view", [](tank_sim::FrameEncoder &encoder,
+                               const tank_sim::TelemetryFrame &frame) {
+                 const std::string_view record = encoder.binary(frame);
+                 return py::memoryview::from_memory(record.data(),
+                                                    static_cast<py::ssize_t>(record.size()));
+             }, py::arg("frame"), py::keep_alive<0, 1>(),
+             "Like encode_binary, as a view valid until the next call")
+        .def_static("decode_binary", [](py::buffer data) {
+                 py::buffer_info info = data.request();
+                 return tank_sim::FrameEncoder::readBinary(
+                     static_cast<const char *>(info.ptr),
+                     static_cast<std::size_t>(info.size * info.itemsize));
+             }, py::arg("data"), R"pbdoc(
+            Parse one binary record.
+
+            Args:
+                data (bytes): A record produced by encode_binary.
+
+            Returns:
+                TelemetryFrame: The decoded frame.
+
+            Raises:
+                ValueError: If the header or size is invalid.
+        )pbdoc")
+        .def_static("binary_size", &tank_sim::FrameEncoder::binarySize, py::arg("loop_count"),
+                    "Size in bytes of a binary record with loop_count loops");
+
+    py::class_<tank_sim::DeltaEncoder::Settings>(m, "DeltaSettings", R"pbdoc(
+        Keyframe spacing and quantization of a delta-encoded frame stream.
+
+        Attributes:
+            keyframe_interval (int): Frames per keyframe (>= 1). Default: 60.
+            quantum (float): Resolution of encoded deltas; decoded values are
+                             within quantum / 2. Default: 1e-6.
+    )pbdoc")
+        .def(py::init<>())
+        .def_readwrite("keyframe_interval", &tank_sim::DeltaEncoder::Settings::keyframeInterval,
+                       "Frames per keyframe")
+        .def_readwrite("quantum", &tank_sim::DeltaEncoder::Settings::quantum,
+                       "Delta resolution");
+
+    py::class_<tank_sim::DeltaEncoder>(m, "DeltaEncoder", R"pbdoc(
+        Encodes a frame stream as periodic keyframes and small delta records.
+
+        Keyframes are FrameEncoder binary records; delta records carry only
+        the channels that changed, as quantized varint deltas. Encode every
+        frame of one stream with the same encoder, and force a keyframe when
+        a client joins.
+
+        Args:
+            settings (DeltaSettings): Optional settings.
+
+        Raises:
+            ValueError: If a setting is out of range.
+
+        Example:
+            >>> encoder = DeltaEncoder()
+            >>> await websocket.send_bytes(encoder.encode(sim.get_telemetry()))
+    )pbdoc")
+        .def(py::init<>())
+        .def(py::init<const tank_sim::DeltaEncoder::Settings &>(), py::arg("settings"))
+        .def("encode", [](tank_sim::DeltaEncoder &encoder, const tank_sim::TelemetryFrame &frame) {
+                 const std::string_view record = encoder.encode(frame);
+                 return py::bytes(record.data(), record.size());
+             }, py::arg("frame"), R"pbdoc(
+            Encode the next frame of the stream.
+
+            Args:
+                frame (TelemetryFrame): Next frame.
+
+            Returns:
+                bytes: A keyframe or a delta record.
+        )pbdoc")
+        .def("force_keyframe", &tank_sim::DeltaEncoder::forceKeyframe,
+             "Make the next encode() emit a keyframe")
+        .def_property_readonly("last_was_keyframe", &tank_sim::DeltaEncoder::lastWasKeyframe,
+                               "Whether the last encode() emitted a keyframe");
+
+    py::class_<tank_sim::DeltaDecoder>(m, "DeltaDecoder", R"pbdoc(
+        Reference decoder for DeltaEncoder streams.
+
+        Args:
+            quantum (float): The encoder's quantum. Default: 1e-6.
+
+        Raises:
+            ValueError: If quantum is not positive.
+    )pbdoc")
+        .def(py::init<double>(), py::arg("quantum") = tank_sim::constants::DEFAULT_DELTA_QUANTUM)
+        .def("decode", [](tank_sim::DeltaDecoder &decoder, py::buffer data) {
+                 py::buffer_info info = data.request();
+                 return decoder.decode(static_cast<const char *>(info.ptr),
+                                       static_cast<std::size_t>(info.size * info.itemsize));
+             }, py::arg("data"), R"pbdoc(
+            Apply one record and return the reconstructed frame.
+
+            Args:
+                data (bytes): Next keyframe or delta record.
+
+            Returns:
+                TelemetryFrame: The reconstructed frame.
+
+            Raises:
+                ValueError: If the record is malformed or a delta arrives
+                            before a keyframe.
+        )pbdoc")
+        .def_property_readonly("synchronized", &tank_sim::DeltaDecoder::synchronized,
+                               "Whether a keyframe has been decoded")
+        .def("reset", &tank_sim::DeltaDecoder::reset, "Wait for the next keyframe");
+
+    py::enum_<tank_sim::OperatorCommand::Type>(m, "CommandType", R"pbdoc(
+        Kind of queued operator command.
+
+        Values:
+            SET_SETPOINT: set_setpoint(index, value)
+            SET_INPUT: set_input(index, value)
+            SET_GAINS: set_controller_gains(index, gains)
+            RESET: reset()
+            SET_SPEED: session speed factor = value (SessionEngine only;
+                a Simulator rejects it)
+    )pbdoc")
+        .value("SET_SETPOINT", tank_sim::OperatorCommand::Type::SetSetpoint)
+        .value("SET_INPUT", tank_sim::OperatorCommand::Type::SetInput)
+        .value("SET_GAINS", tank_sim::OperatorCommand::Type::SetGains)
+        .value("RESET", tank_sim::OperatorCommand::Type::Reset)
+        .value("SET_SPEED", tank_sim::OperatorCommand::Type::SetSpeed);
+
+    py::class_<tank_sim::OperatorCommand>(m, "OperatorCommand", R"pbdoc(
+        Operator action queued for the stepping thread.
+
+        Attributes:
+            type (CommandType): Which operator method to apply.
+            index (int): Controller or input index.
+            value (float): Setpoint or input value.
+            gains (PIDGains): Gains for SET_GAINS.
+            id (int): Caller-chosen tag echoed in the AppliedCommand.
+
+        Example:
+            >>> cmd = OperatorCommand()
+            >>> cmd.type = CommandType.SET_SETPOINT
+            >>> cmd.index = 0
+            >>> cmd.value = 3.0
+            >>> sim.submit_command(cmd)
+    )pbdoc")
+        .def(py::init<>())
+        .def_readwrite("type", &tank_sim::OperatorCommand::type, "Command kind")
+        .def_readwrite("index", &tank_sim::OperatorCommand::index, "Controller or input index")
+        .def_readwrite("value", &tank_sim::OperatorCommand::value, "Setpoint or input value")
+        .def_readwrite("gains", &tank_sim::OperatorCommand::gains, "Gains for SET_GAINS")
+        .def_readwrite("id", &tank_sim::OperatorCommand::id, "Caller tag");
+
+    py::class_<tank_sim::AppliedCommand>(m, "AppliedCommand", R"pbdoc(
+        Result of a queued operator command.
+
+        Attributes:
+            id (int): Tag of the command.
+            type (CommandType): Command kind.
+            index (int): Controller or input index.
+            accepted (bool): False if the operator method rejected it.
+            time (float): Simulation time at which it took effect (s).
+            latency_micros (float): Wall time from submit to apply (us).
+    )pbdoc")
+        .def_readonly("id", &tank_sim::AppliedCommand::id)
+        .def_readonly("type", &tank_sim::AppliedCommand::type)
+        .def_readonly("index", &tank_sim::AppliedCommand::index)
+        .def_readonly("accepted", &tank_sim::AppliedCommand::accepted)
+        .def_readonly("time", &tank_sim::AppliedCommand::time)
+        .def_readonly("latency_micros", &tank_sim::AppliedCommand::latencyMicros);
+
+    py::class_<tank_sim::Simulator::CommandStats>(m, "CommandStats", R"pbdoc(
+        Counters and latency of the operator command queue.
+
+        Attributes:
+            applied (int): Commands applied (accepted or rejected).
+            rejected (int): Commands rejected by the operator method.
+            results_dropped (int): Results lost because nobody polled them.
+            last_latency_micros (float): Latency of the last command (us).
+            mean_latency_micros (float): Mean latency (us).
+            max_latency_micros (float): Worst latency (us).
+    )pbdoc")
+        .def_readonly("applied", &tank_sim::Simulator::CommandStats::applied)
+        .def_readonly("rejected", &tank_sim::Simulator::CommandStats::rejected)
+        .def_readonly("results_dropped", &tank_sim::Simulator::CommandStats::resultsDropped)
+        .def_readonly("last_latency_micros", &tank_sim::Simulator::CommandStats::lastLatencyMicros)
+        .def_readonly("mean_latency_micros", &tank_sim::Simulator::CommandStats::meanLatencyMicros)
+        .def_readonly("max_latency_micros", &tank_sim::Simulator::CommandStats::maxLatencyMicros);
+
+    py::class_<TelemetrySubscription>(m, "TelemetrySubscription", R"pbdoc(
+        Cursor into a simulator's per-step telemetry stream.
+
+        Created by Simulator.subscribe_telemetry(). Each subscription reads
+        every frame independently of other subscriptions, from any thread.
+        A subscription that falls more than the ring capacity behind skips
+        to the oldest retained frame; the skipped frames are counted in lost.
+
+        Attributes:
+            lost (int): Frames skipped because this subscription fell behind.
+    )pbdoc")
+        .def("poll", [](TelemetrySubscription &sub, int max_frames) {
+                 std::vector<tank_sim::TelemetryFrame> frames;
+                 {
+                     py::gil_scoped_release release;
+                     tank_sim::TelemetryFrame frame;
+                     while (max_frames <= 0 || static_cast<int>(frames.size()) < max_frames) {
+                         auto status = sub.sim->readTelemetry(sub.cursor, frame);
+                         if (status == tank_sim::Simulator::TelemetryRing::ReadStatus::Empty) {
+                             break;
+                         }
+                         if (status == tank_sim::Simulator::TelemetryRing::ReadStatus::Ok) {
+                             frames.push_back(frame);
+                         }
+                     }
+                 }
+                 return frames;
+             }, py::arg("max_frames") = 0, R"pbdoc(
+            Take the frames published since the last poll.
+
+            Args:
+                max_frames (int): Upper bound on frames returned; 0 for all.
+
+            Returns:
+                list[TelemetryFrame]: New frames, oldest first.
+        )pbdoc")
+        .def_property_readonly("lost", [](const TelemetrySubscription &sub) {
+            return sub.cursor.lost;
+        });
+
+    py::enum_<tank_sim::RealtimePacer::CatchUp>(m, "CatchUp", R"pbdoc(
+        What an engine does with ticks missed while a tick or the process stalled.
+
+        Values:
+            BURST: Run the missed ticks back to back (at most 10), then skip (default).
+            SKIP: Drop the missed ticks and continue on the same schedule.
+            REBASE: Run one late tick and restart the schedule from it.
+    )pbdoc")
+        .value("BURST", tank_sim::RealtimePacer::CatchUp::Burst)
+        .value("SKIP", tank_sim::RealtimePacer::CatchUp::Skip)
+        .value("REBASE", tank_sim::RealtimePacer::CatchUp::Rebase);
+
+    py::class_<tank_sim::RealtimePacer::Stats>(m, "PacingStats", R"pbdoc(
+        Tick lateness of an engine thread (wakeup time minus deadline).
+
+        Attributes:
+            ticks (int): Ticks run.
+            skipped (int): Deadlines dropped by the catch-up policy.
+            rebased (int): Schedule restarts (REBASE).
+            mean_lateness_micros (float): Mean lateness (us).
+            max_lateness_micros (float): Worst lateness (us).
+            histogram (list[int]): Ticks per log2 bucket: bucket 0 < 1 us,
+                                   bucket b in [2^(b-1), 2^b) us.
+            realtime (bool): The thread runs SCHED_FIFO with locked memory.
+    )pbdoc")
+        .def_readonly("ticks", &tank_sim::RealtimePacer::Stats::ticks)
+        .def_readonly("skipped", &tank_sim::RealtimePacer::Stats::skipped)
+        .def_readonly("rebased", &tank_sim::RealtimePacer::Stats::rebased)
+        .def_readonly("mean_lateness_micros", &tank_sim::RealtimePacer::Stats::meanLatenessMicros)
+        .def_readonly("max_lateness_micros", &tank_sim::RealtimePacer::Stats::maxLatenessMicros)
+        .def_property_readonly("histogram", [](const tank_sim::RealtimePacer::Stats &s) {
+            return std::vector<std::uint64_t>(s.histogram.begin(), s.histogram.end());
+        })
+        .def_readonly("realtime", &tank_sim::RealtimePacer::Stats::realtime)
+        .def("percentile_micros", &tank_sim::RealtimePacer::Stats::percentileMicros,
+             py::arg("fraction"), R"pbdoc(
+            Lateness below which a fraction of the ticks ran, e.g. 0.99.
+
+            Returns:
+                float: Upper bound of the histogram bucket (us); 0 without ticks.
+        )pbdoc");
+
+    py::class_<tank_sim::SessionEngine::SpeculationStats>(m, "SpeculationStats", R"pbdoc(
+        Counters of an engine's speculative execution.
+
+        Attributes:
+            computed_steps (int): Steps computed ahead between ticks.
+            served_ticks (int): Ticks served from a session's buffer.
+            discarded_ticks (int): Buffered ticks thrown away by commands.
+    )pbdoc")
+        .def_readonly("computed_steps", &tank_sim::SessionEngine::SpeculationStats::computedSteps)
+        .def_readonly("served_ticks", &tank_sim::SessionEngine::SpeculationStats::servedTicks)
+        .def_readonly("discarded_ticks", &tank_sim::SessionEngine::SpeculationStats::discardedTicks);
+
+    py::class_<PyEngine>(m, "SessionEngine", R"pbdoc(
+        Many simulations stepped on a native thread, one wakeup per tick.
+
+        The engine thread steps every session each tick, renders each state
+        message once (the same JSON as FrameEncoder.encode_json) and then
+        signals a descriptor. Register fileno() with the event loop
+        (loop.add_reader) and call drain() when it becomes readable: one
+        call returns the frames of all sessions and of every tick since the
+        last drain, so asyncio needs no per-session timers.
+
+        Sessions are identified by session_key(name). A session is created
+        by its first join() and destroyed by its last leave(); joins beyond
+        max_sessions are ignored. Requests take effect at the next tick.
+
+        Attributes:
+            running (bool): Whether the engine thread is ticking.
+            ticks (int): Ticks completed since the last start().
+            session_count (int): Sessions alive after the last tick.
+            lost (int): Frames overwritten before drain() read them.
+
+        Example:
+            >>> engine = SessionEngine(create_default_config())
+            >>> key = SessionEngine.session_key("plant")
+            >>> engine.join(key)
+            >>> engine.start(tick_period=1.0)
+            >>> loop.add_reader(engine.fileno(), on_ready)
+            >>> for key, time, message in engine.drain():
+            ...     broadcast(key, message)
+    )pbdoc")
+        .def(py::init<const tank_sim::Simulator::Config &, int>(), py::arg("config"),
+             py::arg("max_sessions") = tank_sim::constants::DEFAULT_ENGINE_MAX_SESSIONS,
+             R"pbdoc(
+            Args:
+                config (SimulatorConfig): Configuration of every session.
+                max_sessions (int): Session limit.
+
+            Raises:
+                ValueError: If max_sessions < 1 or the config is invalid.
+        )pbdoc")
+        .def("start", [](PyEngine &e, double tick_period,
+                         tank_sim::RealtimePacer::CatchUp catch_up, bool realtime, int cpu) {
+                 if (e.thread && e.thread->running()) {
+                     throw std::runtime_error("Engine is already running");
+                 }
+                 tank_sim::RealtimePacer::Settings pacing;
+                 pacing.period = tick_period;
+                 pacing.catchUp = catch_up;
+                 pacing.realtime = realtime;
+                 pacing.cpu = cpu;
+                 e.thread.reset();
+                 e.thread = std::make_unique<tank_sim::EngineThread>(*e.engine, pacing);
+                 e.thread->addSignal(e.signal);
+                 e.thread->start();
+             }, py::arg("tick_period") = 1.0,
+             py::arg("catch_up") = tank_sim::RealtimePacer::CatchUp::Burst,
+             py::arg("realtime") = false, py::arg("cpu") = -1, R"pbdoc(
+            Start ticking every tick_period seconds.
+
+            Ticks run on absolute deadlines, so the time spent ticking does
+            not make the engine drift behind the wall clock.
+
+            Args:
+                tick_period (float): Seconds between ticks.
+                catch_up (CatchUp): Policy for ticks missed during a stall.
+                realtime (bool): Run the engine thread SCHED_FIFO with locked
+                                 memory when permitted (see pacing_stats.realtime).
+                cpu (int): CPU to pin a realtime thread to; -1 for any.
+
+            Raises:
+                ValueError: If tick_period is not positive or cpu < -1.
+                RuntimeError: If the engine is already running.
+        )pbdoc")
+        .def("stop", [](PyEngine &e) {
+                 if (e.thread) {
+                     py::gil_scoped_release release;
+                     e.thread->stop();
+                 }
+             }, "Stop ticking; waits for a tick in progress")
+        .def("fileno", [](const PyEngine &e) { return e.signal.fd(); },
+             "Descriptor that becomes readable when frames are ready")
+        .def("drain", [](PyEngine &e, int max_frames) {
+                 e.signal.consume();
+                 py::list frames;
+                 tank_sim::SessionEngine::EncodedFrame frame;
+                 using Status = tank_sim::SessionEngine::FrameRing::ReadStatus;
+                 while (max_frames <= 0 || static_cast<int>(py::len(frames)) < max_frames) {
+                     const Status status = e.engine->frames().read(e.cursor, frame);
+                     if (status == Status::Empty) {
+                         break;
+                     }
+                     if (status == Status::Ok) {
+                         const std::string_view payload = frame.payload();
+                         frames.append(py::make_tuple(frame.sessionKey, frame.time,
+                                                      py::str(payload.data(), payload.size())));
+                     }
+                 }
+                 return frames;
+             }, py::arg("max_frames") = 0, R"pbdoc(
+            Take the frames published since the last drain.
+
+            Args:
+                max_frames (int): Upper bound on frames returned; 0 for all.
+                                 Call again while the result is full.
+
+            Returns:
+                list[tuple[int, float, str]]: (session_key, time, message)
+                per frame, oldest first; message is the state JSON.
+        )pbdoc")
+        .def("join", [](PyEngine &e, std::uint64_t key) {
+                 e.push(tank_sim::SessionEngine::Request::Type::Join, key);
+             }, py::arg("session_key"), R"pbdoc(
+            Add a subscriber to a session, creating it if needed.
+
+            Raises:
+                RuntimeError: If the request queue is full.
+        )pbdoc")
+        .def("leave", [](PyEngine &e, std::uint64_t key) {
+                 e.push(tank_sim::SessionEngine::Request::Type::Leave, key);
+             }, py::arg("session_key"), R"pbdoc(
+            Remove a subscriber; the last one destroys the session.
+
+            Raises:
+                RuntimeError: If the request queue is full.
+        )pbdoc")
+        .def("submit", [](PyEngine &e, std::uint64_t key,
+                          const tank_sim::OperatorCommand &command) {
+                 e.push(tank_sim::SessionEngine::Request::Type::Command, key, command);
+             }, py::arg("session_key"), py::arg("command"), R"pbdoc(
+            Queue an operator command for one session.
+
+            A SET_SPEED command sets the session's speed factor instead:
+            value simulator steps per engine tick on average (clamped to
+            0.01 .. 3600, inf = as fast as possible), still publishing at
+            most one frame per tick.
+
+            Args:
+                session_key (int): Target session.
+                command (OperatorCommand): Command, applied at the next tick.
+
+            Raises:
+                RuntimeError: If the request queue is full.
+        )pbdoc")
+        .def("export_session", [](PyEngine &e, std::uint64_t key) {
+                 e.push(tank_sim::SessionEngine::Request::Type::Export, key);
+             }, py::arg("session_key"), R"pbdoc(
+            Remove a session at the next tick and hand its state to take_exports().
+
+            The snapshot is taken after the requests queued before this one.
+
+            Raises:
+                RuntimeError: If the request queue is full.
+        )pbdoc")
+        .def("take_exports", [](PyEngine &e) { return exportTuples(e.engine->takeExports()); },
+             R"pbdoc(
+            Sessions removed by export_session() since the last call.
+
+            Returns:
+                list[tuple[int, float, bytes | None]]: (session_key, speed,
+                snapshot) per export; snapshot is None for a session the
+                engine did not have.
+        )pbdoc")
+        .def("import_session", [](PyEngine &e, std::uint64_t key, const py::bytes &snapshot,
+                                  int subscribers, double speed) {
+                 e.engine->importSession(importTransfer(key, snapshot, subscribers, speed));
+             }, py::arg("session_key"), py::arg("snapshot"), py::arg("subscribers") = 1,
+             py::arg("speed") = 1.0, R"pbdoc(
+            Continue an exported session from its snapshot at the next tick.
+
+            Ignored for a session the engine already has. Requests queued
+            after this call act on the imported state.
+
+            Args:
+                session_key (int): Key of the session.
+                snapshot (bytes): From take_exports() or Simulator.capture_state().
+                subscribers (int): Engine references the caller holds (leave() each).
+                speed (float): Speed factor the session continues at.
+
+            Raises:
+                ValueError: If the snapshot does not fit the engine's
+                            configuration or subscribers < 1.
+        )pbdoc")
+        .def_static("session_key", &tank_sim::SessionEngine::sessionKey, py::arg("name"),
+                    "Key of the session with this name")
+        .def_property_readonly("running", [](const PyEngine &e) {
+            return e.thread && e.thread->running();
+        })
+        .def_property_readonly("ticks", [](const PyEngine &e) {
+            return e.thread ? e.thread->ticks() : std::uint64_t{0};
+        })
+        .def_property_readonly("session_count", [](const PyEngine &e) {
+            return e.engine->sessionCount();
+        })
+        .def_property_readonly("pacing_stats", [](const PyEngine &e) {
+            return e.thread ? e.thread->pacingStats() : tank_sim::RealtimePacer::Stats{};
+        }, "Tick lateness histogram of the last start()")
+        .def_property_readonly("lost", [](const PyEngine &e) { return e.cursor.lost; })
+        .def("attach_store", [](PyEngine &e, tank_sim::SharedSessionStore *store) {
+                 if (e.thread && e.thread->running()) {
+                     throw std::runtime_error("Stop the engine before changing its store");
+                 }
+                 e.engine->attachStore(store);
+             }, py::arg("store").none(true), py::keep_alive<1, 2>(), R"pbdoc(
+            Export every session's telemetry to a SharedSessionStore.
+
+            Sessions claim a store slot when created and release it when
+            destroyed; sessions already exported by another process are not
+            exported twice. Pass None to stop exporting.
+
+            Raises:
+                RuntimeError: If the engine is running.
+        )pbdoc")
+        .def("enable_speculation", [](PyEngine &e, int ticks) {
+                 if (e.thread && e.thread->running()) {
+                     throw std::runtime_error("Stop the engine before changing speculation");
+                 }
+                 e.engine->enableSpeculation(ticks);
+             }, py::arg("ticks"), R"pbdoc(
+            Compute sessions up to ticks ahead while the engine thread is idle.
+
+            Ticks then serve frames from each session's buffer; a command
+            discards the buffered tail and returns the session to the state
+            its clients have seen. Configurations that a snapshot cannot
+            restore exactly (sensor noise, estimator, identification, MPC,
+            loop health, alarms) are never speculated. 0 turns it off.
+
+            Raises:
+                ValueError: If ticks is negative or above 600.
+                RuntimeError: If the engine is running.
+        )pbdoc")
+        .def_property_readonly("speculation_stats", [](const PyEngine &e) {
+            return e.engine->speculationStats();
+        }, "Counters of speculative execution (any thread)");
+
+    py::class_<tank_sim::SessionSample>(m, "SessionSample", R"pbdoc(
+        One history point of a session in a SharedSessionStore.
+
+        Attributes:
+            time (float): Simulation time (s).
+            tank_level (float): True level (m).
+            setpoint (float): Setpoint of loop 0.
+            inlet_flow (float): Inlet flow (m³/s).
+            outlet_flow (float): Outlet flow (m³/s).
+            valve_position (float): Valve position (0-1).
+            error (float): Error of loop 0.
+            controller_output (float): Output of loop 0.
+    )pbdoc")
+        .def(py::init([](double time, double tank_level, double setpoint, double inlet_flow,
+                         double outlet_flow, double valve_position, double error,
+                         double controller_output) {
+                 return tank_sim::SessionSample{time, tank_level, setpoint, inlet_flow,
+                                                outlet_flow, valve_position, error,
+                                                controller_output};
+             }), py::arg("time"), py::arg("tank_level"), py::arg("setpoint"),
+             py::arg("inlet_flow"), py::arg("outlet_flow"), py::arg("valve_position"),
+             py::arg("error"), py::arg("controller_output"))
+        .def_readonly("time", &tank_sim::SessionSample::time)
+        .def_readonly("tank_level", &tank_sim::SessionSample::tankLevel)
+        .def_readonly("setpoint", &tank_sim::SessionSample::setpoint)
+        .def_readonly("inlet_flow", &tank_sim::SessionSample::inletFlow)
+        .def_readonly("outlet_flow", &tank_sim::SessionSample::outletFlow)
+        .def_readonly("valve_position", &tank_sim::SessionSample::valvePosition)
+        .def_readonly("error", &tank_sim::SessionSample::error)
+        .def_readonly("controller_output", &tank_sim::SessionSample::controllerOutput);
+
+    py::class_<tank_sim::SharedSessionStore>(m, "SharedSessionStore", R"pbdoc(
+        Session telemetry in POSIX shared memory, readable by any process.
+
+        A SessionEngine with attach_store() publishes the latest frame and
+        the history of each session into a slot of the segment; every other
+        process (e.g. the other API workers) opens the same name and reads
+        them without going through the engine process.
+
+        Example:
+            >>> store = SharedSessionStore("/tank_sim", slots=1000)
+            >>> engine.attach_store(store)
+            >>> # In another process:
+            >>> store = SharedSessionStore.attach("/tank_sim")
+            >>> frame = store.latest(SessionEngine.session_key("shared:plant"))
+    )pbdoc")
+        .def(py::init<const std::string &, int>(), py::arg("name"), py::arg("slots"), R"pbdoc(
+            Create the segment, or open it if it exists with the same layout.
+
+            Args:
+                name (str): Shared-memory name, "/name".
+                slots (int): Sessions the segment can hold.
+
+            Raises:
+                ValueError: If the name is invalid or slots < 1.
+                RuntimeError: If the segment cannot be mapped or has a
+                              different layout.
+        )pbdoc")
+        .def_static("attach", [](const std::string &name) {
+                        return std::make_unique<tank_sim::SharedSessionStore>(name);
+                    }, py::arg("name"), R"pbdoc(
+            Open an existing segment.
+
+            Raises:
+                RuntimeError: If there is no such segment or its layout differs.
+        )pbdoc")
+        .def_static("unlink", &tank_sim::SharedSessionStore::unlink, py::arg("name"),
+                    "Remove the segment name; returns False if it did not exist")
+        .def_property_readonly("name", &tank_sim::SharedSessionStore::name)
+        .def_property_readonly("slot_count", &tank_sim::SharedSessionStore::slotCount)
+        .def("sessions", [](const tank_sim::SharedSessionStore &store) {
+                 py::list result;
+                 for (const auto &info : store.sessions()) {
+                     py::dict entry;
+                     entry["session_key"] = info.sessionKey;
+                     entry["slot"] = info.slot;
+                     entry["owner_pid"] = info.ownerPid;
+                     entry["frames"] = info.frames;
+                     result.append(entry);
+                 }
+                 return result;
+             }, R"pbdoc(
+            Sessions currently exported.
+
+            Returns:
+                list[dict]: session_key, slot, owner_pid and frames of each.
+        )pbdoc")
+        .def("latest", [](const tank_sim::SharedSessionStore &store,
+                          std::uint64_t key) -> py::object {
+                 tank_sim::TelemetryFrame frame;
+                 if (!store.latest(key, frame)) {
+                     return py::none();
+                 }
+                 return py::cast(frame);
+             }, py::arg("session_key"),
+             "Newest TelemetryFrame of a session, or None if it is not exported")
+        .def("history", &tank_sim::SharedSessionStore::history, py::arg("session_key"),
+             py::arg("since") = -std::numeric_limits<double>::infinity(), R"pbdoc(
+            History of a session after a simulation time.
+
+            Args:
+                session_key (int): Session to read.
+                since (float): Only samples with time > since.
+
+            Returns:
+                list[SessionSample]: Oldest first; empty if not exported.
+        )pbdoc")
+        .def("reclaim_dead", &tank_sim::SharedSessionStore::reclaimDead,
+             "Free the slots of owner processes that have exited; returns the count");
+
+    py::class_<tank_sim::ShardRouter>(m, "ShardRouter", R"pbdoc(
+        Sessions spread over tank_engine_shard processes, movable live.
+
+        Connects to each shard's Unix socket and places sessions on a
+        consistent-hash ring. join(), leave() and submit() work as on
+        SessionEngine; register fileno() with the event loop and call
+        drain() when it becomes readable to receive the shards' frames.
+
+        migrate() moves a session to another shard without losing a tick
+        or a command: its frames continue from the same state, and
+        requests made meanwhile are replayed on the new shard.
+
+        Attributes:
+            session_count (int): Sessions with subscribers.
+            shard_count (int): Shards connected now.
+            migrations_in_flight (int): Migrations not yet completed.
+
+        Example:
+            >>> router = ShardRouter(["/run/tank/shard0.sock", "/run/tank/shard1.sock"])
+            >>> router.join(SessionEngine.session_key("plant"))
+            >>> loop.add_reader(router.fileno(), on_ready)
+            >>> router.drain_shard(0)  # before restarting shard 0
+    )pbdoc")
+        .def(py::init<const std::vector<std::string> &>(), py::arg("socket_paths"), R"pbdoc(
+            Args:
+                socket_paths (list[str]): One listening socket per shard;
+                                          shard ids are list positions.
+
+            Raises:
+                ValueError: If the list is empty.
+                RuntimeError: If a shard cannot be reached.
+        )pbdoc")
+        .def("add_shard", &tank_sim::ShardRouter::addShard, py::arg("socket_path"),
+             "Connect another shard and return its id; see rebalance()")
+        .def("fileno", &tank_sim::ShardRouter::fd,
+             "Descriptor that becomes readable when a shard has sent something")
+        .def("drain", [](tank_sim::ShardRouter &router) {
+                 py::list frames;
+                 for (const auto &frame : router.poll(0)) {
+                     frames.append(py::make_tuple(frame.sessionKey, frame.time,
+                                                  py::str(frame.message)));
+                 }
+                 return frames;
+             }, R"pbdoc(
+            Read the shards' messages and complete finished migrations.
+
+            Returns:
+                list[tuple[int, float, str]]: (session_key, time, message)
+                per frame, as SessionEngine.drain().
+        )pbdoc")
+        .def("join", &tank_sim::ShardRouter::join, py::arg("session_key"),
+             "Add a subscriber to a session on its shard")
+        .def("leave", &tank_sim::ShardRouter::leave, py::arg("session_key"),
+             "Remove a subscriber; the last one destroys the session")
+        .def("submit", &tank_sim::ShardRouter::submit, py::arg("session_key"),
+             py::arg("command"), "Queue an operator command for one session")
+        .def("migrate", &tank_sim::ShardRouter::migrate, py::arg("session_key"),
+             py::arg("shard"), R"pbdoc(
+            Start moving a session to another shard.
+
+            Returns:
+                bool: False if the session has no subscribers, is already
+                on that shard or is already moving.
+
+            Raises:
+                ValueError: If the shard id is unknown or disconnected.
+        )pbdoc")
+        .def("drain_shard", &tank_sim::ShardRouter::drainShard, py::arg("shard"), R"pbdoc(
+            Take a shard off the ring and move all its sessions away.
+
+            Returns:
+                int: Migrations started.
+
+            Raises:
+                RuntimeError: If it is the last shard on the ring.
+        )pbdoc")
+        .def("rebalance", &tank_sim::ShardRouter::rebalance,
+             "Move sessions whose ring owner changed; returns migrations started")
+        .def("export_session", &tank_sim::ShardRouter::exportSession,
+             py::arg("session_key"), R"pbdoc(
+            Start removing a session from its shard for take_exports().
+
+            Requests made for the session until it arrives are dropped.
+
+            Returns:
+                bool: False if the session has no subscribers or is moving.
+        )pbdoc")
+        .def("take_exports", [](tank_sim::ShardRouter &router) {
+                 return exportTuples(router.takeExports());
+             }, R"pbdoc(
+            Sessions exported since the last call (arriving through drain()).
+
+            Returns:
+                list[tuple[int, float, bytes | None]]: As SessionEngine.take_exports().
+        )pbdoc")
+        .def("import_session", [](tank_sim::ShardRouter &router, std::uint64_t key,
+                                  const py::bytes &snapshot, int subscribers, double speed) {
+                 router.importSession(importTransfer(key, snapshot, subscribers, speed));
+             }, py::arg("session_key"), py::arg("snapshot"), py::arg("subscribers") = 1,
+             py::arg("speed") = 1.0, R"pbdoc(
+            Continue an exported session on its ring owner.
 
-        Full class bindings (Simulator, SimulatorConfig, etc.) will be
-        added in subsequent development tasks.
-    )pbdoc";
+            Ignored for a session the router already routes. The shard
+            drops the connection over a snapshot its configuration does not
+            restore: check it with Simulator.restore_state() first.
 
-    // Module version function
-    m.def("get_version", &get_version, R"pbdoc(
-        Get the version of the tank_sim module.
+            Raises:
+                ValueError: If the snapshot is malformed or subscribers < 1.
+        )pbdoc")
+        .def("shard_of", &tank_sim::ShardRouter::shardOf, py::arg("session_key"),
+             "Shard a session is on (or would be created on)")
+        .def("sessions_on", &tank_sim::ShardRouter::sessionsOn, py::arg("shard"),
+             "Sessions with subscribers on a shard")
+        .def_property_readonly("session_count", &tank_sim::ShardRouter::sessionCount)
+        .def_property_readonly("shard_count", &tank_sim::ShardRouter::shardCount)
+        .def_property_readonly("migrations_in_flight",
+                               &tank_sim::ShardRouter::migrationsInFlight);
+
+    py::class_<tank_sim::CompressedHistory>(m, "CompressedHistory", R"pbdoc(
+        A session's history in a compact, lossless block (XOR-compressed).
+
+        Restored from a SessionCheckpoint and decoded only when needed.
+    )pbdoc")
+        .def(py::init<>(), "Empty history")
+        .def("__len__", &tank_sim::CompressedHistory::size)
+        .def_property_readonly("nbytes", [](const tank_sim::CompressedHistory &h) {
+            return h.bytes().size();
+        }, "Size of the compressed block")
+        .def("samples", &tank_sim::CompressedHistory::decode, R"pbdoc(
+            Decompress the history.
 
-        Returns:
-            str: Version string in semantic versioning format (e.g., "0.1.0").
-    )pbdoc");
+            Returns:
+                list[SessionSample]: Oldest first.
 
-    // ========================================================================
-    // TankModel::Parameters binding
-    // ========================================================================
-    py::class_<tank_sim::TankModel::Parameters>(m, "TankModelParameters", R"pbdoc(
-        Configuration parameters for the tank physics model.
+            Raises:
+                ValueError: If the block is corrupt.
+        )pbdoc");
 
-        This class represents the physical characteristics of the tank system.
-        All parameters are read-write and can be modified at any time.
+    py::class_<PyCheckpointWriter>(m, "CheckpointWriter", R"pbdoc(
+        Collects sessions and writes them to one checkpoint file.
 
-        Attributes:
-            area (float): Cross-sectional area of the tank in m².
-                         Must be positive. Larger area means slower level changes.
-            k_v (float): Valve discharge coefficient in m^2.5/s.
-                        Determines the relationship between valve position and outlet flow.
-                        For the standard tank, k_v = 1.2649.
-            max_height (float): Maximum tank height in meters.
-                               Physical limit of the tank. Typically 5.0 m.
+        add() copies each session's state and history (cheap); write()
+        compresses and writes them on several threads without holding the
+        GIL, then renames the file into place.
 
         Example:
-            >>> params = TankModelParameters()
-            >>> params.area = 120.0
-            >>> params.k_v = 1.2649
-            >>> params.max_height = 5.0
+            >>> writer = CheckpointWriter()
+            >>> writer.add("plant", sim, history_frames, metadata=b"{}")
+            >>> writer.write("/data/sessions.ckp")
     )pbdoc")
         .def(py::init<>())
-        .def_readwrite("area", &tank_sim::TankModel::Parameters::area,
-                      "Cross-sectional area (m²)")
-        .def_readwrite("k_v", &tank_sim::TankModel::Parameters::k_v,
-                      "Valve discharge coefficient (m^2.5/s)")
-        .def_readwrite("max_height", &tank_sim::TankModel::Parameters::max_height,
-                      "Maximum tank height (m)");
+        .def("add", [](PyCheckpointWriter &w, const std::string &name,
+                       const tank_sim::Simulator &sim, const py::iterable &history,
+                       const tank_sim::CompressedHistory *earlier, const py::bytes &metadata) {
+                 tank_sim::SessionCheckpoint::Session session;
+                 session.name = name;
+                 session.metadata = metadata;
+                 session.snapshot = sim.captureState();
+                 if (earlier != nullptr) {
+                     session.earlier = *earlier;
+                 }
+                 for (const py::handle item : history) {
+                     session.history.push_back(tank_sim::SessionSample::fromFrame(
+                         item.cast<const tank_sim::TelemetryFrame &>()));
+                 }
+                 w.sessions.push_back(std::move(session));
+             }, py::arg("name"), py::arg("simulator"), py::arg("history"),
+             py::arg("earlier") = nullptr, py::arg("metadata") = py::bytes(), R"pbdoc(
+            Add a session.
 
-    // ========================================================================
-    // PIDController::Gains binding
-    // ========================================================================
-    py::class_<tank_sim::PIDController::Gains>(m, "PIDGains", R"pbdoc(
-        PID controller gain parameters.
+            Args:
+                name (str): Session name.
+                simulator (Simulator): Its simulator; the state is captured now.
+                history (Iterable[TelemetryFrame]): Frames, oldest first.
+                earlier (CompressedHistory | None): Restored history older
+                                                    than every frame.
+                metadata (bytes): Caller's own state, returned as is.
 
-        This class contains the three tuning parameters for a PID controller:
-        proportional, integral, and derivative gains. All parameters are read-write
-        and can be modified at any time for dynamic retuning.
+            Raises:
+                ValueError: If the simulator cannot be snapshotted.
+        )pbdoc")
+        .def("add_snapshot", [](PyCheckpointWriter &w, const std::string &name,
+                                const py::bytes &snapshot, const py::iterable &history,
+                                const py::bytes &metadata) {
+                 tank_sim::SessionCheckpoint::Session session;
+                 session.name = name;
+                 session.metadata = metadata;
+                 session.snapshot = snapshotFromBytes(snapshot);
+                 for (const py::handle item : history) {
+                     session.history.push_back(item.cast<tank_sim::SessionSample>());
+                 }
+                 w.sessions.push_back(std::move(session));
+             }, py::arg("name"), py::arg("snapshot"), py::arg("history"),
+             py::arg("metadata") = py::bytes(), R"pbdoc(
+            Add a session captured elsewhere, e.g. exported from an engine.
 
-        Attributes:
-            Kc (float): Proportional gain (dimensionless).
-                       Controls the immediate response to error. Negative values
-                       implement reverse-acting control (e.g., for outlet valve).
-                       Typical range: -5.0 to +5.0 depending on system dynamics.
-            tau_I (float): Integral time constant in seconds.
-                          Controls long-term error correction. Larger values mean
-                          slower integral action. Set to 0 to disable integral action.
-                          Typical range: 5.0 to 50.0 seconds.
-            tau_D (float): Derivative time constant in seconds.
-                          Provides predictive damping based on error rate of change.
-                          Set to 0 to disable derivative action.
-                          Typical range: 0.5 to 5.0 seconds.
+            Args:
+                name (str): Session name.
+                snapshot (bytes): Simulator.capture_state() or an export's snapshot.
+                history (Iterable[SessionSample]): Samples, oldest first.
+                metadata (bytes): Caller's own state, returned as is.
+
+            Raises:
+                ValueError: If the snapshot is malformed.
+        )pbdoc")
+        .def("__len__", [](const PyCheckpointWriter &w) { return w.sessions.size(); })
+        .def("write", [](PyCheckpointWriter &w, const std::string &path, int threads) {
+                 py::gil_scoped_release release;
+                 return tank_sim::SessionCheckpoint::write(path, w.sessions, threads);
+             }, py::arg("path"), py::arg("threads") = 0, R"pbdoc(
+            Write the sessions added so far, replacing the file atomically.
+
+            Args:
+                path (str): Checkpoint file; "<path>.tmp" is used meanwhile.
+                threads (int): Encoder threads; 0 for one per core.
+
+            Returns:
+                int: Bytes written.
+
+            Raises:
+                RuntimeError: If the file cannot be written.
+        )pbdoc");
+
+    py::class_<tank_sim::SessionCheckpoint>(m, "SessionCheckpoint", R"pbdoc(
+        A checkpoint file, memory-mapped for restoring its sessions.
 
         Example:
-            >>> gains = PIDGains()
-            >>> gains.Kc = -1.0      # Reverse-acting
-            >>> gains.tau_I = 10.0   # 10 second integral
-            >>> gains.tau_D = 1.0    # 1 second derivative
+            >>> checkpoint = SessionCheckpoint("/data/sessions.ckp")
+            >>> for i in range(len(checkpoint)):
+            ...     sim = Simulator(config)
+            ...     checkpoint.restore(i, sim)
     )pbdoc")
-        .def(py::init<>())
-        .def_readwrite("Kc", &tank_sim::PIDController::Gains::Kc,
-                      "Proportional gain (dimensionless)")
-        .def_readwrite("tau_I", &tank_sim::PIDController::Gains::tau_I,
-                      "Integral time constant (seconds)")
-        .def_readwrite("tau_D", &tank_sim::PIDController::Gains::tau_D,
-                      "Derivative time constant (seconds)");
+        .def(py::init<const std::string &>(), py::arg("path"), R"pbdoc(
+            Raises:
+                RuntimeError: If the file is missing, truncated or not a
+                              checkpoint of this version.
+        )pbdoc")
+        .def("__len__", &tank_sim::SessionCheckpoint::size)
+        .def("name", [](const tank_sim::SessionCheckpoint &c, int index) {
+                 return std::string(c.name(index));
+             }, py::arg("index"), "Name of a session")
+        .def("metadata", [](const tank_sim::SessionCheckpoint &c, int index) {
+                 const std::string_view metadata = c.metadata(index);
+                 return py::bytes(metadata.data(), metadata.size());
+             }, py::arg("index"), "Metadata stored with a session")
+        .def("restore", [](const tank_sim::SessionCheckpoint &c, int index,
+                           tank_sim::Simulator &sim) { sim.restoreState(c.snapshot(index)); },
+             py::arg("index"), py::arg("simulator"), R"pbdoc(
+            Continue a session's state in a simulator.
+
+            Raises:
+                ValueError: If the simulator's configuration does not match.
+                IndexError: If the index is out of range.
+        )pbdoc")
+        .def("snapshot", [](const tank_sim::SessionCheckpoint &c, int index) {
+                 return snapshotBytes(c.snapshot(index));
+             }, py::arg("index"), R"pbdoc(
+            A session's state as Simulator.capture_state() bytes.
+
+            Raises:
+                IndexError: If the index is out of range.
+        )pbdoc")
+        .def("history", &tank_sim::SessionCheckpoint::history, py::arg("index"),
+             "History of a session as a CompressedHistory");
 
     // ========================================================================
     // Simulator::ControllerConfig binding
@@ -161,8 +1650,16 @@ PYBIND11_MODULE(_tank_sim, m) {
                                  Prevents integral windup. Typical value: 10.0.
             measured_index (int): Index of the state variable being measured (usually 0 for level).
             output_index (int): Index of the input variable being adjusted (usually 1 for valve).
+                               -1 for an internal loop whose output only feeds
+                               control links (e.g. a cascade master).
             initial_setpoint (float): Initial target value for the controlled variable.
                                     For a tank level controller, typically 2.5 m.
+            measured_source (SignalSource): Whether measured_index refers to the
+                                          state (default) or the inputs.
+            type (ControllerType): PID (default) or MPC. An MPC controller
+                                  ignores gains and max_integral, and starts
+                                  its output at bias.
+            mpc (MPCSettings): MPC settings, used when type is MPC.
 
         Example:
             >>> config = ControllerConfig()
@@ -194,7 +1691,13 @@ PYBIND11_MODULE(_tank_sim, m) {
         .def_readwrite("output_index", &tank_sim::Simulator::ControllerConfig::outputIndex,
                       "Index of output/input variable")
         .def_readwrite("initial_setpoint", &tank_sim::Simulator::ControllerConfig::initialSetpoint,
-                      "Initial controller setpoint");
+                      "Initial controller setpoint")
+        .def_readwrite("measured_source", &tank_sim::Simulator::ControllerConfig::measuredSource,
+                      "Source of the measured variable (state or input)")
+        .def_readwrite("type", &tank_sim::Simulator::ControllerConfig::type,
+                      "Control law (PID or MPC)")
+        .def_readwrite("mpc", &tank_sim::Simulator::ControllerConfig::mpc,
+                      "MPC settings (used when type is MPC)");
 
     // ========================================================================
     // Simulator::Config binding
@@ -219,6 +1722,31 @@ PYBIND11_MODULE(_tank_sim, m) {
                                            q_in is inlet flow (m³/s), typically 1.0.
                                            valve_position (0-1), typically 0.5.
             dt (float): Simulation timestep in seconds. Typical value: 1.0.
+            control_links (list[ControlLink]): Cascade, ratio and feedforward
+                                              connections. Empty by default.
+            gain_schedules (list[GainScheduleConfig]): Gain-scheduled controllers.
+                                                      Empty by default.
+            sensor_noise_std (float): Standard deviation of Gaussian level
+                                     sensor noise in meters. 0 (default) is an
+                                     ideal sensor.
+            sensor_noise_seed (int): Seed of the sensor noise generator.
+            use_estimator (bool): Feed controllers an EKF level estimate
+                                 instead of the raw sensor. False by default.
+            estimator (EstimatorSettings): Estimator noise model.
+            identify_model (bool): Track area and k_v online with recursive
+                                  least squares. False by default.
+            identifier (IdentifierSettings): Identifier settings.
+            performance (PerformanceSettings): Loop KPI thresholds.
+            monitor_loop_health (bool): Run oscillation and Harris-index
+                                       detectors on every loop. False by
+                                       default.
+            loop_health (LoopHealthSettings): Detector settings.
+            alarms (list[AlarmConfig]): Limit alarms evaluated every step.
+            stream_telemetry (bool): Keep the per-step frame ring read by
+                                    subscribe_telemetry(). True by default.
+            report_command_results (bool): Keep the result ring read by
+                                          poll_applied_commands(). True by
+                                          default.
 
         Example:
             >>> config = SimulatorConfig()
@@ -253,7 +1781,36 @@ PYBIND11_MODULE(_tank_sim, m) {
                       },
                       "Initial inputs vector (as numpy array)")
         .def_readwrite("dt", &tank_sim::Simulator::Config::dt,
-                      "Simulation timestep (seconds)");
+                      "Simulation timestep (seconds)")
+        .def_readwrite("control_links", &tank_sim::Simulator::Config::controlLinks,
+                      "Cascade, ratio and feedforward links")
+        .def_readwrite("gain_schedules", &tank_sim::Simulator::Config::gainSchedules,
+                      "Gain schedules attached to controllers")
+        .def_readwrite("sensor_noise_std", &tank_sim::Simulator::Config::sensorNoiseStdDev,
+                      "Level sensor noise standard deviation (m)")
+        .def_readwrite("sensor_noise_seed", &tank_sim::Simulator::Config::sensorNoiseSeed,
+                      "Sensor noise generator seed")
+        .def_readwrite("use_estimator", &tank_sim::Simulator::Config::useEstimator,
+                      "Whether controllers read the EKF estimate")
+        .def_readwrite("estimator", &tank_sim::Simulator::Config::estimator,
+                      "Estimator noise model")
+        .def_readwrite("identify_model", &tank_sim::Simulator::Config::identifyModel,
+                      "Whether to identify the tank model online")
+        .def_readwrite("identifier", &tank_sim::Simulator::Config::identifier,
+                      "Online identifier settings")
+        .def_readwrite("performance", &tank_sim::Simulator::Config::performance,
+                      "Loop performance index thresholds")
+        .def_readwrite("monitor_loop_health", &tank_sim::Simulator::Config::monitorLoopHealth,
+                      "Whether to run loop health detectors")
+        .def_readwrite("loop_health", &tank_sim::Simulator::Config::loopHealth,
+                      "Loop health detector settings")
+        .def_readwrite("alarms", &tank_sim::Simulator::Config::alarms,
+                      "Limit alarms")
+        .def_readwrite("stream_telemetry", &tank_sim::Simulator::Config::streamTelemetry,
+                      "Whether to keep the per-step telemetry ring")
+        .def_readwrite("report_command_results",
+                      &tank_sim::Simulator::Config::reportCommandResults,
+                      "Whether to keep the applied-command result ring");
 
     // ========================================================================
     // Simulator class binding
@@ -296,19 +1853,35 @@ PYBIND11_MODULE(_tank_sim, m) {
              )pbdoc")
 
         // Core simulation method
-        .def("step", &tank_sim::Simulator::step, R"pbdoc(
-            Advance the simulation by one timestep.
+        .def("step", [](tank_sim::Simulator &sim, int steps) {
+                 if (steps == 1) {
+                     sim.step();
+                 } else {
+                     sim.stepMany(steps);
+                 }
+             }, py::arg("steps") = 1, R"pbdoc(
+            Advance the simulation by one or more timesteps.
 
-            This method:
+            Each timestep:
             1. Computes control outputs from all configured PID controllers
             2. Updates controller integral accumulators
             3. Integrates the tank physics ODE by dt seconds
             4. Updates state, inputs, and time
 
             Should be called at regular intervals (e.g., every 1 second).
+            With steps > 1 the whole batch runs in C++: queued commands are
+            applied before the first step and a single telemetry frame is
+            published after the last, which is how faster-than-real-time
+            sessions advance many steps per wall-clock tick.
+
+            Args:
+                steps: Timesteps to take (default 1)
 
             Returns:
                 None
+
+            Raises:
+                ValueError: If steps < 1
         )pbdoc")
 
         // State getters (all const, non-modifying)
@@ -346,6 +1919,25 @@ PYBIND11_MODULE(_tank_sim, m) {
                 Use set_input() to modify individual inputs.
         )pbdoc")
 
+        .def("get_measured_state", &tank_sim::Simulator::getMeasuredState, R"pbdoc(
+            Get the last level sensor reading as a numpy array.
+
+            Equals get_state() when sensor_noise_std is 0.
+
+            Returns:
+                numpy.ndarray: Sensor reading (float64, 1D array).
+        )pbdoc")
+
+        .def("get_estimated_state", &tank_sim::Simulator::getEstimatedState, R"pbdoc(
+            Get the state the controllers read as a numpy array.
+
+            This is the EKF estimate when use_estimator is set, otherwise the
+            raw sensor reading.
+
+            Returns:
+                numpy.ndarray: Estimated state (float64, 1D array).
+        )pbdoc")
+
         .def("get_setpoint", 
              [](const tank_sim::Simulator& self, int index) {
                  if (index < 0 || index >= self.getControllerCount()) {
@@ -503,6 +2095,8 @@ PYBIND11_MODULE(_tank_sim, m) {
 
             Raises:
                 IndexError: If index is out of range.
+                ValueError: If the controller is an MPC controller or is
+                    gain-scheduled (the schedule sets its gains every step).
 
             Example:
                 >>> new_gains = tank_sim.PIDGains()
@@ -512,6 +2106,179 @@ PYBIND11_MODULE(_tank_sim, m) {
                 >>> sim.set_controller_gains(0, new_gains)
         )pbdoc")
 
+        .def("get_mpc_stats",
+             [](const tank_sim::Simulator& self, int index) {
+                 return self.getMPCStats(index);
+             },
+             py::arg("index"), R"pbdoc(
+            Get solve latency statistics of an MPC controller.
+
+            Args:
+                index (int): Controller index (0-based).
+
+            Returns:
+                MPCSolveStats: Copy of the controller's statistics.
+
+            Raises:
+                IndexError: If index is out of range.
+                ValueError: If the controller is not an MPC controller.
+
+            Example:
+                >>> stats = sim.get_mpc_stats(0)
+                >>> print(f"{stats.mean_micros:.1f} us per solve")
+        )pbdoc")
+
+        .def("get_identified_model", &tank_sim::Simulator::getIdentifiedModel, R"pbdoc(
+            Get the online estimate of the tank model.
+
+            Returns:
+                IdentifiedModel: Identified area, k_v and time constant.
+
+            Raises:
+                ValueError: If identify_model was not set in the config.
+
+            Example:
+                >>> model = sim.get_identified_model()
+                >>> print(f"k_v = {model.k_v:.3f}")
+        )pbdoc")
+
+        .def("get_performance", &tank_sim::Simulator::getPerformance, R"pbdoc(
+            Get the streaming performance indices of every controller.
+
+            Indices accumulate each step and restart whenever set_setpoint()
+            is called for that controller, and on reset().
+
+            Returns:
+                list[LoopPerformance]: One entry per controller, in config order.
+
+            Example:
+                >>> sim.set_setpoint(0, 3.0)
+                >>> for _ in range(600):
+                ...     sim.step()
+                >>> kpi = sim.get_performance()[0]
+                >>> print(f"IAE = {kpi.iae:.2f}, overshoot = {kpi.overshoot:.1%}")
+        )pbdoc")
+
+        .def("get_loop_health", &tank_sim::Simulator::getLoopHealth, R"pbdoc(
+            Get the oscillation and performance flags of every controller.
+
+            Returns:
+                list[LoopHealthStatus]: One entry per controller, in config order.
+
+            Raises:
+                ValueError: If monitor_loop_health was not set in the config.
+
+            Example:
+                >>> for i, health in enumerate(sim.get_loop_health()):
+                ...     if health.oscillating:
+                ...         print(f"loop {i} oscillating, period {health.period:.0f} s")
+        )pbdoc")
+
+        .def("drain_alarm_events", &tank_sim::Simulator::drainAlarmEvents, R"pbdoc(
+            Take the alarm transitions since the last call.
+
+            Events are only produced when an alarm is raised or cleared.
+            reset() clears active alarms with events.
+
+            Returns:
+                list[AlarmEvent]: Transitions, oldest first.
+
+            Example:
+                >>> for event in sim.drain_alarm_events():
+                ...     print(event.alarm, "RAISED" if event.active else "cleared")
+        )pbdoc")
+
+        .def("get_active_alarms", &tank_sim::Simulator::getActiveAlarms, R"pbdoc(
+            Get the alarms currently active.
+
+            Returns:
+                list[int]: Indices into SimulatorConfig.alarms.
+        )pbdoc")
+
+        .def("submit_command", &tank_sim::Simulator::submitCommand, py::arg("command"), R"pbdoc(
+            Queue an operator command for the stepping thread.
+
+            Commands are applied in order at the start of the next step()
+            (or apply_pending_commands()). Only one thread may submit.
+
+            Args:
+                command (OperatorCommand): Command to queue.
+
+            Returns:
+                bool: False if the queue is full.
+        )pbdoc")
+
+        .def("poll_applied_commands", [](tank_sim::Simulator &sim) {
+                 std::vector<tank_sim::AppliedCommand> results;
+                 tank_sim::AppliedCommand result;
+                 while (sim.pollAppliedCommand(result)) {
+                     results.push_back(result);
+                 }
+                 return results;
+             }, R"pbdoc(
+            Take the results of applied commands (submitting thread only).
+
+            Returns:
+                list[AppliedCommand]: Results, in application order.
+        )pbdoc")
+
+        .def("apply_pending_commands", &tank_sim::Simulator::applyPendingCommands, R"pbdoc(
+            Apply queued commands without stepping (stepping thread only).
+
+            Returns:
+                int: Number of commands applied.
+        )pbdoc")
+
+        .def("get_command_stats", &tank_sim::Simulator::getCommandStats,
+             py::return_value_policy::copy, R"pbdoc(
+            Get command queue counters and latency (stepping thread only).
+
+            Returns:
+                CommandStats: Applied/rejected counts and latency in microseconds.
+        )pbdoc")
+
+        .def("get_telemetry", &tank_sim::Simulator::getTelemetry,
+             py::call_guard<py::gil_scoped_release>(), R"pbdoc(
+            Get the latest published frame.
+
+            Safe to call from any thread while another thread steps the
+            simulator: the frame is read from a sequence lock, so it is
+            always consistent and the stepping thread is never blocked.
+
+            Returns:
+                TelemetryFrame: State, inputs and loop values of the last step.
+
+            Example:
+                >>> frame = sim.get_telemetry()
+                >>> print(f"t={frame.time:.0f} s level={frame.tank_level:.3f} m")
+        )pbdoc")
+
+        .def("subscribe_telemetry", [](const tank_sim::Simulator &sim, bool from_oldest) {
+                 return TelemetrySubscription{&sim, sim.subscribeTelemetry(from_oldest)};
+             }, py::arg("from_oldest") = false, py::keep_alive<0, 1>(), R"pbdoc(
+            Subscribe to the stream of per-step frames.
+
+            step() and reset() each publish one frame into a fixed ring. The
+            stepping thread never waits for subscribers, so adding one costs
+            it nothing; a subscriber that polls too slowly loses frames.
+
+            Args:
+                from_oldest (bool): Start at the oldest retained frame instead
+                                    of the next one published.
+
+            Returns:
+                TelemetrySubscription: Cursor to poll for new frames.
+
+            Raises:
+                ValueError: If the config disabled stream_telemetry.
+
+            Example:
+                >>> sub = sim.subscribe_telemetry()
+                >>> sim.step()
+                >>> [f.step for f in sub.poll()]
+                [1]
+        )pbdoc")
+
         .def("reset", &tank_sim::Simulator::reset, R"pbdoc(
             Reset the simulator to initial conditions.
 
@@ -532,5 +2299,137 @@ PYBIND11_MODULE(_tank_sim, m) {
                 >>> sim.step()  # Run one step
                 >>> sim.reset()  # Back to beginning
                 >>> sim.step()  # Produces identical result
+        )pbdoc")
+        .def("capture_state", [](const tank_sim::Simulator &sim) {
+                 return snapshotBytes(sim.captureState());
+             }, R"pbdoc(
+            Binary snapshot of the dynamic state.
+
+            Covers time, states, inputs and every loop's setpoint, gains and
+            PID memory. A simulator built from the same configuration
+            continues exactly as this one would after restore_state().
+
+            Returns:
+                bytes: The snapshot (same host only; raw native layout).
+
+            Raises:
+                ValueError: If the simulator has more loops than a snapshot holds.
+        )pbdoc")
+        .def("restore_state", [](tank_sim::Simulator &sim, const py::bytes &data) {
+                 sim.restoreState(snapshotFromBytes(data));
+             }, py::arg("snapshot"), R"pbdoc(
+            Continue from a snapshot taken by capture_state().
+
+            The identified model and the active alarms continue as captured,
+            without alarm events; the estimator and KPIs restart from the
+            restored state.
+
+            Args:
+                snapshot (bytes): Result of capture_state().
+
+            Raises:
+                ValueError: If the snapshot does not match this configuration.
+        )pbdoc");
+
+    // ========================================================================
+    // Offline parameter estimation
+    // ========================================================================
+    py::class_<tank_sim::RecordedData>(m, "RecordedData", R"pbdoc(
+        Historian record of one tank sampled at a fixed interval.
+
+        level[k] is the level at time k*dt; inlet_flow[k] and valve_position[k]
+        are the inputs held over the following sample. All three lists must
+        have the same length.
+
+        Attributes:
+            dt (float): Sample interval in seconds.
+            inlet_flow (list[float]): Inlet flow samples (m³/s).
+            valve_position (list[float]): Valve position samples (0-1).
+            level (list[float]): Level samples (m).
+    )pbdoc")
+        .def(py::init<>())
+        .def_readwrite("dt", &tank_sim::RecordedData::dt, "Sample interval (s)")
+        .def_readwrite("inlet_flow", &tank_sim::RecordedData::inletFlow, "Inlet flow samples")
+        .def_readwrite("valve_position", &tank_sim::RecordedData::valvePosition,
+                      "Valve position samples")
+        .def_readwrite("level", &tank_sim::RecordedData::level, "Level samples");
+
+    py::class_<tank_sim::ParameterEstimator::Settings>(m, "ParameterEstimatorSettings", R"pbdoc(
+        Levenberg-Marquardt settings for offline calibration.
+
+        Attributes:
+            max_iterations (int): Accepted-step limit.
+            tolerance (float): Relative step and cost-decrease tolerance.
+            initial_damping (float): Initial damping relative to diag(J'J).
+    )pbdoc")
+        .def(py::init<>())
+        .def_readwrite("max_iterations", &tank_sim::ParameterEstimator::Settings::maxIterations,
+                      "Accepted-step limit")
+        .def_readwrite("tolerance", &tank_sim::ParameterEstimator::Settings::tolerance,
+                      "Convergence tolerance")
+        .def_readwrite("initial_damping", &tank_sim::ParameterEstimator::Settings::initialDamping,
+                      "Initial LM damping");
+
+    py::class_<tank_sim::ParameterEstimator::Result>(m, "ParameterFit", R"pbdoc(
+        Result of calibrating one tank.
+
+        Attributes:
+            params (TankModelParameters): Fitted area and k_v (max_height
+                                         copied from the initial guess).
+            rms_residual (float): RMS level residual at the solution (m).
+            iterations (int): Accepted Levenberg-Marquardt steps.
+            converged (bool): Whether the tolerance was met.
+    )pbdoc")
+        .def_readonly("params", &tank_sim::ParameterEstimator::Result::params)
+        .def_readonly("rms_residual", &tank_sim::ParameterEstimator::Result::rmsResidual)
+        .def_readonly("iterations", &tank_sim::ParameterEstimator::Result::iterations)
+        .def_readonly("converged", &tank_sim::ParameterEstimator::Result::converged);
+
+    py::class_<tank_sim::ParameterEstimator>(m, "ParameterEstimator", R"pbdoc(
+        Calibrates TankModel area and k_v from recorded data.
+
+        Simulates the model against the recorded inputs and minimizes the
+        squared level residuals with Levenberg-Marquardt, using forward
+        sensitivities for the Jacobian.
+
+        Example:
+            >>> estimator = ParameterEstimator()
+            >>> fit = estimator.estimate(record, create_default_config().model_params)
+            >>> print(fit.params.area, fit.params.k_v)
+    )pbdoc")
+        .def(py::init<>())
+        .def(py::init<const tank_sim::ParameterEstimator::Settings&>(), py::arg("settings"))
+        .def("estimate", &tank_sim::ParameterEstimator::estimate,
+             py::arg("data"), py::arg("initial_guess"),
+             py::call_guard<py::gil_scoped_release>(), R"pbdoc(
+            Fit one tank.
+
+            Args:
+                data (RecordedData): Recorded inputs and levels.
+                initial_guess (TankModelParameters): Starting parameters.
+
+            Returns:
+                ParameterFit: Fitted parameters and statistics.
+
+            Raises:
+                ValueError: If the record is inconsistent or the guess is not positive.
+        )pbdoc")
+        .def("estimate_many", &tank_sim::ParameterEstimator::estimateMany,
+             py::arg("data"), py::arg("initial_guesses"), py::arg("threads") = 0,
+             py::call_guard<py::gil_scoped_release>(), R"pbdoc(
+            Fit many tanks in parallel on a pool of worker threads.
+
+            The GIL is released for the duration of the call.
+
+            Args:
+                data (list[RecordedData]): One record per tank.
+                initial_guesses (list[TankModelParameters]): One guess per tank.
+                threads (int): Worker count; 0 uses all hardware threads.
+
+            Returns:
+                list[ParameterFit]: Results in the order of data.
+
+            Raises:
+                ValueError: If the list sizes differ or any fit fails.
         )pbdoc");
 }
@@ -0,0 +1,36 @@
+#ifndef TANK_SIM_SERVER_DEFAULT_CONFIG_H
+#define TANK_SIM_SERVER_DEFAULT_CONFIG_H
+
+#include "constants.h"
+#include "simulator.h"
+
+namespace tank_sim {
+
+/// Same tank and PID loop as tank_sim.create_default_config()
+inline Simulator::Config defaultServerConfig() {
+    Simulator::Config config;
+    config.params = TankModel::Parameters{constants::DEFAULT_TANK_AREA,
+                                          constants::DEFAULT_VALVE_COEFFICIENT,
+                                          constants::TANK_MAX_HEIGHT};
+    config.initialState = Eigen::VectorXd(1);
+    config.initialState << constants::TANK_NOMINAL_HEIGHT;
+    config.initialInputs = Eigen::VectorXd(2);
+    config.initialInputs << 1.0, 0.5;
+    config.dt = 1.0;
+
+    Simulator::ControllerConfig ctrl;
+    ctrl.gains = PIDController::Gains{-1.0, 10.0, 1.0};
+    ctrl.bias = constants::DEFAULT_PID_BIAS;
+    ctrl.minOutputLimit = constants::DEFAULT_PID_MIN_OUTPUT;
+    ctrl.maxOutputLimit = constants::DEFAULT_PID_MAX_OUTPUT;
+    ctrl.maxIntegralAccumulation = constants::DEFAULT_PID_MAX_INTEGRAL;
+    ctrl.measuredIndex = 0;
+    ctrl.outputIndex = 1;
+    ctrl.initialSetpoint = constants::TANK_NOMINAL_HEIGHT;
+    config.controllerConfig.push_back(ctrl);
+    return config;
+}
+
+}  // namespace tank_sim
+
+#endif  // TANK_SIM_SERVER_DEFAULT_CONFIG_H
@@ -0,0 +1,301 @@
+// tank_ws_loadtest: open many WebSocket clients against tank_ws_server and
+// measure how evenly each tick's frame reaches them.
+//
+// For every tick (identified by the "time" field of the state message) the
+// spread is the time between the first and the last client receiving it.
+// Reports frames/s and the p50/p99/max spread.
+//
+// Usage: tank_ws_loadtest [--host A.B.C.D] [--port N] [--clients N]
+//                         [--session NAME] [--duration SECONDS] [--threads N]
+
+#include "constants.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    std::string host = "127.0.0.1";
+    int port = tank_sim::constants::DEFAULT_WS_SERVER_PORT;
+    int clients = 1000;
+    std::string session = "loadtest";  ///< Empty: one private session per client
+    double duration = 10.0;
+    int threads = 4;
+};
+
+/// First and last arrival of one tick's frame, in ns since start
+struct Arrival {
+    std::int64_t first;
+    std::int64_t last;
+    int count;
+};
+
+struct Connection {
+    int fd;
+    bool open = false;
+    std::string in;
+};
+
+struct Worker {
+    std::vector<Connection> connections;
+    std::map<double, Arrival> arrivals;
+    std::uint64_t frames = 0;
+    int failed = 0;
+};
+
+int connectTo(const Options& options) {
+    const int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(static_cast<std::uint16_t>(options.port));
+    inet_pton(AF_INET, options.host.c_str(), &address.sin_addr);
+    if (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        close(fd);
+        return -1;
+    }
+    const int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    std::string request = "GET /ws";
+    if (!options.session.empty()) {
+        request += "?session=" + options.session;
+    }
+    request += " HTTP/1.1\r\nHost: " + options.host +
+               "\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+               "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+               "Sec-WebSocket-Version: 13\r\n\r\n";
+    if (send(fd, request.data(), request.size(), MSG_NOSIGNAL) !=
+        static_cast<ssize_t>(request.size())) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/// Consume complete server frames from in; returns false on a bad stream
+bool consume(Connection& connection, Worker& worker, std::int64_t now) {
+    std::string& in = connection.in;
+    if (!connection.open) {
+        const std::size_t end = in.find("\r\n\r\n");
+        if (end == std::string::npos) {
+            return true;
+        }
+        if (in.compare(0, 12, "HTTP/1.1 101") != 0) {
+            return false;
+        }
+        connection.open = true;
+        in.erase(0, end + 4);
+    }
+
+    std::size_t pos = 0;
+    while (in.size() - pos >= 2) {
+        const auto* bytes = reinterpret_cast<const unsigned char*>(in.data() + pos);
+        const int opcode = bytes[0] & 0x0F;
+        std::uint64_t length = bytes[1] & 0x7F;
+        std::size_t header = 2;
+        if (length == 126) {
+            header = 4;
+            if (in.size() - pos < header) break;
+            length = (static_cast<std::uint64_t>(bytes[2]) << 8) | bytes[3];
+        } else if (length == 127) {
+            header = 10;
+            if (in.size() - pos < header) break;
+            length = 0;
+            for (int i = 0; i < 8; ++i) {
+                length = (length << 8) | bytes[2 + i];
+            }
+        }
+        if (in.size() - pos < header + length) {
+            break;
+        }
+        if (opcode == 0x8) {
+            return false;
+        }
+        if (opcode == 0x1) {
+            const std::string payload(in.data() + pos + header, static_cast<std::size_t>(length));
+            const std::size_t at = payload.find("\"time\":");
+            if (at != std::string::npos) {
+                const double time = std::strtod(payload.c_str() + at + 7, nullptr);
+                auto [it, inserted] = worker.arrivals.try_emplace(time, Arrival{now, now, 0});
+                it->second.first = std::min(it->second.first, now);
+                it->second.last = std::max(it->second.last, now);
+                ++it->second.count;
+                ++worker.frames;
+            }
+        }
+        pos += header + static_cast<std::size_t>(length);
+    }
+    in.erase(0, pos);
+    return true;
+}
+
+void runWorker(Worker& worker, Clock::time_point start, const std::atomic<bool>& running) {
+    const int epoll = epoll_create1(0);
+    for (std::size_t i = 0; i < worker.connections.size(); ++i) {
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.u64 = i;
+        epoll_ctl(epoll, EPOLL_CTL_ADD, worker.connections[i].fd, &event);
+    }
+
+    epoll_event events[256];
+    char buffer[16 * 1024];
+    while (running.load(std::memory_order_relaxed)) {
+        const int count = epoll_wait(epoll, events, 256, 100);
+        const std::int64_t now =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+        for (int i = 0; i < count; ++i) {
+            Connection& connection = worker.connections[events[i].data.u64];
+            const ssize_t n = recv(connection.fd, buffer, sizeof(buffer), MSG_DONTWAIT);
+            if (n <= 0) {
+                if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) {
+                    epoll_ctl(epoll, EPOLL_CTL_DEL, connection.fd, nullptr);
+                    ++worker.failed;
+                }
+                continue;
+            }
+            connection.in.append(buffer, static_cast<std::size_t>(n));
+            if (!consume(connection, worker, now)) {
+                epoll_ctl(epoll, EPOLL_CTL_DEL, connection.fd, nullptr);
+                ++worker.failed;
+            }
+        }
+    }
+    close(epoll);
+}
+
+double percentile(std::vector<double>& values, double p) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    const std::size_t index =
+        std::min(values.size() - 1, static_cast<std::size_t>(p * static_cast<double>(values.size())));
+    std::nth_element(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(index), values.end());
+    return values[index];
+}
+
+[[noreturn]] void usage(const char* program) {
+    std::fprintf(stderr,
+                 "Usage: %s [--host A.B.C.D] [--port N] [--clients N] [--session NAME]\n"
+                 "          [--duration SECONDS] [--threads N]\n",
+                 program);
+    std::exit(2);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const char* flag = argv[i];
+        if (i + 1 >= argc) {
+            usage(argv[0]);
+        }
+        const char* value = argv[++i];
+        if (std::strcmp(flag, "--host") == 0) {
+            options.host = value;
+        } else if (std::strcmp(flag, "--port") == 0) {
+            options.port = std::atoi(value);
+        } else if (std::strcmp(flag, "--clients") == 0) {
+            options.clients = std::atoi(value);
+        } else if (std::strcmp(flag, "--session") == 0) {
+            options.session = value;
+        } else if (std::strcmp(flag, "--duration") == 0) {
+            options.duration = std::atof(value);
+        } else if (std::strcmp(flag, "--threads") == 0) {
+            options.threads = std::max(1, std::atoi(value));
+        } else {
+            usage(argv[0]);
+        }
+    }
+
+    // Tens of thousands of sockets need more than the default 1024 fds
+    rlimit limit{};
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+
+    std::vector<Worker> workers(static_cast<std::size_t>(options.threads));
+    int connected = 0;
+    for (int i = 0; i < options.clients; ++i) {
+        const int fd = connectTo(options);
+        if (fd < 0) {
+            std::fprintf(stderr, "connect failed after %d clients: %s\n", connected,
+                         std::strerror(errno));
+            break;
+        }
+        Connection connection;
+        connection.fd = fd;
+        workers[static_cast<std::size_t>(i % options.threads)].connections.push_back(connection);
+        ++connected;
+    }
+
+    const auto start = Clock::now();
+    std::atomic<bool> running{true};
+    std::vector<std::thread> threads;
+    for (auto& worker : workers) {
+        threads.emplace_back([&worker, start, &running]() { runWorker(worker, start, running); });
+    }
+    std::this_thread::sleep_for(std::chrono::duration<double>(options.duration));
+    running.store(false);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    const double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+    // Merge per-thread arrivals; spread only over ticks every client saw
+    std::map<double, Arrival> merged;
+    std::uint64_t frames = 0;
+    int failed = 0;
+    for (auto& worker : workers) {
+        frames += worker.frames;
+        failed += worker.failed;
+        for (const auto& [time, arrival] : worker.arrivals) {
+            auto [it, inserted] = merged.try_emplace(time, arrival);
+            if (!inserted) {
+                it->second.first = std::min(it->second.first, arrival.first);
+                it->second.last = std::max(it->second.last, arrival.last);
+                it->second.count += arrival.count;
+            }
+        }
+        for (const auto& connection : worker.connections) {
+            close(connection.fd);
+        }
+    }
+    std::vector<double> spreads;
+    for (const auto& [time, arrival] : merged) {
+        if (arrival.count == connected - failed) {
+            spreads.push_back(static_cast<double>(arrival.last - arrival.first) / 1e3);
+        }
+    }
+
+    std::printf("clients %d (failed %d), frames %llu, %.0f frames/s\n", connected, failed,
+                static_cast<unsigned long long>(frames), static_cast<double>(frames) / elapsed);
+    std::printf("ticks %zu, spread p50 %.1f us, p99 %.1f us, max %.1f us\n", spreads.size(),
+                percentile(spreads, 0.50), percentile(spreads, 0.99),
+                spreads.empty() ? 0.0 : *std::max_element(spreads.begin(), spreads.end()));
+    return failed == 0 ? 0 : 1;
+}
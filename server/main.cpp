@@ -0,0 +1,136 @@
+// tank_ws_server: native WebSocket telemetry server.
+//
+// Serves the same /ws protocol as the FastAPI backend for the per-tick state
+// stream and the setpoint, inlet_flow, pid, reset and speed commands, with
+// every session on the default tank configuration. Clients that connect to
+// /ws?format=delta get binary delta-encoded states instead of JSON (see
+// src/frame_delta.h). With --store, every
+// session is also exported to a SharedSessionStore, so API workers started
+// with SESSION_STORE=<name> can serve its telemetry.
+//
+// --catch-up picks what the engine does with ticks missed during a stall
+// (burst, skip or rebase); --realtime CPU runs the engine thread SCHED_FIFO
+// with locked memory, pinned to CPU (-1: not pinned), when permitted.
+// --speculate TICKS lets the engine compute sessions up to TICKS ticks ahead
+// while it is idle and serve their frames from a buffer.
+//
+// Usage: tank_ws_server [--port N] [--threads N] [--tick SECONDS] [--max-sessions N]
+//                       [--store /NAME] [--catch-up POLICY] [--realtime CPU]
+//                       [--speculate TICKS]
+
+#include "default_config.h"
+#include "session_engine.h"
+#include "shared_session_store.h"
+#include "ws_server.h"
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+tank_sim::WsServer* g_server = nullptr;
+
+void handleSignal(int) {
+    if (g_server) {
+        g_server->stop();
+    }
+}
+
+[[noreturn]] void usage(const char* program) {
+    std::fprintf(stderr,
+                 "Usage: %s [--port N] [--threads N] [--tick SECONDS] [--max-sessions N]"
+                 " [--store /NAME] [--catch-up burst|skip|rebase] [--realtime CPU]"
+                 " [--speculate TICKS]\n",
+                 program);
+    std::exit(2);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    tank_sim::WsServer::Settings settings;
+    int max_sessions = tank_sim::constants::DEFAULT_ENGINE_MAX_SESSIONS;
+    int speculation_ticks = 0;
+    std::string store_name;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* flag = argv[i];
+        if (i + 1 >= argc) {
+            usage(argv[0]);
+        }
+        const char* value = argv[++i];
+        if (std::strcmp(flag, "--port") == 0) {
+            settings.port = std::atoi(value);
+        } else if (std::strcmp(flag, "--threads") == 0) {
+            settings.threads = std::atoi(value);
+        } else if (std::strcmp(flag, "--tick") == 0) {
+            settings.pacing.period = std::atof(value);
+        } else if (std::strcmp(flag, "--max-sessions") == 0) {
+            max_sessions = std::atoi(value);
+        } else if (std::strcmp(flag, "--store") == 0) {
+            store_name = value;
+        } else if (std::strcmp(flag, "--catch-up") == 0) {
+            try {
+                settings.pacing.catchUp = tank_sim::RealtimePacer::catchUpFromName(value);
+            } catch (const std::invalid_argument&) {
+                usage(argv[0]);
+            }
+        } else if (std::strcmp(flag, "--realtime") == 0) {
+            settings.pacing.realtime = true;
+            settings.pacing.cpu = std::atoi(value);
+        } else if (std::strcmp(flag, "--speculate") == 0) {
+            speculation_ticks = std::atoi(value);
+        } else {
+            usage(argv[0]);
+        }
+    }
+
+    try {
+        // Declared first: the engine releases its slots on destruction
+        std::unique_ptr<tank_sim::SharedSessionStore> store;
+        auto engine = std::make_unique<tank_sim::SessionEngine>(
+            tank_sim::defaultServerConfig(), max_sessions);
+        if (!store_name.empty()) {
+            store = std::make_unique<tank_sim::SharedSessionStore>(store_name, max_sessions);
+            store->reclaimDead();
+            engine->attachStore(store.get());
+        }
+        engine->enableSpeculation(speculation_ticks);
+        tank_sim::WsServer server(*engine, settings);
+
+        g_server = &server;
+        std::signal(SIGINT, handleSignal);
+        std::signal(SIGTERM, handleSignal);
+        std::printf("tank_ws_server listening on port %d\n", settings.port);
+        std::fflush(stdout);
+
+        server.run();
+
+        const auto stats = server.stats();
+        std::printf("frames sent %llu, dropped %llu, lost %llu\n",
+                    static_cast<unsigned long long>(stats.framesSent),
+                    static_cast<unsigned long long>(stats.framesDropped),
+                    static_cast<unsigned long long>(stats.framesLost));
+        const auto& pacing = server.pacingStats();
+        std::printf("tick lateness p99 %.0f us, max %.0f us, skipped %llu%s\n",
+                    pacing.percentileMicros(0.99), pacing.maxLatenessMicros,
+                    static_cast<unsigned long long>(pacing.skipped),
+                    pacing.realtime ? " (real-time)" : "");
+        if (speculation_ticks > 0) {
+            const auto speculation = engine->speculationStats();
+            std::printf("ticks served ahead %llu, discarded %llu\n",
+                        static_cast<unsigned long long>(speculation.servedTicks),
+                        static_cast<unsigned long long>(speculation.discardedTicks));
+        }
+        g_server = nullptr;
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "tank_ws_server: %s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
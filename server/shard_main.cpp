@@ -0,0 +1,130 @@
+// tank_engine_shard: one engine process behind a ShardRouter.
+//
+// Steps the sessions a router places on it and streams their frames back
+// over a Unix-domain socket; sessions move in and out of the process live
+// as the router migrates them. Start one per core and give the router
+// (e.g. the API with SIMULATION_ENGINE=sharded) the list of socket paths.
+// With --store, the shard's sessions are also exported to a
+// SharedSessionStore.
+//
+// --catch-up and --realtime CPU pace the engine thread and --speculate TICKS
+// computes sessions ahead, as in tank_ws_server.
+//
+// Usage: tank_engine_shard --socket PATH [--tick SECONDS] [--max-sessions N]
+//                          [--store /NAME] [--catch-up POLICY] [--realtime CPU]
+//                          [--speculate TICKS]
+
+#include "default_config.h"
+#include "engine_shard.h"
+#include "session_engine.h"
+#include "shared_session_store.h"
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+tank_sim::EngineShard* g_shard = nullptr;
+
+void handleSignal(int) {
+    if (g_shard) {
+        g_shard->stop();
+    }
+}
+
+[[noreturn]] void usage(const char* program) {
+    std::fprintf(stderr,
+                 "Usage: %s --socket PATH [--tick SECONDS] [--max-sessions N] [--store /NAME]"
+                 " [--catch-up burst|skip|rebase] [--realtime CPU] [--speculate TICKS]\n",
+                 program);
+    std::exit(2);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::string socket_path;
+    tank_sim::RealtimePacer::Settings pacing;
+    int max_sessions = tank_sim::constants::DEFAULT_ENGINE_MAX_SESSIONS;
+    int speculation_ticks = 0;
+    std::string store_name;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* flag = argv[i];
+        if (i + 1 >= argc) {
+            usage(argv[0]);
+        }
+        const char* value = argv[++i];
+        if (std::strcmp(flag, "--socket") == 0) {
+            socket_path = value;
+        } else if (std::strcmp(flag, "--tick") == 0) {
+            pacing.period = std::atof(value);
+        } else if (std::strcmp(flag, "--max-sessions") == 0) {
+            max_sessions = std::atoi(value);
+        } else if (std::strcmp(flag, "--store") == 0) {
+            store_name = value;
+        } else if (std::strcmp(flag, "--catch-up") == 0) {
+            try {
+                pacing.catchUp = tank_sim::RealtimePacer::catchUpFromName(value);
+            } catch (const std::invalid_argument&) {
+                usage(argv[0]);
+            }
+        } else if (std::strcmp(flag, "--realtime") == 0) {
+            pacing.realtime = true;
+            pacing.cpu = std::atoi(value);
+        } else if (std::strcmp(flag, "--speculate") == 0) {
+            speculation_ticks = std::atoi(value);
+        } else {
+            usage(argv[0]);
+        }
+    }
+    if (socket_path.empty()) {
+        usage(argv[0]);
+    }
+
+    try {
+        // Declared first: the engine releases its slots on destruction
+        std::unique_ptr<tank_sim::SharedSessionStore> store;
+        auto engine = std::make_unique<tank_sim::SessionEngine>(
+            tank_sim::defaultServerConfig(), max_sessions);
+        if (!store_name.empty()) {
+            store = std::make_unique<tank_sim::SharedSessionStore>(store_name, max_sessions);
+            store->reclaimDead();
+            engine->attachStore(store.get());
+        }
+        engine->enableSpeculation(speculation_ticks);
+        tank_sim::EngineShard shard(*engine, socket_path, pacing);
+
+        g_shard = &shard;
+        std::signal(SIGINT, handleSignal);
+        std::signal(SIGTERM, handleSignal);
+        std::printf("tank_engine_shard listening on %s\n", socket_path.c_str());
+        std::fflush(stdout);
+
+        shard.run();
+
+        std::printf("frames dropped %llu\n",
+                    static_cast<unsigned long long>(shard.framesDropped()));
+        const auto& stats = shard.pacingStats();
+        std::printf("tick lateness p99 %.0f us, max %.0f us, skipped %llu%s\n",
+                    stats.percentileMicros(0.99), stats.maxLatenessMicros,
+                    static_cast<unsigned long long>(stats.skipped),
+                    stats.realtime ? " (real-time)" : "");
+        if (speculation_ticks > 0) {
+            const auto speculation = engine->speculationStats();
+            std::printf("ticks served ahead %llu, discarded %llu\n",
+                        static_cast<unsigned long long>(speculation.servedTicks),
+                        static_cast<unsigned long long>(speculation.discardedTicks));
+        }
+        g_shard = nullptr;
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "tank_engine_shard: %s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
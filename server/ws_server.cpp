@@ -0,0 +1,585 @@
+#include "ws_server.h"
+#include "engine_thread.h"
+#include "frame_delta.h"
+#include "websocket_codec.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace tank_sim {
+
+namespace {
+
+constexpr int MAX_EVENTS = 256;
+constexpr int POLL_TIMEOUT_MS = 100;          ///< Bounds how long stop() takes
+constexpr std::size_t READ_CHUNK = 16 * 1024;
+constexpr std::size_t MAX_HANDSHAKE = 8 * 1024;
+constexpr std::size_t MAX_MESSAGE = 64 * 1024;
+constexpr std::size_t MAX_BACKLOG = 256 * 1024;   ///< Unsent replies before a client is cut off
+
+void check(bool ok, const char* what) {
+    if (!ok) {
+        throw std::runtime_error(std::string(what) + ": " + std::strerror(errno));
+    }
+}
+
+std::string jsonEscape(std::string_view text) {
+    std::string out;
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            out += ' ';
+        } else {
+            out += c;
+        }
+    }
+    return out;
+}
+
+std::string serverFrame(websocket::Opcode opcode, std::string_view payload) {
+    char header[websocket::MAX_SERVER_HEADER];
+    const std::size_t size = websocket::writeFrameHeader(header, opcode, payload.size());
+    std::string frame(header, size);
+    frame.append(payload.data(), payload.size());
+    return frame;
+}
+
+std::string errorFrame(std::string_view message) {
+    return serverFrame(websocket::Text,
+                       "{\"type\":\"error\",\"message\":\"" + jsonEscape(message) + "\"}");
+}
+
+}  // namespace
+
+// ============================================================================
+// Event loop: one thread, one epoll instance, one listening socket
+// ============================================================================
+
+class WsServer::EventLoop {
+public:
+    std::atomic<std::uint64_t> clients{0};
+    std::atomic<std::uint64_t> sent{0};
+    std::atomic<std::uint64_t> dropped{0};
+    std::atomic<std::uint64_t> lost{0};
+
+    EventLoop(SessionEngine& engine, int index, int port)
+        : engine_(engine), queue_(engine.addProducer()), index_(index), private_count_(0) {
+        epoll_ = epoll_create1(EPOLL_CLOEXEC);
+        check(epoll_ >= 0, "epoll_create1");
+
+        // Every loop listens on the same port; the kernel balances accepts
+        listen_ = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        check(listen_ >= 0, "socket");
+        const int one = 1;
+        setsockopt(listen_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        check(setsockopt(listen_, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one)) == 0,
+              "SO_REUSEPORT");
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_ANY);
+        address.sin_port = htons(static_cast<std::uint16_t>(port));
+        check(bind(listen_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0, "bind");
+        check(listen(listen_, SOMAXCONN) == 0, "listen");
+
+        watch(listen_, &listen_, EPOLLIN);
+        watch(wake_.fd(), &wake_, EPOLLIN);
+        cursor_ = engine_.frames().subscribe();
+    }
+
+    ~EventLoop() {
+        for (auto& entry : clients_) {
+            ::close(entry.first);
+        }
+        ::close(listen_);
+        ::close(epoll_);
+    }
+
+    /// Notified by the engine thread after each tick
+    TickSignal& signal() { return wake_; }
+
+    void run(const std::atomic<bool>& running) {
+        epoll_event events[MAX_EVENTS];
+        while (running.load(std::memory_order_acquire)) {
+            flushRequests();
+            const int count = epoll_wait(epoll_, events, MAX_EVENTS, POLL_TIMEOUT_MS);
+            for (int i = 0; i < count; ++i) {
+                void* tag = events[i].data.ptr;
+                if (tag == &listen_) {
+                    acceptClients();
+                } else if (tag == &wake_) {
+                    wake_.consume();
+                    forwardFrames();
+                } else {
+                    Client& client = *static_cast<Client*>(tag);
+                    if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+                        scheduleClose(client);
+                        continue;
+                    }
+                    if (events[i].events & EPOLLOUT) {
+                        flush(client);
+                    }
+                    if (events[i].events & (EPOLLIN | EPOLLRDHUP)) {
+                        receive(client);
+                    }
+                }
+            }
+            closeScheduled();
+        }
+    }
+
+private:
+    struct Client {
+        int fd;
+        bool open = false;        ///< Handshake done, subscribed to a session
+        bool closing = false;
+        bool writeArmed = false;  ///< EPOLLOUT requested
+        std::uint64_t sessionKey = 0;
+        std::size_t slot = 0;     ///< Index in the session's client list
+        std::string in;
+        std::string out;          ///< Bytes behind a partial write
+        std::size_t outOffset = 0;
+        std::string pending;      ///< Newest state frame waiting behind out
+        bool hasPending = false;
+        std::unique_ptr<DeltaEncoder> delta;  ///< Set for format=delta clients
+    };
+
+    SessionEngine& engine_;
+    SessionEngine::RequestQueue& queue_;
+    int index_;
+    int epoll_;
+    TickSignal wake_;
+    int listen_;
+    std::uint64_t private_count_;
+    SessionEngine::FrameRing::Cursor cursor_;
+    std::unordered_map<int, std::unique_ptr<Client>> clients_;
+    std::unordered_map<std::uint64_t, std::vector<Client*>> sessions_;
+    std::vector<SessionEngine::Request> backlog_;  ///< Requests the queue had no room for
+    std::vector<Client*> closing_;
+    std::string record_;   ///< Scratch for delta-encoded WebSocket frames
+
+    void watch(int fd, void* tag, std::uint32_t events) {
+        epoll_event event{};
+        event.events = events;
+        event.data.ptr = tag;
+        check(epoll_ctl(epoll_, EPOLL_CTL_ADD, fd, &event) == 0, "epoll_ctl");
+    }
+
+    void armWrite(Client& client, bool arm) {
+        if (client.writeArmed == arm) {
+            return;
+        }
+        epoll_event event{};
+        event.events = EPOLLIN | EPOLLRDHUP | (arm ? EPOLLOUT : 0u);
+        event.data.ptr = &client;
+        epoll_ctl(epoll_, EPOLL_CTL_MOD, client.fd, &event);
+        client.writeArmed = arm;
+    }
+
+    void request(SessionEngine::Request::Type type, std::uint64_t key,
+                 const OperatorCommand& command = OperatorCommand{}) {
+        const SessionEngine::Request r{type, key, command};
+        if (!backlog_.empty() || !queue_.tryPush(r)) {
+            backlog_.push_back(r);
+        }
+    }
+
+    void flushRequests() {
+        std::size_t done = 0;
+        while (done < backlog_.size() && queue_.tryPush(backlog_[done])) {
+            ++done;
+        }
+        backlog_.erase(backlog_.begin(), backlog_.begin() + static_cast<std::ptrdiff_t>(done));
+    }
+
+    void acceptClients() {
+        for (;;) {
+            const int fd = accept4(listen_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) {
+                return;  // EAGAIN, or a transient error such as EMFILE
+            }
+            const int one = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            auto client = std::make_unique<Client>();
+            client->fd = fd;
+            watch(fd, client.get(), EPOLLIN | EPOLLRDHUP);
+            clients_.emplace(fd, std::move(client));
+        }
+    }
+
+    // ------------------------------------------------------------------------
+    // Outgoing
+    // ------------------------------------------------------------------------
+
+    /**
+     * @brief Write bytes, queueing what the socket does not take.
+     *
+     * A state frame (conflate) that finds a backlog replaces the previous
+     * waiting state frame; other messages are appended, and a client whose
+     * backlog would pass MAX_BACKLOG (pings it never reads the pongs of)
+     * is closed.
+     */
+    void send(Client& client, std::string_view bytes, bool conflate) {
+        if (client.closing) {
+            return;
+        }
+        if (!client.out.empty()) {
+            if (conflate) {
+                if (client.hasPending) {
+                    dropped.fetch_add(1, std::memory_order_relaxed);
+                }
+                client.pending.assign(bytes.data(), bytes.size());
+                client.hasPending = true;
+            } else if (client.out.size() - client.outOffset + bytes.size() > MAX_BACKLOG) {
+                scheduleClose(client);
+            } else {
+                client.out.append(bytes.data(), bytes.size());
+            }
+            return;
+        }
+
+        const ssize_t n = ::send(client.fd, bytes.data(), bytes.size(), MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+            scheduleClose(client);
+            return;
+        }
+        if (conflate) {
+            sent.fetch_add(1, std::memory_order_relaxed);
+        }
+        const std::size_t written = n < 0 ? 0 : static_cast<std::size_t>(n);
+        if (written < bytes.size()) {
+            client.out.assign(bytes.data() + written, bytes.size() - written);
+            client.outOffset = 0;
+            armWrite(client, true);
+        }
+    }
+
+    void flush(Client& client) {
+        while (!client.closing) {
+            while (client.outOffset < client.out.size()) {
+                const ssize_t n = ::send(client.fd, client.out.data() + client.outOffset,
+                                         client.out.size() - client.outOffset,
+                                         MSG_NOSIGNAL | MSG_DONTWAIT);
+                if (n < 0) {
+                    if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                        scheduleClose(client);
+                    }
+                    return;
+                }
+                client.outOffset += static_cast<std::size_t>(n);
+            }
+            client.out.clear();
+            client.outOffset = 0;
+            if (!client.hasPending) {
+                break;
+            }
+            client.out.swap(client.pending);
+            client.hasPending = false;
+            sent.fetch_add(1, std::memory_order_relaxed);
+        }
+        armWrite(client, false);
+    }
+
+    void forwardFrames() {
+        SessionEngine::EncodedFrame frame;
+        for (;;) {
+            const std::uint64_t lost_before = cursor_.lost;
+            const auto status = engine_.frames().read(cursor_, frame);
+            if (status == SessionEngine::FrameRing::ReadStatus::Empty) {
+                break;
+            }
+            if (status == SessionEngine::FrameRing::ReadStatus::Overrun) {
+                lost.fetch_add(cursor_.lost - lost_before, std::memory_order_relaxed);
+                continue;
+            }
+            auto it = sessions_.find(frame.sessionKey);
+            if (it == sessions_.end()) {
+                continue;
+            }
+            const std::string_view bytes = frame.bytes();
+            for (Client* client : it->second) {
+                if (client->delta) {
+                    sendDelta(*client, frame.telemetry);
+                } else {
+                    send(*client, bytes, true);
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Send a state as a binary DeltaEncoder record.
+     *
+     * A backlogged client may have its waiting record replaced, so until
+     * the backlog drains it gets keyframes; the decoder never misses the
+     * reference of a delta.
+     */
+    void sendDelta(Client& client, const TelemetryFrame& telemetry) {
+        if (!client.out.empty()) {
+            client.delta->forceKeyframe();
+        }
+        const std::string_view record = client.delta->encode(telemetry);
+        char header[websocket::MAX_SERVER_HEADER];
+        const std::size_t header_size =
+            websocket::writeFrameHeader(header, websocket::Binary, record.size());
+        record_.assign(header, header_size);
+        record_.append(record.data(), record.size());
+        send(client, record_, true);
+    }
+
+    // ------------------------------------------------------------------------
+    // Incoming
+    // ------------------------------------------------------------------------
+
+    void receive(Client& client) {
+        char buffer[READ_CHUNK];
+        for (;;) {
+            const ssize_t n = recv(client.fd, buffer, sizeof(buffer), 0);
+            if (n == 0) {
+                scheduleClose(client);
+                return;
+            }
+            if (n < 0) {
+                if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                    scheduleClose(client);
+                }
+                break;
+            }
+            client.in.append(buffer, static_cast<std::size_t>(n));
+        }
+        if (!client.open) {
+            handshake(client);
+        }
+        if (client.open) {
+            processFrames(client);
+        }
+    }
+
+    void reject(Client& client, std::string_view status) {
+        const std::string response = "HTTP/1.1 " + std::string(status) +
+                                     "\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+        send(client, response, false);
+        scheduleClose(client);
+    }
+
+    void handshake(Client& client) {
+        const std::size_t end = client.in.find("\r\n\r\n");
+        if (end == std::string::npos) {
+            if (client.in.size() > MAX_HANDSHAKE) {
+                reject(client, "431 Request Header Fields Too Large");
+            }
+            return;
+        }
+
+        websocket::UpgradeRequest upgrade;
+        if (!websocket::parseUpgradeRequest(std::string_view(client.in).substr(0, end + 4),
+                                            upgrade)) {
+            reject(client, "400 Bad Request");
+            return;
+        }
+        if (upgrade.path != "/ws") {
+            reject(client, "404 Not Found");
+            return;
+        }
+        if (!upgrade.format.empty() && upgrade.format != "json" && upgrade.format != "delta") {
+            reject(client, "400 Bad Request");
+            return;
+        }
+        client.in.erase(0, end + 4);
+        send(client, websocket::upgradeResponse(upgrade.key), false);
+
+        // Private sessions get a name no shared session can have
+        const std::string name =
+            upgrade.session.empty()
+                ? "private:" + std::to_string(index_) + ":" + std::to_string(++private_count_)
+                : "shared:" + upgrade.session;
+        const std::uint64_t key = SessionEngine::sessionKey(name);
+        auto& subscribers = sessions_[key];
+        const bool creates = subscribers.empty();
+        if (creates && !engine_.reserveSession()) {
+            send(client,
+                 errorFrame("Maximum sessions (" + std::to_string(engine_.maxSessions()) +
+                            ") reached, rejecting connection"),
+                 false);
+            send(client, serverFrame(websocket::Close, std::string("\x03\xf0", 2)), false);
+            sessions_.erase(key);
+            scheduleClose(client);
+            return;
+        }
+
+        client.open = true;
+        if (upgrade.format == "delta") {
+            client.delta = std::make_unique<DeltaEncoder>();
+        }
+        client.sessionKey = key;
+        client.slot = subscribers.size();
+        subscribers.push_back(&client);
+        request(creates ? SessionEngine::Request::Type::ReservedJoin
+                        : SessionEngine::Request::Type::Join,
+                key);
+        clients.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void processFrames(Client& client) {
+        std::size_t pos = 0;
+        while (!client.closing) {
+            websocket::FrameInfo info;
+            const auto status =
+                websocket::parseClientFrame(client.in.data() + pos, client.in.size() - pos, info);
+            if (status == websocket::ParseStatus::Incomplete) {
+                break;
+            }
+            if (status == websocket::ParseStatus::Invalid || info.payloadSize > MAX_MESSAGE) {
+                closeWith(client, "\x03\xea");  // 1002 protocol error
+                break;
+            }
+            if (client.in.size() - pos < info.headerSize + info.payloadSize) {
+                break;
+            }
+
+            char* payload = &client.in[pos + info.headerSize];
+            const std::size_t size = static_cast<std::size_t>(info.payloadSize);
+            websocket::unmask(payload, size, info.mask);
+            pos += info.headerSize + size;
+
+            switch (info.opcode) {
+                case websocket::Text:
+                    if (!info.fin) {
+                        closeWith(client, "\x03\xef");  // 1007: fragmented messages unsupported
+                        break;
+                    }
+                    command(client, std::string_view(payload, size));
+                    break;
+                case websocket::Ping:
+                    send(client, serverFrame(websocket::Pong, std::string_view(payload, size)),
+                         false);
+                    break;
+                case websocket::Pong:
+                    break;
+                case websocket::Close:
+                    closeWith(client, "\x03\xe8");  // 1000 normal closure
+                    break;
+                default:
+                    closeWith(client, "\x03\xeb");  // 1003 unsupported data
+                    break;
+            }
+        }
+        client.in.erase(0, pos);
+    }
+
+    void command(Client& client, std::string_view text) {
+        OperatorCommand command;
+        std::string error;
+        if (!SessionEngine::parseClientMessage(text, command, error)) {
+            send(client, errorFrame(error), false);
+            return;
+        }
+        request(SessionEngine::Request::Type::Command, client.sessionKey, command);
+    }
+
+    void closeWith(Client& client, const char (&code)[3]) {
+        send(client, serverFrame(websocket::Close, std::string_view(code, 2)), false);
+        scheduleClose(client);
+    }
+
+    // ------------------------------------------------------------------------
+    // Teardown, deferred to the end of the event batch
+    // ------------------------------------------------------------------------
+
+    void scheduleClose(Client& client) {
+        if (!client.closing) {
+            client.closing = true;
+            closing_.push_back(&client);
+        }
+    }
+
+    void closeScheduled() {
+        for (Client* client : closing_) {
+            if (client->open) {
+                auto& subscribers = sessions_[client->sessionKey];
+                subscribers[client->slot] = subscribers.back();
+                subscribers[client->slot]->slot = client->slot;
+                subscribers.pop_back();
+                if (subscribers.empty()) {
+                    sessions_.erase(client->sessionKey);
+                }
+                request(SessionEngine::Request::Type::Leave, client->sessionKey);
+                clients.fetch_sub(1, std::memory_order_relaxed);
+            }
+            const int fd = client->fd;
+            epoll_ctl(epoll_, EPOLL_CTL_DEL, fd, nullptr);
+            ::close(fd);
+            clients_.erase(fd);
+        }
+        closing_.clear();
+    }
+};
+
+// ============================================================================
+// Server: engine thread plus the event loops
+// ============================================================================
+
+WsServer::WsServer(SessionEngine& engine, const Settings& settings)
+    : engine_(engine), settings_(settings), running_(false) {
+    RealtimePacer::validate(settings.pacing);
+    int threads = settings.threads > 0 ? settings.threads
+                                       : static_cast<int>(std::thread::hardware_concurrency());
+    threads = std::max(threads, 1);
+    for (int i = 0; i < threads; ++i) {
+        loops_.push_back(std::make_unique<EventLoop>(engine_, i, settings.port));
+    }
+}
+
+WsServer::~WsServer() = default;
+
+void WsServer::run() {
+    EngineThread ticker(engine_, settings_.pacing);
+    for (auto& loop : loops_) {
+        ticker.addSignal(loop->signal());
+    }
+
+    running_.store(true, std::memory_order_release);
+    std::vector<std::thread> threads;
+    for (auto& loop : loops_) {
+        threads.emplace_back([this, &loop]() { loop->run(running_); });
+    }
+    ticker.start();
+
+    // stop() may come from a signal handler, so it only clears the flag
+    while (running_.load(std::memory_order_acquire)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(POLL_TIMEOUT_MS));
+    }
+
+    ticker.stop();
+    pacing_stats_ = ticker.pacingStats();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+void WsServer::stop() { running_.store(false, std::memory_order_release); }
+
+WsServer::Stats WsServer::stats() const {
+    Stats total{0, 0, 0, 0};
+    for (const auto& loop : loops_) {
+        total.clients += loop->clients.load(std::memory_order_relaxed);
+        total.framesSent += loop->sent.load(std::memory_order_relaxed);
+        total.framesDropped += loop->dropped.load(std::memory_order_relaxed);
+        total.framesLost += loop->lost.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+}  // namespace tank_sim
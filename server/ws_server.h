@@ -0,0 +1,89 @@
+#ifndef TANK_SIM_WS_SERVER_H
+#define TANK_SIM_WS_SERVER_H
+
+#include "constants.h"
+#include "realtime_pacer.h"
+#include "session_engine.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace tank_sim {
+
+/**
+ * @brief Native WebSocket telemetry server in front of a SessionEngine.
+ *
+ * Serves the state-streaming part of the API's /ws protocol without
+ * Python: GET /ws (private session) and GET /ws?session=<name> (shared),
+ * state messages once per tick, and the setpoint, pid, inlet_flow and
+ * reset commands. FastAPI keeps serving config, health and history.
+ * With format=delta in the query a client gets the states as binary
+ * DeltaEncoder records (keyframes plus deltas) instead of JSON.
+ *
+ * Threads:
+ * - An EngineThread ticks the SessionEngine at the tick period and then
+ *   wakes every event loop through its TickSignal (one write per loop, not
+ *   per client).
+ * - One event-loop thread per core, each with its own epoll instance and
+ *   its own SO_REUSEPORT listening socket, so the kernel spreads accepts
+ *   and loops share nothing. A loop reads new frames from the engine's
+ *   BroadcastRing with its own cursor and writes each one, as is, to its
+ *   clients of that session; joins, leaves and commands go back through
+ *   the loop's own RequestQueue.
+ *
+ * A client whose socket is full keeps only the newest frame (conflation,
+ * as in the API's ClientMailbox) and the replaced frames are counted as
+ * dropped; a slow client never delays the engine or other clients.
+ */
+class WsServer {
+public:
+    struct Settings {
+        int port = constants::DEFAULT_WS_SERVER_PORT;
+        int threads = 0;           ///< Event loops; 0 = hardware_concurrency
+        RealtimePacer::Settings pacing;   ///< Engine tick period, catch-up, real time
+    };
+
+    /// Counters summed over all event loops
+    struct Stats {
+        std::uint64_t clients;       ///< Open WebSocket connections
+        std::uint64_t framesSent;    ///< Frames written or queued behind a partial write
+        std::uint64_t framesDropped; ///< Frames replaced before they were sent
+        std::uint64_t framesLost;    ///< Frames a loop missed by ring overrun
+    };
+
+    /**
+     * @throws std::invalid_argument if the pacing settings are invalid
+     * @throws std::runtime_error if a socket, epoll or eventfd call fails
+     */
+    WsServer(SessionEngine& engine, const Settings& settings);
+    ~WsServer();
+
+    WsServer(const WsServer&) = delete;
+    WsServer& operator=(const WsServer&) = delete;
+
+    /// Serve until stop(); blocks the calling thread
+    void run();
+
+    /// Ask run() to return; safe from any thread or a signal handler
+    void stop();
+
+    Stats stats() const;
+
+    /// Tick lateness of the last run(); read after run() returns
+    const RealtimePacer::Stats& pacingStats() const { return pacing_stats_; }
+
+private:
+    class EventLoop;
+
+    SessionEngine& engine_;
+    Settings settings_;
+    RealtimePacer::Stats pacing_stats_;
+    std::vector<std::unique_ptr<EventLoop>> loops_;
+    std::atomic<bool> running_;
+};
+
+}  // namespace tank_sim
+
+#endif  // TANK_SIM_WS_SERVER_H
@@ -0,0 +1,124 @@
+#include "alarm_evaluator.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+namespace tank_sim {
+
+AlarmEvaluator::AlarmEvaluator(const std::vector<Alarm>& alarms, int event_capacity)
+    : event_head_(0), event_count_(0), dropped_(0) {
+    if (event_capacity < 1) {
+        throw std::invalid_argument("Alarm event capacity must be at least 1");
+    }
+
+    const size_t n = alarms.size();
+    sign_.reserve(n);
+    rate_.reserve(n);
+    on_threshold_.reserve(n);
+    off_threshold_.reserve(n);
+    on_delay_.reserve(n);
+    off_delay_.reserve(n);
+
+    for (size_t i = 0; i < n; ++i) {
+        const Alarm& alarm = alarms[i];
+
+        // Validate limits and delays - fail fast
+        if (alarm.deadband < 0.0 || alarm.onDelay < 0.0 || alarm.offDelay < 0.0) {
+            throw std::invalid_argument("Alarm " + std::to_string(i) +
+                                        " deadband and delays must be non-negative");
+        }
+        if (alarm.type == Type::RateOfChange && alarm.limit <= 0.0) {
+            throw std::invalid_argument("Alarm " + std::to_string(i) +
+                                        " rate-of-change limit must be positive");
+        }
+
+        // Mirror Low alarms so that "value > threshold" means abnormal
+        const double sign = alarm.type == Type::Low ? -1.0 : 1.0;
+        sign_.push_back(sign);
+        rate_.push_back(alarm.type == Type::RateOfChange ? 1.0 : 0.0);
+        on_threshold_.push_back(sign * alarm.limit);
+        off_threshold_.push_back(sign * alarm.limit - alarm.deadband);
+        on_delay_.push_back(alarm.onDelay);
+        off_delay_.push_back(alarm.offDelay);
+    }
+
+    previous_.assign(n, 0.0);
+    on_timer_.assign(n, 0.0);
+    off_timer_.assign(n, 0.0);
+    active_.assign(n, 0);
+    events_.resize(event_capacity);
+}
+
+void AlarmEvaluator::reset(const std::vector<double>& values, double time) {
+    for (size_t i = 0; i < active_.size(); ++i) {
+        if (active_[i]) {
+            pushEvent(AlarmEvent{static_cast<int>(i), false, time, values[i]});
+        }
+    }
+    previous_ = values;
+    std::fill(on_timer_.begin(), on_timer_.end(), 0.0);
+    std::fill(off_timer_.begin(), off_timer_.end(), 0.0);
+    std::fill(active_.begin(), active_.end(), 0);
+}
+
+void AlarmEvaluator::restore(const std::vector<double>& values, std::uint64_t active) {
+    previous_ = values;
+    std::fill(on_timer_.begin(), on_timer_.end(), 0.0);
+    std::fill(off_timer_.begin(), off_timer_.end(), 0.0);
+    for (size_t i = 0; i < active_.size(); ++i) {
+        active_[i] = i < 64 && ((active >> i) & 1u) != 0 ? 1 : 0;
+    }
+}
+
+void AlarmEvaluator::evaluate(const std::vector<double>& values, double time, double dt) {
+    const double half_step = 0.5 * dt;
+    const size_t n = active_.size();
+    for (size_t i = 0; i < n; ++i) {
+        // Rate alarms see |dv/dt|, level alarms the (mirrored) value
+        const double value = values[i];
+        const double rate = std::abs(value - previous_[i]) / dt;
+        previous_[i] = value;
+        const double x = rate_[i] * rate + (1.0 - rate_[i]) * sign_[i] * value;
+
+        const bool raise = x > on_threshold_[i];
+        const bool clear = x < off_threshold_[i];
+        on_timer_[i] = raise ? on_timer_[i] + dt : 0.0;
+        off_timer_[i] = clear ? off_timer_[i] + dt : 0.0;
+
+        const bool was_active = active_[i] != 0;
+        const bool now_active =
+            was_active ? !(clear && off_timer_[i] + half_step >= off_delay_[i])
+                       : raise && on_timer_[i] + half_step >= on_delay_[i];
+        if (now_active != was_active) {
+            active_[i] = now_active;
+            pushEvent(AlarmEvent{static_cast<int>(i), now_active, time,
+                                 rate_[i] != 0.0 ? rate : value});
+        }
+    }
+}
+
+int AlarmEvaluator::drainEvents(std::vector<AlarmEvent>& out) {
+    const int drained = event_count_;
+    const int capacity = static_cast<int>(events_.size());
+    for (int k = 0; k < drained; ++k) {
+        out.push_back(events_[(event_head_ + k) % capacity]);
+    }
+    event_head_ = 0;
+    event_count_ = 0;
+    return drained;
+}
+
+void AlarmEvaluator::pushEvent(const AlarmEvent& event) {
+    const int capacity = static_cast<int>(events_.size());
+    if (event_count_ == capacity) {
+        // Overwrite the oldest event
+        event_head_ = (event_head_ + 1) % capacity;
+        --event_count_;
+        ++dropped_;
+    }
+    events_[(event_head_ + event_count_) % capacity] = event;
+    ++event_count_;
+}
+
+}  // namespace tank_sim
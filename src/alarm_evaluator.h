@@ -0,0 +1,139 @@
+#ifndef TANK_SIM_ALARM_EVALUATOR_H
+#define TANK_SIM_ALARM_EVALUATOR_H
+
+#include "constants.h"
+#include "control_graph.h"
+#include <cstdint>
+#include <vector>
+
+namespace tank_sim {
+
+/**
+ * @brief One alarm state transition.
+ */
+struct AlarmEvent {
+    int alarm;      ///< Index of the alarm in the configuration
+    bool active;    ///< true = raised, false = cleared
+    double time;    ///< Simulation time of the transition (s)
+    double value;   ///< Evaluated value (signal, or |rate| for rate alarms)
+};
+
+/**
+ * @brief Limit alarms with deadband and on/off delays.
+ *
+ * Each alarm watches one signal against one limit:
+ *
+ * - High:         raised when value > limit, cleared when value < limit - deadband
+ * - Low:          raised when value < limit, cleared when value > limit + deadband
+ * - RateOfChange: raised when |dvalue/dt| > limit, cleared when
+ *                 |dvalue/dt| < limit - deadband
+ *
+ * A condition must hold for onDelay seconds before the alarm is raised and
+ * the clear condition for offDelay seconds before it is cleared (delays are
+ * rounded to the nearest whole step). This suppresses chattering on noisy
+ * signals.
+ *
+ * Alarm parameters are stored as parallel arrays with Low alarms mirrored
+ * (value and limits negated) so every alarm runs the same comparisons;
+ * evaluate() takes a branch only when an alarm changes state. Transitions
+ * are appended to a fixed-capacity event ring, oldest first, and read with
+ * drainEvents(); when a consumer falls behind the oldest events are dropped
+ * and counted.
+ */
+class AlarmEvaluator {
+public:
+    enum class Type { High, Low, RateOfChange };
+
+    /**
+     * @brief Configuration of one alarm.
+     */
+    struct Alarm {
+        SignalRef signal;       ///< Watched signal (resolved by the owner)
+        Type type;
+        double limit;           ///< Trip limit (units of the signal, or per second)
+        double deadband = 0.0;  ///< Clear hysteresis (same units as limit)
+        double onDelay = 0.0;   ///< Seconds the condition must persist to raise
+        double offDelay = 0.0;  ///< Seconds the clear condition must persist
+    };
+
+    /**
+     * @brief Construct an evaluator for a set of alarms.
+     *
+     * @param alarms Alarm configurations; events refer to them by index
+     * @param event_capacity Events retained between drains
+     *
+     * @throws std::invalid_argument if a deadband or delay is negative, a
+     *         rate limit is not positive, or event_capacity < 1
+     */
+    explicit AlarmEvaluator(const std::vector<Alarm>& alarms,
+                            int event_capacity = constants::DEFAULT_ALARM_EVENT_CAPACITY);
+
+    /**
+     * @brief Clear all alarms and timers, and take values as the previous
+     * sample for rate alarms.
+     *
+     * Active alarms emit a clear event, so event subscribers stay in step.
+     *
+     * @param values One value per alarm (the alarm's signal)
+     * @param time Simulation time after the reset (s)
+     */
+    void reset(const std::vector<double>& values, double time);
+
+    /**
+     * @brief Continue with the given alarms active, without events.
+     *
+     * For restoring a snapshot: bit i of active sets alarm i (the first
+     * 64 alarms); delay timers restart.
+     *
+     * @param values One value per alarm, the reference for rate alarms
+     */
+    void restore(const std::vector<double>& values, std::uint64_t active);
+
+    /**
+     * @brief Evaluate all alarms at the end of a time step.
+     *
+     * @param values One value per alarm (the alarm's signal)
+     * @param time Simulation time of the sample (s)
+     * @param dt Time since the previous sample (s)
+     */
+    void evaluate(const std::vector<double>& values, double time, double dt);
+
+    /**
+     * @brief Move pending events to out (appended, oldest first).
+     *
+     * @return Number of events appended
+     */
+    int drainEvents(std::vector<AlarmEvent>& out);
+
+    bool isActive(int alarm) const { return active_[alarm] != 0; }
+    int size() const { return static_cast<int>(active_.size()); }
+    int pendingEvents() const { return event_count_; }
+    long long droppedEvents() const { return dropped_; }
+
+private:
+    void pushEvent(const AlarmEvent& event);
+
+    // Per-alarm parameters (Low alarms mirrored)
+    std::vector<double> sign_;          ///< -1 for Low, +1 otherwise
+    std::vector<double> rate_;          ///< 1 for rate alarms, 0 otherwise
+    std::vector<double> on_threshold_;
+    std::vector<double> off_threshold_;
+    std::vector<double> on_delay_;
+    std::vector<double> off_delay_;
+
+    // Per-alarm state
+    std::vector<double> previous_;
+    std::vector<double> on_timer_;
+    std::vector<double> off_timer_;
+    std::vector<std::uint8_t> active_;
+
+    // Event ring
+    std::vector<AlarmEvent> events_;
+    int event_head_;    ///< Index of the oldest pending event
+    int event_count_;
+    long long dropped_;
+};
+
+}  // namespace tank_sim
+
+#endif  // TANK_SIM_ALARM_EVALUATOR_H
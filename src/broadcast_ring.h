@@ -0,0 +1,171 @@
+#ifndef TANK_SIM_BROADCAST_RING_H
+#define TANK_SIM_BROADCAST_RING_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace tank_sim {
+
+/**
+ * @brief Single-producer, multi-consumer broadcast ring.
+ *
+ * Every consumer sees every published value, in order, until it falls more
+ * than N values behind. The producer never waits for consumers and does not
+ * know how many there are: each consumer keeps its own Cursor, so adding a
+ * consumer costs the producer nothing.
+ *
+ * Each slot carries a sequence number in the style of SeqLock: 2k+1 while
+ * value k is being written into it, 2k+2 once it is complete. A consumer
+ * that expects value k checks the slot's sequence before and after copying;
+ * any other sequence means the producer has lapped it. The cursor then
+ * jumps to the oldest value still in the ring and the number of skipped
+ * values is added to Cursor::lost (an overrun), so a slow consumer loses
+ * data instead of stalling the producer.
+ *
+ * Payloads are stored as relaxed atomic 64-bit words, as in SeqLock.
+ *
+ * @tparam T Trivially copyable value
+ * @tparam N Capacity, a power of two
+ */
+template <typename T, std::size_t N>
+class BroadcastRing {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "Broadcast payload must be trivially copyable");
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "Broadcast ring capacity must be a power of two");
+
+public:
+    /**
+     * @brief Read position of one consumer.
+     */
+    struct Cursor {
+        std::uint64_t next = 0;  ///< Sequence number of the next value to read
+        std::uint64_t lost = 0;  ///< Values skipped because of overruns
+    };
+
+    enum class ReadStatus {
+        Ok,       ///< A value was copied and the cursor advanced
+        Empty,    ///< No new value yet
+        Overrun   ///< Cursor was lapped; it now points at the oldest value
+    };
+
+    BroadcastRing() : head_(0) {
+        for (auto& slot : slots_) {
+            slot.sequence.store(0, std::memory_order_relaxed);
+            for (auto& word : slot.words) {
+                word.store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    BroadcastRing(const BroadcastRing&) = delete;
+    BroadcastRing& operator=(const BroadcastRing&) = delete;
+
+    /**
+     * @brief Append a value (producer thread only). Never blocks.
+     */
+    void publish(const T& value) {
+        std::array<std::uint64_t, WORDS> buffer{};
+        std::memcpy(buffer.data(), &value, sizeof(T));
+
+        const std::uint64_t index = head_.load(std::memory_order_relaxed);
+        Slot& slot = slots_[index & (N - 1)];
+        slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (std::size_t i = 0; i < WORDS; ++i) {
+            slot.words[i].store(buffer[i], std::memory_order_relaxed);
+        }
+        slot.sequence.store(2 * index + 2, std::memory_order_release);
+        head_.store(index + 1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Cursor positioned after the latest value (only new values).
+     */
+    Cursor subscribe() const {
+        Cursor cursor;
+        cursor.next = head_.load(std::memory_order_acquire);
+        return cursor;
+    }
+
+    /**
+     * @brief Cursor positioned at the oldest value still in the ring.
+     */
+    Cursor subscribeOldest() const {
+        Cursor cursor;
+        cursor.next = oldest(head_.load(std::memory_order_acquire));
+        return cursor;
+    }
+
+    /**
+     * @brief Copy the value at the cursor and advance it (consumer's thread).
+     *
+     * On Overrun the cursor has been moved to the oldest retained value and
+     * cursor.lost updated; call again to continue reading.
+     */
+    ReadStatus read(Cursor& cursor, T& out) const {
+        const std::uint64_t head = head_.load(std::memory_order_acquire);
+        if (cursor.next >= head) {
+            return ReadStatus::Empty;
+        }
+        if (head - cursor.next > N - 1) {
+            skipTo(cursor, oldest(head));
+            return ReadStatus::Overrun;
+        }
+
+        const Slot& slot = slots_[cursor.next & (N - 1)];
+        const std::uint64_t expected = 2 * cursor.next + 2;
+        std::array<std::uint64_t, WORDS> buffer;
+        if (slot.sequence.load(std::memory_order_acquire) == expected) {
+            for (std::size_t i = 0; i < WORDS; ++i) {
+                buffer[i] = slot.words[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) == expected) {
+                std::memcpy(&out, buffer.data(), sizeof(T));
+                ++cursor.next;
+                return ReadStatus::Ok;
+            }
+        }
+
+        // The producer reused the slot while we were reading it
+        skipTo(cursor, oldest(head_.load(std::memory_order_acquire)));
+        return ReadStatus::Overrun;
+    }
+
+    /**
+     * @brief Number of values published so far.
+     */
+    std::uint64_t published() const { return head_.load(std::memory_order_acquire); }
+
+    static constexpr std::size_t capacity() { return N; }
+
+private:
+    static constexpr std::size_t WORDS = (sizeof(T) + 7) / 8;
+
+    struct Slot {
+        std::atomic<std::uint64_t> sequence;
+        std::array<std::atomic<std::uint64_t>, WORDS> words;
+    };
+
+    // The slot of value head - N is the one the producer writes next, so
+    // only the last N - 1 values are safe to read.
+    static std::uint64_t oldest(std::uint64_t head) { return head > N - 1 ? head - (N - 1) : 0; }
+
+    static void skipTo(Cursor& cursor, std::uint64_t next) {
+        if (next > cursor.next) {
+            cursor.lost += next - cursor.next;
+            cursor.next = next;
+        }
+    }
+
+    alignas(64) std::atomic<std::uint64_t> head_;
+    alignas(64) std::array<Slot, N> slots_;
+};
+
+}  // namespace tank_sim
+
+#endif  // TANK_SIM_BROADCAST_RING_H
@@ -96,6 +96,16 @@ constexpr double TANK_NOMINAL_HEIGHT = 2.5;
  */
 constexpr double GRAVITY = 9.81;
 
+/**
+ * @brief Level floor used when linearizing the valve equation
+ *
+ * Unit: m
+ * d(sqrt(h))/dh = 1 / (2 sqrt(h)) is unbounded as h -> 0. Analytic Jacobians
+ * (TankModel::stateJacobian) evaluate the slope at max(h, this value) so that
+ * linear predictions and state estimators stay finite near an empty tank.
+ */
+constexpr double JACOBIAN_MIN_LEVEL = 1e-3;
+
 // ============================================================================
 // INTEGRATION PARAMETERS (RK4 Stepper)
 // ============================================================================
@@ -231,6 +241,481 @@ constexpr double DEFAULT_PID_MAX_INTEGRAL = 10.0;
  */
 constexpr double DEFAULT_PID_DT = 1.0;
 
+// ============================================================================
+// MODEL PREDICTIVE CONTROL
+// ============================================================================
+
+/**
+ * @brief Default MPC prediction horizon
+ *
+ * Unit: steps
+ * Number of future samples the linearized tank model is predicted over.
+ * At dt = 1 s this covers about one closed-loop settling period.
+ */
+constexpr int DEFAULT_MPC_HORIZON = 30;
+
+/**
+ * @brief Default MPC control horizon (number of free moves)
+ *
+ * Unit: steps
+ * Moves after the control horizon are held at the last free move (move
+ * blocking), which keeps the QP at this many decision variables.
+ */
+constexpr int DEFAULT_MPC_CONTROL_HORIZON = 5;
+
+/**
+ * @brief Default weight on squared level error in the MPC cost
+ *
+ * Unit: 1/m²
+ */
+constexpr double DEFAULT_MPC_OUTPUT_WEIGHT = 1.0;
+
+/**
+ * @brief Default weight on squared output moves in the MPC cost
+ *
+ * Unitless (output is a normalized valve position)
+ * Larger values give smoother, slower valve action.
+ */
+constexpr double DEFAULT_MPC_MOVE_WEIGHT = 0.05;
+
+/**
+ * @brief Default ADMM penalty parameter for the MPC QP solver
+ *
+ * Unitless
+ */
+constexpr double DEFAULT_MPC_ADMM_RHO = 0.1;
+
+/**
+ * @brief Default maximum ADMM iterations per MPC solve
+ */
+constexpr int DEFAULT_MPC_MAX_ITERATIONS = 200;
+
+/**
+ * @brief Default ADMM convergence tolerance (primal and dual residuals)
+ *
+ * Unit: output units (valve position)
+ */
+constexpr double DEFAULT_MPC_TOLERANCE = 1e-6;
+
+// ============================================================================
+// STATE ESTIMATION
+// ============================================================================
+
+/**
+ * @brief Default process noise variance of the level estimator
+ *
+ * Unit: m² per sample
+ * Models unmeasured inflow disturbances. Larger values make the filter
+ * trust the sensor more and the model less.
+ */
+constexpr double DEFAULT_ESTIMATOR_PROCESS_NOISE = 1e-6;
+
+/**
+ * @brief Default measurement noise variance of the level estimator
+ *
+ * Unit: m²
+ * Matches a level transmitter with about 1 cm standard deviation.
+ */
+constexpr double DEFAULT_ESTIMATOR_MEASUREMENT_NOISE = 1e-4;
+
+/**
+ * @brief Default initial variance of the level estimate
+ *
+ * Unit: m²
+ */
+constexpr double DEFAULT_ESTIMATOR_INITIAL_VARIANCE = 1e-2;
+
+// ============================================================================
+// ONLINE IDENTIFICATION
+// ============================================================================
+
+/**
+ * @brief Default RLS forgetting factor
+ *
+ * Unitless, in (0, 1]
+ * Memory of about 1 / (1 - lambda) = 500 samples, long enough to average
+ * sensor noise and short enough to follow a fouling valve.
+ */
+constexpr double DEFAULT_RLS_FORGETTING_FACTOR = 0.998;
+
+/**
+ * @brief Default prior variance of each RLS parameter
+ *
+ * Unit: (1/m²)² for 1/A and (m^0.5/s)² for k_v/A
+ * Both parameters are O(1e-2) for the default tank, but the slope
+ * observations are O(1e-3), so a loose prior is needed for the data to
+ * dominate within a few hundred samples.
+ */
+constexpr double DEFAULT_RLS_INITIAL_COVARIANCE = 1.0;
+
+/**
+ * @brief Default upper bound on the trace of the RLS covariance
+ *
+ * Limits covariance windup while the plant sits at steady state.
+ */
+constexpr double DEFAULT_RLS_MAX_COVARIANCE_TRACE = 10.0;
+
+// ============================================================================
+// PARAMETER ESTIMATION (Offline Calibration)
+// ============================================================================
+
+/**
+ * @brief Default Levenberg-Marquardt accepted-step limit
+ */
+constexpr int DEFAULT_LM_MAX_ITERATIONS = 100;
+
+/**
+ * @brief Default Levenberg-Marquardt convergence tolerance
+ *
+ * Unitless: applied to the log-parameter step and to the relative cost
+ * decrease of an accepted step.
+ */
+constexpr double DEFAULT_LM_TOLERANCE = 1e-10;
+
+/**
+ * @brief Default initial Levenberg-Marquardt damping
+ *
+ * Unitless, relative to diag(J'J). Small values start close to Gauss-Newton.
+ */
+constexpr double DEFAULT_LM_INITIAL_DAMPING = 1e-3;
+
+// ============================================================================
+// CONTROL PERFORMANCE INDICES
+// ============================================================================
+
+/**
+ * @brief Default settling band as a fraction of the setpoint step
+ *
+ * Unitless (2% criterion)
+ */
+constexpr double DEFAULT_SETTLING_BAND = 0.02;
+
+/**
+ * @brief Default rise-time thresholds as fractions of the setpoint step
+ *
+ * Unitless (10% to 90% rise time)
+ */
+constexpr double DEFAULT_RISE_LOW = 0.1;
+constexpr double DEFAULT_RISE_HIGH = 0.9;
+
+// ============================================================================
+// LOOP HEALTH MONITORING
+// ============================================================================
+
+/**
+ * @brief Samples in the sliding spectral and autocovariance window
+ *
+ * At dt = 1 s this resolves oscillation periods up to about 4 minutes.
+ */
+constexpr int DEFAULT_HEALTH_WINDOW = 256;
+
+/**
+ * @brief Oscillation periods averaged for the zero-crossing regularity
+ */
+constexpr int DEFAULT_HEALTH_CROSSINGS = 8;
+
+/**
+ * @brief Error hysteresis for zero crossings and quiet-signal threshold
+ *
+ * Units: measured-variable units (m for level loops)
+ */
+constexpr double DEFAULT_HEALTH_NOISE_BAND = 0.005;
+
+/**
+ * @brief Regularity factor above which crossings are periodic
+ *
+ * r = mean(T) / (3 std(T)); r > 1 is the usual oscillation criterion.
+ */
+constexpr double DEFAULT_HEALTH_REGULARITY_THRESHOLD = 1.0;
+
+/**
+ * @brief Share of window variance in the spectral peak for an oscillation
+ */
+constexpr double DEFAULT_HEALTH_SPECTRAL_THRESHOLD = 0.5;
+
+/**
+ * @brief AR model order of the Harris index fit
+ */
+constexpr int DEFAULT_HEALTH_AR_ORDER = 10;
+
+/**
+ * @brief Process delay in samples for the minimum-variance benchmark
+ *
+ * A sampled loop with a zero-order hold has at least one sample of delay.
+ */
+constexpr int DEFAULT_HEALTH_DELAY = 1;
+
+/**
+ * @brief Harris index below which a loop is flagged as performing poorly
+ */
+constexpr double DEFAULT_HEALTH_HARRIS_THRESHOLD = 0.3;
+
+/**
+ * @brief Pole radius of the sliding DFT
+ *
+ * Slightly below 1 so rounding errors decay instead of accumulating.
+ */
+constexpr double SLIDING_DFT_DAMPING = 0.99999;
+
+// ============================================================================
+// ALARMS
+// ============================================================================
+
+/**
+ * @brief Alarm events retained between drains
+ *
+ * Older events are dropped (and counted) when a consumer falls behind.
+ */
+constexpr int DEFAULT_ALARM_EVENT_CAPACITY = 1024;
+
+// ============================================================================
+// TELEMETRY
+// ============================================================================
+
+/**
+ * @brief Controllers carried in a TelemetryFrame
+ *
+ * Keeps the frame fixed-size; further loops are read with the per-index
+ * getters.
+ */
+constexpr int MAX_TELEMETRY_LOOPS = 8;
+
+/**
+ * @brief Frames retained in a simulator's telemetry broadcast ring
+ *
+ * Must be a power of two. A consumer more than this many steps behind
+ * skips ahead and counts the lost frames.
+ */
+constexpr int TELEMETRY_RING_CAPACITY = 128;
+
+// ============================================================================
+// OPERATOR COMMAND QUEUE
+// ============================================================================
+
+/**
+ * @brief Capacity of the operator command ring and of the result ring
+ *
+ * Must be a power of two. Operator actions arrive at human rates, so a
+ * full ring means the stepping thread has stalled.
+ */
+constexpr int COMMAND_QUEUE_CAPACITY = 256;
+
+// ============================================================================
+// DELTA-ENCODED FRAMES
+// ============================================================================
+
+/**
+ * @brief Frames between keyframes in a delta-encoded stream
+ *
+ * A client that joins or loses a frame recovers at the next keyframe;
+ * at 1 Hz the default bounds that to one minute.
+ */
+constexpr int DEFAULT_KEYFRAME_INTERVAL = 60;
+
+/**
+ * @brief Quantization step of delta-encoded values
+ *
+ * Decoded values are within half a step of the true ones. 1e-6 is far
+ * below what the trends can show in m, m³/s or valve fraction.
+ */
+constexpr double DEFAULT_DELTA_QUANTUM = 1e-6;
+
+// ============================================================================
+// SESSION ENGINE AND NATIVE TELEMETRY SERVER
+// ============================================================================
+
+/**
+ * @brief Encoded frames retained by a SessionEngine
+ *
+ * Must be a power of two. Every session publishes one frame per tick, so
+ * this bounds the sessions a reader can keep up with per tick.
+ */
+constexpr int ENGINE_FRAME_RING_CAPACITY = 8192;
+
+/**
+ * @brief Capacity of each producer's join/leave/command queue to the engine
+ *
+ * Must be a power of two.
+ */
+constexpr int ENGINE_REQUEST_QUEUE_CAPACITY = 4096;
+
+/**
+ * @brief Default limit on simulations owned by one SessionEngine
+ */
+constexpr int DEFAULT_ENGINE_MAX_SESSIONS = 1000;
+
+/**
+ * @brief Slowest session speed factor (simulation seconds per dt of wall time)
+ *
+ * Slower requests are clamped up to it; at 0.01 a session steps once every
+ * 100 ticks.
+ */
+constexpr double MIN_SESSION_SPEED = 0.01;
+
+/**
+ * @brief Most simulator steps one session may take in one engine tick
+ *
+ * Caps fast-forward ("as fast as possible" runs exactly this many), so a
+ * single session cannot stall the tick for every other one. At dt = 1 s
+ * this is an hour of simulated time per tick.
+ */
+constexpr int ENGINE_MAX_STEPS_PER_TICK = 3600;
+
+/**
+ * @brief Most ticks a SessionEngine may compute a session ahead
+ *
+ * Each buffered tick holds one TelemetryFrame and one SimulatorSnapshot
+ * (about 1.7 KB together), so this bounds speculation memory at about
+ * 1 MB per session.
+ */
+constexpr int MAX_ENGINE_SPECULATION_TICKS = 600;
+
+/**
+ * @brief Simulator steps per SessionEngine::speculate() call
+ *
+ * The engine thread checks its idle-time budget between calls.
+ */
+constexpr int ENGINE_SPECULATION_CHUNK_STEPS = 1000;
+
+/**
+ * @brief Share of the tick period the engine thread may spend speculating
+ *
+ * The rest of the period stays idle, so a burst of commands (which
+ * discard speculative work) does not find the thread busy.
+ */
+constexpr double ENGINE_SPECULATION_IDLE_SHARE = 0.5;
+
+/**
+ * @brief Default TCP port of the native WebSocket telemetry server
+ *
+ * FastAPI keeps port 8000 for config and health.
+ */
+constexpr int DEFAULT_WS_SERVER_PORT = 8001;
+
+// ============================================================================
+// SHARED-MEMORY SESSION STORE
+// ============================================================================
+
+/**
+ * @brief History samples kept per session in the shared-memory store
+ *
+ * Must be a power of two. 8192 samples cover the API's two-hour history at
+ * 1 Hz; at 64 bytes per sample a slot needs about 512 KiB of shared memory.
+ */
+constexpr int SESSION_STORE_HISTORY_CAPACITY = 8192;
+
+/**
+ * @brief Layout version of the shared-memory store
+ *
+ * Bump when the segment layout changes so processes built from different
+ * versions refuse to attach to each other's segments.
+ */
+constexpr int SESSION_STORE_VERSION = 1;
+
+// ============================================================================
+// STATE SNAPSHOTS AND ENGINE SHARDS
+// ============================================================================
+
+/**
+ * @brief Controllers carried in a SimulatorSnapshot
+ *
+ * Keeps the snapshot fixed-size (about 1.3 KiB); simulators with more
+ * loops cannot be snapshotted.
+ */
+constexpr int MAX_SNAPSHOT_LOOPS = 16;
+
+/**
+ * @brief Alarms whose active state a SimulatorSnapshot carries
+ *
+ * One bit each; simulators with more alarms cannot be snapshotted.
+ */
+constexpr int MAX_SNAPSHOT_ALARMS = 64;
+
+/**
+ * @brief Points per shard on the consistent-hash ring
+ *
+ * More points spread sessions more evenly across shards; adding or
+ * removing a shard moves only about 1/N of the sessions either way.
+ */
+constexpr int SHARD_RING_REPLICAS = 128;
+
+/**
+ * @brief Largest message on a shard socket (bytes)
+ *
+ * Comfortably above an encoded state frame and a session transfer.
+ */
+constexpr int SHARD_MAX_MESSAGE_SIZE = 16384;
+
+/**
+ * @brief Output a shard buffers for a stalled router before dropping frames
+ *
+ * Frames are dropped, never transfers: a router that catches up gets the
+ * next tick's frames and never a gap in a migration.
+ */
+constexpr int SHARD_MAX_PENDING_BYTES = 8 * 1024 * 1024;
+
+// ============================================================================
+// SESSION CHECKPOINTS
+// ============================================================================
+
+/**
+ * @brief History samples kept per session in a checkpoint
+ *
+ * The API's two-hour history at 1 Hz; older samples are dropped on write.
+ */
+constexpr int CHECKPOINT_HISTORY_CAPACITY = 7200;
+
+/**
+ * @brief Upper bound on checkpoint encoder threads
+ *
+ * Encoding is CPU-bound; beyond a handful of cores the single file write
+ * dominates.
+ */
+constexpr int CHECKPOINT_MAX_THREADS = 8;
+
+// ============================================================================
+// REAL-TIME PACING
+// ============================================================================
+
+/**
+ * @brief Late ticks run back to back before a Burst pacer starts skipping
+ *
+ * Bounds the catch-up after a long stall (e.g. a suspended process) to a
+ * few periods of simulated time.
+ */
+constexpr int PACER_MAX_BURST = 10;
+
+/**
+ * @brief Buckets of the tick lateness histogram
+ *
+ * Bucket 0 counts ticks less than 1 us late, bucket b ticks in
+ * [2^(b-1), 2^b) us, and the last bucket everything later (over ~4 s).
+ */
+constexpr int PACER_LATENESS_BUCKETS = 24;
+
+/**
+ * @brief Longest single sleep of a pacer (seconds)
+ *
+ * Sleeps are cut into slices so cancel() takes effect within this time;
+ * the last slice still ends exactly on the deadline.
+ */
+constexpr double PACER_CANCEL_SLICE = 0.05;
+
+/**
+ * @brief SCHED_FIFO priority of a real-time pacing thread
+ *
+ * Above the kernel's default threaded IRQ handlers (50), below the
+ * watchdog and migration threads (99).
+ */
+constexpr int PACER_RT_PRIORITY = 80;
+
+/**
+ * @brief Stack a real-time pacing thread touches up front (bytes)
+ *
+ * With the memory locked, later calls never take a page fault on the stack.
+ */
+constexpr int PACER_STACK_PREFAULT = 256 * 1024;
+
 // ============================================================================
 // NUMERICAL TOLERANCES (Testing and Validation)
 // ============================================================================
@@ -0,0 +1,195 @@
+#include "control_graph.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace tank_sim {
+
+namespace {
+
+void validateSignal(const SignalRef& signal, int state_size, int input_size,
+                    int controller_count, const std::string& what) {
+    int limit = 0;
+    switch (signal.source) {
+        case SignalRef::Source::State:
+            limit = state_size;
+            break;
+        case SignalRef::Source::Input:
+            limit = input_size;
+            break;
+        case SignalRef::Source::ControllerOutput:
+            limit = controller_count;
+            break;
+    }
+    if (signal.index < 0 || signal.index >= limit) {
+        throw std::invalid_argument(what + " signal index " +
+                                    std::to_string(signal.index) +
+                                    " is out of bounds (size " +
+                                    std::to_string(limit) + ")");
+    }
+}
+
+}  // namespace
+
+ControlSchedule ControlSchedule::compile(const std::vector<SignalRef>& measurements,
+                                         const std::vector<ControlLink>& links,
+                                         int state_size, int input_size) {
+    const int n = static_cast<int>(measurements.size());
+
+    // Validation 1: measurements must come from the plant, not other loops
+    for (int i = 0; i < n; ++i) {
+        if (measurements[i].source == SignalRef::Source::ControllerOutput) {
+            throw std::invalid_argument("Controller " + std::to_string(i) +
+                                        " cannot measure a controller output");
+        }
+        validateSignal(measurements[i], state_size, input_size, n,
+                       "Controller " + std::to_string(i) + " measured");
+    }
+
+    // Validation 2: links, and build the dependency graph (master -> slave)
+    std::vector<std::vector<int>> dependents(n);
+    std::vector<int> in_degree(n, 0);
+    std::vector<int> setpoint_links(n, 0);
+    for (size_t k = 0; k < links.size(); ++k) {
+        const ControlLink& link = links[k];
+        const std::string name = "Control link " + std::to_string(k);
+
+        if (link.target < 0 || link.target >= n) {
+            throw std::invalid_argument(name + " target " + std::to_string(link.target) +
+                                        " is out of bounds for " + std::to_string(n) +
+                                        " controller(s)");
+        }
+        validateSignal(link.source, state_size, input_size, n, name + " source");
+
+        if (link.type == ControlLink::Type::Cascade &&
+            link.source.source != SignalRef::Source::ControllerOutput) {
+            throw std::invalid_argument(name + ": cascade source must be a controller output");
+        }
+        if (link.type != ControlLink::Type::Feedforward &&
+            ++setpoint_links[link.target] > 1) {
+            throw std::invalid_argument("Controller " + std::to_string(link.target) +
+                                        " has more than one setpoint link");
+        }
+        if (link.source.source == SignalRef::Source::ControllerOutput) {
+            dependents[link.source.index].push_back(link.target);
+            ++in_degree[link.target];
+        }
+    }
+
+    // Step 1: Kahn's algorithm, one dependency level at a time. Within a level
+    // loops keep config order, so a network without links is the identity.
+    ControlSchedule schedule;
+    schedule.loop_order_.reserve(n);
+    std::vector<std::vector<int>> levels;
+    std::vector<int> current;
+    for (int i = 0; i < n; ++i) {
+        if (in_degree[i] == 0) {
+            current.push_back(i);
+        }
+    }
+    while (!current.empty()) {
+        std::vector<int> next;
+        for (int i : current) {
+            schedule.loop_order_.push_back(i);
+            for (int j : dependents[i]) {
+                if (--in_degree[j] == 0) {
+                    next.push_back(j);
+                }
+            }
+        }
+        levels.push_back(current);
+        std::sort(next.begin(), next.end());
+        current.swap(next);
+    }
+    if (static_cast<int>(schedule.loop_order_.size()) != n) {
+        throw std::invalid_argument("Control links contain a cycle");
+    }
+
+    schedule.slot_of_.assign(n, 0);
+    for (int slot = 0; slot < n; ++slot) {
+        schedule.slot_of_[schedule.loop_order_[slot]] = slot;
+    }
+
+    // Step 2: Emit flat operations level by level, all indices in slot space
+    auto source_index = [&schedule](const SignalRef& signal) {
+        return signal.source == SignalRef::Source::ControllerOutput
+                   ? schedule.slot_of_[signal.index]
+                   : signal.index;
+    };
+
+    int begin = 0;
+    for (const auto& level : levels) {
+        const int end = begin + static_cast<int>(level.size());
+
+        for (int i : level) {
+            if (measurements[i].source != SignalRef::Source::State) {
+                schedule.ops_.push_back({Op::Kind::SetMeasured, measurements[i].source,
+                                         measurements[i].index, schedule.slot_of_[i],
+                                         0, 1.0, 0.0});
+            }
+        }
+
+        for (int i : level) {
+            bool has_feedforward = false;
+            for (const ControlLink& link : links) {
+                if (link.target != i) {
+                    continue;
+                }
+                Op::Kind kind = Op::Kind::SetSetpoint;
+                if (link.type == ControlLink::Type::Feedforward) {
+                    kind = has_feedforward ? Op::Kind::AddFeedforward
+                                           : Op::Kind::SetFeedforward;
+                    has_feedforward = true;
+                }
+                schedule.ops_.push_back({kind, link.source.source,
+                                         source_index(link.source),
+                                         schedule.slot_of_[i], 0, link.gain, link.bias});
+            }
+        }
+
+        schedule.ops_.push_back({Op::Kind::Compute, SignalRef::Source::State, 0,
+                                 begin, end, 0.0, 0.0});
+        begin = end;
+    }
+
+    return schedule;
+}
+
+void ControlSchedule::execute(PIDBank& bank, const Eigen::VectorXd& state,
+                              const Eigen::VectorXd& inputs, double dt) const {
+    for (const Op& op : ops_) {
+        double signal = 0.0;
+        switch (op.source) {
+            case SignalRef::Source::State:
+                signal = state(op.sourceIndex);
+                break;
+            case SignalRef::Source::Input:
+                signal = inputs(op.sourceIndex);
+                break;
+            case SignalRef::Source::ControllerOutput:
+                signal = bank.getOutput(op.sourceIndex);
+                break;
+        }
+
+        switch (op.kind) {
+            case Op::Kind::SetMeasured:
+                bank.setMeasured(op.target, signal);
+                break;
+            case Op::Kind::SetSetpoint:
+                bank.setSetpoint(op.target, op.gain * signal + op.bias);
+                break;
+            case Op::Kind::SetFeedforward:
+                bank.setFeedforward(op.target, op.gain * (signal - op.bias));
+                break;
+            case Op::Kind::AddFeedforward:
+                bank.setFeedforward(op.target, bank.getFeedforward(op.target) +
+                                                   op.gain * (signal - op.bias));
+                break;
+            case Op::Kind::Compute:
+                bank.compute(op.target, op.end, dt);
+                break;
+        }
+    }
+}
+
+}  // namespace tank_sim
@@ -0,0 +1,134 @@
+#ifndef TANK_SIM_CONTROL_GRAPH_H
+#define TANK_SIM_CONTROL_GRAPH_H
+
+#include "pid_bank.h"
+#include <Eigen/Dense>
+#include <vector>
+
+namespace tank_sim {
+
+/**
+ * @brief Reference to a scalar signal in the simulator.
+ *
+ * Signals are read by controllers (measurement), by control links (cascade,
+ * ratio, feedforward sources) and by later monitoring components.
+ */
+struct SignalRef {
+    enum class Source {
+        State,             ///< state(index)
+        Input,             ///< inputs(index)
+        ControllerOutput   ///< output of controller number index
+    };
+
+    Source source;
+    int index;
+};
+
+/**
+ * @brief A connection between a signal and a controller.
+ *
+ * - Cascade:     setpoint[target] = gain * output(source controller) + bias
+ *                (source must be a ControllerOutput; the master loop)
+ * - Ratio:       setpoint[target] = gain * signal + bias
+ * - Feedforward: output[target] += gain * (signal - bias)
+ *                (bias is the signal's nominal value, so the loop bias is
+ *                unchanged at the design point)
+ *
+ * A controller may have at most one setpoint link (Cascade or Ratio) and any
+ * number of Feedforward links. While a setpoint link is active the operator
+ * setpoint of the target controller is overwritten every step (remote mode).
+ */
+struct ControlLink {
+    enum class Type { Cascade, Ratio, Feedforward };
+
+    Type type;
+    SignalRef source;
+    int target;    ///< Index of the controller being driven
+    double gain;
+    double bias;
+};
+
+/**
+ * @brief Flat, precompiled execution order for a control network.
+ *
+ * ControlSchedule::compile() topologically sorts controllers once so that
+ * every master loop is computed before the loops it drives. Loops are
+ * renumbered into bank slots in that order (loopOrder), which makes each
+ * dependency level a contiguous slot range for PIDBank::compute(). The
+ * result is a flat list of POD operations; execute() walks it with a single
+ * switch, so complex strategies cost no graph traversal or virtual dispatch
+ * per step.
+ *
+ * For a network with no links the schedule is the identity order and a
+ * single Compute operation over all loops.
+ */
+class ControlSchedule {
+public:
+    struct Op {
+        enum class Kind {
+            SetMeasured,     ///< measured[target] = signal (non-state measurements)
+            SetSetpoint,     ///< setpoint[target] = gain * signal + bias
+            SetFeedforward,  ///< feedforward[target] = gain * (signal - bias)
+            AddFeedforward,  ///< feedforward[target] += gain * (signal - bias)
+            Compute          ///< PID update for slots [target, end)
+        };
+
+        Kind kind;
+        SignalRef::Source source;
+        int sourceIndex;   ///< Slot index when source is ControllerOutput
+        int target;        ///< Bank slot (first slot for Compute)
+        int end;           ///< One past the last slot (Compute only)
+        double gain;
+        double bias;
+    };
+
+    /**
+     * @brief Compile a control network into a flat schedule.
+     *
+     * @param measurements Measured signal of each controller, in config order
+     *                     (State or Input sources only)
+     * @param links Cascade, ratio and feedforward connections
+     * @param state_size Size of the state vector (for index validation)
+     * @param input_size Size of the input vector (for index validation)
+     * @return The compiled schedule
+     *
+     * @throws std::invalid_argument if an index is out of range, a controller
+     *         measures another controller's output, a controller has more than
+     *         one setpoint link, a Cascade source is not a controller output,
+     *         or the links contain a cycle
+     */
+    static ControlSchedule compile(const std::vector<SignalRef>& measurements,
+                                   const std::vector<ControlLink>& links,
+                                   int state_size, int input_size);
+
+    /**
+     * @brief Run the schedule against a PID bank.
+     *
+     * Expects the bank's state-sourced measurements to have been gathered
+     * already; outputs are left in the bank for PIDBank::scatter().
+     *
+     * @param bank PID bank built with loops in loopOrder()
+     * @param state Current state vector
+     * @param inputs Current input vector
+     * @param dt Time step in seconds
+     */
+    void execute(PIDBank& bank, const Eigen::VectorXd& state,
+                 const Eigen::VectorXd& inputs, double dt) const;
+
+    /// Config index of the controller placed in each bank slot
+    const std::vector<int>& loopOrder() const { return loop_order_; }
+
+    /// Bank slot of each controller, indexed by config index
+    const std::vector<int>& slotOf() const { return slot_of_; }
+
+    const std::vector<Op>& ops() const { return ops_; }
+
+private:
+    std::vector<int> loop_order_;
+    std::vector<int> slot_of_;
+    std::vector<Op> ops_;
+};
+
+}  // namespace tank_sim
+
+#endif  // TANK_SIM_CONTROL_GRAPH_H
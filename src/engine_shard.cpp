@@ -0,0 +1,275 @@
+#include "engine_shard.h"
+#include "constants.h"
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace tank_sim {
+
+namespace {
+
+constexpr int POLL_TIMEOUT_MS = 100;   ///< Bounds how long stop() takes
+constexpr int MAX_EVENTS = 64;
+
+/// Frame payload: simulation time, then the state JSON
+std::string framePayload(const SessionEngine::EncodedFrame& frame) {
+    const std::string_view json = frame.payload();
+    std::string payload(sizeof(double) + json.size(), '\0');
+    std::memcpy(&payload[0], &frame.time, sizeof(double));
+    std::memcpy(&payload[sizeof(double)], json.data(), json.size());
+    return payload;
+}
+
+}  // namespace
+
+EngineShard::EngineShard(SessionEngine& engine, const std::string& socket_path,
+                         double tick_period)
+    : EngineShard(engine, socket_path, RealtimePacer::Settings{tick_period}) {}
+
+EngineShard::EngineShard(SessionEngine& engine, const std::string& socket_path,
+                         const RealtimePacer::Settings& pacing)
+    : engine_(engine),
+      path_(socket_path),
+      pacing_(pacing),
+      listen_(-1),
+      epoll_(-1),
+      queue_(engine.addProducer()),
+      cursor_(engine.frames().subscribe()),
+      running_(true),
+      router_count_(0),
+      dropped_(0) {
+    // Validate the pacing - fail fast
+    RealtimePacer::validate(pacing);
+    listen_ = ShardLink::listen(socket_path);
+    epoll_ = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_ < 0) {
+        ::close(listen_);
+        throw std::runtime_error(std::string("epoll_create1: ") + std::strerror(errno));
+    }
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = listen_;
+    epoll_ctl(epoll_, EPOLL_CTL_ADD, listen_, &event);
+    event.data.fd = wake_.fd();
+    epoll_ctl(epoll_, EPOLL_CTL_ADD, wake_.fd(), &event);
+}
+
+EngineShard::~EngineShard() {
+    routers_.clear();
+    ::close(epoll_);
+    ::close(listen_);
+    ::unlink(path_.c_str());
+}
+
+void EngineShard::run() {
+    EngineThread ticker(engine_, pacing_);
+    ticker.addSignal(wake_);
+    ticker.start();
+
+    epoll_event events[MAX_EVENTS];
+    while (running_.load(std::memory_order_acquire)) {
+        const int count = epoll_wait(epoll_, events, MAX_EVENTS, POLL_TIMEOUT_MS);
+        for (int i = 0; i < count; ++i) {
+            const int fd = events[i].data.fd;
+            if (fd == listen_) {
+                accept();
+            } else if (fd == wake_.fd()) {
+                wake_.consume();
+                // Frames first: a session's last frames precede its Exported
+                forwardFrames();
+                forwardExports();
+            } else {
+                auto it = routers_.find(fd);
+                if (it == routers_.end()) {
+                    continue;
+                }
+                Router& router = it->second;
+                bool open = (events[i].events & (EPOLLERR | EPOLLHUP)) == 0;
+                if (open && (events[i].events & EPOLLIN)) {
+                    open = router.link->receive(
+                        [&](const ShardLink::Header& header, std::string_view payload) {
+                            open = open && handle(router, header, payload);
+                        });
+                }
+                if (!open) {
+                    close(fd);
+                }
+            }
+        }
+
+        // Requests that did not fit the queue, then pending output
+        while (!backlog_.empty() && queue_.tryPush(backlog_.front())) {
+            backlog_.pop_front();
+        }
+        std::vector<int> broken;
+        for (auto& [fd, router] : routers_) {
+            if (!router.link->flush()) {
+                broken.push_back(fd);
+            } else {
+                updateInterest(fd, router);
+            }
+        }
+        for (int fd : broken) {
+            close(fd);
+        }
+    }
+    ticker.stop();
+    pacing_stats_ = ticker.pacingStats();
+}
+
+void EngineShard::stop() { running_.store(false, std::memory_order_release); }
+
+void EngineShard::accept() {
+    for (;;) {
+        const int fd = accept4(listen_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            return;
+        }
+        Router& router = routers_[fd];
+        router.link = std::make_unique<ShardLink>(fd);
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        epoll_ctl(epoll_, EPOLL_CTL_ADD, fd, &event);
+        router_count_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+bool EngineShard::handle(Router& router, const ShardLink::Header& header,
+                         std::string_view payload) {
+    using Type = SessionEngine::Request::Type;
+    const std::uint64_t key = header.sessionKey;
+    switch (header.type) {
+        case ShardLink::MessageType::Join:
+            ++router.subscribers[key];
+            request(Type::Join, key);
+            return true;
+        case ShardLink::MessageType::Leave: {
+            auto it = router.subscribers.find(key);
+            if (it != router.subscribers.end() && --it->second <= 0) {
+                router.subscribers.erase(it);
+            }
+            request(Type::Leave, key);
+            return true;
+        }
+        case ShardLink::MessageType::Command: {
+            if (payload.size() != sizeof(OperatorCommand)) {
+                return false;
+            }
+            OperatorCommand command;
+            std::memcpy(&command, payload.data(), sizeof(command));
+            request(Type::Command, key, command);
+            return true;
+        }
+        case ShardLink::MessageType::Export:
+            // The subscribers move with the session
+            router.subscribers.erase(key);
+            exporters_[key] = router.link->fd();
+            request(Type::Export, key);
+            return true;
+        case ShardLink::MessageType::Import: {
+            SessionEngine::Transfer transfer;
+            if (payload.size() != sizeof(transfer)) {
+                return false;
+            }
+            std::memcpy(&transfer, payload.data(), sizeof(transfer));
+            try {
+                engine_.importSession(transfer);
+            } catch (const std::invalid_argument&) {
+                return false;   // Shards with different configurations
+            }
+            if (transfer.subscribers > 0) {
+                router.subscribers[key] += transfer.subscribers;
+            }
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+void EngineShard::request(SessionEngine::Request::Type type, std::uint64_t key,
+                          const OperatorCommand& command) {
+    const SessionEngine::Request request{type, key, command};
+    // Keep order behind earlier requests that did not fit
+    if (!backlog_.empty() || !queue_.tryPush(request)) {
+        backlog_.push_back(request);
+    }
+}
+
+void EngineShard::forwardExports() {
+    for (const auto& transfer : engine_.takeExports()) {
+        auto requester = exporters_.find(transfer.sessionKey);
+        if (requester == exporters_.end()) {
+            continue;
+        }
+        auto it = routers_.find(requester->second);
+        exporters_.erase(requester);
+        if (it != routers_.end()) {
+            it->second.link->send(ShardLink::MessageType::Exported, transfer.sessionKey,
+                                  &transfer, sizeof(transfer));
+        }
+    }
+}
+
+void EngineShard::forwardFrames() {
+    using Status = SessionEngine::FrameRing::ReadStatus;
+    SessionEngine::EncodedFrame frame;
+    Status status;
+    while ((status = engine_.frames().read(cursor_, frame)) != Status::Empty) {
+        if (status != Status::Ok) {
+            continue;
+        }
+        std::string payload;
+        for (auto& [fd, router] : routers_) {
+            if (router.subscribers.count(frame.sessionKey) == 0) {
+                continue;
+            }
+            if (router.link->pending() > static_cast<std::size_t>(constants::SHARD_MAX_PENDING_BYTES)) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+            if (payload.empty()) {
+                payload = framePayload(frame);
+            }
+            router.link->send(ShardLink::MessageType::Frame, frame.sessionKey, payload.data(),
+                              payload.size());
+        }
+    }
+}
+
+void EngineShard::close(int fd) {
+    auto it = routers_.find(fd);
+    if (it == routers_.end()) {
+        return;
+    }
+    // The router's clients are gone: release their sessions
+    for (const auto& [key, count] : it->second.subscribers) {
+        for (int i = 0; i < count; ++i) {
+            request(SessionEngine::Request::Type::Leave, key);
+        }
+    }
+    epoll_ctl(epoll_, EPOLL_CTL_DEL, fd, nullptr);
+    routers_.erase(it);
+    router_count_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void EngineShard::updateInterest(int fd, Router& router) {
+    const bool arm = router.link->pending() > 0;
+    if (arm == router.writeArmed) {
+        return;
+    }
+    router.writeArmed = arm;
+    epoll_event event{};
+    event.events = EPOLLIN | (arm ? EPOLLOUT : 0u);
+    event.data.fd = fd;
+    epoll_ctl(epoll_, EPOLL_CTL_MOD, fd, &event);
+}
+
+}  // namespace tank_sim
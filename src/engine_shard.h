@@ -0,0 +1,106 @@
+#ifndef TANK_SIM_ENGINE_SHARD_H
+#define TANK_SIM_ENGINE_SHARD_H
+
+#include "engine_thread.h"
+#include "session_engine.h"
+#include "shard_link.h"
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace tank_sim {
+
+/**
+ * @brief Serves a SessionEngine to ShardRouters over a Unix-domain socket.
+ *
+ * One engine process per shard: run() ticks the engine on an EngineThread
+ * and, on one event-loop thread, turns router messages into engine
+ * requests and sends each router the frames of the sessions it joined.
+ * The loop is the engine's single request producer.
+ *
+ * Migration support: Export queues the request and, once the engine has
+ * removed the session, answers the requesting router with Exported and
+ * the session's Transfer; Import hands a Transfer to the engine, which
+ * continues the session at its next tick.
+ *
+ * Linux only (epoll).
+ */
+class EngineShard {
+public:
+    /**
+     * @param engine Engine to serve; must outlive the shard
+     * @param socket_path Filesystem path of the listening socket
+     * @param pacing Engine tick period, catch-up policy and real-time options
+     *
+     * @throws std::invalid_argument if the pacing settings are invalid or
+     *         the path is too long
+     * @throws std::runtime_error if the socket or epoll instance cannot be
+     *         created
+     */
+    EngineShard(SessionEngine& engine, const std::string& socket_path,
+                const RealtimePacer::Settings& pacing);
+
+    /// Shard ticking every tick_period seconds with the default pacing
+    EngineShard(SessionEngine& engine, const std::string& socket_path, double tick_period);
+
+    /// Closes the sockets and removes the socket file
+    ~EngineShard();
+
+    EngineShard(const EngineShard&) = delete;
+    EngineShard& operator=(const EngineShard&) = delete;
+
+    /// Serve until stop(); blocks the calling thread
+    void run();
+
+    /// Ask run() to return; safe from any thread or a signal handler
+    void stop();
+
+    /// Routers connected now
+    int routerCount() const { return router_count_.load(std::memory_order_relaxed); }
+
+    /// Frames not sent to a router whose output was backed up
+    std::uint64_t framesDropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+    /// Tick lateness of the last run(); read after run() returns
+    const RealtimePacer::Stats& pacingStats() const { return pacing_stats_; }
+
+private:
+    struct Router {
+        std::unique_ptr<ShardLink> link;
+        std::unordered_map<std::uint64_t, int> subscribers;   ///< Joins per session
+        bool writeArmed = false;
+    };
+
+    SessionEngine& engine_;
+    std::string path_;
+    RealtimePacer::Settings pacing_;
+    RealtimePacer::Stats pacing_stats_;
+    int listen_;
+    int epoll_;
+    TickSignal wake_;
+    SessionEngine::RequestQueue& queue_;
+    SessionEngine::FrameRing::Cursor cursor_;
+    std::deque<SessionEngine::Request> backlog_;   ///< Requests waiting for queue space
+    std::unordered_map<int, Router> routers_;      ///< By socket
+    std::unordered_map<std::uint64_t, int> exporters_;   ///< Session -> requesting socket
+    std::atomic<bool> running_;
+    std::atomic<int> router_count_;
+    std::atomic<std::uint64_t> dropped_;
+
+    void accept();
+    bool handle(Router& router, const ShardLink::Header& header, std::string_view payload);
+    void request(SessionEngine::Request::Type type, std::uint64_t key,
+                 const OperatorCommand& command = OperatorCommand{});
+    void forwardFrames();
+    void forwardExports();
+    void close(int fd);
+    void updateInterest(int fd, Router& router);
+};
+
+}  // namespace tank_sim
+
+#endif  // TANK_SIM_ENGINE_SHARD_H
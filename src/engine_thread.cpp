@@ -0,0 +1,126 @@
+#include "engine_thread.h"
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include <fcntl.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/eventfd.h>
+#endif
+
+namespace tank_sim {
+
+// ============================================================================
+// TickSignal
+// ============================================================================
+
+TickSignal::TickSignal() {
+#ifdef __linux__
+    read_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    write_fd_ = read_fd_;
+    if (read_fd_ < 0) {
+        throw std::runtime_error(std::string("eventfd: ") + std::strerror(errno));
+    }
+#else
+    int fds[2];
+    if (pipe(fds) != 0) {
+        throw std::runtime_error(std::string("pipe: ") + std::strerror(errno));
+    }
+    for (int fd : fds) {
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+        fcntl(fd, F_SETFD, FD_CLOEXEC);
+    }
+    read_fd_ = fds[0];
+    write_fd_ = fds[1];
+#endif
+}
+
+TickSignal::~TickSignal() {
+    ::close(read_fd_);
+    if (write_fd_ != read_fd_) {
+        ::close(write_fd_);
+    }
+}
+
+void TickSignal::notify() {
+#ifdef __linux__
+    const std::uint64_t one = 1;
+    [[maybe_unused]] ssize_t n = write(write_fd_, &one, sizeof(one));
+#else
+    // A full pipe is already readable; the lost byte only lowers the count
+    const char one = 1;
+    [[maybe_unused]] ssize_t n = write(write_fd_, &one, 1);
+#endif
+}
+
+std::uint64_t TickSignal::consume() {
+#ifdef __linux__
+    std::uint64_t count = 0;
+    return read(read_fd_, &count, sizeof(count)) == sizeof(count) ? count : 0;
+#else
+    std::uint64_t count = 0;
+    char buffer[256];
+    ssize_t n;
+    while ((n = read(read_fd_, buffer, sizeof(buffer))) > 0) {
+        count += static_cast<std::uint64_t>(n);
+    }
+    return count;
+#endif
+}
+
+// ============================================================================
+// EngineThread
+// ============================================================================
+
+EngineThread::EngineThread(SessionEngine& engine, double tick_period)
+    : EngineThread(engine, RealtimePacer::Settings{tick_period}) {}
+
+EngineThread::EngineThread(SessionEngine& engine, const RealtimePacer::Settings& pacing)
+    : engine_(engine), pacer_(pacing), running_(false), ticks_(0) {}
+
+EngineThread::~EngineThread() { stop(); }
+
+void EngineThread::addSignal(TickSignal& signal) { signals_.push_back(&signal); }
+
+void EngineThread::start() {
+    if (running_.exchange(true, std::memory_order_acq_rel)) {
+        return;
+    }
+    pacer_.start();
+    thread_ = std::thread(&EngineThread::run, this);
+}
+
+void EngineThread::stop() {
+    running_.store(false, std::memory_order_release);
+    pacer_.cancel();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void EngineThread::run() {
+    if (pacer_.settings().realtime) {
+        pacer_.enterRealtime();
+    }
+    using Clock = std::chrono::steady_clock;
+    const auto idle = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(
+        pacer_.settings().period * constants::ENGINE_SPECULATION_IDLE_SHARE));
+    while (pacer_.wait()) {
+        const auto woke = Clock::now();
+        engine_.tick();
+        ticks_.fetch_add(1, std::memory_order_acq_rel);
+        for (TickSignal* signal : signals_) {
+            signal->notify();
+        }
+
+        // Idle until the next deadline: compute sessions ahead in chunks
+        while (running_.load(std::memory_order_acquire) && Clock::now() - woke < idle &&
+               engine_.speculate(constants::ENGINE_SPECULATION_CHUNK_STEPS) > 0) {
+        }
+    }
+}
+
+}  // namespace tank_sim
@@ -0,0 +1,122 @@
+#ifndef TANK_SIM_ENGINE_THREAD_H
+#define TANK_SIM_ENGINE_THREAD_H
+
+#include "realtime_pacer.h"
+#include "session_engine.h"
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace tank_sim {
+
+/**
+ * @brief Counting wakeup for a thread that waits in poll, epoll or asyncio.
+ *
+ * notify() never blocks. The descriptor becomes readable after the first
+ * notify and stays readable until consume(), which returns how many
+ * notifications arrived since the previous consume, so ticks the waiter was
+ * too slow for coalesce into one wakeup. Backed by an eventfd on Linux and
+ * a non-blocking pipe elsewhere.
+ */
+class TickSignal {
+public:
+    /// @throws std::runtime_error if the descriptor cannot be created
+    TickSignal();
+    ~TickSignal();
+
+    TickSignal(const TickSignal&) = delete;
+    TickSignal& operator=(const TickSignal&) = delete;
+
+    /// Descriptor to wait on for readability
+    int fd() const { return read_fd_; }
+
+    /// Signal the waiter (any thread)
+    void notify();
+
+    /// Reset the signal; returns the notifications since the last call (0 if none)
+    std::uint64_t consume();
+
+private:
+    int read_fd_;
+    int write_fd_;   ///< Same as read_fd_ for an eventfd
+};
+
+/**
+ * @brief Ticks a SessionEngine on its own thread at a fixed period.
+ *
+ * After each tick every registered TickSignal is notified once, so a
+ * consumer learns that frames are ready without polling or per-session
+ * timers: one wakeup per tick (or per batch of ticks, if it falls behind)
+ * regardless of the number of sessions. Consumers then drain the engine's
+ * frame ring with their own cursor.
+ *
+ * Ticks are paced by a RealtimePacer: they are scheduled at start +
+ * n * period on absolute deadlines, so a late tick does not shift the ones
+ * after it, and ticks missed during a stall are caught up according to the
+ * pacer's policy. With Settings::realtime the thread runs SCHED_FIFO with
+ * locked memory when the process is allowed to (see realtime()).
+ *
+ * Between ticks the thread lets the engine compute sessions ahead
+ * (SessionEngine::speculate()) for up to ENGINE_SPECULATION_IDLE_SHARE of
+ * the period; engines without speculation return at once.
+ */
+class EngineThread {
+public:
+    /**
+     * @param engine Engine to tick; must outlive this object
+     * @param tick_period Seconds between ticks
+     *
+     * @throws std::invalid_argument if tick_period is not positive
+     */
+    EngineThread(SessionEngine& engine, double tick_period);
+
+    /**
+     * @param engine Engine to tick; must outlive this object
+     * @param pacing Tick period, catch-up policy and real-time options
+     *
+     * @throws std::invalid_argument if the settings are invalid
+     */
+    EngineThread(SessionEngine& engine, const RealtimePacer::Settings& pacing);
+
+    /// Stops the thread
+    ~EngineThread();
+
+    EngineThread(const EngineThread&) = delete;
+    EngineThread& operator=(const EngineThread&) = delete;
+
+    /// Register a signal notified after each tick; call before start()
+    void addSignal(TickSignal& signal);
+
+    /// Start ticking; does nothing if already running
+    void start();
+
+    /// Stop ticking and join the thread; returns within the current tick
+    /// (or PACER_CANCEL_SLICE while waiting for one)
+    void stop();
+
+    bool running() const { return running_.load(std::memory_order_acquire); }
+
+    /// Ticks completed since construction
+    std::uint64_t ticks() const { return ticks_.load(std::memory_order_acquire); }
+
+    /// Tick lateness histogram and catch-up counters (any thread)
+    RealtimePacer::Stats pacingStats() const { return pacer_.stats(); }
+
+    /// Whether the thread is running as a real-time thread
+    bool realtime() const { return pacer_.stats().realtime; }
+
+private:
+    SessionEngine& engine_;
+    RealtimePacer pacer_;
+    std::vector<TickSignal*> signals_;
+    std::thread thread_;
+    std::atomic<bool> running_;
+    std::atomic<std::uint64_t> ticks_;
+
+    void run();
+};
+
+}  // namespace tank_sim
+
+#endif  // TANK_SIM_ENGINE_THREAD_H
@@ -0,0 +1,125 @@
+#ifndef TANK_SIM_EXTENDED_KALMAN_FILTER_H
+#define TANK_SIM_EXTENDED_KALMAN_FILTER_H
+
+#include <Eigen/Dense>
+#include <stdexcept>
+
+namespace tank_sim {
+
+/**
+ * @brief Extended Kalman filter with compile-time state and measurement sizes.
+ *
+ * The filter owns the estimate and its covariance; the caller owns the
+ * model. Each sample the caller propagates the estimate through its
+ * nonlinear model and passes the result together with the model Jacobian to
+ * predict(), then passes the sensor reading, the predicted reading and the
+ * measurement Jacobian to update():
+ *
+ *   predict:  x = f(x),  P = F P F' + Q
+ *   update:   S = H P H' + R,  K = P H' S^-1
+ *             x = x + K (z - h(x)),  P = (I - K H) P (I - K H)' + K R K'
+ *
+ * The covariance update uses the Joseph form, which keeps P symmetric
+ * positive semi-definite under rounding. All matrices are fixed-size Eigen
+ * types, so a filter lives entirely inside its owner (no heap allocation)
+ * and arrays of filters are contiguous.
+ *
+ * @tparam NX Number of states
+ * @tparam NZ Number of measurements
+ */
+template <int NX, int NZ>
+class ExtendedKalmanFilter {
+    static_assert(NX > 0 && NZ > 0, "Filter dimensions must be positive");
+
+public:
+    using StateVector = Eigen::Matrix<double, NX, 1>;
+    using StateMatrix = Eigen::Matrix<double, NX, NX>;
+    using MeasurementVector = Eigen::Matrix<double, NZ, 1>;
+    using MeasurementMatrix = Eigen::Matrix<double, NZ, NX>;
+    using MeasurementCovariance = Eigen::Matrix<double, NZ, NZ>;
+    using GainMatrix = Eigen::Matrix<double, NX, NZ>;
+
+    /**
+     * @brief Construct a filter from its initial estimate and noise models.
+     *
+     * @param initial_state Initial state estimate
+     * @param initial_covariance Initial estimate covariance P0
+     * @param process_noise Process noise covariance Q (per sample)
+     * @param measurement_noise Measurement noise covariance R
+     *
+     * @throws std::invalid_argument if a covariance has a negative diagonal
+     *         entry or R has a non-positive diagonal entry
+     */
+    ExtendedKalmanFilter(const StateVector& initial_state,
+                         const StateMatrix& initial_covariance,
+                         const StateMatrix& process_noise,
+                         const MeasurementCovariance& measurement_noise)
+        : x_(initial_state), p_(initial_covariance), q_(process_noise),
+          r_(measurement_noise), innovation_(MeasurementVector::Zero()) {
+        // Validate noise models - fail fast
+        if ((initial_covariance.diagonal().array() < 0.0).any() ||
+            (process_noise.diagonal().array() < 0.0).any()) {
+            throw std::invalid_argument("Kalman filter covariances cannot have negative variances");
+        }
+        if ((measurement_noise.diagonal().array() <= 0.0).any()) {
+            throw std::invalid_argument("Kalman filter measurement noise must be positive");
+        }
+    }
+
+    /**
+     * @brief Time update.
+     *
+     * @param predicted_state f(x): the estimate propagated through the model
+     * @param transition F = df/dx evaluated at the previous estimate
+     */
+    void predict(const StateVector& predicted_state, const StateMatrix& transition) {
+        x_ = predicted_state;
+        p_ = transition * p_ * transition.transpose() + q_;
+    }
+
+    /**
+     * @brief Measurement update.
+     *
+     * @param measurement Sensor reading z
+     * @param predicted_measurement h(x) at the predicted estimate
+     * @param observation H = dh/dx at the predicted estimate
+     */
+    void update(const MeasurementVector& measurement,
+                const MeasurementVector& predicted_measurement,
+                const MeasurementMatrix& observation) {
+        innovation_ = measurement - predicted_measurement;
+        const MeasurementCovariance s =
+            observation * p_ * observation.transpose() + r_;
+        // K' = S^-1 H P (S and P are symmetric)
+        const GainMatrix gain =
+            s.llt().solve(observation * p_).transpose();
+        x_ += gain * innovation_;
+        const StateMatrix i_kh = StateMatrix::Identity() - gain * observation;
+        p_ = i_kh * p_ * i_kh.transpose() + gain * r_ * gain.transpose();
+    }
+
+    /**
+     * @brief Restart from a new estimate and covariance (noise models are kept).
+     */
+    void reset(const StateVector& state, const StateMatrix& covariance) {
+        x_ = state;
+        p_ = covariance;
+        innovation_.setZero();
+    }
+
+    const StateVector& state() const { return x_; }
+    const StateMatrix& covariance() const { return p_; }
+    /// Innovation z - h(x) of the last update
+    const MeasurementVector& innovation() const { return innovation_; }
+
+private:
+    StateVector x_;
+    StateMatrix p_;
+    StateMatrix q_;
+    MeasurementCovariance r_;
+    MeasurementVector innovation_;
+};
+
+}  // namespace tank_sim
+
+#endif  // TANK_SIM_EXTENDED_KALMAN_FILTER_H
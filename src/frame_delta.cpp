@@ -0,0 +1,226 @@
+#include "frame_delta.h"
+#include <cmath>
+#include <stdexcept>
+
+namespace tank_sim {
+
+namespace {
+
+/// Deltas beyond this many quanta are sent as a keyframe instead
+constexpr double MAX_QUANTA = 4.0e18;
+
+constexpr std::uint32_t ALARMS_BIT = 1u << 31;
+
+int channelCount(int loop_count) {
+    return static_cast<int>(FrameEncoder::BINARY_SCALARS) + 3 * loop_count;
+}
+
+/// Channel c of a frame, in the order documented on DeltaEncoder
+double& channel(TelemetryFrame& frame, int c) {
+    switch (c) {
+        case 0: return frame.time;
+        case 1: return frame.tankLevel;
+        case 2: return frame.measuredLevel;
+        case 3: return frame.inletFlow;
+        case 4: return frame.outletFlow;
+        case 5: return frame.valvePosition;
+        default: break;
+    }
+    const int loop = (c - 6) / 3;
+    switch ((c - 6) % 3) {
+        case 0: return frame.setpoint[loop];
+        case 1: return frame.error[loop];
+        default: return frame.controllerOutput[loop];
+    }
+}
+
+double channel(const TelemetryFrame& frame, int c) {
+    return channel(const_cast<TelemetryFrame&>(frame), c);
+}
+
+char* putVarint(char* out, std::uint64_t value) {
+    while (value >= 0x80) {
+        *out++ = static_cast<char>((value & 0x7f) | 0x80);
+        value >>= 7;
+    }
+    *out++ = static_cast<char>(value);
+    return out;
+}
+
+std::uint64_t zigzag(std::int64_t value) {
+    return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+}
+
+std::int64_t unzigzag(std::uint64_t value) {
+    return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+}
+
+/**
+ * @brief Read a varint, advancing p; throws if it runs past end.
+ */
+std::uint64_t getVarint(const unsigned char*& p, const unsigned char* end) {
+    std::uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (p == end) {
+            throw std::invalid_argument("Delta frame is truncated");
+        }
+        const unsigned char byte = *p++;
+        value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) {
+            return value;
+        }
+    }
+    throw std::invalid_argument("Delta frame has an overlong varint");
+}
+
+/// Reconstruction shared by encoder and decoder so both round identically
+double applyDelta(double reference, std::int64_t quanta, double quantum) {
+    return reference + static_cast<double>(quanta) * quantum;
+}
+
+void validateQuantum(double quantum) {
+    if (!(quantum > 0.0) || !std::isfinite(quantum)) {
+        throw std::invalid_argument("Delta quantum must be positive and finite");
+    }
+}
+
+}  // namespace
+
+DeltaEncoder::DeltaEncoder() : DeltaEncoder(Settings{}) {}
+
+DeltaEncoder::DeltaEncoder(const Settings& settings)
+    : settings_(settings), reference_{}, since_keyframe_(0), need_keyframe_(true),
+      last_keyframe_(false) {
+    // Validate settings - fail fast
+    if (settings.keyframeInterval < 1) {
+        throw std::invalid_argument("Keyframe interval must be at least 1");
+    }
+    validateQuantum(settings.quantum);
+}
+
+std::string_view DeltaEncoder::keyframe(const TelemetryFrame& frame) {
+    const std::size_t size = FrameEncoder::writeBinary(frame, buffer_.data());
+    reference_ = FrameEncoder::readBinary(buffer_.data(), size);
+    since_keyframe_ = 1;
+    need_keyframe_ = false;
+    last_keyframe_ = true;
+    return std::string_view(buffer_.data(), size);
+}
+
+std::string_view DeltaEncoder::encode(const TelemetryFrame& frame) {
+    if (need_keyframe_ || since_keyframe_ >= settings_.keyframeInterval ||
+        frame.loopCount != reference_.loopCount || frame.step <= reference_.step) {
+        return keyframe(frame);
+    }
+
+    // Quantize every channel against the decoder's reconstruction
+    const int channels = channelCount(frame.loopCount);
+    std::array<std::int64_t, MAX_CHANNELS> quanta{};
+    std::uint32_t mask = 0;
+    for (int c = 0; c < channels; ++c) {
+        const double value = channel(frame, c);
+        const double reference = channel(reference_, c);
+        if (value == reference) {
+            continue;
+        }
+        const double scaled = (value - reference) / settings_.quantum;
+        if (!std::isfinite(scaled) || std::abs(scaled) > MAX_QUANTA) {
+            return keyframe(frame);
+        }
+        quanta[c] = std::llround(scaled);
+        if (quanta[c] != 0) {
+            mask |= 1u << c;
+        }
+    }
+    const std::int64_t alarm_delta =
+        static_cast<std::int64_t>(frame.activeAlarms) - reference_.activeAlarms;
+    if (alarm_delta != 0) {
+        mask |= ALARMS_BIT;
+    }
+
+    char* out = buffer_.data();
+    out[0] = static_cast<char>(BINARY_KIND_DELTA);
+    out[1] = static_cast<char>(FrameEncoder::BINARY_VERSION);
+    out[2] = static_cast<char>(frame.loopCount & 0xff);
+    out[3] = static_cast<char>(frame.loopCount >> 8);
+    for (int i = 0; i < 4; ++i) {
+        out[4 + i] = static_cast<char>(mask >> (8 * i));
+    }
+    char* p = putVarint(out + DELTA_HEADER_SIZE, frame.step - reference_.step);
+    for (int c = 0; c < channels; ++c) {
+        if (mask & (1u << c)) {
+            p = putVarint(p, zigzag(quanta[c]));
+            double& reference = channel(reference_, c);
+            reference = applyDelta(reference, quanta[c], settings_.quantum);
+        }
+    }
+    if (mask & ALARMS_BIT) {
+        p = putVarint(p, zigzag(alarm_delta));
+    }
+    reference_.step = frame.step;
+    reference_.activeAlarms = frame.activeAlarms;
+
+    ++since_keyframe_;
+    last_keyframe_ = false;
+    return std::string_view(out, static_cast<std::size_t>(p - out));
+}
+
+DeltaDecoder::DeltaDecoder(double quantum) : quantum_(quantum), reference_{}, synchronized_(false) {
+    validateQuantum(quantum);
+}
+
+TelemetryFrame DeltaDecoder::decode(const char* data, std::size_t size) {
+    if (size < 1) {
+        throw std::invalid_argument("Delta frame is empty");
+    }
+    const auto* bytes = reinterpret_cast<const unsigned char*>(data);
+    if (bytes[0] == FrameEncoder::BINARY_KIND_STATE) {
+        reference_ = FrameEncoder::readBinary(data, size);
+        synchronized_ = true;
+        return reference_;
+    }
+
+    // Validate the delta header - fail fast
+    if (bytes[0] != DeltaEncoder::BINARY_KIND_DELTA || size < DeltaEncoder::DELTA_HEADER_SIZE ||
+        bytes[1] != FrameEncoder::BINARY_VERSION) {
+        throw std::invalid_argument("Unsupported delta frame kind, version or size");
+    }
+    if (!synchronized_) {
+        throw std::invalid_argument("Delta frame received before a keyframe");
+    }
+    const int loops = bytes[2] | (bytes[3] << 8);
+    if (loops != reference_.loopCount) {
+        throw std::invalid_argument("Delta frame loop count does not match the keyframe");
+    }
+    const std::uint32_t mask = static_cast<std::uint32_t>(bytes[4]) |
+                               (static_cast<std::uint32_t>(bytes[5]) << 8) |
+                               (static_cast<std::uint32_t>(bytes[6]) << 16) |
+                               (static_cast<std::uint32_t>(bytes[7]) << 24);
+    const int channels = channelCount(loops);
+    if ((mask & ~ALARMS_BIT) >> channels) {
+        throw std::invalid_argument("Delta frame changes a channel it does not have");
+    }
+
+    // Decode into a copy so a malformed record leaves the reference intact
+    TelemetryFrame frame = reference_;
+    const unsigned char* p = bytes + DeltaEncoder::DELTA_HEADER_SIZE;
+    const unsigned char* end = bytes + size;
+    frame.step += getVarint(p, end);
+    for (int c = 0; c < channels; ++c) {
+        if (mask & (1u << c)) {
+            double& value = channel(frame, c);
+            value = applyDelta(value, unzigzag(getVarint(p, end)), quantum_);
+        }
+    }
+    if (mask & ALARMS_BIT) {
+        frame.activeAlarms += static_cast<std::int32_t>(unzigzag(getVarint(p, end)));
+    }
+    if (p != end) {
+        throw std::invalid_argument("Delta frame has trailing bytes");
+    }
+
+    reference_ = frame;
+    return frame;
+}
+
+}  // namespace tank_sim
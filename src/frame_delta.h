@@ -0,0 +1,131 @@
+#ifndef TANK_SIM_FRAME_DELTA_H
+#define TANK_SIM_FRAME_DELTA_H
+
+#include "constants.h"
+#include "frame_encoder.h"
+#include "telemetry.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace tank_sim {
+
+/**
+ * @brief Delta encoding of a telemetry frame stream.
+ *
+ * Consecutive frames differ in a few channels by small amounts. The
+ * encoder sends a keyframe (the FrameEncoder binary record, kind
+ * BINARY_KIND_STATE) every keyframeInterval frames and, in between, delta
+ * records that carry only the channels that changed:
+ *
+ *     offset 0  u8   kind (BINARY_KIND_DELTA)
+ *     offset 1  u8   version (FrameEncoder::BINARY_VERSION)
+ *     offset 2  u16  loopCount
+ *     offset 4  u32  change mask: bit c for channel c, bit 31 for activeAlarms
+ *     offset 8  varint step increment, then one zigzag varint per set bit
+ *
+ * Channels are time, tankLevel, measuredLevel, inletFlow, outletFlow,
+ * valvePosition, then setpoint, error and controllerOutput of each loop.
+ * A channel's delta is round((value - reference) / quantum), where the
+ * reference is the value the decoder reconstructed from the previous
+ * records, so quantization error never accumulates: every decoded value
+ * is within quantum / 2 of the encoded one. Unchanged channels cost
+ * nothing, and typical changes fit in one to three bytes.
+ *
+ * A keyframe is also sent on the first frame, after forceKeyframe() (e.g.
+ * when a client joins), when the loop count changes, when the step does
+ * not increase (reset) and when a value is not finite or its delta does
+ * not fit.
+ */
+class DeltaEncoder {
+public:
+    static constexpr unsigned char BINARY_KIND_DELTA = 2;
+    static constexpr std::size_t DELTA_HEADER_SIZE = 8;
+    static constexpr int MAX_CHANNELS =
+        static_cast<int>(FrameEncoder::BINARY_SCALARS) + 3 * TelemetryFrame::MAX_LOOPS;
+    static constexpr std::size_t MAX_VARINT_SIZE = 10;
+    static constexpr std::size_t MAX_DELTA_SIZE =
+        DELTA_HEADER_SIZE + MAX_VARINT_SIZE * (MAX_CHANNELS + 2);
+    static_assert(MAX_CHANNELS <= 31, "Channels must fit the change mask");
+
+    /**
+     * @brief Keyframe spacing and quantization.
+     */
+    struct Settings {
+        int keyframeInterval = constants::DEFAULT_KEYFRAME_INTERVAL;  ///< Frames per keyframe
+        double quantum = constants::DEFAULT_DELTA_QUANTUM;            ///< Delta resolution
+    };
+
+    /// Encoder with default settings
+    DeltaEncoder();
+
+    /**
+     * @throws std::invalid_argument unless keyframeInterval >= 1 and quantum
+     *         is positive and finite
+     */
+    explicit DeltaEncoder(const Settings& settings);
+
+    /**
+     * @brief Encode the next frame of the stream.
+     *
+     * @return Keyframe or delta record in the encoder's buffer, valid until
+     *         the next call
+     */
+    std::string_view encode(const TelemetryFrame& frame);
+
+    /// Make the next encode() emit a keyframe
+    void forceKeyframe() { need_keyframe_ = true; }
+
+    /// Whether the last encode() emitted a keyframe
+    bool lastWasKeyframe() const { return last_keyframe_; }
+
+private:
+    Settings settings_;
+    TelemetryFrame reference_;   ///< Frame as the decoder has reconstructed it
+    int since_keyframe_;
+    bool need_keyframe_;
+    bool last_keyframe_;
+    std::array<char, FrameEncoder::MAX_JSON_SIZE> buffer_;
+    static_assert(MAX_DELTA_SIZE <= FrameEncoder::MAX_JSON_SIZE, "Encoder buffer too small");
+
+    std::string_view keyframe(const TelemetryFrame& frame);
+};
+
+/**
+ * @brief Reference decoder for DeltaEncoder streams.
+ *
+ * Must be constructed with the encoder's quantum and fed every record in
+ * order. After a lost record, decode the next keyframe to resynchronize.
+ */
+class DeltaDecoder {
+public:
+    /**
+     * @throws std::invalid_argument unless quantum is positive and finite
+     */
+    explicit DeltaDecoder(double quantum = constants::DEFAULT_DELTA_QUANTUM);
+
+    /**
+     * @brief Apply one record and return the reconstructed frame.
+     *
+     * @throws std::invalid_argument if the record is malformed, or is a
+     *         delta that arrives before any keyframe or does not match the
+     *         keyframe's loop count
+     */
+    TelemetryFrame decode(const char* data, std::size_t size);
+
+    /// Whether a keyframe has been decoded since construction or reset()
+    bool synchronized() const { return synchronized_; }
+
+    /// Forget the reference; the next record must be a keyframe
+    void reset() { synchronized_ = false; }
+
+private:
+    double quantum_;
+    TelemetryFrame reference_;
+    bool synchronized_;
+};
+
+}  // namespace tank_sim
+
+#endif  // TANK_SIM_FRAME_DELTA_H
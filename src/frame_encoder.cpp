@@ -0,0 +1,160 @@
+#include "frame_encoder.h"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+namespace tank_sim {
+
+namespace {
+
+/// Append a string literal without its NUL
+template <std::size_t N>
+char* append(char* out, const char (&text)[N]) {
+    std::memcpy(out, text, N - 1);
+    return out + N - 1;
+}
+
+/**
+ * @brief Shortest round-trip decimal, with Python's ".0" for integers.
+ *
+ * Writes at most 26 characters.
+ */
+char* appendNumber(char* out, double value) {
+    if (!std::isfinite(value)) {
+        return append(out, "null");
+    }
+    char* end = std::to_chars(out, out + 32, value).ptr;
+    if (std::find_if(out, end, [](char c) { return c == '.' || c == 'e'; }) == end) {
+        end = append(end, ".0");
+    }
+    return end;
+}
+
+void putU64(char* out, std::uint64_t value) {
+    for (int i = 0; i < 8; ++i) {
+        out[i] = static_cast<char>(value >> (8 * i));
+    }
+}
+
+std::uint64_t getU64(const char* in) {
+    std::uint64_t value = 0;
+    for (int i = 0; i < 8; ++i) {
+        value |= static_cast<std::uint64_t>(static_cast<unsigned char>(in[i])) << (8 * i);
+    }
+    return value;
+}
+
+void putDouble(char* out, double value) {
+    std::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    putU64(out, bits);
+}
+
+double getDouble(const char* in) {
+    const std::uint64_t bits = getU64(in);
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+}  // namespace
+
+std::size_t FrameEncoder::writeJson(const TelemetryFrame& frame, char* out) {
+    const bool has_loop = frame.loopCount > 0;
+    char* p = out;
+    p = append(p, "{\"type\":\"state\",\"data\":{\"time\":");
+    p = appendNumber(p, frame.time);
+    p = append(p, ",\"tank_level\":");
+    p = appendNumber(p, frame.tankLevel);
+    p = append(p, ",\"setpoint\":");
+    p = appendNumber(p, has_loop ? frame.setpoint[0] : 0.0);
+    p = append(p, ",\"inlet_flow\":");
+    p = appendNumber(p, frame.inletFlow);
+    p = append(p, ",\"outlet_flow\":");
+    p = appendNumber(p, frame.outletFlow);
+    p = append(p, ",\"valve_position\":");
+    p = appendNumber(p, frame.valvePosition);
+    p = append(p, ",\"error\":");
+    p = appendNumber(p, has_loop ? frame.error[0] : 0.0);
+    p = append(p, ",\"controller_output\":");
+    p = appendNumber(p, has_loop ? frame.controllerOutput[0] : 0.0);
+    p = append(p, "}}");
+    return static_cast<std::size_t>(p - out);
+}
+
+std::size_t FrameEncoder::writeBinary(const TelemetryFrame& frame, char* out) {
+    const int loops = std::clamp(frame.loopCount, 0, TelemetryFrame::MAX_LOOPS);
+    const auto alarms = static_cast<std::uint32_t>(frame.activeAlarms);
+
+    out[0] = static_cast<char>(BINARY_KIND_STATE);
+    out[1] = static_cast<char>(BINARY_VERSION);
+    out[2] = static_cast<char>(loops & 0xff);
+    out[3] = static_cast<char>(loops >> 8);
+    for (int i = 0; i < 4; ++i) {
+        out[4 + i] = static_cast<char>(alarms >> (8 * i));
+    }
+    putU64(out + 8, frame.step);
+
+    char* p = out + BINARY_HEADER_SIZE;
+    for (double value : {frame.time, frame.tankLevel, frame.measuredLevel, frame.inletFlow,
+                         frame.outletFlow, frame.valvePosition}) {
+        putDouble(p, value);
+        p += 8;
+    }
+    for (int i = 0; i < loops; ++i) {
+        putDouble(p, frame.setpoint[i]);
+        putDouble(p + 8, frame.error[i]);
+        putDouble(p + 16, frame.controllerOutput[i]);
+        p += 24;
+    }
+    return static_cast<std::size_t>(p - out);
+}
+
+TelemetryFrame FrameEncoder::readBinary(const char* data, std::size_t size) {
+    // Validate the header - fail fast
+    if (size < BINARY_HEADER_SIZE) {
+        throw std::invalid_argument("Binary frame is shorter than its header");
+    }
+    const auto* bytes = reinterpret_cast<const unsigned char*>(data);
+    if (bytes[0] != BINARY_KIND_STATE || bytes[1] != BINARY_VERSION) {
+        throw std::invalid_argument("Unsupported binary frame kind or version");
+    }
+    const int loops = bytes[2] | (bytes[3] << 8);
+    if (loops > TelemetryFrame::MAX_LOOPS || size != binarySize(loops)) {
+        throw std::invalid_argument("Binary frame size does not match its loop count");
+    }
+
+    TelemetryFrame frame{};
+    frame.loopCount = loops;
+    frame.activeAlarms = static_cast<std::int32_t>(
+        bytes[4] | (bytes[5] << 8) | (bytes[6] << 16) | (static_cast<std::uint32_t>(bytes[7]) << 24));
+    frame.step = getU64(data + 8);
+
+    const char* p = data + BINARY_HEADER_SIZE;
+    double* scalars[] = {&frame.time, &frame.tankLevel, &frame.measuredLevel,
+                         &frame.inletFlow, &frame.outletFlow, &frame.valvePosition};
+    for (double* field : scalars) {
+        *field = getDouble(p);
+        p += 8;
+    }
+    for (int i = 0; i < loops; ++i) {
+        frame.setpoint[i] = getDouble(p);
+        frame.error[i] = getDouble(p + 8);
+        frame.controllerOutput[i] = getDouble(p + 16);
+        p += 24;
+    }
+    return frame;
+}
+
+std::string_view FrameEncoder::json(const TelemetryFrame& frame) {
+    return std::string_view(buffer_.data(), writeJson(frame, buffer_.data()));
+}
+
+std::string_view FrameEncoder::binary(const TelemetryFrame& frame) {
+    return std::string_view(buffer_.data(), writeBinary(frame, buffer_.data()));
+}
+
+}  // namespace tank_sim
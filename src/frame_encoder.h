@@ -0,0 +1,101 @@
+#ifndef TANK_SIM_FRAME_ENCODER_H
+#define TANK_SIM_FRAME_ENCODER_H
+
+#include "telemetry.h"
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+namespace tank_sim {
+
+/**
+ * @brief Renders telemetry frames into wire formats without allocating.
+ *
+ * Two encodings of a TelemetryFrame:
+ *
+ * - JSON: the WebSocket "state" message the frontend consumes,
+ *
+ *     {"type":"state","data":{"time":..,"tank_level":..,"setpoint":..,
+ *      "inlet_flow":..,"outlet_flow":..,"valve_position":..,"error":..,
+ *      "controller_output":..}}
+ *
+ *   with the loop values of the first loop (0 when there are no loops).
+ *   Numbers are written with std::to_chars in shortest round-trip form,
+ *   with ".0" added to integral values as Python's json module does, so
+ *   parsing gives back exactly the doubles in the frame. Non-finite values
+ *   are written as null.
+ *
+ * - Binary: a fixed little-endian record, BINARY_HEADER_SIZE bytes of
+ *   header followed by doubles:
+ *
+ *     offset  0  u8   kind (BINARY_KIND_STATE)
+ *     offset  1  u8   version (BINARY_VERSION)
+ *     offset  2  u16  loopCount
+ *     offset  4  i32  activeAlarms
+ *     offset  8  u64  step
+ *     offset 16  f64  time, tankLevel, measuredLevel, inletFlow,
+ *                     outletFlow, valvePosition
+ *     offset 64  f64  setpoint, error, controllerOutput for each loop
+ *
+ *   The size follows from loopCount (binarySize()), so a client can walk a
+ *   stream of records without a length prefix.
+ *
+ * The static writers render into caller-owned memory of at least
+ * MAX_JSON_SIZE / MAX_BINARY_SIZE bytes. An encoder instance owns one such
+ * buffer and returns views into it, valid until its next call.
+ */
+class FrameEncoder {
+public:
+    static constexpr std::size_t MAX_JSON_SIZE = 512;
+    static constexpr std::size_t BINARY_HEADER_SIZE = 16;
+    static constexpr std::size_t BINARY_SCALARS = 6;
+    static constexpr std::size_t MAX_BINARY_SIZE =
+        BINARY_HEADER_SIZE + 8 * (BINARY_SCALARS + 3 * TelemetryFrame::MAX_LOOPS);
+    static constexpr unsigned char BINARY_KIND_STATE = 1;
+    static constexpr unsigned char BINARY_VERSION = 1;
+
+    /**
+     * @brief Render the JSON state message.
+     *
+     * @param frame Frame to encode
+     * @param out Buffer of at least MAX_JSON_SIZE bytes
+     * @return Bytes written (no terminating NUL)
+     */
+    static std::size_t writeJson(const TelemetryFrame& frame, char* out);
+
+    /**
+     * @brief Render the binary record.
+     *
+     * @param frame Frame to encode (loopCount is clamped to [0, MAX_LOOPS])
+     * @param out Buffer of at least MAX_BINARY_SIZE bytes
+     * @return Bytes written, binarySize(loopCount)
+     */
+    static std::size_t writeBinary(const TelemetryFrame& frame, char* out);
+
+    /**
+     * @brief Parse one binary record.
+     *
+     * @throws std::invalid_argument if the kind, version or loop count is
+     *         wrong, or size is not binarySize(loopCount)
+     */
+    static TelemetryFrame readBinary(const char* data, std::size_t size);
+
+    /// Size of a binary record with the given number of loops
+    static constexpr std::size_t binarySize(int loop_count) {
+        return BINARY_HEADER_SIZE + 8 * (BINARY_SCALARS + 3 * static_cast<std::size_t>(loop_count));
+    }
+
+    /// JSON message in the encoder's buffer, valid until the next call
+    std::string_view json(const TelemetryFrame& frame);
+
+    /// Binary record in the encoder's buffer, valid until the next call
+    std::string_view binary(const TelemetryFrame& frame);
+
+private:
+    std::array<char, MAX_JSON_SIZE> buffer_;
+    static_assert(MAX_BINARY_SIZE <= MAX_JSON_SIZE, "Encoder buffer too small");
+};
+
+}  // namespace tank_sim
+
+#endif  // TANK_SIM_FRAME_ENCODER_H
@@ -0,0 +1,66 @@
+#include "gain_schedule.h"
+#include <stdexcept>
+
+namespace tank_sim {
+
+GainSchedule::GainSchedule(const std::vector<Point>& table) : bracket_(0) {
+    // Validate the table - fail fast
+    if (table.empty()) {
+        throw std::invalid_argument("Gain schedule table must not be empty");
+    }
+    const bool integral_enabled = table.front().gains.tau_I != 0.0;
+    for (size_t k = 0; k < table.size(); ++k) {
+        const Point& point = table[k];
+        if (k > 0 && !(point.x > table[k - 1].x)) {
+            throw std::invalid_argument("Gain schedule breakpoints must be strictly increasing");
+        }
+        if (point.gains.tau_I < 0.0 || point.gains.tau_D < 0.0) {
+            throw std::invalid_argument("Gain schedule time constants cannot be negative");
+        }
+        if ((point.gains.tau_I != 0.0) != integral_enabled) {
+            throw std::invalid_argument(
+                "Gain schedule tau_I must be zero at all breakpoints or at none");
+        }
+    }
+
+    x_.reserve(table.size());
+    kc_.reserve(table.size());
+    tau_i_.reserve(table.size());
+    tau_d_.reserve(table.size());
+    for (const Point& point : table) {
+        x_.push_back(point.x);
+        kc_.push_back(point.gains.Kc);
+        tau_i_.push_back(point.gains.tau_I);
+        tau_d_.push_back(point.gains.tau_D);
+    }
+}
+
+PIDController::Gains GainSchedule::lookup(double x) {
+    const int last = size() - 1;
+
+    // Clamp outside the table (also covers a single-point table)
+    if (last == 0 || x <= x_.front()) {
+        return PIDController::Gains{kc_.front(), tau_i_.front(), tau_d_.front()};
+    }
+    if (x >= x_.back()) {
+        return PIDController::Gains{kc_.back(), tau_i_.back(), tau_d_.back()};
+    }
+
+    // Walk from the cached interval; x is strictly inside (x_0, x_last) here,
+    // so both walks terminate inside the table.
+    int k = bracket_;
+    while (x < x_[k]) {
+        --k;
+    }
+    while (x > x_[k + 1]) {
+        ++k;
+    }
+    bracket_ = k;
+
+    const double w = (x - x_[k]) / (x_[k + 1] - x_[k]);
+    return PIDController::Gains{kc_[k] + w * (kc_[k + 1] - kc_[k]),
+                                tau_i_[k] + w * (tau_i_[k + 1] - tau_i_[k]),
+                                tau_d_[k] + w * (tau_d_[k + 1] - tau_d_[k])};
+}
+
+}  // namespace tank_sim
@@ -0,0 +1,83 @@
+#ifndef TANK_SIM_GAIN_SCHEDULE_H
+#define TANK_SIM_GAIN_SCHEDULE_H
+
+#include "control_graph.h"
+#include "pid_controller.h"
+#include <vector>
+
+namespace tank_sim {
+
+/**
+ * @brief Piecewise-linear PID gain table indexed by a scheduling variable.
+ *
+ * The tank's outlet flow follows q_out = k_v * x * sqrt(h), so the process
+ * gain seen by a level controller changes with level. A GainSchedule stores
+ * Kc, tau_I and tau_D at a set of breakpoints of a scheduling variable
+ * (level, flow, ...) and linearly interpolates between them each sample.
+ *
+ * ## Lookup Cost
+ *
+ * The index of the last bracketing interval is cached. A scheduling variable
+ * that moves by less than one interval per sample (the normal case for a
+ * physical signal) is found in O(1): lookup() first tests the cached
+ * interval and only then walks to a neighbour. Values outside the table are
+ * clamped to the end points.
+ *
+ * @note tau_I must be either zero at every breakpoint (no integral action)
+ *       or positive at every breakpoint; interpolating between "disabled"
+ *       and a finite integral time has no meaning.
+ */
+class GainSchedule {
+public:
+    /**
+     * @brief One table row: gains to use when the variable equals x.
+     */
+    struct Point {
+        double x;
+        PIDController::Gains gains;
+    };
+
+    /**
+     * @brief Construct a schedule from its breakpoints.
+     *
+     * @param table Breakpoints with strictly increasing x (at least one)
+     *
+     * @throws std::invalid_argument if the table is empty, x is not strictly
+     *         increasing, any tau is negative, or tau_I mixes zero and
+     *         non-zero values
+     */
+    explicit GainSchedule(const std::vector<Point>& table);
+
+    /**
+     * @brief Interpolate the gains at the given value of the scheduling variable.
+     *
+     * @param x Current value of the scheduling variable
+     * @return Interpolated gains (end-point gains outside the table range)
+     */
+    PIDController::Gains lookup(double x);
+
+    /// Index of the cached bracketing interval [x_k, x_{k+1}]
+    int bracket() const { return bracket_; }
+
+    int size() const { return static_cast<int>(x_.size()); }
+
+private:
+    std::vector<double> x_;
+    std::vector<double> kc_;
+    std::vector<double> tau_i_;
+    std::vector<double> tau_d_;
+    int bracket_;   ///< Last interval used; the search starts here
+};
+
+/**
+ * @brief Attaches a gain schedule to one controller of a Simulator.
+ */
+struct GainScheduleConfig {
+    int controller;                          ///< Index of the scheduled controller
+    SignalRef variable;                      ///< Scheduling variable (State or Input)
+    std::vector<GainSchedule::Point> table;  ///< Breakpoints
+};
+
+}  // namespace tank_sim
+
+#endif  // TANK_SIM_GAIN_SCHEDULE_H
@@ -0,0 +1,71 @@
+#include "hash_ring.h"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace tank_sim {
+
+namespace {
+
+/// splitmix64 finalizer: spreads shard points and keys over the ring
+std::uint64_t mix(std::uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+}  // namespace
+
+HashRing::HashRing(int replicas) : replicas_(replicas) {
+    if (replicas < 1) {
+        throw std::invalid_argument("Hash ring needs at least one point per shard");
+    }
+}
+
+void HashRing::addShard(int shard) {
+    if (shard < 0 || contains(shard)) {
+        throw std::invalid_argument("Shard id " + std::to_string(shard) +
+                                    " is negative or already on the ring");
+    }
+    for (int r = 0; r < replicas_; ++r) {
+        const std::uint64_t seed =
+            (static_cast<std::uint64_t>(shard) << 32) | static_cast<std::uint32_t>(r);
+        points_.emplace_back(mix(seed), shard);
+    }
+    std::sort(points_.begin(), points_.end());
+}
+
+void HashRing::removeShard(int shard) {
+    points_.erase(std::remove_if(points_.begin(), points_.end(),
+                                 [shard](const auto& point) { return point.second == shard; }),
+                  points_.end());
+}
+
+bool HashRing::contains(int shard) const {
+    return std::any_of(points_.begin(), points_.end(),
+                       [shard](const auto& point) { return point.second == shard; });
+}
+
+std::vector<int> HashRing::shards() const {
+    std::vector<int> ids;
+    for (const auto& point : points_) {
+        ids.push_back(point.second);
+    }
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+    return ids;
+}
+
+int HashRing::shardFor(std::uint64_t key) const {
+    if (points_.empty()) {
+        throw std::logic_error("Hash ring has no shards");
+    }
+    const std::uint64_t hash = mix(key);
+    auto it = std::lower_bound(points_.begin(), points_.end(),
+                               std::make_pair(hash, std::numeric_limits<int>::min()));
+    return it != points_.end() ? it->second : points_.front().second;
+}
+
+}  // namespace tank_sim
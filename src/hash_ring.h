@@ -0,0 +1,63 @@
+#ifndef TANK_SIM_HASH_RING_H
+#define TANK_SIM_HASH_RING_H
+
+#include "constants.h"
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace tank_sim {
+
+/**
+ * @brief Consistent-hash ring mapping session keys to shards.
+ *
+ * Every shard owns `replicas` pseudo-random points on a 64-bit ring; a key
+ * belongs to the shard of the first point at or after the key's hash,
+ * wrapping around. Adding or removing a shard therefore moves only the
+ * keys between its points and their predecessors, about 1/N of them, and
+ * every process that builds a ring from the same shard ids agrees on the
+ * owner of every key.
+ *
+ * Lookups are a binary search over the sorted points.
+ */
+class HashRing {
+public:
+    /**
+     * @param replicas Points per shard
+     *
+     * @throws std::invalid_argument if replicas < 1
+     */
+    explicit HashRing(int replicas = constants::SHARD_RING_REPLICAS);
+
+    /**
+     * @brief Add a shard's points.
+     *
+     * @throws std::invalid_argument if the shard id is negative or present
+     */
+    void addShard(int shard);
+
+    /// Remove a shard's points; unknown ids are ignored
+    void removeShard(int shard);
+
+    bool contains(int shard) const;
+
+    /// Shard ids on the ring, ascending
+    std::vector<int> shards() const;
+
+    bool empty() const { return points_.empty(); }
+
+    /**
+     * @brief Owner of a key.
+     *
+     * @throws std::logic_error if the ring has no shards
+     */
+    int shardFor(std::uint64_t key) const;
+
+private:
+    int replicas_;
+    std::vector<std::pair<std::uint64_t, int>> points_;   ///< (point, shard), sorted
+};
+
+}  // namespace tank_sim
+
+#endif  // TANK_SIM_HASH_RING_H
@@ -0,0 +1,259 @@
+#include "history_codec.h"
+#include <array>
+#include <cstring>
+#include <stdexcept>
+
+namespace tank_sim {
+
+namespace {
+
+constexpr int FIELDS = 7;
+
+/// XOR-coded sample fields in stream order (time, first, is coded apart)
+constexpr std::array<double SessionSample::*, FIELDS> XOR_FIELDS = {
+    &SessionSample::tankLevel,     &SessionSample::setpoint,
+    &SessionSample::inletFlow,     &SessionSample::outletFlow,
+    &SessionSample::valvePosition, &SessionSample::error,
+    &SessionSample::controllerOutput};
+
+std::uint64_t toBits(double value) {
+    std::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+double fromBits(std::uint64_t bits) {
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+std::uint64_t lowMask(int bits) { return bits >= 64 ? ~0ULL : (1ULL << bits) - 1; }
+
+/// MSB-first bit stream appended to a string
+class BitWriter {
+public:
+    explicit BitWriter(std::string& out) : out_(out), acc_(0), used_(0) {}
+
+    void write(std::uint64_t value, int bits) {
+        // At most 32 bits at a time keep the accumulator below 40 bits
+        if (bits > 32) {
+            write(value >> 32, bits - 32);
+            bits = 32;
+        }
+        acc_ = (acc_ << bits) | (value & lowMask(bits));
+        used_ += bits;
+        while (used_ >= 8) {
+            used_ -= 8;
+            out_.push_back(static_cast<char>(acc_ >> used_));
+        }
+        acc_ &= lowMask(used_);
+    }
+
+    void finish() {
+        if (used_ > 0) {
+            out_.push_back(static_cast<char>(acc_ << (8 - used_)));
+            acc_ = 0;
+            used_ = 0;
+        }
+    }
+
+private:
+    std::string& out_;
+    std::uint64_t acc_;
+    int used_;
+};
+
+class BitReader {
+public:
+    explicit BitReader(std::string_view in) : in_(in), pos_(0), acc_(0), used_(0) {}
+
+    std::uint64_t read(int bits) {
+        if (bits > 32) {
+            const std::uint64_t high = read(bits - 32);
+            return (high << 32) | read(32);
+        }
+        while (used_ < bits) {
+            if (pos_ >= in_.size()) {
+                throw std::invalid_argument("Corrupt history block: stream ends early");
+            }
+            acc_ = (acc_ << 8) | static_cast<unsigned char>(in_[pos_++]);
+            used_ += 8;
+        }
+        used_ -= bits;
+        const std::uint64_t value = (acc_ >> used_) & lowMask(bits);
+        acc_ &= lowMask(used_);
+        return value;
+    }
+
+private:
+    std::string_view in_;
+    std::size_t pos_;
+    std::uint64_t acc_;
+    int used_;
+};
+
+/// Per-field XOR state: the last meaningful-bit window
+struct XorWindow {
+    int leading = -1;   ///< -1 until the first non-zero XOR
+    int trailing = 0;
+};
+
+void encodeXor(BitWriter& out, XorWindow& window, std::uint64_t x) {
+    if (x == 0) {
+        out.write(0, 1);
+        return;
+    }
+    int leading = __builtin_clzll(x);
+    const int trailing = __builtin_ctzll(x);
+    if (leading > 31) {
+        leading = 31;   // 5-bit field
+    }
+    if (window.leading >= 0 && leading >= window.leading && trailing >= window.trailing) {
+        // Fits the previous window: control bits 10
+        out.write(0b10, 2);
+        out.write(x >> window.trailing, 64 - window.leading - window.trailing);
+        return;
+    }
+    // New window: control bits 11, leading zeros, meaningful length (64 as 0)
+    const int meaningful = 64 - leading - trailing;
+    out.write(0b11, 2);
+    out.write(static_cast<std::uint64_t>(leading), 5);
+    out.write(static_cast<std::uint64_t>(meaningful & 63), 6);
+    out.write(x >> trailing, meaningful);
+    window.leading = leading;
+    window.trailing = trailing;
+}
+
+std::uint64_t decodeXor(BitReader& in, XorWindow& window) {
+    if (in.read(1) == 0) {
+        return 0;
+    }
+    if (in.read(1) == 0) {
+        if (window.leading < 0) {
+            throw std::invalid_argument("Corrupt history block: window used before set");
+        }
+        const int meaningful = 64 - window.leading - window.trailing;
+        return in.read(meaningful) << window.trailing;
+    }
+    const int leading = static_cast<int>(in.read(5));
+    int meaningful = static_cast<int>(in.read(6));
+    if (meaningful == 0) {
+        meaningful = 64;
+    }
+    if (leading + meaningful > 64) {
+        throw std::invalid_argument("Corrupt history block: bad window");
+    }
+    window.leading = leading;
+    window.trailing = 64 - leading - meaningful;
+    return in.read(meaningful) << window.trailing;
+}
+
+/**
+ * Time is coded as the delta-of-delta of its bit pattern: successive
+ * positive doubles are successive integers, so a fixed step is a constant
+ * delta within a binade, and accumulated rounding moves it by an ulp or two.
+ */
+struct TimeCoder {
+    std::uint64_t previous = 0;
+    std::uint64_t delta = 0;
+};
+
+void encodeTime(BitWriter& out, TimeCoder& coder, double time) {
+    const std::uint64_t bits = toBits(time);
+    const std::uint64_t delta = bits - coder.previous;
+    const auto dod = static_cast<std::int64_t>(delta - coder.delta);
+    const std::uint64_t zigzag = (static_cast<std::uint64_t>(dod) << 1) ^
+                                 static_cast<std::uint64_t>(dod >> 63);
+    if (zigzag == 0) {
+        out.write(0, 1);
+    } else if (zigzag < (1ULL << 7)) {
+        out.write(0b10, 2);
+        out.write(zigzag, 7);
+    } else if (zigzag < (1ULL << 12)) {
+        out.write(0b110, 3);
+        out.write(zigzag, 12);
+    } else if (zigzag < (1ULL << 20)) {
+        out.write(0b1110, 4);
+        out.write(zigzag, 20);
+    } else {
+        out.write(0b1111, 4);
+        out.write(zigzag, 64);
+    }
+    coder.previous = bits;
+    coder.delta = delta;
+}
+
+double decodeTime(BitReader& in, TimeCoder& coder) {
+    std::uint64_t zigzag = 0;
+    if (in.read(1) != 0) {
+        int width = 64;
+        if (in.read(1) == 0) {
+            width = 7;
+        } else if (in.read(1) == 0) {
+            width = 12;
+        } else if (in.read(1) == 0) {
+            width = 20;
+        }
+        zigzag = in.read(width);
+    }
+    const std::uint64_t dod = (zigzag >> 1) ^ (~(zigzag & 1) + 1);
+    coder.delta += dod;
+    coder.previous += coder.delta;
+    return fromBits(coder.previous);
+}
+
+}  // namespace
+
+CompressedHistory::CompressedHistory() : count_(0), block_(sizeof(std::uint32_t), '\0') {}
+
+CompressedHistory::CompressedHistory(const std::vector<SessionSample>& samples)
+    : count_(static_cast<std::uint32_t>(samples.size())) {
+    block_.reserve(sizeof(count_) + samples.size() * 8);
+    block_.append(reinterpret_cast<const char*>(&count_), sizeof(count_));
+    BitWriter out(block_);
+    TimeCoder time;
+    std::array<XorWindow, FIELDS> windows{};
+    const SessionSample* previous = nullptr;
+    for (const SessionSample& sample : samples) {
+        encodeTime(out, time, sample.time);
+        for (int f = 0; f < FIELDS; ++f) {
+            // Each field is predicted to repeat its previous value
+            const double predicted = previous ? previous->*XOR_FIELDS[f] : 0.0;
+            encodeXor(out, windows[f], toBits(sample.*XOR_FIELDS[f]) ^ toBits(predicted));
+        }
+        previous = &sample;
+    }
+    out.finish();
+}
+
+CompressedHistory CompressedHistory::fromBytes(std::string_view block) {
+    CompressedHistory history;
+    // Validate the header - fail fast; every sample takes at least a byte
+    if (block.size() < sizeof(history.count_)) {
+        throw std::invalid_argument("Corrupt history block: missing header");
+    }
+    std::memcpy(&history.count_, block.data(), sizeof(history.count_));
+    if (history.count_ > block.size() - sizeof(history.count_)) {
+        throw std::invalid_argument("Corrupt history block: sample count too large");
+    }
+    history.block_.assign(block.data(), block.size());
+    return history;
+}
+
+std::vector<SessionSample> CompressedHistory::decode() const {
+    std::vector<SessionSample> samples(count_);
+    BitReader in(std::string_view(block_).substr(sizeof(count_)));
+    TimeCoder time;
+    std::array<XorWindow, FIELDS> windows{};
+    for (std::size_t i = 0; i < samples.size(); ++i) {
+        samples[i].time = decodeTime(in, time);
+        for (int f = 0; f < FIELDS; ++f) {
+            const double predicted = i > 0 ? samples[i - 1].*XOR_FIELDS[f] : 0.0;
+            samples[i].*XOR_FIELDS[f] = fromBits(decodeXor(in, windows[f]) ^ toBits(predicted));
+        }
+    }
+    return samples;
+}
+
+}  // namespace tank_sim
@@ -0,0 +1,64 @@
+#ifndef TANK_SIM_HISTORY_CODEC_H
+#define TANK_SIM_HISTORY_CODEC_H
+
+#include "shared_session_store.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace tank_sim {
+
+/**
+ * @brief A session's history (SessionSamples) in a compact, lossless block.
+ *
+ * The coding follows Gorilla (Pelkonen et al., VLDB 2015). Each value
+ * field is XORed with its previous value and written as one 0 bit when it
+ * repeats, otherwise as the meaningful (non-zero) bits of the XOR with
+ * their position; setpoints and flows often repeat and levels change in
+ * the low bits, so most fields cost a few bits. Time is written as the
+ * delta-of-delta of its bit pattern, so a fixed step costs one bit. Only
+ * integer operations on the bits are involved: every sample comes back
+ * bit for bit.
+ *
+ * Block layout: sample count (uint32, host order), then the bit stream,
+ * row by row, MSB first.
+ */
+class CompressedHistory {
+public:
+    /// Empty history
+    CompressedHistory();
+
+    /// Compress samples, oldest first
+    explicit CompressedHistory(const std::vector<SessionSample>& samples);
+
+    /**
+     * @brief Take a block written by bytes().
+     *
+     * @throws std::invalid_argument if the block is too short for its
+     *         sample count header (the stream itself is checked by decode())
+     */
+    static CompressedHistory fromBytes(std::string_view block);
+
+    /// Samples in the block
+    std::size_t size() const { return count_; }
+
+    /// The block, for storage
+    const std::string& bytes() const { return block_; }
+
+    /**
+     * @brief Decompress all samples, oldest first.
+     *
+     * @throws std::invalid_argument if the block is corrupt
+     */
+    std::vector<SessionSample> decode() const;
+
+private:
+    std::uint32_t count_;
+    std::string block_;
+};
+
+}  // namespace tank_sim
+
+#endif  // TANK_SIM_HISTORY_CODEC_H
@@ -0,0 +1,55 @@
+#include "level_estimator.h"
+
+namespace tank_sim {
+
+// exp(J*dt) below is taken elementwise, which is the matrix exponential only
+// for the single-state tank
+static_assert(constants::TANK_STATE_SIZE == 1,
+              "LevelEstimator transition assumes a scalar tank state");
+
+namespace {
+
+LevelEstimator::Filter::StateMatrix scaledIdentity(double value) {
+    return LevelEstimator::Filter::StateMatrix::Identity() * value;
+}
+
+}  // namespace
+
+LevelEstimator::LevelEstimator(const Settings& settings,
+                               const TankModel::StateVector& initial_state)
+    : settings_(settings),
+      filter_(initial_state, scaledIdentity(settings.initialVariance),
+              scaledIdentity(settings.processNoise),
+              scaledIdentity(settings.measurementNoise)) {}
+
+const TankModel::StateVector& LevelEstimator::update(
+    const TankModel& model, const TankModel::InputVector& inputs,
+    const TankModel::StateVector& measurement, double dt) {
+    const TankModel::StateVector& x = filter_.state();
+
+    // Step 1: Transition Jacobian at the previous estimate, exp(J*dt)
+    const Filter::StateMatrix transition =
+        (model.stateJacobian(x, inputs) * dt).array().exp().matrix();
+
+    // Step 2: Propagate the estimate with one RK4 step (inputs held)
+    using Vector = TankModel::StateVector;
+    const Vector k1 = model.derivatives(x, inputs);
+    const Vector k2 = model.derivatives(Vector(x + 0.5 * dt * k1), inputs);
+    const Vector k3 = model.derivatives(Vector(x + 0.5 * dt * k2), inputs);
+    const Vector k4 = model.derivatives(Vector(x + dt * k3), inputs);
+    const Vector predicted = x + dt / 6.0 * (k1 + 2.0 * k2 + 2.0 * k3 + k4);
+
+    filter_.predict(predicted, transition);
+
+    // Step 3: Correct with the level reading (H = I, so h(x) = x)
+    const TankModel::StateVector predicted_measurement = filter_.state();
+    filter_.update(measurement, predicted_measurement,
+                   Filter::MeasurementMatrix::Identity());
+    return filter_.state();
+}
+
+void LevelEstimator::reset(const TankModel::StateVector& state) {
+    filter_.reset(state, scaledIdentity(settings_.initialVariance));
+}
+
+}  // namespace tank_sim
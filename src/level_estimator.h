@@ -0,0 +1,77 @@
+#ifndef TANK_SIM_LEVEL_ESTIMATOR_H
+#define TANK_SIM_LEVEL_ESTIMATOR_H
+
+#include "constants.h"
+#include "extended_kalman_filter.h"
+#include "tank_model.h"
+
+namespace tank_sim {
+
+/**
+ * @brief EKF that estimates the tank state from a noisy level sensor.
+ *
+ * Prediction integrates TankModel over one sample with a fixed-size RK4 step
+ * using the inputs that were applied during the sample. The transition
+ * Jacobian is exp(J*dt), with J the analytic TankModel::stateJacobian at the
+ * previous estimate (exact for the linearized model). The measurement is the
+ * level itself, so H = I.
+ *
+ * Every call is allocation-free: the filter, model vectors and Jacobians are
+ * all fixed-size.
+ */
+class LevelEstimator {
+public:
+    using Filter = ExtendedKalmanFilter<constants::TANK_STATE_SIZE,
+                                        constants::TANK_STATE_SIZE>;
+
+    /**
+     * @brief Noise model of the estimator.
+     */
+    struct Settings {
+        double processNoise = constants::DEFAULT_ESTIMATOR_PROCESS_NOISE;          ///< Q (m² per sample)
+        double measurementNoise = constants::DEFAULT_ESTIMATOR_MEASUREMENT_NOISE;  ///< R (m²)
+        double initialVariance = constants::DEFAULT_ESTIMATOR_INITIAL_VARIANCE;    ///< P0 (m²)
+    };
+
+    /**
+     * @brief Construct an estimator starting at the given state.
+     *
+     * @param settings Noise model
+     * @param initial_state Initial estimate
+     *
+     * @throws std::invalid_argument if a variance is negative or the
+     *         measurement noise is not positive
+     */
+    LevelEstimator(const Settings& settings, const TankModel::StateVector& initial_state);
+
+    /**
+     * @brief Run one predict/update cycle.
+     *
+     * @param model Plant model used for prediction
+     * @param inputs Inputs applied over the sample that just ended
+     * @param measurement Sensor reading at the end of the sample
+     * @param dt Sample time in seconds
+     * @return Filtered state estimate
+     */
+    const TankModel::StateVector& update(const TankModel& model,
+                                         const TankModel::InputVector& inputs,
+                                         const TankModel::StateVector& measurement,
+                                         double dt);
+
+    /**
+     * @brief Restart at the given state with the initial variance.
+     */
+    void reset(const TankModel::StateVector& state);
+
+    const TankModel::StateVector& estimate() const { return filter_.state(); }
+    const Filter::StateMatrix& covariance() const { return filter_.covariance(); }
+    const Filter::MeasurementVector& innovation() const { return filter_.innovation(); }
+
+private:
+    Settings settings_;
+    Filter filter_;
+};
+
+}  // namespace tank_sim
+
+#endif  // TANK_SIM_LEVEL_ESTIMATOR_H
@@ -0,0 +1,259 @@
+#include "loop_health.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace tank_sim {
+
+namespace {
+
+constexpr double NaN = std::numeric_limits<double>::quiet_NaN();
+
+}  // namespace
+
+LoopHealth::LoopHealth(const Settings& settings) : settings_(settings) {
+    // Validate settings - fail fast
+    if (settings.arOrder < 1) {
+        throw std::invalid_argument("AR order must be at least 1");
+    }
+    if (settings.window < 8 || settings.window <= settings.arOrder) {
+        throw std::invalid_argument("Health window must be at least 8 and exceed the AR order");
+    }
+    if (settings.crossings < 2) {
+        throw std::invalid_argument("Regularity needs at least 2 periods");
+    }
+    if (settings.delay < 1) {
+        throw std::invalid_argument("Minimum-variance delay must be at least 1 sample");
+    }
+    if (settings.noiseBand < 0.0) {
+        throw std::invalid_argument("Noise band must be non-negative");
+    }
+
+    const int window = settings.window;
+    periods_.resize(settings.crossings);
+    history_.resize(window + settings.arOrder + 1);
+    bins_.resize(window / 2);
+    twiddles_.resize(window / 2);
+    for (int k = 1; k <= window / 2; ++k) {
+        twiddles_[k - 1] = std::polar(1.0, constants::TWO_PI * k / window);
+    }
+    damping_window_ = std::pow(constants::SLIDING_DFT_DAMPING, window);
+    lag_sums_.resize(settings.arOrder + 1);
+    autocovariance_.resize(settings.arOrder + 1);
+    ar_.resize(settings.arOrder + 1);
+    ar_previous_.resize(settings.arOrder + 1);
+    impulse_.resize(settings.delay);
+
+    reset();
+}
+
+void LoopHealth::reset() {
+    time_ = 0.0;
+    dt_ = 0.0;
+    samples_ = 0;
+
+    sign_ = 0;
+    last_up_ = NaN;
+    last_down_ = NaN;
+    std::fill(periods_.begin(), periods_.end(), 0.0);
+    period_head_ = 0;
+    period_count_ = 0;
+    period_ = NaN;
+    regularity_ = NaN;
+
+    std::fill(history_.begin(), history_.end(), 0.0);
+    history_head_ = 0;
+    std::fill(bins_.begin(), bins_.end(), std::complex<double>(0.0, 0.0));
+    sum_ = 0.0;
+    std::fill(lag_sums_.begin(), lag_sums_.end(), 0.0);
+    harris_ = NaN;
+}
+
+void LoopHealth::update(double error, double dt) {
+    const int window = settings_.window;
+    const int order = settings_.arOrder;
+    const int size = static_cast<int>(history_.size());
+
+    dt_ = dt;
+    time_ += dt;
+    ++samples_;
+
+    // Step 1: Zero crossings with hysteresis
+    if (error > settings_.noiseBand) {
+        if (sign_ < 0) {
+            recordCrossing(last_up_);
+        }
+        sign_ = 1;
+    } else if (error < -settings_.noiseBand) {
+        if (sign_ > 0) {
+            recordCrossing(last_down_);
+        }
+        sign_ = -1;
+    }
+
+    // A loop that stopped crossing for two periods is no longer oscillating
+    if (period_count_ > 0) {
+        const double last = std::max(std::isnan(last_up_) ? 0.0 : last_up_,
+                                     std::isnan(last_down_) ? 0.0 : last_down_);
+        if (time_ - last > 2.0 * period_) {
+            period_count_ = 0;
+            period_head_ = 0;
+            period_ = NaN;
+            regularity_ = NaN;
+        }
+    }
+
+    // Step 2: Store the sample; lag j is at history_[head - j]
+    history_head_ = (history_head_ + 1) % size;
+    history_[history_head_] = error;
+    auto lagged = [&](int lag) { return history_[(history_head_ - lag + size) % size]; };
+
+    // Step 3: Slide the sums: add the new sample, drop the one leaving the window
+    sum_ += error;
+    for (int k = 0; k <= order; ++k) {
+        if (k < samples_) {
+            lag_sums_[k] += error * lagged(k);
+        }
+    }
+    const double leaving = samples_ > window ? lagged(window) : 0.0;
+    if (samples_ > window) {
+        sum_ -= leaving;
+        for (int k = 0; k <= order; ++k) {
+            if (window + k < samples_) {
+                lag_sums_[k] -= leaving * lagged(window + k);
+            }
+        }
+    }
+
+    // Step 4: Sliding DFT, X_k <- e^{jw_k} (r X_k + x_n - r^N x_{n-N})
+    const double delta = error - damping_window_ * leaving;
+    for (size_t k = 0; k < bins_.size(); ++k) {
+        bins_[k] = twiddles_[k] * (constants::SLIDING_DFT_DAMPING * bins_[k] + delta);
+    }
+
+    // Step 5: Harris index once the window is full
+    if (samples_ >= window) {
+        refreshHarrisIndex();
+    }
+}
+
+void LoopHealth::recordCrossing(double& last_crossing) {
+    if (!std::isnan(last_crossing)) {
+        periods_[period_head_] = time_ - last_crossing;
+        period_head_ = (period_head_ + 1) % settings_.crossings;
+        period_count_ = std::min(period_count_ + 1, settings_.crossings);
+
+        if (period_count_ == settings_.crossings) {
+            double mean = 0.0;
+            for (double p : periods_) {
+                mean += p;
+            }
+            mean /= settings_.crossings;
+            double variance = 0.0;
+            for (double p : periods_) {
+                variance += (p - mean) * (p - mean);
+            }
+            variance /= settings_.crossings - 1;
+
+            period_ = mean;
+            regularity_ = variance > 0.0 ? mean / (3.0 * std::sqrt(variance))
+                                         : std::numeric_limits<double>::infinity();
+        }
+    }
+    last_crossing = time_;
+}
+
+void LoopHealth::refreshHarrisIndex() {
+    const int order = settings_.arOrder;
+    const double n = static_cast<double>(settings_.window);
+    const double mean = sum_ / n;
+    for (int k = 0; k <= order; ++k) {
+        autocovariance_[k] = lag_sums_[k] / n - mean * mean;
+    }
+
+    const double variance = autocovariance_[0];
+    if (variance <= settings_.noiseBand * settings_.noiseBand || variance <= 0.0) {
+        harris_ = NaN;
+        return;
+    }
+
+    // Levinson-Durbin: x_t = sum a_i x_{t-i} + e_t, innovation variance
+    std::fill(ar_.begin(), ar_.end(), 0.0);
+    double innovation = variance;
+    for (int m = 1; m <= order; ++m) {
+        double acc = autocovariance_[m];
+        for (int i = 1; i < m; ++i) {
+            acc -= ar_[i] * autocovariance_[m - i];
+        }
+        const double reflection = acc / innovation;
+        if (std::abs(reflection) >= 1.0) {
+            break;  // Not positive definite (rounding); keep order m - 1
+        }
+        ar_previous_ = ar_;
+        ar_[m] = reflection;
+        for (int i = 1; i < m; ++i) {
+            ar_[i] = ar_previous_[i] - reflection * ar_previous_[m - i];
+        }
+        innovation *= 1.0 - reflection * reflection;
+    }
+
+    // Minimum variance = innovation * sum of the first `delay` impulse coefficients^2
+    double impulse_energy = 0.0;
+    for (int j = 0; j < settings_.delay; ++j) {
+        double psi = j == 0 ? 1.0 : 0.0;
+        for (int i = 1; i <= std::min(j, order); ++i) {
+            psi += ar_[i] * impulse_[j - i];
+        }
+        impulse_[j] = psi;
+        impulse_energy += psi * psi;
+    }
+
+    harris_ = std::min(1.0, innovation * impulse_energy / variance);
+}
+
+LoopHealth::Status LoopHealth::status() const {
+    const int window = settings_.window;
+    const bool full = samples_ >= window;
+
+    Status result;
+    result.samples = samples_;
+    result.period = period_;
+    result.regularity = regularity_;
+    result.harrisIndex = harris_;
+    result.peakPeriod = NaN;
+    result.peakFraction = NaN;
+    result.errorStdDev = NaN;
+
+    if (samples_ > 0) {
+        const double n = static_cast<double>(std::min<long long>(samples_, window));
+        const double mean = sum_ / n;
+        result.errorStdDev = std::sqrt(std::max(0.0, lag_sums_[0] / n - mean * mean));
+    }
+    const bool quiet = !(result.errorStdDev > settings_.noiseBand);
+
+    // Spectral peak: Parseval gives sum (x - mean)^2 = 2/N sum_{k<N/2} |X_k|^2
+    if (full && !quiet) {
+        const int half = static_cast<int>(bins_.size());
+        int peak = 0;
+        for (int k = 1; k < half; ++k) {
+            if (std::norm(bins_[k]) > std::norm(bins_[peak])) {
+                peak = k;
+            }
+        }
+        const double energy = result.errorStdDev * result.errorStdDev * window * window;
+        double power = 0.0;
+        for (int k = std::max(0, peak - 1); k <= std::min(half - 1, peak + 1); ++k) {
+            power += (k == half - 1 && window % 2 == 0 ? 1.0 : 2.0) * std::norm(bins_[k]);
+        }
+        result.peakPeriod = window * dt_ / (peak + 1);
+        result.peakFraction = std::min(1.0, power / energy);
+    }
+
+    result.oscillating = !quiet && result.regularity > settings_.regularityThreshold &&
+                         result.peakFraction > settings_.spectralThreshold;
+    result.poorPerformance = !quiet && result.harrisIndex < settings_.harrisThreshold;
+    return result;
+}
+
+}  // namespace tank_sim
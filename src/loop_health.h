@@ -0,0 +1,136 @@
+#ifndef TANK_SIM_LOOP_HEALTH_H
+#define TANK_SIM_LOOP_HEALTH_H
+
+#include "constants.h"
+#include <complex>
+#include <vector>
+
+namespace tank_sim {
+
+/**
+ * @brief Streaming oscillation detection and Harris performance index for
+ * one control loop.
+ *
+ * Fed the control error once per step, it maintains three detectors:
+ *
+ * - Zero-crossing regularity: the error crosses zero (with a hysteresis of
+ *   +/- noiseBand) and the period between successive crossings in the same
+ *   direction is recorded. Over the last `crossings` periods the regularity
+ *   factor r = mean(T) / (3 std(T)) exceeds 1 for a sustained oscillation
+ *   and stays well below it for noise.
+ * - Spectral peak: a sliding DFT of the last `window` samples keeps every
+ *   bin up to Nyquist in O(window/2) per step. The peak bin (plus its two
+ *   neighbours, to cover leakage) is reported as a fraction of the window's
+ *   variance; a single sinusoid approaches 1, white noise about 3/window.
+ * - Harris index: sliding autocovariances at lags 0..arOrder over the same
+ *   window are fitted with an AR model by Levinson-Durbin. The first `delay`
+ *   coefficients of its impulse response give the minimum achievable
+ *   (minimum-variance) error variance, and the index is that variance
+ *   divided by the actual variance: 1 = at the benchmark, near 0 = poor.
+ *
+ * The loop is flagged as oscillating when both the regularity and the
+ * spectral concentration exceed their thresholds, and as performing poorly
+ * when the Harris index falls below its threshold. Signals whose standard
+ * deviation is within noiseBand are considered quiet and never flagged.
+ *
+ * Buffers are sized at construction; update() does not allocate.
+ */
+class LoopHealth {
+public:
+    /**
+     * @brief Detector settings.
+     */
+    struct Settings {
+        int window = constants::DEFAULT_HEALTH_WINDOW;                 ///< Samples in the spectral/AR window
+        int crossings = constants::DEFAULT_HEALTH_CROSSINGS;           ///< Periods used for regularity
+        double noiseBand = constants::DEFAULT_HEALTH_NOISE_BAND;       ///< Error hysteresis/quiet band
+        double regularityThreshold = constants::DEFAULT_HEALTH_REGULARITY_THRESHOLD;
+        double spectralThreshold = constants::DEFAULT_HEALTH_SPECTRAL_THRESHOLD;
+        int arOrder = constants::DEFAULT_HEALTH_AR_ORDER;              ///< AR model order
+        int delay = constants::DEFAULT_HEALTH_DELAY;                   ///< Process delay (samples)
+        double harrisThreshold = constants::DEFAULT_HEALTH_HARRIS_THRESHOLD;
+    };
+
+    /**
+     * @brief Detector outputs at one instant.
+     *
+     * Quantities that are not yet available (too few crossings, window not
+     * full, quiet signal) are NaN.
+     */
+    struct Status {
+        bool oscillating;          ///< Regular and spectrally concentrated oscillation
+        bool poorPerformance;      ///< Harris index below threshold
+        double period;             ///< Mean zero-crossing period (s)
+        double regularity;         ///< mean(T) / (3 std(T))
+        double peakPeriod;         ///< Period of the spectral peak (s)
+        double peakFraction;       ///< Share of window variance in the peak
+        double harrisIndex;        ///< Minimum-variance / actual variance
+        double errorStdDev;        ///< Error standard deviation over the window
+        long long samples;         ///< Samples seen since the last reset
+    };
+
+    /**
+     * @throws std::invalid_argument if the window is shorter than 8 or not
+     *         longer than arOrder, crossings < 2, arOrder < 1,
+     *         delay < 1 or noiseBand < 0
+     */
+    explicit LoopHealth(const Settings& settings);
+
+    /**
+     * @brief Add one error sample.
+     *
+     * @param error Control error (setpoint - measured)
+     * @param dt Time step in seconds
+     */
+    void update(double error, double dt);
+
+    /**
+     * @brief Clear all history.
+     */
+    void reset();
+
+    Status status() const;
+
+private:
+    void recordCrossing(double& last_crossing);
+    void refreshHarrisIndex();
+
+    Settings settings_;
+    double time_;
+    double dt_;
+    long long samples_;
+
+    // Zero crossings: -1/+1 once the error has left the band, 0 before
+    int sign_;
+    double last_up_;
+    double last_down_;
+    std::vector<double> periods_;  ///< Ring of the last `crossings` periods
+    int period_head_;
+    int period_count_;
+    double period_;
+    double regularity_;
+
+    // Sample history: window + arOrder + 1 samples for the lag sums
+    std::vector<double> history_;
+    int history_head_;
+
+    // Sliding DFT bins 1..window/2 and their rotations
+    std::vector<std::complex<double>> bins_;
+    std::vector<std::complex<double>> twiddles_;
+    double damping_window_;  ///< damping^window
+
+    // Sliding sums over the window: sum x and sum x_t x_{t-k}, k = 0..arOrder
+    double sum_;
+    std::vector<double> lag_sums_;
+    double harris_;
+
+    // Levinson-Durbin and impulse response workspace
+    std::vector<double> autocovariance_;
+    std::vector<double> ar_;
+    std::vector<double> ar_previous_;
+    std::vector<double> impulse_;
+};
+
+}  // namespace tank_sim
+
+#endif  // TANK_SIM_LOOP_HEALTH_H
@@ -0,0 +1,92 @@
+#include "loop_performance.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace tank_sim {
+
+namespace {
+
+constexpr double NaN = std::numeric_limits<double>::quiet_NaN();
+
+}  // namespace
+
+LoopPerformance::LoopPerformance(const Settings& settings) : settings_(settings) {
+    // Validate thresholds - fail fast
+    if (settings.settlingBand <= 0.0) {
+        throw std::invalid_argument("Settling band must be positive");
+    }
+    if (!(settings.riseLow >= 0.0 && settings.riseLow < settings.riseHigh &&
+          settings.riseHigh <= 1.0)) {
+        throw std::invalid_argument("Rise thresholds must satisfy 0 <= low < high <= 1");
+    }
+    restart(0.0, 0.0, 0.0);
+}
+
+void LoopPerformance::restart(double setpoint, double measured, double output) {
+    elapsed_ = 0.0;
+    start_ = measured;
+    step_ = setpoint - measured;
+    iae_ = 0.0;
+    ise_ = 0.0;
+    itae_ = 0.0;
+    peak_ = 0.0;
+    rise_low_time_ = NaN;
+    rise_time_ = NaN;
+    last_outside_ = 0.0;
+    inside_ = false;
+    previous_output_ = output;
+    travel_ = 0.0;
+}
+
+void LoopPerformance::update(double setpoint, double measured, double output, double dt) {
+    elapsed_ += dt;
+
+    // Integral indices (rectangle rule at the end of the step)
+    const double error = setpoint - measured;
+    const double abs_error = std::abs(error);
+    iae_ += abs_error * dt;
+    ise_ += error * error * dt;
+    itae_ += elapsed_ * abs_error * dt;
+
+    travel_ += std::abs(output - previous_output_);
+    previous_output_ = output;
+
+    if (step_ == 0.0) {
+        return;
+    }
+
+    // Step-response indices, all relative to the initial step
+    const double progress = (measured - start_) / step_;
+    if (std::isnan(rise_low_time_) && progress >= settings_.riseLow) {
+        rise_low_time_ = elapsed_;
+    }
+    if (std::isnan(rise_time_) && progress >= settings_.riseHigh) {
+        rise_time_ = elapsed_ - rise_low_time_;
+    }
+
+    const double direction = step_ > 0.0 ? 1.0 : -1.0;
+    peak_ = std::max(peak_, (measured - setpoint) * direction);
+
+    inside_ = abs_error <= settings_.settlingBand * std::abs(step_);
+    if (!inside_) {
+        last_outside_ = elapsed_;
+    }
+}
+
+LoopPerformance::Snapshot LoopPerformance::snapshot() const {
+    Snapshot result;
+    result.elapsed = elapsed_;
+    result.step = step_;
+    result.iae = iae_;
+    result.ise = ise_;
+    result.itae = itae_;
+    result.overshoot = step_ != 0.0 ? peak_ / std::abs(step_) : 0.0;
+    result.riseTime = rise_time_;
+    result.settlingTime = inside_ ? last_outside_ : NaN;
+    result.valveTravel = travel_;
+    return result;
+}
+
+}  // namespace tank_sim
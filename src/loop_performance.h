@@ -0,0 +1,103 @@
+#ifndef TANK_SIM_LOOP_PERFORMANCE_H
+#define TANK_SIM_LOOP_PERFORMANCE_H
+
+#include "constants.h"
+
+namespace tank_sim {
+
+/**
+ * @brief Streaming control-performance indices for one loop.
+ *
+ * Accumulates the usual loop-grading KPIs sample by sample, in O(1) time and
+ * memory, over an evaluation interval that starts at construction and at
+ * every restart() (the Simulator restarts it when the operator changes the
+ * setpoint):
+ *
+ * - IAE  = sum |e| dt
+ * - ISE  = sum e^2 dt
+ * - ITAE = sum t |e| dt     (t = time since the interval started)
+ * - Overshoot: peak excursion past the setpoint as a fraction of the step
+ * - Rise time: first crossing of riseLow to first crossing of riseHigh of
+ *   the step
+ * - Settling time: end of the last sample outside +/- settlingBand * |step|
+ * - Valve travel: sum |du| of the controller output
+ *
+ * The step is setpoint - measured at the start of the interval. When it is
+ * zero (pure disturbance rejection) the step-response indices are not
+ * defined and stay NaN/zero; the integral indices and valve travel are
+ * always valid. Indices that have not happened yet (rise, settling) are NaN.
+ */
+class LoopPerformance {
+public:
+    /**
+     * @brief Thresholds for the step-response indices.
+     */
+    struct Settings {
+        double settlingBand = constants::DEFAULT_SETTLING_BAND;  ///< Fraction of |step|
+        double riseLow = constants::DEFAULT_RISE_LOW;            ///< Fraction of step
+        double riseHigh = constants::DEFAULT_RISE_HIGH;          ///< Fraction of step
+    };
+
+    /**
+     * @brief KPI values at one instant.
+     */
+    struct Snapshot {
+        double elapsed;        ///< Time since the interval started (s)
+        double step;           ///< Setpoint step size at the start (measured units)
+        double iae;            ///< Integral of absolute error
+        double ise;            ///< Integral of squared error
+        double itae;           ///< Integral of time-weighted absolute error
+        double overshoot;      ///< Peak overshoot as a fraction of |step| (0 if none)
+        double riseTime;       ///< Rise time (s), NaN until reached
+        double settlingTime;   ///< Settling time (s), NaN while outside the band
+        double valveTravel;    ///< Accumulated |du| of the controller output
+    };
+
+    /**
+     * @throws std::invalid_argument unless 0 < settlingBand and
+     *         0 <= riseLow < riseHigh <= 1
+     */
+    explicit LoopPerformance(const Settings& settings);
+
+    /**
+     * @brief Start a new evaluation interval.
+     *
+     * @param setpoint Setpoint for the interval
+     * @param measured Measured value at the start
+     * @param output Controller output at the start
+     */
+    void restart(double setpoint, double measured, double output);
+
+    /**
+     * @brief Add one sample at the end of a time step.
+     *
+     * @param setpoint Current setpoint (may move, e.g. under cascade)
+     * @param measured Current measured value
+     * @param output Current controller output
+     * @param dt Time step in seconds
+     */
+    void update(double setpoint, double measured, double output, double dt);
+
+    Snapshot snapshot() const;
+
+private:
+    Settings settings_;
+
+    double elapsed_;
+    double start_;          ///< Measured value at the start of the interval
+    double step_;           ///< setpoint - start_
+    double iae_;
+    double ise_;
+    double itae_;
+    double peak_;           ///< Largest (measured - setpoint) * sign(step)
+    double rise_low_time_;  ///< NaN until riseLow is crossed
+    double rise_time_;      ///< NaN until riseHigh is crossed
+    double last_outside_;   ///< End time of the last sample outside the band
+    bool inside_;           ///< Whether the last sample was inside the band
+    double previous_output_;
+    double travel_;
+};
+
+}  // namespace tank_sim
+
+#endif  // TANK_SIM_LOOP_PERFORMANCE_H
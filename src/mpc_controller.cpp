@@ -0,0 +1,218 @@
+#include "mpc_controller.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+
+namespace tank_sim {
+
+namespace {
+
+/// ADMM iterations between residual-balancing updates of rho
+constexpr int RHO_UPDATE_INTERVAL = 25;
+
+/// Primal/dual residual ratio that triggers a rho update
+constexpr double RHO_BALANCE_RATIO = 10.0;
+
+/// |a*dt| below which exp(a*dt) is treated as 1 in the ZOH discretization
+constexpr double ZOH_SMALL_EXPONENT = 1e-9;
+
+}  // namespace
+
+MPCController::MPCController(const Settings& settings, int measured_index,
+                             int output_index, double min_output, double max_output)
+    : settings_(settings), measured_index_(measured_index),
+      output_index_(output_index), min_output_(min_output),
+      max_output_(max_output), rho_(settings.rho), warm_(false) {
+    // Validate settings - fail fast
+    if (settings.horizon < 1) {
+        throw std::invalid_argument("MPC horizon must be at least 1");
+    }
+    if (settings.controlHorizon < 1 || settings.controlHorizon > settings.horizon) {
+        throw std::invalid_argument("MPC control horizon must be between 1 and the horizon");
+    }
+    if (settings.outputWeight <= 0.0) {
+        throw std::invalid_argument("MPC output weight must be positive");
+    }
+    if (settings.moveWeight < 0.0) {
+        throw std::invalid_argument("MPC move weight cannot be negative");
+    }
+    if (settings.rho <= 0.0 || settings.maxIterations < 1 || settings.tolerance <= 0.0) {
+        throw std::invalid_argument(
+            "MPC solver settings require rho > 0, max_iterations >= 1 and tolerance > 0");
+    }
+    if (measured_index < 0 || measured_index >= constants::TANK_STATE_SIZE) {
+        throw std::invalid_argument("MPC measured_index is out of bounds for the tank state");
+    }
+    if (output_index < 0 || output_index >= constants::TANK_INPUT_SIZE) {
+        throw std::invalid_argument("MPC output_index is out of bounds for the tank inputs");
+    }
+    if (min_output > max_output) {
+        throw std::invalid_argument("min_output must be <= max_output");
+    }
+
+    // Size the workspace once; compute() only writes into it
+    const int n = settings.horizon;
+    const int m = settings.controlHorizon;
+    powers_.setZero(n);
+    free_.setZero(n);
+    su_.setZero(n, m);
+    hessian_.setZero(m, m);
+    kkt_.setZero(m, m);
+    llt_ = Eigen::LLT<Eigen::MatrixXd>(m);
+    gradient_.setZero(m);
+    x_.setZero(m);
+    z_.setZero(m);
+    z_prev_.setZero(m);
+    dual_.setZero(m);
+    rhs_.setZero(m);
+    lower_.setZero(m);
+    upper_.setZero(m);
+    plan_.setZero(m);
+}
+
+double MPCController::compute(const TankModel& model, const Eigen::VectorXd& state,
+                              const Eigen::VectorXd& inputs, double setpoint,
+                              double dt) {
+    const auto start = std::chrono::steady_clock::now();
+    const int n = settings_.horizon;
+    const int m = settings_.controlHorizon;
+    const double u0 = inputs(output_index_);
+    const double h0 = state(measured_index_);
+
+    // Step 1: Linearize about the current point: dh/dt ~ f0 + a*dh + b*du
+    const TankModel::StateVector x = state;
+    const TankModel::InputVector u = inputs;
+    const double f0 = model.derivatives(x, u)(measured_index_);
+    const double a = model.stateJacobian(x, u)(measured_index_, measured_index_);
+    const double b = model.inputJacobian(x, u)(measured_index_, output_index_);
+
+    // Step 2: Exact zero-order-hold discretization (phi = integral of e^{a s})
+    double ad = 1.0;
+    double phi = dt;
+    if (std::abs(a * dt) > ZOH_SMALL_EXPONENT) {
+        ad = std::exp(a * dt);
+        phi = (ad - 1.0) / a;
+    }
+    const double bd = phi * b;
+    const double cd = phi * f0;
+
+    // Step 3: Prediction matrices. Column j < M-1 is a single move held for
+    // one sample; the last column is held to the end of the horizon.
+    double power = 1.0;
+    double drift = 0.0;
+    for (int k = 0; k < n; ++k) {
+        powers_(k) = power;
+        drift = ad * drift + cd;
+        free_(k) = drift;
+        power *= ad;
+    }
+    double held = 0.0;
+    for (int k = 0; k < n; ++k) {
+        for (int j = 0; j < m - 1; ++j) {
+            su_(k, j) = k >= j ? powers_(k - j) * bd : 0.0;
+        }
+        if (k >= m - 1) {
+            held = ad * held + bd;
+        }
+        su_(k, m - 1) = held;
+    }
+
+    // Step 4: Condensed QP in deviation variables z = u - u0:
+    //   H = Q*Su'Su + R*D'D,  g = Q*Su'(free + h0 - setpoint)
+    // D is the move-difference matrix (u_{-1} = u0), so D'D is tridiagonal.
+    const double q = settings_.outputWeight;
+    const double r = settings_.moveWeight;
+    hessian_.noalias() = su_.transpose() * su_;
+    hessian_ *= q;
+    for (int j = 0; j < m; ++j) {
+        hessian_(j, j) += r * (j + 1 < m ? 2.0 : 1.0);
+        if (j + 1 < m) {
+            hessian_(j, j + 1) -= r;
+            hessian_(j + 1, j) -= r;
+        }
+    }
+    free_.array() += h0 - setpoint;
+    gradient_.noalias() = su_.transpose() * free_;
+    gradient_ *= q;
+
+    lower_.setConstant(min_output_ - u0);
+    upper_.setConstant(max_output_ - u0);
+
+    // Step 5: Warm start from the previous plan shifted by one sample
+    if (warm_) {
+        for (int j = 0; j < m; ++j) {
+            const int from = std::min(j + 1, m - 1);
+            z_(j) = std::clamp(plan_(from) - u0, lower_(j), upper_(j));
+            rhs_(j) = dual_(from);
+        }
+        dual_ = rhs_;
+    } else {
+        z_.setZero();
+        z_ = z_.cwiseMax(lower_).cwiseMin(upper_);
+        dual_.setZero();
+    }
+
+    // Step 6: ADMM on  min 1/2 z'Hz + g'z  s.t.  x = z, lower <= z <= upper
+    kkt_ = hessian_;
+    kkt_.diagonal().array() += rho_;
+    llt_.compute(kkt_);
+
+    bool converged = false;
+    int iteration = 0;
+    while (iteration < settings_.maxIterations) {
+        ++iteration;
+        rhs_ = rho_ * (z_ - dual_) - gradient_;
+        x_ = llt_.solve(rhs_);
+        z_prev_ = z_;
+        z_ = (x_ + dual_).cwiseMax(lower_).cwiseMin(upper_);
+        dual_ += x_ - z_;
+
+        const double primal = (x_ - z_).lpNorm<Eigen::Infinity>();
+        const double dual = rho_ * (z_ - z_prev_).lpNorm<Eigen::Infinity>();
+        if (primal <= settings_.tolerance && dual <= settings_.tolerance) {
+            converged = true;
+            break;
+        }
+
+        // Residual balancing: the scaled dual is y/rho, so rescale it too
+        if (iteration % RHO_UPDATE_INTERVAL == 0) {
+            double scale = 1.0;
+            if (primal > RHO_BALANCE_RATIO * dual) {
+                scale = 2.0;
+            } else if (dual > RHO_BALANCE_RATIO * primal) {
+                scale = 0.5;
+            }
+            if (scale != 1.0) {
+                rho_ *= scale;
+                dual_ /= scale;
+                kkt_.diagonal().array() += rho_ - rho_ / scale;
+                llt_.compute(kkt_);
+            }
+        }
+    }
+
+    // Step 7: z is feasible by construction; apply its first move
+    plan_ = z_.array() + u0;
+    warm_ = true;
+
+    const double micros = std::chrono::duration<double, std::micro>(
+                              std::chrono::steady_clock::now() - start).count();
+    ++stats_.solves;
+    stats_.lastMicros = micros;
+    stats_.meanMicros += (micros - stats_.meanMicros) / static_cast<double>(stats_.solves);
+    stats_.maxMicros = std::max(stats_.maxMicros, micros);
+    stats_.lastIterations = iteration;
+    stats_.lastConverged = converged;
+
+    return plan_(0);
+}
+
+void MPCController::reset() {
+    warm_ = false;
+    rho_ = settings_.rho;
+    dual_.setZero();
+    plan_.setZero();
+}
+
+}  // namespace tank_sim
@@ -0,0 +1,47 @@
+#ifndef TANK_SIM_OPERATOR_COMMAND_H
+#define TANK_SIM_OPERATOR_COMMAND_H
+
+#include "pid_controller.h"
+#include <cstdint>
+
+namespace tank_sim {
+
+/**
+ * @brief Operator action queued for the stepping thread.
+ *
+ * Mirrors the Simulator operator methods; fields not used by a type are
+ * ignored. SetSpeed is handled by SessionEngine, which owns the pacing; a
+ * Simulator rejects it.
+ */
+struct OperatorCommand {
+    enum class Type {
+        SetSetpoint,  ///< setSetpoint(index, value)
+        SetInput,     ///< setInput(index, value)
+        SetGains,     ///< setControllerGains(index, gains)
+        Reset,        ///< reset()
+        SetSpeed      ///< Session speed factor = value (SessionEngine only)
+    };
+
+    Type type;
+    int index = 0;
+    double value = 0.0;
+    PIDController::Gains gains{0.0, 0.0, 0.0};
+    std::uint64_t id = 0;             ///< Caller-chosen tag, echoed in the result
+    std::int64_t enqueuedNanos = 0;   ///< Set by Simulator::submitCommand
+};
+
+/**
+ * @brief Outcome of one applied command, returned to the producer.
+ */
+struct AppliedCommand {
+    std::uint64_t id;
+    OperatorCommand::Type type;
+    int index;
+    bool accepted;         ///< false if the operator method rejected it
+    double time;           ///< Simulation time at which it took effect (s)
+    double latencyMicros;  ///< Wall time from submit to apply (us)
+};
+
+}  // namespace tank_sim
+
+#endif  // TANK_SIM_OPERATOR_COMMAND_H
@@ -0,0 +1,188 @@
+#include "parameter_estimator.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace tank_sim {
+
+namespace {
+
+/// Damping above which no descent direction is left (converged at a minimum)
+constexpr double MAX_DAMPING = 1e12;
+
+/// Sum of squared residuals plus the Gauss-Newton normal equations
+struct Evaluation {
+    double sse;
+    Eigen::Matrix2d jtj;
+    Eigen::Vector2d jtr;
+};
+
+/**
+ * @brief Derivative of [h, dh/dA, dh/dk_v] for one sample's inputs.
+ */
+Eigen::Vector3d augmentedDerivative(const Eigen::Vector3d& y, double area, double k_v,
+                                    double q_in, double x) {
+    const double h = y(0);
+    const double root_h = std::sqrt(std::max(h, 0.0));
+    const double f = (q_in - k_v * x * root_h) / area;
+    const double f_h =
+        -k_v * x / (2.0 * area * std::sqrt(std::max(h, constants::JACOBIAN_MIN_LEVEL)));
+    const double f_area = -f / area;
+    const double f_kv = -x * root_h / area;
+
+    return Eigen::Vector3d(f, f_h * y(1) + f_area, f_h * y(2) + f_kv);
+}
+
+/**
+ * @brief Simulate the record at log-parameters p and accumulate J'J and J'r.
+ *
+ * Residual r_k = h_model(k) - level(k); J columns are dr/dlog(A) and
+ * dr/dlog(k_v), i.e. the sensitivities scaled by the parameter.
+ */
+Evaluation evaluate(const RecordedData& data, const Eigen::Vector2d& log_params) {
+    const double area = std::exp(log_params(0));
+    const double k_v = std::exp(log_params(1));
+    const double dt = data.dt;
+
+    Evaluation result{0.0, Eigen::Matrix2d::Zero(), Eigen::Vector2d::Zero()};
+    Eigen::Vector3d y(data.level.front(), 0.0, 0.0);
+    for (size_t k = 0; k + 1 < data.level.size(); ++k) {
+        const double q = data.inletFlow[k];
+        const double x = data.valvePosition[k];
+
+        // RK4 on the augmented system, inputs held over the sample
+        const Eigen::Vector3d k1 = augmentedDerivative(y, area, k_v, q, x);
+        const Eigen::Vector3d k2 = augmentedDerivative(y + 0.5 * dt * k1, area, k_v, q, x);
+        const Eigen::Vector3d k3 = augmentedDerivative(y + 0.5 * dt * k2, area, k_v, q, x);
+        const Eigen::Vector3d k4 = augmentedDerivative(y + dt * k3, area, k_v, q, x);
+        y += dt / 6.0 * (k1 + 2.0 * k2 + 2.0 * k3 + k4);
+
+        const double residual = y(0) - data.level[k + 1];
+        const Eigen::Vector2d jacobian(y(1) * area, y(2) * k_v);
+        result.sse += residual * residual;
+        result.jtj.noalias() += jacobian * jacobian.transpose();
+        result.jtr += jacobian * residual;
+    }
+    return result;
+}
+
+}  // namespace
+
+ParameterEstimator::ParameterEstimator() : ParameterEstimator(Settings{}) {}
+
+ParameterEstimator::ParameterEstimator(const Settings& settings) : settings_(settings) {
+    // Validate settings - fail fast
+    if (settings.maxIterations < 1) {
+        throw std::invalid_argument("max_iterations must be at least 1");
+    }
+    if (settings.tolerance <= 0.0 || settings.initialDamping <= 0.0) {
+        throw std::invalid_argument("LM tolerance and initial damping must be positive");
+    }
+}
+
+ParameterEstimator::Result ParameterEstimator::estimate(
+    const RecordedData& data, const TankModel::Parameters& initial_guess) const {
+    // Validate the record and the starting point
+    const size_t n = data.level.size();
+    if (n < 2 || data.inletFlow.size() != n || data.valvePosition.size() != n) {
+        throw std::invalid_argument(
+            "Recorded data needs at least two samples and equal-length series");
+    }
+    if (data.dt <= 0.0) {
+        throw std::invalid_argument("Recorded data dt must be positive");
+    }
+    if (initial_guess.area <= 0.0 || initial_guess.k_v <= 0.0) {
+        throw std::invalid_argument("Initial area and k_v must be positive");
+    }
+
+    Eigen::Vector2d log_params(std::log(initial_guess.area), std::log(initial_guess.k_v));
+    Evaluation current = evaluate(data, log_params);
+    double damping = settings_.initialDamping;
+    int iterations = 0;
+    bool converged = false;
+
+    while (iterations < settings_.maxIterations && !converged) {
+        // Step 1: Damped normal equations, scaled by diag(J'J) (Marquardt)
+        Eigen::Matrix2d lhs = current.jtj;
+        lhs.diagonal() += damping * current.jtj.diagonal().cwiseMax(1e-30);
+        const Eigen::Vector2d step = lhs.ldlt().solve(-current.jtr);
+
+        // Step 2: Accept if the cost drops, otherwise raise the damping
+        const Eigen::Vector2d trial_params = log_params + step;
+        Evaluation trial = evaluate(data, trial_params);
+        if (trial.sse < current.sse) {
+            const double decrease = current.sse - trial.sse;
+            converged = step.lpNorm<Eigen::Infinity>() < settings_.tolerance ||
+                        decrease <= settings_.tolerance * current.sse;
+            log_params = trial_params;
+            current = trial;
+            damping /= 3.0;
+            ++iterations;
+        } else {
+            damping *= 2.0;
+            // No descent direction left: at a (local) minimum
+            if (damping > MAX_DAMPING || step.lpNorm<Eigen::Infinity>() < settings_.tolerance) {
+                converged = true;
+            }
+        }
+    }
+
+    Result result;
+    result.params = TankModel::Parameters{std::exp(log_params(0)), std::exp(log_params(1)),
+                                          initial_guess.max_height};
+    result.rmsResidual = std::sqrt(current.sse / static_cast<double>(n - 1));
+    result.iterations = iterations;
+    result.converged = converged;
+    return result;
+}
+
+std::vector<ParameterEstimator::Result> ParameterEstimator::estimateMany(
+    const std::vector<RecordedData>& data,
+    const std::vector<TankModel::Parameters>& initial_guesses, int threads) const {
+    if (data.size() != initial_guesses.size()) {
+        throw std::invalid_argument("estimateMany needs one initial guess per record");
+    }
+
+    int workers = threads > 0 ? threads
+                              : static_cast<int>(std::thread::hardware_concurrency());
+    workers = std::max(1, std::min(workers, static_cast<int>(data.size())));
+
+    // Workers pull the next tank from a shared counter; fits are independent
+    std::vector<Result> results(data.size());
+    std::atomic<size_t> next{0};
+    std::exception_ptr first_error;
+    std::mutex error_mutex;
+
+    auto worker = [&]() {
+        for (size_t i = next++; i < data.size(); i = next++) {
+            try {
+                results[i] = estimate(data[i], initial_guesses[i]);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(error_mutex);
+                if (!first_error) {
+                    first_error = std::current_exception();
+                }
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(workers);
+    for (int t = 0; t < workers; ++t) {
+        pool.emplace_back(worker);
+    }
+    for (auto& thread : pool) {
+        thread.join();
+    }
+
+    if (first_error) {
+        std::rethrow_exception(first_error);
+    }
+    return results;
+}
+
+}  // namespace tank_sim
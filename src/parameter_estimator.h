@@ -0,0 +1,105 @@
+#ifndef TANK_SIM_PARAMETER_ESTIMATOR_H
+#define TANK_SIM_PARAMETER_ESTIMATOR_H
+
+#include "constants.h"
+#include "tank_model.h"
+#include <vector>
+
+namespace tank_sim {
+
+/**
+ * @brief Historian record of one tank, sampled at a fixed interval.
+ *
+ * level[k] is the level at time k*dt; inletFlow[k] and valvePosition[k]
+ * are the inputs held over [k*dt, (k+1)*dt). All three vectors must have
+ * the same length (the last input sample is unused).
+ */
+struct RecordedData {
+    double dt;
+    std::vector<double> inletFlow;
+    std::vector<double> valvePosition;
+    std::vector<double> level;
+};
+
+/**
+ * @brief Offline calibration of TankModel area and k_v from recorded data.
+ *
+ * The model is simulated from the first recorded level with the recorded
+ * inputs (fixed-step RK4, one step per sample), and the sum of squared level
+ * residuals is minimized by Levenberg-Marquardt. Gradients come from forward
+ * sensitivities integrated alongside the level:
+ *
+ *   d/dt (dh/dp) = (df/dh) (dh/dp) + df/dp,   p in {A, k_v}
+ *
+ * using the analytic partial derivatives of the material balance. The
+ * parameters are optimized in log space, which keeps them positive and
+ * balances their scales. With two parameters J'J and J'r are accumulated
+ * during the simulation, so a fit needs O(1) memory beyond the record.
+ *
+ * estimateMany() fits independent tanks on a pool of worker threads. The
+ * estimator itself is immutable, so one instance can be shared.
+ */
+class ParameterEstimator {
+public:
+    /**
+     * @brief Levenberg-Marquardt settings.
+     */
+    struct Settings {
+        int maxIterations = constants::DEFAULT_LM_MAX_ITERATIONS;   ///< Accepted-step limit
+        double tolerance = constants::DEFAULT_LM_TOLERANCE;         ///< Relative step/cost tolerance
+        double initialDamping = constants::DEFAULT_LM_INITIAL_DAMPING;  ///< Initial lambda
+    };
+
+    /**
+     * @brief Outcome of one fit.
+     */
+    struct Result {
+        TankModel::Parameters params;  ///< Fitted parameters (max_height from the guess)
+        double rmsResidual;            ///< RMS level residual at the solution (m)
+        int iterations;                ///< Accepted LM steps
+        bool converged;                ///< Whether the tolerance was met
+    };
+
+    /// Estimator with default settings
+    ParameterEstimator();
+
+    /**
+     * @throws std::invalid_argument if a setting is out of range
+     */
+    explicit ParameterEstimator(const Settings& settings);
+
+    /**
+     * @brief Fit one tank.
+     *
+     * @param data Recorded inputs and levels
+     * @param initial_guess Starting parameters (area and k_v must be positive)
+     * @return Fitted parameters and fit statistics
+     *
+     * @throws std::invalid_argument if the record is inconsistent or has
+     *         fewer than two samples, or the guess is not positive
+     */
+    Result estimate(const RecordedData& data,
+                    const TankModel::Parameters& initial_guess) const;
+
+    /**
+     * @brief Fit many tanks in parallel.
+     *
+     * @param data One record per tank
+     * @param initial_guesses One starting point per tank
+     * @param threads Worker count; 0 uses std::thread::hardware_concurrency()
+     * @return Results in the order of data
+     *
+     * @throws std::invalid_argument if the sizes differ, or the first error
+     *         raised by any individual fit
+     */
+    std::vector<Result> estimateMany(const std::vector<RecordedData>& data,
+                                     const std::vector<TankModel::Parameters>& initial_guesses,
+                                     int threads = 0) const;
+
+private:
+    Settings settings_;
+};
+
+}  // namespace tank_sim
+
+#endif  // TANK_SIM_PARAMETER_ESTIMATOR_H
@@ -0,0 +1,183 @@
+#include "pid_bank.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace tank_sim {
+
+namespace {
+
+void validateGains(const PIDController::Gains& gains) {
+    if (gains.tau_I < 0.0) {
+        throw std::invalid_argument("Integral time constant (tau_I) cannot be negative");
+    }
+    if (gains.tau_D < 0.0) {
+        throw std::invalid_argument("Derivative time constant (tau_D) cannot be negative");
+    }
+}
+
+/**
+ * @brief PID update kernel over [begin, end).
+ *
+ * The arrays never overlap, which __restrict tells the compiler; without it
+ * GCC gives up on vectorizing because thirteen arrays exceed its runtime
+ * alias-check budget. Clamping is written as plain selects so the loop body
+ * has no control flow.
+ */
+void computeLoops(const double* __restrict kc, const double* __restrict inv_tau_i,
+                  const double* __restrict tau_d, const double* __restrict bias,
+                  const double* __restrict ff,
+                  const double* __restrict lo, const double* __restrict hi,
+                  const double* __restrict max_i, const double* __restrict sp,
+                  const double* __restrict meas, double* __restrict out,
+                  double* __restrict integral, double* __restrict prev,
+                  int begin, int end, double dt) {
+    for (int i = begin; i < end; ++i) {
+        const double error = sp[i] - meas[i];
+        // Backward finite difference, one-step delay (see PIDController)
+        const double error_dot = (error - prev[i]) / dt;
+
+        const double output_unsat =
+            bias[i] + ff[i] + kc[i] * (error + inv_tau_i[i] * integral[i] + tau_d[i] * error_dot);
+        const double low = lo[i];
+        const double high = hi[i];
+        const double raised = output_unsat < low ? low : output_unsat;
+        out[i] = raised > high ? high : raised;
+
+        // Anti-windup: accumulate only in the linear range, then clamp
+        const bool saturated = (output_unsat < low) | (output_unsat > high);
+        const double limit = max_i[i];
+        const double accumulated = integral[i] + error * dt;
+        const double floored = accumulated < -limit ? -limit : accumulated;
+        const double clamped = floored > limit ? limit : floored;
+        integral[i] = saturated ? integral[i] : clamped;
+
+        prev[i] = error;
+    }
+}
+
+}  // namespace
+
+void PIDBank::reserve(int count) {
+    for (auto* v : {&kc_, &tau_i_, &inv_tau_i_, &tau_d_, &bias_, &feedforward_,
+                    &min_output_,
+                    &max_output_, &max_integral_, &setpoint_, &measured_,
+                    &output_, &integral_, &previous_error_}) {
+        v->reserve(count);
+    }
+    measured_index_.reserve(count);
+    output_index_.reserve(count);
+}
+
+int PIDBank::addLoop(const PIDController::Gains& gains, double bias,
+                     double min_output, double max_output, double max_integral,
+                     int measured_index, int output_index, double setpoint) {
+    // Same fail-fast validation as PIDController
+    validateGains(gains);
+    if (min_output > max_output) {
+        throw std::invalid_argument("min_output must be <= max_output");
+    }
+    if (max_integral < 0.0) {
+        throw std::invalid_argument("max_integral must be non-negative");
+    }
+    if (measured_index < -1 || output_index < -1) {
+        throw std::invalid_argument("Loop measured/output indices must be >= -1");
+    }
+
+    kc_.push_back(gains.Kc);
+    tau_i_.push_back(gains.tau_I);
+    inv_tau_i_.push_back(gains.tau_I != 0.0 ? 1.0 / gains.tau_I : 0.0);
+    tau_d_.push_back(gains.tau_D);
+    bias_.push_back(bias);
+    feedforward_.push_back(0.0);
+    min_output_.push_back(min_output);
+    max_output_.push_back(max_output);
+    max_integral_.push_back(max_integral);
+
+    setpoint_.push_back(setpoint);
+    measured_.push_back(0.0);
+    output_.push_back(bias);
+    integral_.push_back(0.0);
+    previous_error_.push_back(0.0);
+
+    measured_index_.push_back(measured_index);
+    output_index_.push_back(output_index);
+
+    return size() - 1;
+}
+
+void PIDBank::gather(const Eigen::VectorXd& state) {
+    const int n = size();
+    for (int i = 0; i < n; ++i) {
+        if (measured_index_[i] >= 0) {
+            measured_[i] = state(measured_index_[i]);
+        }
+    }
+}
+
+void PIDBank::compute(int begin, int end, double dt) {
+    computeLoops(kc_.data(), inv_tau_i_.data(), tau_d_.data(), bias_.data(),
+                 feedforward_.data(),
+                 min_output_.data(), max_output_.data(), max_integral_.data(),
+                 setpoint_.data(), measured_.data(), output_.data(),
+                 integral_.data(), previous_error_.data(), begin, end, dt);
+}
+
+void PIDBank::scatter(Eigen::VectorXd& inputs) const {
+    const int n = size();
+    for (int i = 0; i < n; ++i) {
+        if (output_index_[i] >= 0) {
+            inputs(output_index_[i]) = output_[i];
+        }
+    }
+}
+
+void PIDBank::update(const Eigen::VectorXd& state, Eigen::VectorXd& inputs, double dt) {
+    gather(state);
+    compute(0, size(), dt);
+    scatter(inputs);
+}
+
+void PIDBank::reset() {
+    std::fill(integral_.begin(), integral_.end(), 0.0);
+    std::fill(previous_error_.begin(), previous_error_.end(), 0.0);
+    std::fill(feedforward_.begin(), feedforward_.end(), 0.0);
+}
+
+PIDController::Gains PIDBank::getGains(int slot) const {
+    return PIDController::Gains{kc_[slot], tau_i_[slot], tau_d_[slot]};
+}
+
+void PIDBank::setGains(int slot, const PIDController::Gains& gains) {
+    validateGains(gains);
+    kc_[slot] = gains.Kc;
+    tau_i_[slot] = gains.tau_I;
+    inv_tau_i_[slot] = gains.tau_I != 0.0 ? 1.0 / gains.tau_I : 0.0;
+    tau_d_[slot] = gains.tau_D;
+}
+
+void PIDBank::setGainsBumpless(int slot, const PIDController::Gains& gains) {
+    const double old_integral_gain = kc_[slot] * inv_tau_i_[slot];
+    setGains(slot, gains);
+    const double new_integral_gain = kc_[slot] * inv_tau_i_[slot];
+
+    // Keep Kc/tau_I * integral continuous; nothing to preserve if either
+    // side has no integral action.
+    if (old_integral_gain != 0.0 && new_integral_gain != 0.0) {
+        const double rescaled = integral_[slot] * (old_integral_gain / new_integral_gain);
+        const double limit = max_integral_[slot];
+        integral_[slot] = std::min(std::max(rescaled, -limit), limit);
+    }
+}
+
+void PIDBank::setLoopState(int slot, double integral, double previous_error, double output) {
+    integral_[slot] = integral;
+    previous_error_[slot] = previous_error;
+    output_[slot] = output;
+}
+
+void PIDBank::setOutputLimits(int slot, double min_val, double max_val) {
+    min_output_[slot] = min_val;
+    max_output_[slot] = max_val;
+}
+
+}  // namespace tank_sim
@@ -0,0 +1,193 @@
+#ifndef TANK_SIM_PID_BANK_H
+#define TANK_SIM_PID_BANK_H
+
+#include "pid_controller.h"
+#include <Eigen/Dense>
+#include <vector>
+
+namespace tank_sim {
+
+/**
+ * @brief A bank of PID loops stored in structure-of-arrays layout.
+ *
+ * PIDBank implements exactly the same discrete-time control law as
+ * PIDController (proportional, integral with anti-windup, derivative on
+ * error), but keeps every loop's gains, limits, integral state and previous
+ * error in contiguous arrays instead of one object per loop. A step is split
+ * into three passes:
+ *
+ * 1. gather():  measured[i] = state(measuredIndex[i])
+ * 2. compute(): branch-free PID update over a contiguous range of loops
+ * 3. scatter(): inputs(outputIndex[i]) = output[i]
+ *
+ * The gather/scatter index arrays are fixed when loops are added, so the
+ * compute pass touches only unit-stride arrays and can be auto-vectorized by
+ * the compiler. For a single loop this is equivalent to PIDController; for
+ * plant-wide networks with thousands of loops it avoids per-controller
+ * object indirection.
+ *
+ * A per-loop feedforward term is added to the bias before the PID terms:
+ *
+ *   u = bias + feedforward + Kc * (error + (1/tau_I) * integral + tau_D * error_dot)
+ *
+ * It is zero unless set by the control schedule (see ControlSchedule).
+ *
+ * @note Loops are addressed by the slot index returned from addLoop().
+ * @note If several loops write the same output index, scatter() applies them
+ *       in slot order, so the highest slot wins (same as the previous
+ *       per-controller loop in Simulator).
+ */
+class PIDBank {
+public:
+    PIDBank() = default;
+
+    /**
+     * @brief Reserve storage for the given number of loops.
+     *
+     * @param count Expected number of loops
+     */
+    void reserve(int count);
+
+    /**
+     * @brief Append a loop to the bank.
+     *
+     * @param gains Initial controller gains
+     * @param bias Output bias when error is zero
+     * @param min_output Minimum output saturation limit
+     * @param max_output Maximum output saturation limit
+     * @param max_integral Maximum magnitude for integral state clamping
+     * @param measured_index State index gathered as the measured value, or -1
+     *                       if the measurement is supplied via setMeasured()
+     * @param output_index Input index the output is scattered to, or -1 for
+     *                     an internal loop (e.g. a cascade master)
+     * @param setpoint Initial setpoint
+     * @return Slot index of the new loop
+     *
+     * @throws std::invalid_argument on the same conditions as the
+     *         PIDController constructor, or if an index is below -1
+     */
+    int addLoop(const PIDController::Gains& gains, double bias,
+                double min_output, double max_output, double max_integral,
+                int measured_index, int output_index, double setpoint);
+
+    /**
+     * @brief Gather measured values for all loops from the state vector.
+     *
+     * @param state Current state vector
+     */
+    void gather(const Eigen::VectorXd& state);
+
+    /**
+     * @brief Run the PID update for loops in [begin, end).
+     *
+     * Uses the measured values from the last gather() (or setMeasured()).
+     * Updates outputs, integral states and previous errors.
+     *
+     * @param begin First slot (inclusive)
+     * @param end Last slot (exclusive)
+     * @param dt Time step in seconds
+     */
+    void compute(int begin, int end, double dt);
+
+    /**
+     * @brief Scatter outputs for all loops into the input vector.
+     *
+     * @param inputs Input vector to write controller outputs into
+     */
+    void scatter(Eigen::VectorXd& inputs) const;
+
+    /**
+     * @brief Convenience wrapper: gather, compute all loops, scatter.
+     *
+     * @param state Current state vector
+     * @param inputs Input vector to write controller outputs into
+     * @param dt Time step in seconds
+     */
+    void update(const Eigen::VectorXd& state, Eigen::VectorXd& inputs, double dt);
+
+    /**
+     * @brief Reset integral states, previous errors and feedforward terms of
+     *        all loops to zero.
+     */
+    void reset();
+
+    int size() const { return static_cast<int>(kc_.size()); }
+
+    // Per-loop accessors (slot index is not bounds-checked)
+    double getSetpoint(int slot) const { return setpoint_[slot]; }
+    void setSetpoint(int slot, double value) { setpoint_[slot] = value; }
+    double getMeasured(int slot) const { return measured_[slot]; }
+    void setMeasured(int slot, double value) { measured_[slot] = value; }
+    double getOutput(int slot) const { return output_[slot]; }
+    double getBias(int slot) const { return bias_[slot]; }
+    void setBias(int slot, double value) { bias_[slot] = value; }
+    double getFeedforward(int slot) const { return feedforward_[slot]; }
+    void setFeedforward(int slot, double value) { feedforward_[slot] = value; }
+    double getIntegralState(int slot) const { return integral_[slot]; }
+    double getPreviousError(int slot) const { return previous_error_[slot]; }
+    int getMeasuredIndex(int slot) const { return measured_index_[slot]; }
+    int getOutputIndex(int slot) const { return output_index_[slot]; }
+    PIDController::Gains getGains(int slot) const;
+
+    /**
+     * @brief Update the gains of one loop without resetting its integral state.
+     *
+     * @throws std::invalid_argument if tau_I < 0 or tau_D < 0
+     */
+    void setGains(int slot, const PIDController::Gains& gains);
+
+    /**
+     * @brief Update the gains of one loop with bumpless integral rescaling.
+     *
+     * The integral contribution to the output, Kc / tau_I * integral_state,
+     * is held constant across the gain change by rescaling integral_state,
+     * so a gain change at constant error does not step the output through
+     * the integral term. Used by gain scheduling, where gains change every
+     * sample. The rescaled state is still clamped to +/-max_integral.
+     *
+     * @throws std::invalid_argument if tau_I < 0 or tau_D < 0
+     */
+    void setGainsBumpless(int slot, const PIDController::Gains& gains);
+
+    /**
+     * @brief Overwrite the internal state of one loop (snapshot restore).
+     *
+     * @param slot Loop slot
+     * @param integral Integral state
+     * @param previous_error Error of the last update
+     * @param output Output of the last update
+     */
+    void setLoopState(int slot, double integral, double previous_error, double output);
+
+    /**
+     * @brief Change the output saturation limits of one loop.
+     */
+    void setOutputLimits(int slot, double min_val, double max_val);
+
+private:
+    // Gains and limits
+    std::vector<double> kc_;
+    std::vector<double> tau_i_;
+    std::vector<double> inv_tau_i_;   ///< 1/tau_I, or 0 when integral action is disabled
+    std::vector<double> tau_d_;
+    std::vector<double> bias_;
+    std::vector<double> feedforward_;
+    std::vector<double> min_output_;
+    std::vector<double> max_output_;
+    std::vector<double> max_integral_;
+
+    // Loop state
+    std::vector<double> setpoint_;
+    std::vector<double> measured_;
+    std::vector<double> output_;
+    std::vector<double> integral_;
+    std::vector<double> previous_error_;
+
+    // Precompiled gather/scatter plan
+    std::vector<int> measured_index_;
+    std::vector<int> output_index_;
+};
+
+}  // namespace tank_sim
+
+#endif  // TANK_SIM_PID_BANK_H
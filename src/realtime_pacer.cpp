@@ -0,0 +1,263 @@
+#include "realtime_pacer.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <time.h>
+#endif
+
+namespace tank_sim {
+
+namespace {
+
+constexpr std::int64_t NANOS_PER_SECOND = 1000000000;
+constexpr int PAGE_SIZE = 4096;
+
+std::int64_t nowNs() {
+#ifdef __linux__
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<std::int64_t>(ts.tv_sec) * NANOS_PER_SECOND + ts.tv_nsec;
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+#endif
+}
+
+// Sleep until an absolute CLOCK_MONOTONIC time (steady_clock elsewhere)
+void sleepUntilNs(std::int64_t deadline_ns) {
+#ifdef __linux__
+    timespec ts;
+    ts.tv_sec = static_cast<time_t>(deadline_ns / NANOS_PER_SECOND);
+    ts.tv_nsec = static_cast<long>(deadline_ns % NANOS_PER_SECOND);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {
+    }
+#else
+    std::this_thread::sleep_until(std::chrono::steady_clock::time_point(
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::nanoseconds(deadline_ns))));
+#endif
+}
+
+// Touch the stack the thread may use so its pages are resident (and, after
+// mlockall, stay so)
+void prefaultStack() {
+    volatile unsigned char buffer[constants::PACER_STACK_PREFAULT];
+    for (int i = 0; i < constants::PACER_STACK_PREFAULT; i += PAGE_SIZE) {
+        buffer[i] = 0;
+    }
+    static_cast<void>(buffer[0]);
+}
+
+int bucketOf(std::int64_t lateness_ns) {
+    std::int64_t micros = lateness_ns / 1000;
+    int bucket = 0;
+    while (micros > 0 && bucket < constants::PACER_LATENESS_BUCKETS - 1) {
+        micros >>= 1;
+        ++bucket;
+    }
+    return bucket;
+}
+
+}  // namespace
+
+// ============================================================================
+// Stats
+// ============================================================================
+
+double RealtimePacer::Stats::percentileMicros(double fraction) const {
+    std::uint64_t total = 0;
+    for (std::uint64_t count : histogram) {
+        total += count;
+    }
+    if (total == 0) {
+        return 0.0;
+    }
+    const double target = std::clamp(fraction, 0.0, 1.0) * static_cast<double>(total);
+    std::uint64_t seen = 0;
+    for (int b = 0; b < constants::PACER_LATENESS_BUCKETS; ++b) {
+        seen += histogram[b];
+        if (seen > 0 && static_cast<double>(seen) >= target) {
+            return bucketUpperMicros(b);
+        }
+    }
+    return bucketUpperMicros(constants::PACER_LATENESS_BUCKETS - 1);
+}
+
+// ============================================================================
+// RealtimePacer
+// ============================================================================
+
+RealtimePacer::RealtimePacer(const Settings& settings)
+    : settings_(settings),
+      period_ns_(0),
+      deadline_ns_(0),
+      burst_(0),
+      cancelled_(false),
+      ticks_(0),
+      skipped_(0),
+      rebased_(0),
+      lateness_sum_ns_(0),
+      lateness_max_ns_(0),
+      realtime_(false) {
+    validate(settings);
+    period_ns_ = std::max<std::int64_t>(
+        1, static_cast<std::int64_t>(std::llround(settings.period * NANOS_PER_SECOND)));
+    for (auto& count : histogram_) {
+        count.store(0, std::memory_order_relaxed);
+    }
+}
+
+void RealtimePacer::validate(const Settings& settings) {
+    // Validate the settings - fail fast
+    if (!(settings.period > 0.0)) {
+        throw std::invalid_argument("Tick period must be positive");
+    }
+    if (settings.maxBurst < 0) {
+        throw std::invalid_argument("Pacer maxBurst must be non-negative");
+    }
+    if (settings.priority < 1 || settings.priority > 99) {
+        throw std::invalid_argument("SCHED_FIFO priority must be in 1..99");
+    }
+    if (settings.cpu < -1) {
+        throw std::invalid_argument("Pacer CPU must be -1 (any) or a CPU index");
+    }
+}
+
+RealtimePacer::CatchUp RealtimePacer::catchUpFromName(std::string_view name) {
+    if (name == "burst") {
+        return CatchUp::Burst;
+    }
+    if (name == "skip") {
+        return CatchUp::Skip;
+    }
+    if (name == "rebase") {
+        return CatchUp::Rebase;
+    }
+    throw std::invalid_argument("Unknown catch-up policy: " + std::string(name));
+}
+
+double RealtimePacer::bucketUpperMicros(int bucket) {
+    if (bucket >= constants::PACER_LATENESS_BUCKETS - 1) {
+        return std::numeric_limits<double>::infinity();
+    }
+    return std::ldexp(1.0, bucket);
+}
+
+void RealtimePacer::start() {
+    cancelled_.store(false, std::memory_order_release);
+    burst_ = 0;
+    deadline_ns_ = nowNs() + period_ns_;
+}
+
+bool RealtimePacer::wait() {
+    std::int64_t now = nowNs();
+    if (now >= deadline_ns_) {
+        // The previous tick overran this deadline: apply the catch-up policy
+        const std::int64_t missed = (now - deadline_ns_) / period_ns_;
+        switch (settings_.catchUp) {
+            case CatchUp::Burst:
+                if (missed > 0 && burst_ < settings_.maxBurst) {
+                    ++burst_;
+                    break;
+                }
+                [[fallthrough]];
+            case CatchUp::Skip:
+                deadline_ns_ += missed * period_ns_;
+                skipped_.fetch_add(static_cast<std::uint64_t>(missed), std::memory_order_relaxed);
+                burst_ = 0;
+                break;
+            case CatchUp::Rebase:
+                if (now > deadline_ns_) {
+                    record(now - deadline_ns_);
+                    rebased_.fetch_add(1, std::memory_order_relaxed);
+                    deadline_ns_ = now + period_ns_;
+                    return !cancelled_.load(std::memory_order_acquire);
+                }
+                break;
+        }
+    } else {
+        burst_ = 0;
+        const auto slice = static_cast<std::int64_t>(constants::PACER_CANCEL_SLICE * NANOS_PER_SECOND);
+        while (now < deadline_ns_) {
+            if (cancelled_.load(std::memory_order_acquire)) {
+                return false;
+            }
+            sleepUntilNs(std::min(deadline_ns_, now + slice));
+            now = nowNs();
+        }
+    }
+    if (cancelled_.load(std::memory_order_acquire)) {
+        return false;
+    }
+    record(now - deadline_ns_);
+    deadline_ns_ += period_ns_;
+    return true;
+}
+
+void RealtimePacer::cancel() { cancelled_.store(true, std::memory_order_release); }
+
+bool RealtimePacer::enterRealtime() {
+#ifdef __linux__
+    bool ok = true;
+    if (settings_.cpu >= CPU_SETSIZE) {
+        ok = false;
+    } else if (settings_.cpu >= 0) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(settings_.cpu, &cpus);
+        ok = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) == 0 && ok;
+    }
+    ok = mlockall(MCL_CURRENT | MCL_FUTURE) == 0 && ok;
+    prefaultStack();
+    sched_param param{};
+    param.sched_priority = settings_.priority;
+    ok = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) == 0 && ok;
+    realtime_.store(ok, std::memory_order_relaxed);
+    return ok;
+#else
+    return false;
+#endif
+}
+
+RealtimePacer::Stats RealtimePacer::stats() const {
+    Stats stats;
+    stats.ticks = ticks_.load(std::memory_order_relaxed);
+    stats.skipped = skipped_.load(std::memory_order_relaxed);
+    stats.rebased = rebased_.load(std::memory_order_relaxed);
+    if (stats.ticks > 0) {
+        stats.meanLatenessMicros = static_cast<double>(lateness_sum_ns_.load(std::memory_order_relaxed)) /
+                                   static_cast<double>(stats.ticks) / 1000.0;
+    }
+    stats.maxLatenessMicros =
+        static_cast<double>(lateness_max_ns_.load(std::memory_order_relaxed)) / 1000.0;
+    for (int b = 0; b < constants::PACER_LATENESS_BUCKETS; ++b) {
+        stats.histogram[b] = histogram_[b].load(std::memory_order_relaxed);
+    }
+    stats.realtime = realtime_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void RealtimePacer::record(std::int64_t lateness_ns) {
+    // Single writer: plain load/store pairs, no read-modify-write needed
+    lateness_sum_ns_.store(lateness_sum_ns_.load(std::memory_order_relaxed) + lateness_ns,
+                           std::memory_order_relaxed);
+    if (lateness_ns > lateness_max_ns_.load(std::memory_order_relaxed)) {
+        lateness_max_ns_.store(lateness_ns, std::memory_order_relaxed);
+    }
+    auto& bucket = histogram_[bucketOf(lateness_ns)];
+    bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    ticks_.fetch_add(1, std::memory_order_release);
+}
+
+}  // namespace tank_sim
@@ -0,0 +1,142 @@
+#ifndef TANK_SIM_REALTIME_PACER_H
+#define TANK_SIM_REALTIME_PACER_H
+
+#include "constants.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string_view>
+
+namespace tank_sim {
+
+/**
+ * @brief Paces a loop on absolute deadlines and measures how late it runs.
+ *
+ * Deadlines are start + n * period on CLOCK_MONOTONIC, and wait() sleeps
+ * until the next one with clock_nanosleep(TIMER_ABSTIME). The work done in
+ * a tick never shifts the ticks after it, so the loop does not drift
+ * behind the wall clock the way "work, then sleep(period)" does.
+ *
+ * A tick that wakes after the following deadline has already passed is
+ * handled by the catch-up policy. The lateness of every tick (wakeup time
+ * minus deadline) goes into a log2 histogram. stats() may be read from any
+ * thread while the pacing thread runs.
+ *
+ * enterRealtime() optionally turns the calling thread into a pinned
+ * SCHED_FIFO thread with locked, prefaulted memory, for hardware-in-the-
+ * loop style use where tick jitter must stay in the tens of microseconds.
+ *
+ * One pacing thread calls start() and wait(); any thread may cancel().
+ */
+class RealtimePacer {
+public:
+    /// What to do with deadlines that passed while a tick was running
+    enum class CatchUp {
+        Burst,    ///< Run the missed ticks back to back (at most maxBurst), then skip
+        Skip,     ///< Drop the missed ticks and continue on the same grid
+        Rebase    ///< Restart the grid one period after the late tick
+    };
+
+    struct Settings {
+        double period = 1.0;                           ///< Seconds between ticks
+        CatchUp catchUp = CatchUp::Burst;
+        int maxBurst = constants::PACER_MAX_BURST;     ///< Burst only
+        bool realtime = false;     ///< Pacing thread calls enterRealtime() first
+        int priority = constants::PACER_RT_PRIORITY;   ///< SCHED_FIFO priority
+        int cpu = -1;              ///< CPU to pin the thread to; -1 = any
+    };
+
+    struct Stats {
+        std::uint64_t ticks = 0;
+        std::uint64_t skipped = 0;          ///< Deadlines dropped by Skip or Burst
+        std::uint64_t rebased = 0;          ///< Grid restarts by Rebase
+        double meanLatenessMicros = 0.0;
+        double maxLatenessMicros = 0.0;
+        std::array<std::uint64_t, constants::PACER_LATENESS_BUCKETS> histogram{};
+        bool realtime = false;              ///< enterRealtime() succeeded
+
+        /**
+         * @brief Lateness below which a fraction of the ticks ran.
+         *
+         * @param fraction In [0, 1], e.g. 0.99
+         * @return Upper bound of the histogram bucket reached (microseconds);
+         *         0 without ticks
+         */
+        double percentileMicros(double fraction) const;
+    };
+
+    /**
+     * @throws std::invalid_argument if the period is not positive, maxBurst
+     *         is negative or the priority is outside 1..99
+     */
+    explicit RealtimePacer(const Settings& settings);
+
+    RealtimePacer(const RealtimePacer&) = delete;
+    RealtimePacer& operator=(const RealtimePacer&) = delete;
+
+    /// Check settings without constructing a pacer (same exceptions)
+    static void validate(const Settings& settings);
+
+    /**
+     * @brief Policy named "burst", "skip" or "rebase" (command lines).
+     *
+     * @throws std::invalid_argument for any other name
+     */
+    static CatchUp catchUpFromName(std::string_view name);
+
+    /// Upper bound of a histogram bucket (microseconds; infinity for the last)
+    static double bucketUpperMicros(int bucket);
+
+    const Settings& settings() const { return settings_; }
+
+    /// Put the first deadline one period from now and clear cancel()
+    void start();
+
+    /**
+     * @brief Sleep until the next deadline.
+     *
+     * @return true when the tick is due, false if cancel() was called
+     */
+    bool wait();
+
+    /// Make wait() return false within PACER_CANCEL_SLICE (any thread)
+    void cancel();
+
+    /**
+     * @brief Make the calling thread real-time: pin it to settings().cpu,
+     *        lock all process memory (mlockall), prefault its stack and
+     *        switch it to SCHED_FIFO at settings().priority.
+     *
+     * Locking memory applies to the whole process. Needs CAP_SYS_NICE and
+     * a sufficient RLIMIT_MEMLOCK (or root); Linux only.
+     *
+     * @return false if any step was refused; the steps that succeeded stay
+     *         applied and the pacer works as before
+     */
+    bool enterRealtime();
+
+    /// Counters and lateness histogram (any thread)
+    Stats stats() const;
+
+private:
+    Settings settings_;
+    std::int64_t period_ns_;
+    std::int64_t deadline_ns_;
+    int burst_;
+    std::atomic<bool> cancelled_;
+
+    // Written by the pacing thread only; atomics so stats() can read them
+    std::atomic<std::uint64_t> ticks_;
+    std::atomic<std::uint64_t> skipped_;
+    std::atomic<std::uint64_t> rebased_;
+    std::atomic<std::int64_t> lateness_sum_ns_;
+    std::atomic<std::int64_t> lateness_max_ns_;
+    std::array<std::atomic<std::uint64_t>, constants::PACER_LATENESS_BUCKETS> histogram_;
+    std::atomic<bool> realtime_;
+
+    void record(std::int64_t lateness_ns);
+};
+
+}  // namespace tank_sim
+
+#endif  // TANK_SIM_REALTIME_PACER_H
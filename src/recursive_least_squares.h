@@ -0,0 +1,112 @@
+#ifndef TANK_SIM_RECURSIVE_LEAST_SQUARES_H
+#define TANK_SIM_RECURSIVE_LEAST_SQUARES_H
+
+#include <Eigen/Dense>
+#include <stdexcept>
+
+namespace tank_sim {
+
+/**
+ * @brief Recursive least squares with exponential forgetting.
+ *
+ * Fits y = phi' * theta one sample at a time:
+ *
+ *   k     = P phi / (lambda + phi' P phi)
+ *   theta = theta + k (y - phi' theta)
+ *   P     = (P - k phi' P) / lambda
+ *
+ * Old samples are down-weighted by lambda per sample (memory of roughly
+ * 1 / (1 - lambda) samples), so the estimate follows slowly drifting
+ * parameters. Without excitation, dividing by lambda makes P grow without
+ * bound (covariance windup); P is therefore rescaled whenever its trace
+ * exceeds a limit.
+ *
+ * Storage is fixed-size and no history is kept, so update() is O(N^2) with
+ * N fixed at compile time and never allocates.
+ *
+ * @tparam N Number of parameters
+ */
+template <int N>
+class RecursiveLeastSquares {
+    static_assert(N > 0, "Parameter count must be positive");
+
+public:
+    using Vector = Eigen::Matrix<double, N, 1>;
+    using Matrix = Eigen::Matrix<double, N, N>;
+
+    /**
+     * @brief Construct an estimator from a prior.
+     *
+     * @param initial_parameters Prior parameter estimate
+     * @param initial_covariance Prior variance of each parameter (P0 = p0 * I)
+     * @param forgetting_factor lambda in (0, 1]
+     * @param max_covariance_trace Upper bound on trace(P)
+     *
+     * @throws std::invalid_argument if lambda is outside (0, 1] or a
+     *         covariance setting is not positive
+     */
+    RecursiveLeastSquares(const Vector& initial_parameters, double initial_covariance,
+                          double forgetting_factor, double max_covariance_trace)
+        : theta_(initial_parameters),
+          p_(Matrix::Identity() * initial_covariance),
+          lambda_(forgetting_factor), max_trace_(max_covariance_trace),
+          samples_(0) {
+        // Validate settings - fail fast
+        if (!(forgetting_factor > 0.0 && forgetting_factor <= 1.0)) {
+            throw std::invalid_argument("Forgetting factor must be in (0, 1]");
+        }
+        if (initial_covariance <= 0.0 || max_covariance_trace <= 0.0) {
+            throw std::invalid_argument("RLS covariance settings must be positive");
+        }
+    }
+
+    /**
+     * @brief Add one sample.
+     *
+     * @param regressor phi
+     * @param observation y
+     * @return A-priori prediction error y - phi' * theta
+     */
+    double update(const Vector& regressor, double observation) {
+        const Vector p_phi = p_ * regressor;
+        const double error = observation - regressor.dot(theta_);
+        const Vector gain = p_phi / (lambda_ + regressor.dot(p_phi));
+
+        theta_ += gain * error;
+        p_ = (p_ - gain * p_phi.transpose()) / lambda_;
+        p_ = 0.5 * (p_ + p_.transpose()).eval();
+
+        // Anti-windup: cap the covariance when the input is not exciting
+        const double trace = p_.trace();
+        if (trace > max_trace_) {
+            p_ *= max_trace_ / trace;
+        }
+
+        ++samples_;
+        return error;
+    }
+
+    const Vector& parameters() const { return theta_; }
+    const Matrix& covariance() const { return p_; }
+    long long samples() const { return samples_; }
+
+    /**
+     * @brief Continue from a saved estimate (settings are kept).
+     */
+    void restore(const Vector& parameters, const Matrix& covariance, long long samples) {
+        theta_ = parameters;
+        p_ = covariance;
+        samples_ = samples;
+    }
+
+private:
+    Vector theta_;
+    Matrix p_;
+    double lambda_;
+    double max_trace_;
+    long long samples_;
+};
+
+}  // namespace tank_sim
+
+#endif  // TANK_SIM_RECURSIVE_LEAST_SQUARES_H
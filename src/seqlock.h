@@ -0,0 +1,113 @@
+#ifndef TANK_SIM_SEQLOCK_H
+#define TANK_SIM_SEQLOCK_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace tank_sim {
+
+/**
+ * @brief Single-writer, multi-reader sequence lock for a trivially copyable value.
+ *
+ * The writer never waits: write() bumps the sequence number to odd, copies
+ * the value, and bumps it to even again. A reader copies the value between
+ * two loads of the sequence number and keeps the copy only if both loads
+ * saw the same even number, i.e. no write overlapped the copy.
+ *
+ * The payload is stored as an array of relaxed atomic 64-bit words, so a
+ * reader racing with the writer reads stale or mixed words (which it then
+ * discards) rather than performing a data race. On x86-64 and AArch64 these
+ * compile to plain loads and stores.
+ *
+ * tryRead() makes a single attempt and is wait-free; read() retries until it
+ * gets a consistent copy, which only happens when a write is in progress
+ * (each write is a copy of a few hundred bytes).
+ *
+ * Only one thread may call write() at a time.
+ *
+ * @tparam T Trivially copyable payload
+ */
+template <typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "SeqLock payload must be trivially copyable");
+
+public:
+    SeqLock() : sequence_(0) {
+        for (auto& word : words_) {
+            word.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    SeqLock(const SeqLock&) = delete;
+    SeqLock& operator=(const SeqLock&) = delete;
+
+    /**
+     * @brief Publish a new value (writer thread only).
+     */
+    void write(const T& value) {
+        std::array<std::uint64_t, WORDS> buffer{};
+        std::memcpy(buffer.data(), &value, sizeof(T));
+
+        const std::uint64_t sequence = sequence_.load(std::memory_order_relaxed);
+        sequence_.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (std::size_t i = 0; i < WORDS; ++i) {
+            words_[i].store(buffer[i], std::memory_order_relaxed);
+        }
+        sequence_.store(sequence + 2, std::memory_order_release);
+    }
+
+    /**
+     * @brief Make one attempt to copy the latest value.
+     *
+     * @param out Receives the value on success; unspecified on failure
+     * @return false if a write overlapped the copy
+     */
+    bool tryRead(T& out) const {
+        const std::uint64_t before = sequence_.load(std::memory_order_acquire);
+        if (before & 1) {
+            return false;
+        }
+
+        std::array<std::uint64_t, WORDS> buffer;
+        for (std::size_t i = 0; i < WORDS; ++i) {
+            buffer[i] = words_[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence_.load(std::memory_order_relaxed) != before) {
+            return false;
+        }
+
+        std::memcpy(&out, buffer.data(), sizeof(T));
+        return true;
+    }
+
+    /**
+     * @brief Copy the latest value, retrying while a write is in progress.
+     */
+    T read() const {
+        T value;
+        while (!tryRead(value)) {
+        }
+        return value;
+    }
+
+    /**
+     * @brief Number of completed writes.
+     */
+    std::uint64_t version() const { return sequence_.load(std::memory_order_acquire) / 2; }
+
+private:
+    static constexpr std::size_t WORDS = (sizeof(T) + 7) / 8;
+
+    std::atomic<std::uint64_t> sequence_;
+    std::array<std::atomic<std::uint64_t>, WORDS> words_;
+};
+
+}  // namespace tank_sim
+
+#endif  // TANK_SIM_SEQLOCK_H
@@ -0,0 +1,263 @@
+#include "session_checkpoint.h"
+#include "constants.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace tank_sim {
+
+struct SessionCheckpoint::Header {
+    std::uint64_t magic;
+    std::uint32_t version;
+    std::uint32_t sessionCount;
+    std::uint64_t fileSize;
+};
+
+struct SessionCheckpoint::Entry {
+    std::uint64_t offset;         ///< Record start, 8-byte aligned
+    std::uint32_t nameSize;
+    std::uint32_t metadataSize;
+    std::uint32_t historySize;    ///< History block bytes
+    std::uint32_t reserved;
+};
+
+namespace {
+
+constexpr std::uint64_t CHECKPOINT_MAGIC = 0x54414e4b434b5031ULL;  // "TANKCKP1"
+constexpr std::uint32_t CHECKPOINT_VERSION = 2;   // SimulatorSnapshot v2 records
+
+std::uint64_t align8(std::uint64_t n) { return (n + 7) & ~std::uint64_t{7}; }
+
+[[noreturn]] void fail(const std::string& what) {
+    throw std::runtime_error(what + ": " + std::strerror(errno));
+}
+
+/// Newest CHECKPOINT_HISTORY_CAPACITY samples of earlier + recent
+CompressedHistory mergeHistory(const SessionCheckpoint::Session& session) {
+    const std::size_t capacity = constants::CHECKPOINT_HISTORY_CAPACITY;
+    if (session.earlier.size() == 0 && session.history.size() <= capacity) {
+        return CompressedHistory(session.history);
+    }
+    std::vector<SessionSample> samples;
+    if (session.history.size() < capacity) {
+        samples = session.earlier.decode();
+        const std::size_t keep = std::min(samples.size(), capacity - session.history.size());
+        samples.erase(samples.begin(), samples.end() - static_cast<std::ptrdiff_t>(keep));
+    }
+    const std::size_t take = std::min(session.history.size(), capacity);
+    samples.insert(samples.end(), session.history.end() - static_cast<std::ptrdiff_t>(take),
+                   session.history.end());
+    return CompressedHistory(samples);
+}
+
+/// Run work(i) for every session index, spread over threads
+template <typename Work>
+void parallelFor(std::size_t count, int threads, Work work) {
+    std::exception_ptr error;
+    std::mutex error_mutex;
+    auto run = [&](int worker) {
+        try {
+            for (std::size_t i = worker; i < count; i += threads) {
+                work(i);
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(error_mutex);
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+    };
+    std::vector<std::thread> pool;
+    for (int worker = 1; worker < threads; ++worker) {
+        pool.emplace_back(run, worker);
+    }
+    run(0);
+    for (auto& thread : pool) {
+        thread.join();
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+void writeAll(int fd, const char* data, std::size_t size, std::uint64_t offset) {
+    while (size > 0) {
+        const ssize_t n = ::pwrite(fd, data, size, static_cast<off_t>(offset));
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            fail("Cannot write checkpoint");
+        }
+        data += n;
+        size -= static_cast<std::size_t>(n);
+        offset += static_cast<std::uint64_t>(n);
+    }
+}
+
+}  // namespace
+
+std::uint64_t SessionCheckpoint::write(const std::string& path,
+                                       const std::vector<Session>& sessions, int threads) {
+    if (threads <= 0) {
+        threads = static_cast<int>(std::thread::hardware_concurrency());
+        threads = std::clamp(threads, 1, constants::CHECKPOINT_MAX_THREADS);
+    }
+    threads = std::max(1, std::min<int>(threads, static_cast<int>(sessions.size())));
+
+    // Compress every history in parallel
+    std::vector<CompressedHistory> histories(sessions.size());
+    parallelFor(sessions.size(), threads,
+                [&](std::size_t i) { histories[i] = mergeHistory(sessions[i]); });
+
+    // Lay the records out after the index
+    std::vector<Entry> index(sessions.size());
+    std::uint64_t offset = align8(sizeof(Header) + sizeof(Entry) * sessions.size());
+    for (std::size_t i = 0; i < sessions.size(); ++i) {
+        index[i] = Entry{offset, static_cast<std::uint32_t>(sessions[i].name.size()),
+                         static_cast<std::uint32_t>(sessions[i].metadata.size()),
+                         static_cast<std::uint32_t>(histories[i].bytes().size()), 0};
+        offset = align8(offset + sizeof(SimulatorSnapshot) + index[i].nameSize +
+                        index[i].metadataSize + index[i].historySize);
+    }
+    const Header header{CHECKPOINT_MAGIC, CHECKPOINT_VERSION,
+                        static_cast<std::uint32_t>(sessions.size()), offset};
+
+    const std::string temp = path + ".tmp";
+    const int fd = ::open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        fail("Cannot create checkpoint " + temp);
+    }
+    try {
+        if (::ftruncate(fd, static_cast<off_t>(header.fileSize)) != 0) {
+            fail("Cannot size checkpoint " + temp);
+        }
+        // Each record is assembled and written by the thread that owns it
+        parallelFor(sessions.size(), threads, [&](std::size_t i) {
+            const Session& session = sessions[i];
+            std::string record;
+            record.reserve(sizeof(SimulatorSnapshot) + session.name.size() +
+                           session.metadata.size() + histories[i].bytes().size());
+            record.append(reinterpret_cast<const char*>(&session.snapshot),
+                          sizeof(SimulatorSnapshot));
+            record += session.name;
+            record += session.metadata;
+            record += histories[i].bytes();
+            writeAll(fd, record.data(), record.size(), index[i].offset);
+        });
+        writeAll(fd, reinterpret_cast<const char*>(&header), sizeof(header), 0);
+        writeAll(fd, reinterpret_cast<const char*>(index.data()), sizeof(Entry) * index.size(),
+                 sizeof(header));
+        if (::fsync(fd) != 0) {
+            fail("Cannot sync checkpoint " + temp);
+        }
+    } catch (...) {
+        ::close(fd);
+        ::unlink(temp.c_str());
+        throw;
+    }
+    ::close(fd);
+    if (::rename(temp.c_str(), path.c_str()) != 0) {
+        const std::string error = std::strerror(errno);
+        ::unlink(temp.c_str());
+        throw std::runtime_error("Cannot rename checkpoint to " + path + ": " + error);
+    }
+    return header.fileSize;
+}
+
+SessionCheckpoint::SessionCheckpoint(const std::string& path) : base_(nullptr), size_(0) {
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        fail("Cannot open checkpoint " + path);
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        const std::string error = std::strerror(errno);
+        ::close(fd);
+        throw std::runtime_error("Cannot stat checkpoint " + path + ": " + error);
+    }
+    size_ = static_cast<std::size_t>(info.st_size);
+    if (size_ < sizeof(Header)) {
+        ::close(fd);
+        throw std::runtime_error("Not a session checkpoint: " + path);
+    }
+    void* base = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED) {
+        fail("Cannot map checkpoint " + path);
+    }
+    base_ = static_cast<const char*>(base);
+    ::madvise(base, size_, MADV_WILLNEED);
+
+    // Validate the header and every index entry - fail fast
+    const Header& header = *reinterpret_cast<const Header*>(base_);
+    std::string problem;
+    if (header.magic != CHECKPOINT_MAGIC || header.version != CHECKPOINT_VERSION) {
+        problem = "Not a session checkpoint of this version";
+    } else if (header.fileSize != size_ ||
+               sizeof(Header) + sizeof(Entry) * std::uint64_t{header.sessionCount} > size_) {
+        problem = "Truncated session checkpoint";
+    } else {
+        for (int i = 0; i < size() && problem.empty(); ++i) {
+            const Entry& e = entry(i);
+            const std::uint64_t end = e.offset + sizeof(SimulatorSnapshot) + e.nameSize +
+                                      e.metadataSize + e.historySize;
+            if (e.offset % 8 != 0 || e.offset > size_ || end > size_) {
+                problem = "Corrupt session checkpoint index";
+            }
+        }
+    }
+    if (!problem.empty()) {
+        ::munmap(const_cast<char*>(base_), size_);
+        throw std::runtime_error(problem + ": " + path);
+    }
+}
+
+SessionCheckpoint::~SessionCheckpoint() { ::munmap(const_cast<char*>(base_), size_); }
+
+int SessionCheckpoint::size() const {
+    return static_cast<int>(reinterpret_cast<const Header*>(base_)->sessionCount);
+}
+
+const SessionCheckpoint::Entry& SessionCheckpoint::entry(int index) const {
+    if (index < 0 || index >= size()) {
+        throw std::out_of_range("Checkpoint session index out of range: " +
+                                std::to_string(index));
+    }
+    return reinterpret_cast<const Entry*>(base_ + sizeof(Header))[index];
+}
+
+std::string_view SessionCheckpoint::name(int index) const {
+    const Entry& e = entry(index);
+    return std::string_view(base_ + e.offset + sizeof(SimulatorSnapshot), e.nameSize);
+}
+
+std::string_view SessionCheckpoint::metadata(int index) const {
+    const Entry& e = entry(index);
+    return std::string_view(base_ + e.offset + sizeof(SimulatorSnapshot) + e.nameSize,
+                            e.metadataSize);
+}
+
+SimulatorSnapshot SessionCheckpoint::snapshot(int index) const {
+    SimulatorSnapshot snapshot;
+    std::memcpy(&snapshot, base_ + entry(index).offset, sizeof(snapshot));
+    return snapshot;
+}
+
+CompressedHistory SessionCheckpoint::history(int index) const {
+    const Entry& e = entry(index);
+    return CompressedHistory::fromBytes(std::string_view(
+        base_ + e.offset + sizeof(SimulatorSnapshot) + e.nameSize + e.metadataSize,
+        e.historySize));
+}
+
+}  // namespace tank_sim
@@ -0,0 +1,96 @@
+#ifndef TANK_SIM_SESSION_CHECKPOINT_H
+#define TANK_SIM_SESSION_CHECKPOINT_H
+
+#include "history_codec.h"
+#include "simulator_snapshot.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace tank_sim {
+
+/**
+ * @brief One file holding the state and history of many sessions, so a
+ *        server can stop and continue them after a restart.
+ *
+ * write() encodes the sessions on several threads (each session's history
+ * compressed into a CompressedHistory block), writes every record at its
+ * offset in parallel, then renames the file into place, so a reader never
+ * sees a half-written checkpoint. Opening a checkpoint maps the file and
+ * checks its index; records are read from the mapping on demand, so only
+ * the sessions actually restored are touched.
+ *
+ * Layout: header, index (one entry per session), then one 8-byte aligned
+ * record per session: SimulatorSnapshot, name, metadata, history block.
+ * Values are in host byte order; checkpoints are meant for the same host
+ * and build (the snapshot version is checked on restore).
+ */
+class SessionCheckpoint {
+public:
+    /**
+     * @brief A session to write.
+     */
+    struct Session {
+        std::string name;
+        std::string metadata;                  ///< Caller's own state, stored as is
+        SimulatorSnapshot snapshot;
+        CompressedHistory earlier;             ///< History restored from a checkpoint
+        std::vector<SessionSample> history;    ///< Samples since, oldest first
+    };
+
+    /**
+     * @brief Write a checkpoint (atomically replacing the file).
+     *
+     * Each session keeps its newest CHECKPOINT_HISTORY_CAPACITY samples of
+     * earlier followed by history.
+     *
+     * @param path File to write; "<path>.tmp" is used while writing
+     * @param sessions Sessions to store
+     * @param threads Encoder threads; 0 picks one per core, up to
+     *        CHECKPOINT_MAX_THREADS
+     * @return Bytes written
+     *
+     * @throws std::runtime_error if the file cannot be written
+     */
+    static std::uint64_t write(const std::string& path, const std::vector<Session>& sessions,
+                               int threads = 0);
+
+    /**
+     * @brief Map a checkpoint and check its index.
+     *
+     * @throws std::runtime_error if the file cannot be read or is not a
+     *         complete checkpoint of this format
+     */
+    explicit SessionCheckpoint(const std::string& path);
+
+    /// Unmaps the file
+    ~SessionCheckpoint();
+
+    SessionCheckpoint(const SessionCheckpoint&) = delete;
+    SessionCheckpoint& operator=(const SessionCheckpoint&) = delete;
+
+    /// Sessions in the checkpoint
+    int size() const;
+
+    // Record accessors; throw std::out_of_range for a bad index. The views
+    // point into the mapping and live as long as the checkpoint.
+    std::string_view name(int index) const;
+    std::string_view metadata(int index) const;
+    SimulatorSnapshot snapshot(int index) const;
+    CompressedHistory history(int index) const;
+
+private:
+    struct Header;
+    struct Entry;
+
+    const char* base_;
+    std::size_t size_;
+
+    const Entry& entry(int index) const;
+};
+
+}  // namespace tank_sim
+
+#endif  // TANK_SIM_SESSION_CHECKPOINT_H
@@ -0,0 +1,469 @@
+#include "session_engine.h"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace tank_sim {
+
+namespace {
+
+/**
+ * @brief Position just after "key": in a flat JSON object, or npos.
+ */
+std::size_t findValue(std::string_view json, std::string_view key) {
+    std::size_t pos = 0;
+    while ((pos = json.find(key, pos)) != std::string_view::npos) {
+        const std::size_t end = pos + key.size();
+        if (pos > 0 && json[pos - 1] == '"' && end < json.size() && json[end] == '"') {
+            std::size_t p = end + 1;
+            while (p < json.size() && std::isspace(static_cast<unsigned char>(json[p]))) {
+                ++p;
+            }
+            if (p < json.size() && json[p] == ':') {
+                ++p;
+                while (p < json.size() && std::isspace(static_cast<unsigned char>(json[p]))) {
+                    ++p;
+                }
+                return p;
+            }
+        }
+        pos = end;
+    }
+    return std::string_view::npos;
+}
+
+bool findString(std::string_view json, std::string_view key, std::string_view& out) {
+    const std::size_t pos = findValue(json, key);
+    if (pos == std::string_view::npos || json[pos] != '"') {
+        return false;
+    }
+    const std::size_t end = json.find('"', pos + 1);
+    if (end == std::string_view::npos) {
+        return false;
+    }
+    out = json.substr(pos + 1, end - pos - 1);
+    return true;
+}
+
+bool findNumber(std::string_view json, std::string_view key, double& out) {
+    const std::size_t pos = findValue(json, key);
+    if (pos == std::string_view::npos) {
+        return false;
+    }
+    const auto result = std::from_chars(json.data() + pos, json.data() + json.size(), out);
+    return result.ec == std::errc();
+}
+
+// The engine thread submits, applies and publishes every session's
+// commands and frames itself, so sessions need no cross-thread outputs
+Simulator::Config sessionConfig(Simulator::Config config) {
+    config.streamTelemetry = false;
+    config.reportCommandResults = false;
+    return config;
+}
+
+}  // namespace
+
+SessionEngine::SessionEngine(const Simulator::Config& config, int max_sessions)
+    : imports_pending_(false),
+      config_(sessionConfig(config)),
+      max_sessions_(max_sessions),
+      session_count_(0),
+      reserved_sessions_(0),
+      store_(nullptr),
+      speculation_ticks_(0),
+      computed_steps_(0),
+      served_ticks_(0),
+      discarded_ticks_(0) {
+    if (max_sessions < 1) {
+        throw std::invalid_argument("Session engine needs room for at least one session");
+    }
+    // Fail now rather than at the first join
+    Simulator probe(config);
+}
+
+SessionEngine::~SessionEngine() { attachStore(nullptr); }
+
+SessionEngine::RequestQueue& SessionEngine::addProducer() {
+    producers_.push_back(std::make_unique<RequestQueue>());
+    return *producers_.back();
+}
+
+void SessionEngine::attachStore(SharedSessionStore* store) {
+    for (auto& [key, session] : sessions_) {
+        if (session.storeSlot >= 0) {
+            store_->release(session.storeSlot);
+        }
+        session.storeSlot = store != nullptr ? store->claim(key) : -1;
+    }
+    store_ = store;
+}
+
+void SessionEngine::enableSpeculation(int ticks) {
+    // Validate the lookahead - fail fast
+    if (ticks < 0 || ticks > constants::MAX_ENGINE_SPECULATION_TICKS) {
+        throw std::invalid_argument("Speculation lookahead must be in 0.." +
+                                    std::to_string(constants::MAX_ENGINE_SPECULATION_TICKS) +
+                                    " ticks");
+    }
+    speculation_ticks_ = canSpeculate(config_) ? ticks : 0;
+    for (auto& [key, session] : sessions_) {
+        // Buffers are sized to the lookahead and rebuilt at the next speculate()
+        discardSpeculation(session);
+        session.speculation.reset();
+    }
+}
+
+bool SessionEngine::canSpeculate(const Simulator::Config& config) {
+    if (config.sensorNoiseStdDev > 0.0 || config.useEstimator || config.identifyModel ||
+        config.monitorLoopHealth || !config.alarms.empty() ||
+        config.controllerConfig.size() > static_cast<std::size_t>(SimulatorSnapshot::MAX_LOOPS)) {
+        return false;
+    }
+    return std::none_of(config.controllerConfig.begin(), config.controllerConfig.end(),
+                        [](const Simulator::ControllerConfig& controller) {
+                            return controller.type == Simulator::ControllerType::MPC;
+                        });
+}
+
+int SessionEngine::speculate(int max_steps) {
+    if (speculation_ticks_ == 0) {
+        return 0;
+    }
+    int computed = 0;
+    for (auto& [key, session] : sessions_) {
+        if (computed >= max_steps) {
+            break;
+        }
+        // A queued command must be applied by a committed step first
+        if (session.commandPending) {
+            continue;
+        }
+        if (!session.speculation) {
+            session.speculation = std::make_unique<Speculation>();
+            session.speculation->ahead.resize(speculation_ticks_);
+        }
+        Speculation& speculation = *session.speculation;
+        const std::size_t capacity = speculation.ahead.size();
+        if (speculation.count == capacity) {
+            continue;
+        }
+        // The simulator is at the last buffered tick, or at the served state
+        double credit = session.credit;
+        if (speculation.count == 0) {
+            speculation.committed = session.simulator->captureState();
+        } else {
+            const std::size_t last = (speculation.first + speculation.count - 1) % capacity;
+            credit = speculation.ahead[last].credit;
+        }
+        while (speculation.count < capacity && computed < max_steps) {
+            Ahead& ahead = speculation.ahead[(speculation.first + speculation.count) % capacity];
+            ahead.steps = stepsDue(session.speed, credit);
+            ahead.credit = credit;
+            if (ahead.steps > 0) {
+                session.simulator->stepMany(ahead.steps);
+                ahead.telemetry = session.simulator->getTelemetry();
+                computed += ahead.steps;
+            }
+            ahead.state = session.simulator->captureState();
+            ++speculation.count;
+        }
+    }
+    add(computed_steps_, static_cast<std::uint64_t>(computed));
+    return computed;
+}
+
+SessionEngine::SpeculationStats SessionEngine::speculationStats() const {
+    SpeculationStats stats;
+    stats.computedSteps = computed_steps_.load(std::memory_order_relaxed);
+    stats.servedTicks = served_ticks_.load(std::memory_order_relaxed);
+    stats.discardedTicks = discarded_ticks_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void SessionEngine::discardSpeculation(Session& session) {
+    Speculation* speculation = session.speculation.get();
+    if (speculation == nullptr || speculation->count == 0) {
+        return;
+    }
+    // Back to the last served tick
+    add(discarded_ticks_, speculation->count);
+    session.simulator->restoreState(speculation->committed);
+    speculation->first = 0;
+    speculation->count = 0;
+}
+
+void SessionEngine::add(std::atomic<std::uint64_t>& counter, std::uint64_t value) {
+    // Single writer: a plain load/store pair, no read-modify-write needed
+    counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+bool SessionEngine::reserveSession() {
+    int reserved = reserved_sessions_.load(std::memory_order_acquire);
+    do {
+        if (reserved >= max_sessions_) {
+            return false;
+        }
+    } while (!reserved_sessions_.compare_exchange_weak(reserved, reserved + 1,
+                                                       std::memory_order_acq_rel));
+    return true;
+}
+
+void SessionEngine::importSession(const Transfer& transfer) {
+    // Validate the snapshot here, where the caller can still react - fail fast
+    if (transfer.snapshot.version != SimulatorSnapshot::VERSION ||
+        transfer.snapshot.loopCount != static_cast<int>(config_.controllerConfig.size())) {
+        throw std::invalid_argument("Session snapshot does not match the engine configuration");
+    }
+    std::lock_guard<std::mutex> lock(transfer_mutex_);
+    imports_.push_back(transfer);
+    imports_pending_.store(true, std::memory_order_release);
+}
+
+std::vector<SessionEngine::Transfer> SessionEngine::takeExports() {
+    std::lock_guard<std::mutex> lock(transfer_mutex_);
+    std::vector<Transfer> exports;
+    exports.swap(exports_);
+    return exports;
+}
+
+SessionEngine::Session& SessionEngine::create(std::uint64_t key, int subscribers) {
+    const int slot = store_ != nullptr ? store_->claim(key) : -1;
+    return sessions_.emplace(key, Session{std::make_unique<Simulator>(config_), subscribers, slot})
+        .first->second;
+}
+
+void SessionEngine::applyImports() {
+    std::vector<Transfer> imports;
+    {
+        std::lock_guard<std::mutex> lock(transfer_mutex_);
+        imports.swap(imports_);
+        imports_pending_.store(false, std::memory_order_relaxed);
+    }
+    for (const Transfer& transfer : imports) {
+        if (transfer.subscribers > 0 && sessions_.count(transfer.sessionKey) == 0) {
+            // Beyond maxSessions if need be; the room is held all the same
+            reserved_sessions_.fetch_add(1, std::memory_order_acq_rel);
+            Session& session = create(transfer.sessionKey, transfer.subscribers);
+            session.simulator->restoreState(transfer.snapshot);
+            session.speed = clampSpeed(transfer.speed);
+        }
+    }
+}
+
+void SessionEngine::apply(const Request& request) {
+    auto it = sessions_.find(request.sessionKey);
+    switch (request.type) {
+        case Request::Type::Join:
+        case Request::Type::ReservedJoin: {
+            const bool reserved = request.type == Request::Type::ReservedJoin;
+            if (it != sessions_.end()) {
+                ++it->second.subscribers;
+                if (reserved) {
+                    reserved_sessions_.fetch_sub(1, std::memory_order_acq_rel);
+                }
+            } else if (reserved || reserveSession()) {
+                create(request.sessionKey, 1);
+            }
+            break;
+        }
+        case Request::Type::Leave:
+            if (it != sessions_.end() && --it->second.subscribers <= 0) {
+                if (it->second.storeSlot >= 0) {
+                    store_->release(it->second.storeSlot);
+                }
+                sessions_.erase(it);
+                reserved_sessions_.fetch_sub(1, std::memory_order_acq_rel);
+            }
+            break;
+        case Request::Type::Export: {
+            Transfer transfer{request.sessionKey, 0, SimulatorSnapshot{}};
+            if (it != sessions_.end()) {
+                discardSpeculation(it->second);
+                // Commands queued ahead of the Export belong to the state that moves
+                it->second.simulator->applyPendingCommands();
+                transfer.subscribers = it->second.subscribers;
+                transfer.snapshot = it->second.simulator->captureState();
+                transfer.speed = it->second.speed;
+                if (it->second.storeSlot >= 0) {
+                    store_->release(it->second.storeSlot);
+                }
+                sessions_.erase(it);
+                reserved_sessions_.fetch_sub(1, std::memory_order_acq_rel);
+            }
+            std::lock_guard<std::mutex> lock(transfer_mutex_);
+            exports_.push_back(transfer);
+            break;
+        }
+        case Request::Type::Command:
+            // Operator input ends any speculative run: the command acts on
+            // the state clients have seen
+            if (it != sessions_.end()) {
+                discardSpeculation(it->second);
+            }
+            // The engine thread both submits and steps, so the queue cannot
+            // fill faster than it drains
+            if (it != sessions_.end() && request.command.type == OperatorCommand::Type::SetSpeed) {
+                // Pacing belongs to the engine; NaN leaves the speed unchanged
+                if (!std::isnan(request.command.value)) {
+                    it->second.speed = clampSpeed(request.command.value);
+                }
+            } else if (it != sessions_.end()) {
+                it->second.simulator->submitCommand(request.command);
+                it->second.commandPending = true;
+                // The next published frame is the first of the new run
+                if (request.command.type == OperatorCommand::Type::Reset &&
+                    it->second.storeSlot >= 0) {
+                    store_->restartHistory(it->second.storeSlot);
+                }
+            }
+            break;
+    }
+}
+
+int SessionEngine::tick() {
+    // Step 1: Imported sessions, then requests from every front end
+    if (imports_pending_.load(std::memory_order_acquire)) {
+        applyImports();
+    }
+    Request request;
+    for (auto& queue : producers_) {
+        while (queue->tryPop(request)) {
+            apply(request);
+        }
+    }
+    session_count_.store(static_cast<int>(sessions_.size()), std::memory_order_release);
+
+    // Step 2: Step each session by its speed and publish one frame, encoded
+    // once, whatever the number of steps
+    EncodedFrame frame;
+    constexpr std::size_t payload_offset = websocket::MAX_SERVER_HEADER;
+    int published = 0;
+    for (auto& [key, session] : sessions_) {
+        TelemetryFrame telemetry;
+        Speculation* speculation = session.speculation.get();
+        if (speculation != nullptr && speculation->count > 0) {
+            // Computed ahead: the tick is a buffer read, and its state the served one
+            const Ahead& ahead = speculation->ahead[speculation->first];
+            speculation->first = (speculation->first + 1) % speculation->ahead.size();
+            --speculation->count;
+            session.credit = ahead.credit;
+            const bool stepped = ahead.steps > 0;
+            telemetry = ahead.telemetry;
+            speculation->committed = ahead.state;
+            add(served_ticks_, 1);
+            if (!stepped) {
+                continue;
+            }
+        } else {
+            const int steps = stepsDue(session.speed, session.credit);
+            if (steps < 1) {
+                continue;   // Slow motion: nothing new to publish this tick
+            }
+            session.simulator->stepMany(steps);
+            session.commandPending = false;
+            telemetry = session.simulator->getTelemetry();
+        }
+
+        const std::size_t payload =
+            FrameEncoder::writeJson(telemetry, frame.data.data() + payload_offset);
+        char header[websocket::MAX_SERVER_HEADER];
+        const std::size_t header_size =
+            websocket::writeFrameHeader(header, websocket::Text, payload);
+        frame.offset = static_cast<std::uint16_t>(payload_offset - header_size);
+        std::copy(header, header + header_size, frame.data.data() + frame.offset);
+        frame.size = static_cast<std::uint16_t>(header_size + payload);
+        frame.sessionKey = key;
+        frame.time = telemetry.time;
+        frame.telemetry = telemetry;
+        frames_.publish(frame);
+
+        if (session.storeSlot >= 0) {
+            store_->publish(session.storeSlot, telemetry);
+        }
+        ++published;
+    }
+    return published;
+}
+
+int SessionEngine::stepsDue(double speed, double& credit) {
+    credit += speed;
+    const int steps = static_cast<int>(
+        std::min(std::floor(credit), static_cast<double>(constants::ENGINE_MAX_STEPS_PER_TICK)));
+    if (steps > 0) {
+        credit -= steps;
+    }
+    return steps;
+}
+
+double SessionEngine::clampSpeed(double speed) {
+    // Infinity ("as fast as possible") becomes the per-tick step budget
+    return std::clamp(speed, constants::MIN_SESSION_SPEED,
+                      static_cast<double>(constants::ENGINE_MAX_STEPS_PER_TICK));
+}
+
+std::uint64_t SessionEngine::sessionKey(std::string_view name) {
+    // FNV-1a
+    std::uint64_t hash = 0xcbf29ce484222325ULL;
+    for (char c : name) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+bool SessionEngine::parseClientMessage(std::string_view text, OperatorCommand& command,
+                                       std::string& error) {
+    std::string_view type;
+    if (text.empty() || text.front() != '{' || !findString(text, "type", type)) {
+        error = "Invalid JSON format";
+        return false;
+    }
+
+    command = OperatorCommand{};
+    if (type == "setpoint" || type == "inlet_flow") {
+        if (!findNumber(text, "value", command.value)) {
+            error = "Missing 'value' field";
+            return false;
+        }
+        command.type = type == "setpoint" ? OperatorCommand::Type::SetSetpoint
+                                          : OperatorCommand::Type::SetInput;
+        return true;
+    }
+    if (type == "pid") {
+        if (!findNumber(text, "Kc", command.gains.Kc) ||
+            !findNumber(text, "tau_I", command.gains.tau_I) ||
+            !findNumber(text, "tau_D", command.gains.tau_D)) {
+            error = "Missing PID gain fields (Kc, tau_I, tau_D)";
+            return false;
+        }
+        command.type = OperatorCommand::Type::SetGains;
+        return true;
+    }
+    if (type == "reset") {
+        command.type = OperatorCommand::Type::Reset;
+        return true;
+    }
+    if (type == "speed") {
+        std::string_view word;
+        if (findString(text, "value", word) && word == "max") {
+            command.value = std::numeric_limits<double>::infinity();
+        } else if (!findNumber(text, "value", command.value) || !(command.value > 0.0)) {
+            error = "Speed must be a positive number or \"max\"";
+            return false;
+        }
+        command.type = OperatorCommand::Type::SetSpeed;
+        return true;
+    }
+    if (type == "history" || type == "inlet_mode" || type == "stats") {
+        error = "Message type not supported by the native server: " + std::string(type);
+        return false;
+    }
+    error = "Unknown message type: " + std::string(type);
+    return false;
+}
+
+}  // namespace tank_sim
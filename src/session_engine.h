@@ -0,0 +1,316 @@
+#ifndef TANK_SIM_SESSION_ENGINE_H
+#define TANK_SIM_SESSION_ENGINE_H
+
+#include "broadcast_ring.h"
+#include "constants.h"
+#include "frame_encoder.h"
+#include "operator_command.h"
+#include "shared_session_store.h"
+#include "simulator.h"
+#include "spsc_ring.h"
+#include "websocket_codec.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace tank_sim {
+
+/**
+ * @brief Owns many simulations and publishes one encoded frame per tick each.
+ *
+ * The native counterpart of the API's SessionManager, for servers that
+ * stream without Python. One engine thread calls tick(); front-end threads
+ * (e.g. socket event loops) talk to it only through lock-free queues:
+ *
+ * - Each front-end thread gets its own RequestQueue from addProducer() and
+ *   pushes Join, Leave and Command requests into it (single producer, the
+ *   engine is the single consumer).
+ * - tick() applies the requests, steps every session, renders its state
+ *   message once as a complete WebSocket text frame (FrameEncoder JSON,
+ *   unmasked, so the same bytes go to every client) and publishes it into
+ *   a BroadcastRing. Front-end threads read the ring with their own cursors
+ *   and forward each frame to their clients of that session.
+ *
+ * Sessions are identified by a 64-bit key derived from their name. A
+ * session is created by its first Join and destroyed with its last Leave;
+ * Joins beyond maxSessions are ignored, so front ends that admit clients
+ * while the engine ticks reserve room with reserveSession() first.
+ *
+ * Each session runs at its own speed factor, set with a SetSpeed command:
+ * at speed v it takes v simulator steps per tick on average. Faster
+ * sessions take all of a tick's steps in one Simulator::stepMany() and
+ * still publish a single frame, so the frame rate does not grow with the
+ * speed; slower sessions skip the ticks on which they do not step.
+ *
+ * With enableSpeculation() the engine computes sessions ahead while it is
+ * idle between ticks (speculate()), and tick() then serves their frames
+ * from a buffer. A command, speed change or export discards the buffered
+ * tail and returns the session to the state of its last served frame.
+ *
+ * With attachStore() the engine also exports every session's telemetry to
+ * a SharedSessionStore, so other processes can read it.
+ *
+ * Sessions can move between engines (e.g. shard processes): an Export
+ * request removes the session at the next tick and hands its state,
+ * captured after the commands queued before it, to takeExports(); the
+ * receiving engine continues it from importSession().
+ *
+ * The frame ring is several megabytes; allocate the engine on the heap.
+ */
+class SessionEngine {
+public:
+    /**
+     * @brief One session's state message, framed for WebSocket.
+     */
+    struct EncodedFrame {
+        std::uint64_t sessionKey;
+        double time;            ///< Simulation time of the state
+        std::uint16_t offset;   ///< Start of the frame in data
+        std::uint16_t size;     ///< Header plus payload bytes
+        std::array<char, websocket::MAX_SERVER_HEADER + FrameEncoder::MAX_JSON_SIZE> data;
+        TelemetryFrame telemetry;   ///< The state itself, for front ends that re-encode it
+
+        std::string_view bytes() const { return std::string_view(data.data() + offset, size); }
+
+        /// The JSON message without the WebSocket header
+        std::string_view payload() const {
+            constexpr std::size_t start = websocket::MAX_SERVER_HEADER;
+            return std::string_view(data.data() + start, size - (start - offset));
+        }
+    };
+    using FrameRing = BroadcastRing<EncodedFrame, constants::ENGINE_FRAME_RING_CAPACITY>;
+
+    /**
+     * @brief Request from a front-end thread.
+     */
+    struct Request {
+        /// ReservedJoin is a Join whose room reserveSession() already holds
+        enum class Type { Join, Leave, Command, Export, ReservedJoin };
+        Type type;
+        std::uint64_t sessionKey;
+        OperatorCommand command;   ///< For Command
+    };
+    using RequestQueue = SpscRing<Request, constants::ENGINE_REQUEST_QUEUE_CAPACITY>;
+
+    /**
+     * @brief A session's state on its way to another engine.
+     *
+     * An Export of a session the engine does not have yields a Transfer
+     * with no subscribers and an empty snapshot.
+     */
+    struct Transfer {
+        std::uint64_t sessionKey;
+        std::int32_t subscribers;
+        SimulatorSnapshot snapshot;
+        double speed = 1.0;   ///< Speed factor the session continues at
+    };
+
+    /**
+     * @brief Counters of speculative execution (any thread).
+     */
+    struct SpeculationStats {
+        std::uint64_t computedSteps = 0;    ///< Steps run ahead by speculate()
+        std::uint64_t servedTicks = 0;      ///< Ticks served from a buffer
+        std::uint64_t discardedTicks = 0;   ///< Buffered ticks thrown away
+    };
+
+    /**
+     * @param config Configuration of every session's simulator
+     * @param max_sessions Session limit
+     *
+     * @throws std::invalid_argument if max_sessions < 1 or the config is
+     *         rejected by Simulator
+     */
+    SessionEngine(const Simulator::Config& config, int max_sessions);
+
+    /// Releases the store slots of the remaining sessions
+    ~SessionEngine();
+
+    SessionEngine(const SessionEngine&) = delete;
+    SessionEngine& operator=(const SessionEngine&) = delete;
+
+    /**
+     * @brief Register a front-end thread and return its request queue.
+     *
+     * Call before the engine thread starts ticking; not thread-safe.
+     */
+    RequestQueue& addProducer();
+
+    /**
+     * @brief Export sessions to a shared-memory store (nullptr to stop).
+     *
+     * Each session claims a slot when it is created (it is not exported if
+     * the store is full or another process already exports its key),
+     * publishes its telemetry every tick, restarts its history on reset and
+     * releases the slot when it ends. The store must outlive the engine or
+     * the next attachStore(). Call while the engine thread is not ticking.
+     */
+    void attachStore(SharedSessionStore* store);
+
+    /**
+     * @brief Let speculate() compute each session up to ticks ahead (0 = off).
+     *
+     * Only configurations that a SimulatorSnapshot restores exactly can
+     * speculate (see canSpeculate()); for others this is a no-op. Turning
+     * it off returns every session to its last served state. Call while
+     * the engine thread is not ticking.
+     *
+     * @throws std::invalid_argument if ticks is negative or above
+     *         MAX_ENGINE_SPECULATION_TICKS
+     */
+    void enableSpeculation(int ticks);
+
+    /**
+     * @brief Whether a rollback to a snapshot continues a run exactly.
+     *
+     * False with sensor noise, a state estimator, model identification,
+     * MPC loops, loop-health monitoring or alarms, whose state a snapshot
+     * does not carry, and with more loops than a snapshot holds. KPIs
+     * (Simulator::getPerformance) restart on a rollback; the engine does
+     * not publish them.
+     */
+    static bool canSpeculate(const Simulator::Config& config);
+
+    /**
+     * @brief Compute sessions ahead (engine thread, between ticks).
+     *
+     * Tops up the buffer of every session that has no command waiting to
+     * be applied, one tick at a time with the same step counts tick()
+     * would take, continuing after the ticks already buffered. Each tick
+     * keeps a snapshot of its state, so a discard is a single restore of
+     * the last served one. Stops after the tick that reaches max_steps.
+     *
+     * @return Simulator steps computed (0 when nothing is left to do)
+     */
+    int speculate(int max_steps);
+
+    SpeculationStats speculationStats() const;
+
+    /**
+     * @brief Continue a session exported by another engine (any thread).
+     *
+     * Applied at the start of the next tick, before queued requests, so
+     * commands queued after this call act on the imported state. Imports
+     * are accepted beyond maxSessions, since dropping one would lose a
+     * session; an import for a session the engine already has is ignored.
+     *
+     * @throws std::invalid_argument if the snapshot version or loop count
+     *         does not match the engine's configuration
+     */
+    void importSession(const Transfer& transfer);
+
+    /// Sessions removed by Export requests since the last call (any thread)
+    std::vector<Transfer> takeExports();
+
+    /**
+     * @brief Apply queued requests, step all sessions and publish (engine thread).
+     *
+     * @return Frames published
+     */
+    int tick();
+
+    /// Frames published by tick(); read from any thread with a cursor
+    const FrameRing& frames() const { return frames_; }
+
+    /// Sessions alive after the last tick (any thread)
+    int sessionCount() const { return session_count_.load(std::memory_order_acquire); }
+
+    int maxSessions() const { return max_sessions_; }
+
+    /**
+     * @brief Hold room for a new session until its ReservedJoin (any thread).
+     *
+     * sessionCount() lags the joins queued since the last tick, so two
+     * front ends checking it at once can both admit the last session.
+     * Every live session holds one room; a ReservedJoin for a session that
+     * is already alive hands its room back.
+     *
+     * @return false if maxSessions rooms are held
+     */
+    bool reserveSession();
+
+    /// Key of the session with this name
+    static std::uint64_t sessionKey(std::string_view name);
+
+    /**
+     * @brief Translate a client message of the /ws protocol into a command.
+     *
+     * Handles the setpoint, pid, inlet_flow and reset messages, which act
+     * on loop 0 and input 0 as in the API, and the speed message
+     * ({"type": "speed", "value": <factor> or "max"}).
+     *
+     * @param text JSON text of the message
+     * @param command Filled on success
+     * @param error Message for the client on failure, as the API words it
+     * @return false if the message is invalid or not handled natively
+     */
+    static bool parseClientMessage(std::string_view text, OperatorCommand& command,
+                                   std::string& error);
+
+private:
+    /// One tick computed ahead
+    struct Ahead {
+        TelemetryFrame telemetry;
+        SimulatorSnapshot state;   ///< Simulator state after the tick
+        int steps;                 ///< 0: a slow-motion tick that publishes nothing
+        double credit;             ///< Session step credit after the tick
+    };
+
+    /// Speculative run of one session: a ring of the ticks not served yet
+    struct Speculation {
+        SimulatorSnapshot committed;   ///< State of the last served tick
+        std::vector<Ahead> ahead;      ///< speculation_ticks_ slots
+        std::size_t first = 0;         ///< Slot of the next tick to serve
+        std::size_t count = 0;         ///< Ticks buffered
+    };
+
+    struct Session {
+        std::unique_ptr<Simulator> simulator;
+        int subscribers;
+        int storeSlot;   ///< Slot in store_, or -1
+        double speed = 1.0;    ///< Simulator steps per tick, on average
+        double credit = 0.0;   ///< Fraction of a step carried to the next tick
+        bool commandPending = false;   ///< Submitted, not yet applied by a step
+        std::unique_ptr<Speculation> speculation = nullptr;   ///< nullptr if not speculating
+    };
+
+    // Session transfers; the engine thread locks only when imports are
+    // pending or a session is exported
+    std::mutex transfer_mutex_;
+    std::vector<Transfer> imports_;
+    std::vector<Transfer> exports_;
+    std::atomic<bool> imports_pending_;
+
+    Simulator::Config config_;
+    int max_sessions_;
+    std::unordered_map<std::uint64_t, Session> sessions_;
+    std::vector<std::unique_ptr<RequestQueue>> producers_;
+    std::atomic<int> session_count_;
+    std::atomic<int> reserved_sessions_;   ///< Live sessions plus joins in flight
+    FrameRing frames_;
+    SharedSessionStore* store_;
+    int speculation_ticks_;
+
+    // Written by the engine thread only; atomics so speculationStats() can read them
+    std::atomic<std::uint64_t> computed_steps_;
+    std::atomic<std::uint64_t> served_ticks_;
+    std::atomic<std::uint64_t> discarded_ticks_;
+
+    void apply(const Request& request);
+    void applyImports();
+    Session& create(std::uint64_t key, int subscribers);
+    static double clampSpeed(double speed);
+    static int stepsDue(double speed, double& credit);
+    void discardSpeculation(Session& session);
+    static void add(std::atomic<std::uint64_t>& counter, std::uint64_t value);
+};
+
+}  // namespace tank_sim
+
+#endif  // TANK_SIM_SESSION_ENGINE_H
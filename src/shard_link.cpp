@@ -0,0 +1,141 @@
+#include "shard_link.h"
+#include "constants.h"
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace tank_sim {
+
+namespace {
+
+sockaddr_un socketAddress(const std::string& path) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+        throw std::invalid_argument("Unix socket path must be 1-" +
+                                    std::to_string(sizeof(address.sun_path) - 1) +
+                                    " characters: " + path);
+    }
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    return address;
+}
+
+int unixSocket() {
+    const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        throw std::runtime_error(std::string("socket: ") + std::strerror(errno));
+    }
+    return fd;
+}
+
+}  // namespace
+
+ShardLink::ShardLink(int fd) : fd_(fd), out_offset_(0) {
+    fcntl(fd_, F_SETFL, fcntl(fd_, F_GETFL) | O_NONBLOCK);
+}
+
+ShardLink::~ShardLink() { ::close(fd_); }
+
+int ShardLink::listen(const std::string& path) {
+    const sockaddr_un address = socketAddress(path);
+    const int fd = unixSocket();
+    ::unlink(path.c_str());
+    if (bind(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(fd, SOMAXCONN) != 0) {
+        const std::string error = std::strerror(errno);
+        ::close(fd);
+        throw std::runtime_error("Cannot listen on " + path + ": " + error);
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    return fd;
+}
+
+int ShardLink::connect(const std::string& path) {
+    const sockaddr_un address = socketAddress(path);
+    const int fd = unixSocket();
+    if (::connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        const std::string error = std::strerror(errno);
+        ::close(fd);
+        throw std::runtime_error("Cannot connect to shard " + path + ": " + error);
+    }
+    return fd;
+}
+
+void ShardLink::send(MessageType type, std::uint64_t session_key, const void* payload,
+                     std::size_t size) {
+    if (size > static_cast<std::size_t>(constants::SHARD_MAX_MESSAGE_SIZE)) {
+        throw std::invalid_argument("Shard message payload too large");
+    }
+    // Drop what has been written before the buffer grows
+    if (out_offset_ == out_.size()) {
+        out_.clear();
+        out_offset_ = 0;
+    }
+    const Header header{static_cast<std::uint32_t>(size), type, session_key};
+    out_.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    if (size > 0) {
+        out_.append(static_cast<const char*>(payload), size);
+    }
+}
+
+bool ShardLink::flush() {
+    while (out_offset_ < out_.size()) {
+        const ssize_t n =
+            ::send(fd_, out_.data() + out_offset_, out_.size() - out_offset_, MSG_NOSIGNAL);
+        if (n > 0) {
+            out_offset_ += static_cast<std::size_t>(n);
+        } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return true;
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else {
+            return false;
+        }
+    }
+    out_.clear();
+    out_offset_ = 0;
+    return true;
+}
+
+bool ShardLink::receive(const Handler& handler) {
+    char buffer[65536];
+    bool open = true;
+    for (;;) {
+        const ssize_t n = ::recv(fd_, buffer, sizeof(buffer), 0);
+        if (n > 0) {
+            in_.append(buffer, static_cast<std::size_t>(n));
+            if (static_cast<std::size_t>(n) < sizeof(buffer)) {
+                break;
+            }
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else {
+            open = n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+            break;
+        }
+    }
+
+    // Dispatch complete messages; keep a partial one for the next call
+    std::size_t offset = 0;
+    while (in_.size() - offset >= sizeof(Header)) {
+        Header header;
+        std::memcpy(&header, in_.data() + offset, sizeof(header));
+        if (header.size > static_cast<std::uint32_t>(constants::SHARD_MAX_MESSAGE_SIZE)) {
+            return false;
+        }
+        if (in_.size() - offset - sizeof(header) < header.size) {
+            break;
+        }
+        handler(header, std::string_view(in_.data() + offset + sizeof(header), header.size));
+        offset += sizeof(header) + header.size;
+    }
+    in_.erase(0, offset);
+    return open;
+}
+
+}  // namespace tank_sim
@@ -0,0 +1,109 @@
+#ifndef TANK_SIM_SHARD_LINK_H
+#define TANK_SIM_SHARD_LINK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+
+namespace tank_sim {
+
+/**
+ * @brief One end of a Unix-domain stream socket between a ShardRouter and
+ *        an EngineShard, carrying length-prefixed binary messages.
+ *
+ * Each message is a fixed Header followed by `size` payload bytes. Both
+ * ends run on the same host, so payloads are raw structs in host byte
+ * order (OperatorCommand, SessionEngine::Transfer) or, for frames, the
+ * simulation time followed by the state JSON.
+ *
+ * The socket is non-blocking. send() appends to an output buffer that
+ * flush() writes as far as the socket accepts; receive() reads what is
+ * available and hands every complete message to the handler.
+ */
+class ShardLink {
+public:
+    enum class MessageType : std::uint32_t {
+        Join = 1,   ///< Router to shard: add a subscriber
+        Leave,      ///< Router to shard: remove a subscriber
+        Command,    ///< Router to shard: OperatorCommand
+        Export,     ///< Router to shard: move the session out
+        Import,     ///< Router to shard: SessionEngine::Transfer to continue
+        Frame,      ///< Shard to router: double time, then the state JSON
+        Exported    ///< Shard to router: SessionEngine::Transfer of an Export
+    };
+
+    struct Header {
+        std::uint32_t size;   ///< Payload bytes
+        MessageType type;
+        std::uint64_t sessionKey;
+    };
+
+    using Handler = std::function<void(const Header&, std::string_view payload)>;
+
+    /// Take ownership of a connected socket and make it non-blocking
+    explicit ShardLink(int fd);
+
+    /// Closes the socket
+    ~ShardLink();
+
+    ShardLink(const ShardLink&) = delete;
+    ShardLink& operator=(const ShardLink&) = delete;
+
+    /**
+     * @brief Listening socket at a filesystem path (a stale socket file is
+     *        replaced).
+     *
+     * @throws std::invalid_argument if the path is too long for a socket
+     * @throws std::runtime_error if the socket cannot be bound
+     */
+    static int listen(const std::string& path);
+
+    /**
+     * @brief Connected socket to a listening path.
+     *
+     * @throws std::invalid_argument if the path is too long for a socket
+     * @throws std::runtime_error if nothing listens there
+     */
+    static int connect(const std::string& path);
+
+    int fd() const { return fd_; }
+
+    /**
+     * @brief Queue a message.
+     *
+     * @throws std::invalid_argument if the payload exceeds
+     *         SHARD_MAX_MESSAGE_SIZE
+     */
+    void send(MessageType type, std::uint64_t session_key, const void* payload = nullptr,
+              std::size_t size = 0);
+
+    /**
+     * @brief Write queued bytes until done or the socket is full.
+     *
+     * @return false if the peer is gone
+     */
+    bool flush();
+
+    /// Bytes queued but not yet written
+    std::size_t pending() const { return out_.size() - out_offset_; }
+
+    /**
+     * @brief Read what is available and dispatch complete messages.
+     *
+     * @return false if the peer closed the socket or sent an oversized
+     *         message
+     */
+    bool receive(const Handler& handler);
+
+private:
+    int fd_;
+    std::string in_;
+    std::string out_;
+    std::size_t out_offset_;
+};
+
+}  // namespace tank_sim
+
+#endif  // TANK_SIM_SHARD_LINK_H
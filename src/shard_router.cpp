@@ -0,0 +1,363 @@
+#include "shard_router.h"
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <sys/epoll.h>
+#include <unistd.h>
+
+namespace tank_sim {
+
+namespace {
+
+constexpr int MAX_EVENTS = 16;
+
+}  // namespace
+
+ShardRouter::ShardRouter(const std::vector<std::string>& socket_paths) : epoll_(-1) {
+    // Validate the shard list - fail fast
+    if (socket_paths.empty()) {
+        throw std::invalid_argument("Shard router needs at least one shard");
+    }
+    epoll_ = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_ < 0) {
+        throw std::runtime_error(std::string("epoll_create1: ") + std::strerror(errno));
+    }
+    try {
+        for (const auto& path : socket_paths) {
+            connect(path);
+        }
+    } catch (...) {
+        shards_.clear();
+        ::close(epoll_);
+        throw;
+    }
+}
+
+ShardRouter::~ShardRouter() {
+    // Deliver what is queued (e.g. final Leaves) before closing the links
+    flush();
+    shards_.clear();
+    ::close(epoll_);
+}
+
+int ShardRouter::addShard(const std::string& socket_path) {
+    connect(socket_path);
+    return static_cast<int>(shards_.size()) - 1;
+}
+
+void ShardRouter::connect(const std::string& socket_path) {
+    const int id = static_cast<int>(shards_.size());
+    auto link = std::make_unique<ShardLink>(ShardLink::connect(socket_path));
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.u32 = static_cast<std::uint32_t>(id);
+    if (epoll_ctl(epoll_, EPOLL_CTL_ADD, link->fd(), &event) != 0) {
+        throw std::runtime_error(std::string("epoll_ctl: ") + std::strerror(errno));
+    }
+    shards_.push_back(Shard{std::move(link)});
+    ring_.addShard(id);
+}
+
+bool ShardRouter::live(int shard) const {
+    return shard >= 0 && shard < static_cast<int>(shards_.size()) && shards_[shard].link;
+}
+
+int ShardRouter::shardCount() const {
+    int count = 0;
+    for (const auto& shard : shards_) {
+        count += shard.link ? 1 : 0;
+    }
+    return count;
+}
+
+int ShardRouter::shardOf(std::uint64_t session_key) const {
+    auto it = routes_.find(session_key);
+    return it != routes_.end() ? it->second.shard : ring_.shardFor(session_key);
+}
+
+int ShardRouter::sessionsOn(int shard) const {
+    int count = 0;
+    for (const auto& [key, route] : routes_) {
+        count += route.shard == shard ? 1 : 0;
+    }
+    return count;
+}
+
+void ShardRouter::send(int shard, ShardLink::MessageType type, std::uint64_t key,
+                       const OperatorCommand* command) {
+    if (!live(shard)) {
+        return;
+    }
+    ShardLink& link = *shards_[shard].link;
+    if (command != nullptr) {
+        link.send(type, key, command, sizeof(*command));
+    } else {
+        link.send(type, key);
+    }
+    // Write now so requests do not wait for the shard's next message; a
+    // dead shard is noticed by poll()
+    link.flush();
+}
+
+void ShardRouter::join(std::uint64_t session_key) {
+    auto it = routes_.find(session_key);
+    if (it == routes_.end()) {
+        it = routes_.emplace(session_key, Route{ring_.shardFor(session_key), 0}).first;
+    }
+    ++it->second.subscribers;
+    auto migration = migrations_.find(session_key);
+    if (migration != migrations_.end()) {
+        migration->second.held.push_back(Held{ShardLink::MessageType::Join, OperatorCommand{}});
+        return;
+    }
+    send(it->second.shard, ShardLink::MessageType::Join, session_key);
+}
+
+void ShardRouter::leave(std::uint64_t session_key) {
+    auto it = routes_.find(session_key);
+    if (it == routes_.end()) {
+        return;
+    }
+    --it->second.subscribers;
+    auto migration = migrations_.find(session_key);
+    if (migration != migrations_.end()) {
+        // The route stays until the migration completes
+        migration->second.held.push_back(Held{ShardLink::MessageType::Leave, OperatorCommand{}});
+        return;
+    }
+    send(it->second.shard, ShardLink::MessageType::Leave, session_key);
+    if (it->second.subscribers <= 0) {
+        routes_.erase(it);
+    }
+}
+
+void ShardRouter::submit(std::uint64_t session_key, const OperatorCommand& command) {
+    auto it = routes_.find(session_key);
+    if (it == routes_.end()) {
+        return;   // The engine would ignore it too
+    }
+    auto migration = migrations_.find(session_key);
+    if (migration != migrations_.end()) {
+        migration->second.held.push_back(Held{ShardLink::MessageType::Command, command});
+        return;
+    }
+    send(it->second.shard, ShardLink::MessageType::Command, session_key, &command);
+}
+
+bool ShardRouter::migrate(std::uint64_t session_key, int shard) {
+    // Validate the target - fail fast
+    if (!live(shard)) {
+        throw std::invalid_argument("Unknown shard: " + std::to_string(shard));
+    }
+    auto it = routes_.find(session_key);
+    if (it == routes_.end() || it->second.shard == shard ||
+        migrations_.count(session_key) != 0) {
+        return false;
+    }
+    send(it->second.shard, ShardLink::MessageType::Export, session_key);
+    migrations_.emplace(session_key, Migration{shard, {}});
+    return true;
+}
+
+bool ShardRouter::exportSession(std::uint64_t session_key) {
+    auto it = routes_.find(session_key);
+    if (it == routes_.end() || migrations_.count(session_key) != 0) {
+        return false;
+    }
+    send(it->second.shard, ShardLink::MessageType::Export, session_key);
+    migrations_.emplace(session_key, Migration{TO_CALLER, {}});
+    return true;
+}
+
+std::vector<SessionEngine::Transfer> ShardRouter::takeExports() {
+    std::vector<SessionEngine::Transfer> exports;
+    exports.swap(exports_);
+    return exports;
+}
+
+void ShardRouter::importSession(const SessionEngine::Transfer& transfer) {
+    const std::uint64_t key = transfer.sessionKey;
+    if (transfer.subscribers <= 0 || routes_.count(key) != 0 || ring_.empty()) {
+        return;
+    }
+    const int shard = ring_.shardFor(key);
+    if (!live(shard)) {
+        return;
+    }
+    ShardLink& link = *shards_[shard].link;
+    link.send(ShardLink::MessageType::Import, key, &transfer, sizeof(transfer));
+    link.flush();
+    routes_.emplace(key, Route{shard, transfer.subscribers});
+}
+
+int ShardRouter::drainShard(int shard) {
+    if (ring_.contains(shard)) {
+        if (ring_.shards().size() == 1) {
+            throw std::logic_error("Cannot drain the last shard");
+        }
+        ring_.removeShard(shard);
+    }
+    int started = 0;
+    for (const auto& [key, route] : routes_) {
+        if (route.shard == shard && migrations_.count(key) == 0) {
+            started += migrate(key, ring_.shardFor(key)) ? 1 : 0;
+        }
+    }
+    return started;
+}
+
+int ShardRouter::rebalance() {
+    int started = 0;
+    for (const auto& [key, route] : routes_) {
+        const int owner = ring_.shardFor(key);
+        if (owner != route.shard && migrations_.count(key) == 0) {
+            started += migrate(key, owner) ? 1 : 0;
+        }
+    }
+    return started;
+}
+
+std::vector<ShardRouter::Frame> ShardRouter::poll(int timeout_ms) {
+    std::vector<Frame> frames;
+    flush();
+
+    epoll_event events[MAX_EVENTS];
+    const int count = epoll_wait(epoll_, events, MAX_EVENTS, timeout_ms);
+    for (int i = 0; i < count; ++i) {
+        const int shard = static_cast<int>(events[i].data.u32);
+        if (!live(shard)) {
+            continue;
+        }
+        bool open = (events[i].events & (EPOLLERR | EPOLLHUP)) == 0;
+        if (events[i].events & EPOLLIN) {
+            // Read even on hang-up: the shard's last messages are still valid
+            open = shards_[shard].link->receive(
+                       [&](const ShardLink::Header& header, std::string_view payload) {
+                           handle(shard, header, payload, frames);
+                       }) &&
+                   open;
+        }
+        if (!open) {
+            dropShard(shard);
+        }
+    }
+
+    // Requests replayed by completed migrations
+    flush();
+    return frames;
+}
+
+void ShardRouter::handle(int shard, const ShardLink::Header& header, std::string_view payload,
+                         std::vector<Frame>& frames) {
+    switch (header.type) {
+        case ShardLink::MessageType::Frame: {
+            // Late frames from a shard the session has left are dropped
+            auto it = routes_.find(header.sessionKey);
+            if (it == routes_.end() || it->second.shard != shard ||
+                payload.size() < sizeof(double)) {
+                return;
+            }
+            Frame frame;
+            frame.sessionKey = header.sessionKey;
+            std::memcpy(&frame.time, payload.data(), sizeof(double));
+            frame.message.assign(payload.data() + sizeof(double), payload.size() - sizeof(double));
+            frames.push_back(std::move(frame));
+            return;
+        }
+        case ShardLink::MessageType::Exported: {
+            SessionEngine::Transfer transfer;
+            if (payload.size() != sizeof(transfer)) {
+                return;
+            }
+            std::memcpy(&transfer, payload.data(), sizeof(transfer));
+            completeMigration(header.sessionKey, transfer);
+            return;
+        }
+        default:
+            return;
+    }
+}
+
+void ShardRouter::completeMigration(std::uint64_t key, const SessionEngine::Transfer& transfer) {
+    auto migration = migrations_.find(key);
+    if (migration == migrations_.end()) {
+        return;
+    }
+    const std::vector<Held> held = std::move(migration->second.held);
+    int target = migration->second.target;
+    migrations_.erase(migration);
+    if (target == TO_CALLER) {
+        // The session leaves the router; requests held for it are dropped
+        routes_.erase(key);
+        exports_.push_back(transfer);
+        exports_.back().sessionKey = key;
+        return;
+    }
+    if (!live(target)) {
+        if (ring_.empty()) {
+            routes_.erase(key);   // No shard left to continue it
+            return;
+        }
+        target = ring_.shardFor(key);
+    }
+
+    // Import first, then the requests held back, in order
+    if (transfer.subscribers > 0 && live(target)) {
+        shards_[target].link->send(ShardLink::MessageType::Import, key, &transfer,
+                                   sizeof(transfer));
+    }
+    for (const auto& request : held) {
+        send(target, request.type, key,
+             request.type == ShardLink::MessageType::Command ? &request.command : nullptr);
+    }
+
+    auto route = routes_.find(key);
+    if (route == routes_.end()) {
+        return;
+    }
+    route->second.shard = target;
+    if (route->second.subscribers <= 0) {
+        routes_.erase(route);
+    }
+}
+
+void ShardRouter::dropShard(int shard) {
+    epoll_ctl(epoll_, EPOLL_CTL_DEL, shards_[shard].link->fd(), nullptr);
+    shards_[shard].link.reset();
+    if (ring_.contains(shard)) {
+        ring_.removeShard(shard);
+    }
+    // Its sessions are lost; migrations towards it go to the ring owner
+    for (auto it = routes_.begin(); it != routes_.end();) {
+        if (it->second.shard == shard) {
+            migrations_.erase(it->first);
+            it = routes_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void ShardRouter::flush() {
+    for (int id = 0; id < static_cast<int>(shards_.size()); ++id) {
+        Shard& shard = shards_[id];
+        if (!shard.link) {
+            continue;
+        }
+        if (!shard.link->flush()) {
+            dropShard(id);
+            continue;
+        }
+        const bool arm = shard.link->pending() > 0;
+        if (arm != shard.writeArmed) {
+            shard.writeArmed = arm;
+            epoll_event event{};
+            event.events = EPOLLIN | (arm ? EPOLLOUT : 0u);
+            event.data.u32 = static_cast<std::uint32_t>(id);
+            epoll_ctl(epoll_, EPOLL_CTL_MOD, shard.link->fd(), &event);
+        }
+    }
+}
+
+}  // namespace tank_sim
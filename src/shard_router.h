@@ -0,0 +1,204 @@
+#ifndef TANK_SIM_SHARD_ROUTER_H
+#define TANK_SIM_SHARD_ROUTER_H
+
+#include "hash_ring.h"
+#include "operator_command.h"
+#include "session_engine.h"
+#include "shard_link.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace tank_sim {
+
+/**
+ * @brief Spreads sessions over EngineShard processes and moves them live.
+ *
+ * The router connects to every shard's Unix socket (shard id = position
+ * in the list) and places each session with a consistent-hash ring, so
+ * adding or draining a shard moves only the sessions that must move. It
+ * offers the request side of a SessionEngine - join(), leave(), submit() -
+ * and poll() returns the frames the shards sent for the joined sessions.
+ *
+ * Live migration of a session from shard A to shard B:
+ * 1. Export goes to A, behind every request already sent there; from now
+ *    on the router holds the session's requests back.
+ * 2. A removes the session at its next tick and answers with the Transfer
+ *    (a SimulatorSnapshot taken after those requests).
+ * 3. The router sends Import to B, then replays the held requests, so no
+ *    command is lost or applied to the old state.
+ * B continues from the snapshot at its next tick: the frame times run on
+ * without a gap or a repeat, at worst one tick later than usual.
+ *
+ * exportSession() runs step 1 and 2 but hands the Transfer to the caller
+ * (takeExports()), e.g. to checkpoint the session; importSession() places
+ * one on its ring owner again.
+ *
+ * Requests are written as they are made when the socket accepts them,
+ * otherwise by the next poll(). A session is routed by one router; the
+ * router is used from one thread. Linux only (epoll).
+ */
+class ShardRouter {
+public:
+    /**
+     * @brief A state message from a shard.
+     */
+    struct Frame {
+        std::uint64_t sessionKey;
+        double time;
+        std::string message;   ///< State JSON
+    };
+
+    /**
+     * @param socket_paths One listening socket per shard
+     *
+     * @throws std::invalid_argument if the list is empty
+     * @throws std::runtime_error if a shard cannot be reached
+     */
+    explicit ShardRouter(const std::vector<std::string>& socket_paths);
+    ~ShardRouter();
+
+    ShardRouter(const ShardRouter&) = delete;
+    ShardRouter& operator=(const ShardRouter&) = delete;
+
+    /**
+     * @brief Connect another shard and put it on the ring.
+     *
+     * Existing sessions stay where they are until rebalance().
+     *
+     * @return The new shard's id
+     * @throws std::runtime_error if the shard cannot be reached
+     */
+    int addShard(const std::string& socket_path);
+
+    /// Add a subscriber to a session on its shard
+    void join(std::uint64_t session_key);
+
+    /// Remove a subscriber; ignored for sessions without subscribers
+    void leave(std::uint64_t session_key);
+
+    /// Queue an operator command for a session
+    void submit(std::uint64_t session_key, const OperatorCommand& command);
+
+    /**
+     * @brief Start moving a session to another shard.
+     *
+     * @return false if the session has no subscribers, is already on that
+     *         shard or is already moving
+     * @throws std::invalid_argument if the shard id is unknown or gone
+     */
+    bool migrate(std::uint64_t session_key, int shard);
+
+    /**
+     * @brief Take a shard off the ring and move all its sessions away,
+     *        e.g. before upgrading its process.
+     *
+     * @return Migrations started; the shard is empty once they complete
+     * @throws std::logic_error if it is the last shard on the ring
+     */
+    int drainShard(int shard);
+
+    /**
+     * @brief Start removing a session from its shard for the caller.
+     *
+     * The session's Transfer arrives in takeExports() after a later poll();
+     * requests made for it meanwhile are dropped. A Transfer with no
+     * subscribers means the shard did not have the session.
+     *
+     * @return false if the session has no subscribers or is already moving
+     */
+    bool exportSession(std::uint64_t session_key);
+
+    /// Sessions removed by exportSession() since the last call
+    std::vector<SessionEngine::Transfer> takeExports();
+
+    /**
+     * @brief Continue an exported session on its ring owner.
+     *
+     * The transfer's subscribers become the session's subscribers. Ignored
+     * for sessions the router already routes or without subscribers. The
+     * shard drops the connection over a snapshot its configuration does
+     * not restore, so callers check the snapshot first.
+     */
+    void importSession(const SessionEngine::Transfer& transfer);
+
+    /**
+     * @brief Move every session whose ring owner changed (after addShard()).
+     *
+     * @return Migrations started
+     */
+    int rebalance();
+
+    /**
+     * @brief Read shard messages, complete migrations and flush requests.
+     *
+     * @param timeout_ms How long to wait for a message; 0 returns at once
+     * @return Frames received, in arrival order per shard
+     */
+    std::vector<Frame> poll(int timeout_ms = 0);
+
+    /// Descriptor that becomes readable when a shard has sent something
+    int fd() const { return epoll_; }
+
+    /// Shard a session is on (or would be created on)
+    int shardOf(std::uint64_t session_key) const;
+
+    /// Sessions with subscribers
+    int sessionCount() const { return static_cast<int>(routes_.size()); }
+
+    /// Sessions with subscribers on a shard
+    int sessionsOn(int shard) const;
+
+    int migrationsInFlight() const { return static_cast<int>(migrations_.size()); }
+
+    /// Shards connected now
+    int shardCount() const;
+
+private:
+    struct Route {
+        int shard;
+        int subscribers;
+    };
+
+    /// A request held back while its session moves
+    struct Held {
+        ShardLink::MessageType type;
+        OperatorCommand command;
+    };
+
+    /// Migration target of exportSession()
+    static constexpr int TO_CALLER = -1;
+
+    struct Migration {
+        int target;   ///< Shard id or TO_CALLER
+        std::vector<Held> held;
+    };
+
+    struct Shard {
+        std::unique_ptr<ShardLink> link;   ///< Null once the shard is gone
+        bool writeArmed = false;
+    };
+
+    HashRing ring_;
+    std::vector<Shard> shards_;   ///< By shard id
+    std::unordered_map<std::uint64_t, Route> routes_;
+    std::unordered_map<std::uint64_t, Migration> migrations_;
+    std::vector<SessionEngine::Transfer> exports_;
+    int epoll_;
+
+    void connect(const std::string& socket_path);
+    bool live(int shard) const;
+    void send(int shard, ShardLink::MessageType type, std::uint64_t key,
+              const OperatorCommand* command = nullptr);
+    void handle(int shard, const ShardLink::Header& header, std::string_view payload,
+                std::vector<Frame>& frames);
+    void completeMigration(std::uint64_t key, const SessionEngine::Transfer& transfer);
+    void dropShard(int shard);
+    void flush();
+};
+
+}  // namespace tank_sim
+
+#endif  // TANK_SIM_SHARD_ROUTER_H
@@ -0,0 +1,397 @@
+#include "shared_session_store.h"
+#include "broadcast_ring.h"
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <thread>
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace tank_sim {
+
+namespace {
+
+constexpr std::uint64_t STORE_MAGIC = 0x54414e4b53484d31ULL;  // "TANKSHM1"
+constexpr std::size_t LATEST_CAPACITY = 4;
+constexpr int ATTACH_TIMEOUT_MS = 2000;    ///< Wait for a creator to finish initializing
+constexpr int LATEST_READ_ATTEMPTS = 4;
+
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free &&
+                  std::atomic<std::int32_t>::is_always_lock_free,
+              "Shared-memory atomics must be lock-free to work across processes");
+
+void validateName(const std::string& name) {
+    if (name.size() < 2 || name.size() > 250 || name[0] != '/' ||
+        name.find('/', 1) != std::string::npos) {
+        throw std::invalid_argument("Shared-memory name must look like \"/name\": " + name);
+    }
+}
+
+[[noreturn]] void fail(const std::string& what) {
+    throw std::runtime_error(what + ": " + std::strerror(errno));
+}
+
+}  // namespace
+
+SessionSample SessionSample::fromFrame(const TelemetryFrame& frame) {
+    const bool has_loop = frame.loopCount > 0;
+    return SessionSample{frame.time,
+                         frame.tankLevel,
+                         has_loop ? frame.setpoint[0] : 0.0,
+                         frame.inletFlow,
+                         frame.outletFlow,
+                         frame.valvePosition,
+                         has_loop ? frame.error[0] : 0.0,
+                         has_loop ? frame.controllerOutput[0] : 0.0};
+}
+
+// ============================================================================
+// Segment layout
+// ============================================================================
+
+struct alignas(64) SharedSessionStore::Header {
+    std::uint64_t magic;
+    std::uint32_t version;
+    std::uint32_t slotCount;
+    std::uint32_t historyCapacity;
+    std::uint32_t slotSize;
+    std::atomic<std::uint32_t> ready;   ///< Set last by the creator
+};
+
+struct alignas(64) SharedSessionStore::Slot {
+    std::atomic<std::uint64_t> sessionKey{0};   ///< 0 = free; claimed by CAS
+    std::atomic<std::int32_t> ownerPid{0};
+    std::atomic<std::uint32_t> active{0};       ///< Set once the claim is complete
+    std::atomic<std::uint64_t> generation{0};   ///< Bumped on every claim and release
+    std::atomic<std::uint64_t> framesStart{0};  ///< latest.published() at the claim
+    std::atomic<std::uint64_t> historyStart{0}; ///< First history sample of this session
+    BroadcastRing<TelemetryFrame, LATEST_CAPACITY> latest;
+    BroadcastRing<SessionSample, constants::SESSION_STORE_HISTORY_CAPACITY> history;
+};
+
+namespace {
+
+std::size_t layoutSize(std::size_t slots, std::size_t header, std::size_t slot) {
+    return header + slots * slot;
+}
+
+}  // namespace
+
+// ============================================================================
+// Creation and attachment
+// ============================================================================
+
+SharedSessionStore::SharedSessionStore(const std::string& name, int slots)
+    : name_(name), base_(nullptr), size_(0), header_(nullptr), slots_(nullptr) {
+    // Validate arguments - fail fast
+    validateName(name);
+    if (slots < 1) {
+        throw std::invalid_argument("Session store needs at least one slot");
+    }
+
+    const std::size_t size =
+        layoutSize(static_cast<std::size_t>(slots), sizeof(Header), sizeof(Slot));
+    const int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd < 0) {
+        if (errno != EEXIST) {
+            fail("shm_open " + name);
+        }
+        // Someone else created it: attach and check it is the same layout
+        SharedSessionStore existing(name);
+        if (existing.slotCount() != slots) {
+            throw std::runtime_error("Session store " + name + " exists with " +
+                                     std::to_string(existing.slotCount()) + " slots, not " +
+                                     std::to_string(slots));
+        }
+        std::swap(base_, existing.base_);
+        std::swap(size_, existing.size_);
+        std::swap(header_, existing.header_);
+        std::swap(slots_, existing.slots_);
+        return;
+    }
+
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        const int error = errno;
+        close(fd);
+        shm_unlink(name.c_str());
+        errno = error;
+        fail("ftruncate " + name);
+    }
+    map(fd, size);
+
+    // Construct the slots, then publish the header for attaching processes
+    for (int i = 0; i < slots; ++i) {
+        new (&slots_[i]) Slot();
+    }
+    header_->magic = STORE_MAGIC;
+    header_->version = constants::SESSION_STORE_VERSION;
+    header_->slotCount = static_cast<std::uint32_t>(slots);
+    header_->historyCapacity = constants::SESSION_STORE_HISTORY_CAPACITY;
+    header_->slotSize = sizeof(Slot);
+    header_->ready.store(1, std::memory_order_release);
+}
+
+SharedSessionStore::SharedSessionStore(const std::string& name)
+    : name_(name), base_(nullptr), size_(0), header_(nullptr), slots_(nullptr) {
+    validateName(name);
+    const int fd = shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0) {
+        fail("shm_open " + name);
+    }
+
+    // The creator may still be sizing or initializing the segment
+    const auto deadline =
+        std::chrono::steady_clock::now() + std::chrono::milliseconds(ATTACH_TIMEOUT_MS);
+    struct stat info;
+    while (fstat(fd, &info) == 0 && static_cast<std::size_t>(info.st_size) < sizeof(Header)) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            close(fd);
+            throw std::runtime_error("Session store " + name + " was never initialized");
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    map(fd, static_cast<std::size_t>(info.st_size));
+    while (header_->ready.load(std::memory_order_acquire) == 0) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            munmap(base_, size_);
+            throw std::runtime_error("Session store " + name + " was never initialized");
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    checkLayout();
+}
+
+SharedSessionStore::~SharedSessionStore() {
+    if (base_ != nullptr) {
+        munmap(base_, size_);
+    }
+}
+
+void SharedSessionStore::map(int fd, std::size_t size) {
+    void* base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    const int error = errno;
+    close(fd);  // The mapping keeps the object alive
+    if (base == MAP_FAILED) {
+        errno = error;
+        fail("mmap " + name_);
+    }
+    base_ = base;
+    size_ = size;
+    header_ = static_cast<Header*>(base);
+    slots_ = reinterpret_cast<Slot*>(static_cast<char*>(base) + sizeof(Header));
+}
+
+void SharedSessionStore::checkLayout() const {
+    const bool matches =
+        header_->magic == STORE_MAGIC &&
+        header_->version == static_cast<std::uint32_t>(constants::SESSION_STORE_VERSION) &&
+        header_->historyCapacity ==
+            static_cast<std::uint32_t>(constants::SESSION_STORE_HISTORY_CAPACITY) &&
+        header_->slotSize == sizeof(Slot) &&
+        size_ >= layoutSize(header_->slotCount, sizeof(Header), sizeof(Slot));
+    if (!matches) {
+        munmap(base_, size_);
+        throw std::runtime_error("Session store " + name_ +
+                                 " has a different layout (built by another version?)");
+    }
+}
+
+bool SharedSessionStore::unlink(const std::string& name) {
+    validateName(name);
+    return shm_unlink(name.c_str()) == 0;
+}
+
+int SharedSessionStore::slotCount() const { return static_cast<int>(header_->slotCount); }
+
+// ============================================================================
+// Owner side
+// ============================================================================
+
+int SharedSessionStore::claim(std::uint64_t session_key) {
+    if (session_key == 0) {
+        throw std::invalid_argument("Session key 0 is reserved for free slots");
+    }
+    if (find(session_key) >= 0) {
+        return -1;
+    }
+
+    const int count = slotCount();
+    for (int i = 0; i < count; ++i) {
+        Slot& slot = slots_[i];
+        std::uint64_t expected = 0;
+        if (!slot.sessionKey.compare_exchange_strong(expected, session_key,
+                                                     std::memory_order_seq_cst)) {
+            continue;
+        }
+
+        // Concurrent claims of the same key: the lowest slot wins. Every claim
+        // scans all other slots after its CAS, and seq_cst guarantees that of
+        // two racing claims at least one sees the other. A higher slot backs
+        // off at once; the lowest waits for each higher one to back off or,
+        // having missed this claim, go active, and then backs off itself.
+        bool won = true;
+        for (int j = 0; j < count && won; ++j) {
+            Slot& other = slots_[j];
+            if (j == i || other.sessionKey.load(std::memory_order_seq_cst) != session_key) {
+                continue;
+            }
+            if (j < i) {
+                won = false;
+                break;
+            }
+            while (other.sessionKey.load(std::memory_order_seq_cst) == session_key &&
+                   other.active.load(std::memory_order_acquire) == 0) {
+                std::this_thread::yield();
+            }
+            won = other.sessionKey.load(std::memory_order_seq_cst) != session_key;
+        }
+        if (!won) {
+            slot.sessionKey.store(0, std::memory_order_seq_cst);
+            return -1;
+        }
+
+        slot.ownerPid.store(static_cast<std::int32_t>(getpid()), std::memory_order_relaxed);
+        slot.framesStart.store(slot.latest.published(), std::memory_order_relaxed);
+        slot.historyStart.store(slot.history.published(), std::memory_order_relaxed);
+        slot.generation.fetch_add(1, std::memory_order_acq_rel);
+        slot.active.store(1, std::memory_order_release);
+        return i;
+    }
+    return -1;
+}
+
+void SharedSessionStore::publish(int slot, const TelemetryFrame& frame) {
+    Slot& s = slots_[slot];
+    s.latest.publish(frame);
+    s.history.publish(SessionSample::fromFrame(frame));
+}
+
+void SharedSessionStore::restartHistory(int slot) {
+    Slot& s = slots_[slot];
+    s.historyStart.store(s.history.published(), std::memory_order_release);
+}
+
+void SharedSessionStore::release(int slot) { free(slots_[slot]); }
+
+void SharedSessionStore::free(Slot& slot) {
+    slot.active.store(0, std::memory_order_release);
+    slot.generation.fetch_add(1, std::memory_order_acq_rel);
+    slot.ownerPid.store(0, std::memory_order_relaxed);
+    slot.sessionKey.store(0, std::memory_order_release);
+}
+
+int SharedSessionStore::reclaimDead() {
+    const std::int32_t self = static_cast<std::int32_t>(getpid());
+    int freed = 0;
+    for (int i = 0; i < slotCount(); ++i) {
+        Slot& slot = slots_[i];
+        std::int32_t pid = slot.ownerPid.load(std::memory_order_acquire);
+        if (pid <= 0 || pid == self || kill(pid, 0) == 0 || errno != ESRCH) {
+            continue;
+        }
+        // Only one reclaimer frees the slot
+        if (slot.ownerPid.compare_exchange_strong(pid, 0, std::memory_order_acq_rel)) {
+            free(slot);
+            ++freed;
+        }
+    }
+    return freed;
+}
+
+// ============================================================================
+// Reader side
+// ============================================================================
+
+int SharedSessionStore::find(std::uint64_t session_key) const {
+    for (int i = 0; i < slotCount(); ++i) {
+        const Slot& slot = slots_[i];
+        if (slot.active.load(std::memory_order_acquire) == 1 &&
+            slot.sessionKey.load(std::memory_order_acquire) == session_key) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+std::vector<SharedSessionStore::SessionInfo> SharedSessionStore::sessions() const {
+    std::vector<SessionInfo> result;
+    for (int i = 0; i < slotCount(); ++i) {
+        const Slot& slot = slots_[i];
+        const std::uint64_t generation = slot.generation.load(std::memory_order_acquire);
+        if (slot.active.load(std::memory_order_acquire) != 1) {
+            continue;
+        }
+        SessionInfo info{slot.sessionKey.load(std::memory_order_acquire), i,
+                         slot.ownerPid.load(std::memory_order_acquire),
+                         slot.latest.published() -
+                             slot.framesStart.load(std::memory_order_acquire)};
+        if (slot.generation.load(std::memory_order_acquire) == generation) {
+            result.push_back(info);
+        }
+    }
+    return result;
+}
+
+bool SharedSessionStore::latest(std::uint64_t session_key, TelemetryFrame& frame) const {
+    const int index = find(session_key);
+    if (index < 0) {
+        return false;
+    }
+    const Slot& slot = slots_[index];
+    const std::uint64_t generation = slot.generation.load(std::memory_order_acquire);
+    const std::uint64_t start = slot.framesStart.load(std::memory_order_acquire);
+
+    for (int attempt = 0; attempt < LATEST_READ_ATTEMPTS; ++attempt) {
+        const std::uint64_t head = slot.latest.published();
+        if (head <= start) {
+            return false;
+        }
+        decltype(slot.latest)::Cursor cursor;
+        cursor.next = head - 1;
+        if (slot.latest.read(cursor, frame) == decltype(slot.latest)::ReadStatus::Ok) {
+            return slot.generation.load(std::memory_order_acquire) == generation;
+        }
+    }
+    return false;
+}
+
+std::vector<SessionSample> SharedSessionStore::history(std::uint64_t session_key,
+                                                       double since) const {
+    std::vector<SessionSample> samples;
+    const int index = find(session_key);
+    if (index < 0) {
+        return samples;
+    }
+    const Slot& slot = slots_[index];
+    const std::uint64_t generation = slot.generation.load(std::memory_order_acquire);
+    const std::uint64_t start = slot.historyStart.load(std::memory_order_acquire);
+
+    using Ring = decltype(slot.history);
+    Ring::Cursor cursor;
+    cursor.next = start;
+    SessionSample sample;
+    for (;;) {
+        const auto status = slot.history.read(cursor, sample);
+        if (status == Ring::ReadStatus::Empty) {
+            break;
+        }
+        if (status == Ring::ReadStatus::Ok && cursor.next > start && sample.time > since) {
+            samples.push_back(sample);
+        }
+    }
+
+    // The slot was released or reused while we read it
+    if (slot.generation.load(std::memory_order_acquire) != generation) {
+        samples.clear();
+    }
+    return samples;
+}
+
+}  // namespace tank_sim
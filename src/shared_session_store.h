@@ -0,0 +1,178 @@
+#ifndef TANK_SIM_SHARED_SESSION_STORE_H
+#define TANK_SIM_SHARED_SESSION_STORE_H
+
+#include "constants.h"
+#include "telemetry.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace tank_sim {
+
+/**
+ * @brief One history point of a session: the fields of the API's state message.
+ */
+struct SessionSample {
+    double time;
+    double tankLevel;
+    double setpoint;
+    double inletFlow;
+    double outletFlow;
+    double valvePosition;
+    double error;
+    double controllerOutput;
+
+    /// Sample of a frame (loop 0, or zeros without loops)
+    static SessionSample fromFrame(const TelemetryFrame& frame);
+};
+
+/**
+ * @brief Session telemetry in a POSIX shared-memory segment.
+ *
+ * Lets several processes share sessions: the process that steps a session
+ * (the owner) publishes its frames into a slot, and any process attached
+ * to the same segment can list the sessions and read their latest frame
+ * and history, e.g. API workers behind a load balancer serving sessions
+ * stepped by one engine process.
+ *
+ * The segment is a header followed by a fixed number of slots. Each slot
+ * holds a small BroadcastRing with the latest full TelemetryFrames and a
+ * BroadcastRing of SessionSamples (the history). Both are lock-free and
+ * contain no pointers, so they work across processes: the owner is the
+ * single producer and readers never block it.
+ *
+ * Ownership:
+ * - claim() takes a free slot by compare-and-swap on its session key and
+ *   records the owner's pid. If processes claim the same key at once, the
+ *   claim in the lowest slot wins and the others return -1.
+ * - release() frees the slot; readers that were reading it notice through
+ *   the slot generation and discard what they read.
+ * - reclaimDead() frees slots whose owner process no longer exists, so a
+ *   crashed engine does not leak slots.
+ *
+ * The first process to construct a store with a name creates and
+ * initializes the segment; later ones attach to it after checking that
+ * the layout matches. The segment outlives the processes until unlink().
+ */
+class SharedSessionStore {
+public:
+    /**
+     * @brief A session currently exported by some process.
+     */
+    struct SessionInfo {
+        std::uint64_t sessionKey;
+        int slot;
+        int ownerPid;
+        std::uint64_t frames;   ///< Frames published since the slot was claimed
+    };
+
+    /**
+     * @brief Create the segment, or attach to an existing one.
+     *
+     * @param name Shared-memory object name ("/name")
+     * @param slots Number of sessions the segment can hold
+     *
+     * @throws std::invalid_argument if the name is not "/name" or slots < 1
+     * @throws std::runtime_error if the segment cannot be created or mapped,
+     *         or exists with a different layout
+     */
+    SharedSessionStore(const std::string& name, int slots);
+
+    /**
+     * @brief Attach to an existing segment with any slot count.
+     *
+     * @throws std::invalid_argument if the name is not "/name"
+     * @throws std::runtime_error if there is no such segment or its layout
+     *         does not match this build
+     */
+    explicit SharedSessionStore(const std::string& name);
+
+    /// Unmaps the segment; it stays in place for other processes
+    ~SharedSessionStore();
+
+    SharedSessionStore(const SharedSessionStore&) = delete;
+    SharedSessionStore& operator=(const SharedSessionStore&) = delete;
+
+    /**
+     * @brief Remove the segment name; mapped processes keep their mapping.
+     *
+     * @return false if there was no segment with this name
+     */
+    static bool unlink(const std::string& name);
+
+    const std::string& name() const { return name_; }
+    int slotCount() const;
+
+    // ------------------------------------------------------------------------
+    // Owner side: one process, one thread per slot
+    // ------------------------------------------------------------------------
+
+    /**
+     * @brief Claim a slot for a session.
+     *
+     * @return Slot index, or -1 if the store is full or the session is
+     *         already exported (by this or another process)
+     */
+    int claim(std::uint64_t session_key);
+
+    /// Publish the session's frame after a step
+    void publish(int slot, const TelemetryFrame& frame);
+
+    /// Drop the history published so far (e.g. after a reset)
+    void restartHistory(int slot);
+
+    /// Free a slot claimed by this process
+    void release(int slot);
+
+    /**
+     * @brief Free the slots of owner processes that have exited.
+     *
+     * @return Slots freed
+     */
+    int reclaimDead();
+
+    // ------------------------------------------------------------------------
+    // Reader side: any process, any thread
+    // ------------------------------------------------------------------------
+
+    /// Slot exporting a session, or -1
+    int find(std::uint64_t session_key) const;
+
+    /// Sessions currently exported, in slot order
+    std::vector<SessionInfo> sessions() const;
+
+    /**
+     * @brief Copy the newest frame of a session.
+     *
+     * @return false if the session is not exported or has no frame yet
+     */
+    bool latest(std::uint64_t session_key, TelemetryFrame& frame) const;
+
+    /**
+     * @brief History samples of a session after a simulation time.
+     *
+     * @param session_key Session to read
+     * @param since Only samples with time > since
+     * @return Samples oldest first; empty if the session is not exported
+     */
+    std::vector<SessionSample> history(std::uint64_t session_key, double since) const;
+
+private:
+    struct Header;
+    struct Slot;
+
+    std::string name_;
+    void* base_;
+    std::size_t size_;
+    Header* header_;
+    Slot* slots_;
+
+    void map(int fd, std::size_t size);
+    void checkLayout() const;
+    void free(Slot& slot);
+};
+
+}  // namespace tank_sim
+
+#endif  // TANK_SIM_SHARED_SESSION_STORE_H
@@ -1,5 +1,8 @@
 #include "simulator.h"
 #include "constants.h"
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
 
 namespace tank_sim {
 
@@ -8,7 +11,7 @@ Simulator::Simulator(const Config &config)
       stepper(config.initialState.size(), config.initialInputs.size()),
       time(0.0), state(config.initialState), inputs(config.initialInputs),
       initialState(config.initialState), initialInputs(config.initialInputs),
-      dt(config.dt), setpoints(), controllers(),
+      dt(config.dt), controllers(),
       controllerConfig(
           config.controllerConfig) { // Validation 1: Check state and input
                                      // dimensions match TankModel expectations
@@ -35,20 +38,57 @@ Simulator::Simulator(const Config &config)
         " and " + std::to_string(constants::MAX_DT) + " seconds");
   }
 
-  // Validation 3: Check controller indices are in bounds
+  // Validation 3: Sensor noise must be non-negative
+  if (config.sensorNoiseStdDev < 0.0) {
+    throw std::invalid_argument("Sensor noise standard deviation cannot be negative");
+  }
+  sensorNoiseStdDev = config.sensorNoiseStdDev;
+  sensorNoiseSeed = config.sensorNoiseSeed;
+  sensorRng.seed(sensorNoiseSeed);
+  sensorNoise = std::normal_distribution<double>(0.0, 1.0);
+  measuredState = state;
+  estimatedState = state;
+  if (config.useEstimator) {
+    estimator.emplace(config.estimator, TankModel::StateVector(state));
+  }
+  if (config.identifyModel) {
+    // Seed with the initial level; the first step then yields a sample
+    identifier.emplace(config.identifier, config.params);
+    identifier->update(state(0), inputs(constants::INPUT_INDEX_INLET_FLOW),
+                       inputs(constants::INPUT_INDEX_VALVE_POSITION), dt);
+  }
+
+  // Validation 4: Check controller indices are in bounds
   for (size_t i = 0; i < config.controllerConfig.size(); ++i) {
     const auto &ctrl = config.controllerConfig[i];
 
-    if (ctrl.measuredIndex < 0 ||
-        static_cast<size_t>(ctrl.measuredIndex) >= state.size()) {
+    if (ctrl.measuredSource == SignalRef::Source::Input) {
+      if (ctrl.measuredIndex < 0 ||
+          static_cast<size_t>(ctrl.measuredIndex) >= inputs.size()) {
+        throw std::invalid_argument(
+            "Controller " + std::to_string(i) + " measured_index " +
+            std::to_string(ctrl.measuredIndex) + " is out of bounds for input " +
+            "vector of size " + std::to_string(inputs.size()));
+      }
+    } else if (ctrl.measuredIndex < 0 ||
+               static_cast<size_t>(ctrl.measuredIndex) >= state.size()) {
       throw std::invalid_argument(
           "Controller " + std::to_string(i) + " measured_index " +
           std::to_string(ctrl.measuredIndex) + " is out of bounds for state " +
           "vector of size " + std::to_string(state.size()));
     }
 
-    if (ctrl.outputIndex < 0 ||
-        static_cast<size_t>(ctrl.outputIndex) >= inputs.size()) {
+    if (ctrl.type == ControllerType::MPC &&
+        (ctrl.measuredSource != SignalRef::Source::State || ctrl.outputIndex < 0)) {
+      throw std::invalid_argument(
+          "Controller " + std::to_string(i) +
+          ": MPC must measure a state and write an input");
+    }
+
+    // output_index -1 marks an internal loop whose output only feeds links
+    if (ctrl.outputIndex < -1 ||
+        (ctrl.outputIndex >= 0 &&
+         static_cast<size_t>(ctrl.outputIndex) >= inputs.size())) {
       throw std::invalid_argument(
           "Controller " + std::to_string(i) + " output_index " +
           std::to_string(ctrl.outputIndex) + " is out of bounds for input " +
@@ -56,24 +96,161 @@ Simulator::Simulator(const Config &config)
     }
   }
 
-  // Validation 4: Create controllers
+  // Validation 5: Compile the control network (checks links, rejects cycles)
+  // Masters are ordered before the loops they drive, once, here.
+  std::vector<SignalRef> measurements;
+  measurements.reserve(config.controllerConfig.size());
   for (const auto &ctrl_config : config.controllerConfig) {
-    controllers.emplace_back(
-        ctrl_config.gains, ctrl_config.bias, ctrl_config.minOutputLimit,
-        ctrl_config.maxOutputLimit, ctrl_config.maxIntegralAccumulation);
+    measurements.push_back({ctrl_config.measuredSource, ctrl_config.measuredIndex});
   }
+  schedule = ControlSchedule::compile(measurements, config.controlLinks,
+                                      static_cast<int>(state.size()),
+                                      static_cast<int>(inputs.size()));
 
-  // Validation 5: Initialize setpoints from config
-  setpoints.resize(controllers.size());
-  for (size_t i = 0; i < controllers.size(); ++i) {
-    setpoints[i] = controllerConfig[i].initialSetpoint;
+  // Validation 6: Create controllers in the PID bank, in schedule order
+  // Each loop's gather (measured_index) and scatter (output_index) slot is
+  // fixed here, so step() never re-reads controllerConfig. Loops measuring an
+  // input are fed by the schedule instead of the state gather. Setpoints
+  // start at their configured values; integral states and previous errors
+  // start at zero (at steady state, error should be zero).
+  controllers.reserve(static_cast<int>(config.controllerConfig.size()));
+  for (int index : schedule.loopOrder()) {
+    const auto &ctrl_config = config.controllerConfig[index];
+    int gather_index = ctrl_config.measuredSource == SignalRef::Source::State
+                           ? ctrl_config.measuredIndex
+                           : -1;
+    bool is_mpc = ctrl_config.type == ControllerType::MPC;
+    int slot = controllers.addLoop(
+        is_mpc ? PIDController::Gains{0.0, 0.0, 0.0} : ctrl_config.gains,
+        ctrl_config.bias, ctrl_config.minOutputLimit, ctrl_config.maxOutputLimit,
+        ctrl_config.maxIntegralAccumulation, gather_index,
+        ctrl_config.outputIndex, ctrl_config.initialSetpoint);
+    if (is_mpc) {
+      predictiveLoops.push_back(
+          {MPCController(ctrl_config.mpc, ctrl_config.measuredIndex,
+                         ctrl_config.outputIndex, ctrl_config.minOutputLimit,
+                         ctrl_config.maxOutputLimit),
+           index, slot});
+    }
   }
-  
-  // Initialize previous errors to zero (at steady state, error should be zero)
-  previousErrors.resize(controllers.size(), 0.0);
+
+  // An MPC loop plans against its operator setpoint with no feedforward
+  // term; links may read its output but must not drive it.
+  for (const auto &link : config.controlLinks) {
+    if (config.controllerConfig[link.target].type == ControllerType::MPC) {
+      throw std::invalid_argument("Control link target " +
+                                  std::to_string(link.target) +
+                                  " is an MPC controller");
+    }
+  }
+
+  // KPI intervals start at the configured setpoints
+  performance.reserve(config.controllerConfig.size());
+  for (size_t i = 0; i < config.controllerConfig.size(); ++i) {
+    performance.emplace_back(config.performance);
+    restartPerformance(static_cast<int>(i));
+  }
+  if (config.monitorLoopHealth) {
+    health.assign(config.controllerConfig.size(), LoopHealth(config.loopHealth));
+  }
+
+  // Validation 7: Gain schedules (tables are validated by GainSchedule)
+  std::vector<bool> scheduled(config.controllerConfig.size(), false);
+  for (const auto &gs : config.gainSchedules) {
+    if (gs.controller < 0 ||
+        static_cast<size_t>(gs.controller) >= config.controllerConfig.size()) {
+      throw std::invalid_argument("Gain schedule controller " +
+                                  std::to_string(gs.controller) +
+                                  " is out of bounds for " +
+                                  std::to_string(config.controllerConfig.size()) +
+                                  " controller(s)");
+    }
+    if (scheduled[gs.controller]) {
+      throw std::invalid_argument("Controller " + std::to_string(gs.controller) +
+                                  " has more than one gain schedule");
+    }
+    scheduled[gs.controller] = true;
+    if (config.controllerConfig[gs.controller].type == ControllerType::MPC) {
+      throw std::invalid_argument("Controller " + std::to_string(gs.controller) +
+                                  " is an MPC controller and cannot be gain scheduled");
+    }
+
+    const Eigen::Index limit =
+        gs.variable.source == SignalRef::Source::State   ? state.size()
+        : gs.variable.source == SignalRef::Source::Input ? inputs.size()
+                                                         : -1;
+    if (limit < 0) {
+      throw std::invalid_argument(
+          "Gain schedule variable must be a state or input signal");
+    }
+    if (gs.variable.index < 0 || gs.variable.index >= limit) {
+      throw std::invalid_argument("Gain schedule variable index " +
+                                  std::to_string(gs.variable.index) +
+                                  " is out of bounds (size " +
+                                  std::to_string(limit) + ")");
+    }
+    scheduledLoops.push_back(
+        {GainSchedule(gs.table), gs.variable, schedule.slotOf()[gs.controller]});
+  }
+
+  // Validation 8: Alarm signals (limits are validated by AlarmEvaluator)
+  alarms.emplace(config.alarms);
+  for (size_t i = 0; i < config.alarms.size(); ++i) {
+    SignalRef signal = config.alarms[i].signal;
+    const Eigen::Index limit =
+        signal.source == SignalRef::Source::State   ? state.size()
+        : signal.source == SignalRef::Source::Input ? inputs.size()
+                                                    : static_cast<Eigen::Index>(controllerConfig.size());
+    if (signal.index < 0 || signal.index >= limit) {
+      throw std::invalid_argument("Alarm " + std::to_string(i) + " signal index " +
+                                  std::to_string(signal.index) +
+                                  " is out of bounds (size " + std::to_string(limit) + ")");
+    }
+    if (signal.source == SignalRef::Source::ControllerOutput) {
+      signal.index = schedule.slotOf()[signal.index];
+    }
+    alarmSignals.push_back(signal);
+  }
+  alarmValues.resize(alarmSignals.size());
+  gatherAlarmValues();
+  alarms->reset(alarmValues, time);
+
+  // Cross-thread outputs only for the callers that read them
+  if (config.reportCommandResults) {
+    commandResults = std::make_unique<
+        SpscRing<AppliedCommand, constants::COMMAND_QUEUE_CAPACITY>>();
+  }
+  if (config.streamTelemetry) {
+    telemetryStream = std::make_unique<TelemetryRing>();
+  }
+
+  stepCount = 0;
+  publishTelemetry(true);
 }
 
 void Simulator::step() {
+  // Step 0: Apply operator commands queued since the last step
+  applyPendingCommands();
+  advance();
+
+  // Step 9: Publish the frame for concurrent readers
+  publishTelemetry(true);
+}
+
+void Simulator::stepMany(int steps) {
+  // Validate the step count - fail fast
+  if (steps < 1) {
+    throw std::invalid_argument("stepMany requires at least one step");
+  }
+  // Commands apply once, before the batch; readers see only its last state
+  applyPendingCommands();
+  for (int i = 0; i < steps; ++i) {
+    advance();
+  }
+  publishTelemetry(true);
+}
+
+void Simulator::advance() {
   // Step 1: Integrate the model forward
   // Create a lambda that wraps TankModel's derivatives method to match
   // Stepper's DerivativeFunc signature: (double t, VectorXd state, VectorXd input) -> VectorXd
@@ -94,31 +271,70 @@ void Simulator::step() {
   // Step 2: Advance simulation time
   time += dt;
 
-  // Step 3: Update all controllers for NEXT step
-  // For each controller, read measured value, calculate error, and compute output
-  for (size_t i = 0; i < controllers.size(); ++i) {
-    // Read the measured variable from current state using measured_index
-    int measured_index = controllerConfig[i].measuredIndex;
-    double measured_value = state(measured_index);
+  // Step 3: Read the level sensor and, if configured, filter the reading.
+  // The estimator predicts with the inputs applied over the step just taken.
+  measuredState = state;
+  if (sensorNoiseStdDev > 0.0) {
+    for (Eigen::Index i = 0; i < measuredState.size(); ++i) {
+      measuredState(i) += sensorNoiseStdDev * sensorNoise(sensorRng);
+    }
+  }
+  if (estimator) {
+    estimatedState = estimator->update(model, inputs, measuredState, dt);
+  } else {
+    estimatedState = measuredState;
+  }
+
+  // Identification uses the same level signal, with the inputs that were
+  // applied over the step
+  if (identifier) {
+    identifier->update(estimatedState(0), inputs(constants::INPUT_INDEX_INLET_FLOW),
+                       inputs(constants::INPUT_INDEX_VALVE_POSITION), dt);
+  }
 
-    // Calculate error as setpoint minus measured value
-    double error = setpoints[i] - measured_value;
+  // Step 4: Interpolate scheduled gains at the new operating point
+  // Bumpless: the integral contribution is preserved across the gain change.
+  for (auto &loop : scheduledLoops) {
+    double x = loop.variable.source == SignalRef::Source::State
+                   ? estimatedState(loop.variable.index)
+                   : inputs(loop.variable.index);
+    controllers.setGainsBumpless(loop.slot, loop.table.lookup(x));
+  }
 
-    // Calculate error derivative using backward finite difference
-    // error_dot = (error - previous_error) / dt
-    // This introduces a one-step delay but is standard for discrete-time PID
-    double error_dot = (error - previousErrors[i]) / dt;
+  // Step 5: Solve MPC loops at the new state; the first planned move
+  // becomes the slot bias, so the zero-gain PID law passes it through.
+  for (auto &loop : predictiveLoops) {
+    double u = loop.controller.compute(model, estimatedState, inputs,
+                                       controllers.getSetpoint(loop.slot), dt);
+    controllers.setBias(loop.slot, u);
+  }
 
-    // Call controller's compute method with error, error_dot, and dt
-    double output = controllers[i].compute(error, error_dot, dt);
+  // Step 6: Update all controllers for NEXT step
+  // The bank gathers every measured value from the estimated state, the
+  // schedule applies cascade/ratio/feedforward links and runs the PID law one
+  // dependency level at a time (error = setpoint - measured, backward
+  // difference for error_dot), and outputs are scattered into the inputs.
+  controllers.gather(estimatedState);
+  schedule.execute(controllers, estimatedState, inputs, dt);
+  controllers.scatter(inputs);
 
-    // Write the controller output to the inputs vector at output_index
-    int output_index = controllerConfig[i].outputIndex;
-    inputs(output_index) = output;
-    
-    // Store current error for next derivative calculation
-    previousErrors[i] = error;
+  // Step 7: Accumulate loop KPIs against the level the controllers saw
+  for (int i = 0; i < static_cast<int>(performance.size()); ++i) {
+    int slot = schedule.slotOf()[i];
+    performance[i].update(controllers.getSetpoint(slot), measuredValue(i),
+                          controllers.getOutput(slot), dt);
   }
+  for (int i = 0; i < static_cast<int>(health.size()); ++i) {
+    health[i].update(getError(i), dt);
+  }
+
+  // Step 8: Alarms on the signals as the controllers see them
+  if (!alarmSignals.empty()) {
+    gatherAlarmValues();
+    alarms->evaluate(alarmValues, time, dt);
+  }
+
+  ++stepCount;
 }
 
 double Simulator::getTime() const {
@@ -133,37 +349,46 @@ Eigen::VectorXd Simulator::getInputs() const {
   return inputs;
 }
 
+Eigen::VectorXd Simulator::getMeasuredState() const {
+  return measuredState;
+}
+
+Eigen::VectorXd Simulator::getEstimatedState() const {
+  return estimatedState;
+}
+
 double Simulator::getSetpoint(int index) const {
-  if (index < 0 || static_cast<size_t>(index) >= setpoints.size()) {
+  if (index < 0 || index >= controllers.size()) {
     throw std::out_of_range("Setpoint index " + std::to_string(index) +
-                            " out of bounds for " + std::to_string(setpoints.size()) +
+                            " out of bounds for " + std::to_string(controllers.size()) +
                             " controller(s)");
   }
-  return setpoints[index];
+  return controllers.getSetpoint(schedule.slotOf()[index]);
 }
 
 double Simulator::getControllerOutput(int index) const {
-  if (index < 0 || static_cast<size_t>(index) >= controllers.size()) {
+  if (index < 0 || index >= controllers.size()) {
     throw std::out_of_range("Controller index " + std::to_string(index) +
                             " out of bounds for " + std::to_string(controllers.size()) +
                             " controller(s)");
   }
   // Get the controller's output from the inputs vector
   int output_index = controllerConfig[index].outputIndex;
+  if (output_index < 0) {
+    // Internal loop (cascade master): output is not written to an input
+    return controllers.getOutput(schedule.slotOf()[index]);
+  }
   return inputs(output_index);
 }
 
 double Simulator::getError(int index) const {
-  if (index < 0 || static_cast<size_t>(index) >= controllers.size()) {
+  if (index < 0 || index >= controllers.size()) {
     throw std::out_of_range("Controller index " + std::to_string(index) +
                             " out of bounds for " + std::to_string(controllers.size()) +
                             " controller(s)");
   }
   // Calculate error: setpoint - measured_value
-  int measured_index = controllerConfig[index].measuredIndex;
-  double measured_value = state(measured_index);
-  double setpoint = setpoints[index];
-  return setpoint - measured_value;
+  return controllers.getSetpoint(schedule.slotOf()[index]) - measuredValue(index);
 }
 
 void Simulator::setInput(int index, double value) {
@@ -173,25 +398,47 @@ void Simulator::setInput(int index, double value) {
                             std::to_string(inputs.size()));
   }
   inputs(index) = value;
+  publishTelemetry();
 }
 
 void Simulator::setSetpoint(int index, double value) {
-  if (index < 0 || static_cast<size_t>(index) >= setpoints.size()) {
+  if (index < 0 || index >= controllers.size()) {
     throw std::out_of_range("Setpoint index " + std::to_string(index) +
-                            " out of bounds for " + std::to_string(setpoints.size()) +
+                            " out of bounds for " + std::to_string(controllers.size()) +
                             " controller(s)");
   }
-  setpoints[index] = value;
+  const int slot = schedule.slotOf()[index];
+  // Only a setpoint change starts a new step response; re-sending the same
+  // value keeps the KPIs gathered so far
+  const bool changed = controllers.getSetpoint(slot) != value;
+  controllers.setSetpoint(slot, value);
+  if (changed) {
+    restartPerformance(index);
+  }
+  publishTelemetry();
 }
 
 void Simulator::setControllerGains(
     int index, const tank_sim::PIDController::Gains &gains) {
-  if (index < 0 || static_cast<size_t>(index) >= controllers.size()) {
+  if (index < 0 || index >= controllers.size()) {
     throw std::out_of_range("Controller index " + std::to_string(index) +
                             " out of bounds for " + std::to_string(controllers.size()) +
                             " controller(s)");
   }
-  controllers[index].setGains(gains);
+  if (findPredictiveLoop(index) != nullptr) {
+    throw std::invalid_argument("Controller " + std::to_string(index) +
+                                " is an MPC controller and has no PID gains");
+  }
+  // The schedule re-interpolates gains every step, so a manual change would
+  // silently vanish; reject it instead
+  const int slot = schedule.slotOf()[index];
+  for (const auto &loop : scheduledLoops) {
+    if (loop.slot == slot) {
+      throw std::invalid_argument("Controller " + std::to_string(index) +
+                                  " is gain-scheduled; edit its schedule instead");
+    }
+  }
+  controllers.setGains(slot, gains);
 }
 
 void Simulator::reset() {
@@ -200,22 +447,356 @@ void Simulator::reset() {
   state = initialState;
   inputs = initialInputs;
   
-  // Reset all controller integral states
-  for (auto& controller : controllers) {
-    controller.reset();
+  // Sensor noise replays from its seed; the estimator restarts at the
+  // initial state
+  sensorRng.seed(sensorNoiseSeed);
+  sensorNoise.reset();
+  measuredState = initialState;
+  estimatedState = initialState;
+  if (estimator) {
+    estimator->reset(TankModel::StateVector(initialState));
   }
+  if (identifier) {
+    identifier->reset();
+    identifier->update(initialState(0),
+                       initialInputs(constants::INPUT_INDEX_INLET_FLOW),
+                       initialInputs(constants::INPUT_INDEX_VALVE_POSITION), dt);
+  }
+
+  // Reset all controller integral states and previous errors (steady state)
+  controllers.reset();
   
   // Reset setpoints to initial values
-  for (size_t i = 0; i < controllers.size(); ++i) {
-    setpoints[i] = controllerConfig[i].initialSetpoint;
+  for (int i = 0; i < controllers.size(); ++i) {
+    controllers.setSetpoint(schedule.slotOf()[i], controllerConfig[i].initialSetpoint);
   }
-  
-  // Reset previous errors to zero (at steady state)
-  std::fill(previousErrors.begin(), previousErrors.end(), 0.0);
+
+  // MPC loops restart cold from their configured bias
+  for (auto &loop : predictiveLoops) {
+    loop.controller.reset();
+    controllers.setBias(loop.slot, controllerConfig[loop.index].bias);
+  }
+
+  for (int i = 0; i < static_cast<int>(performance.size()); ++i) {
+    restartPerformance(i);
+  }
+  for (auto &monitor : health) {
+    monitor.reset();
+  }
+
+  gatherAlarmValues();
+  alarms->reset(alarmValues, time);
+
+  stepCount = 0;
+  publishTelemetry(true);
+}
+
+SimulatorSnapshot Simulator::captureState() const {
+  if (controllers.size() > SimulatorSnapshot::MAX_LOOPS) {
+    throw std::invalid_argument("Cannot snapshot more than " +
+                                std::to_string(SimulatorSnapshot::MAX_LOOPS) +
+                                " controllers");
+  }
+  if (alarms->size() > SimulatorSnapshot::MAX_ALARMS) {
+    throw std::invalid_argument("Cannot snapshot more than " +
+                                std::to_string(SimulatorSnapshot::MAX_ALARMS) + " alarms");
+  }
+
+  SimulatorSnapshot snapshot{};
+  snapshot.version = SimulatorSnapshot::VERSION;
+  snapshot.loopCount = controllers.size();
+  snapshot.step = stepCount;
+  snapshot.time = time;
+  for (int i = 0; i < constants::TANK_STATE_SIZE; ++i) {
+    snapshot.state[i] = state(i);
+    snapshot.measuredState[i] = measuredState(i);
+    snapshot.estimatedState[i] = estimatedState(i);
+  }
+  for (int i = 0; i < constants::TANK_INPUT_SIZE; ++i) {
+    snapshot.inputs[i] = inputs(i);
+  }
+  for (int slot = 0; slot < controllers.size(); ++slot) {
+    snapshot.loops[slot] = SimulatorSnapshot::Loop{
+        controllers.getSetpoint(slot),       controllers.getMeasured(slot),
+        controllers.getOutput(slot),         controllers.getIntegralState(slot),
+        controllers.getPreviousError(slot),  controllers.getBias(slot),
+        controllers.getFeedforward(slot),    controllers.getGains(slot)};
+  }
+  if (identifier) {
+    snapshot.identifier = identifier->state();
+  }
+  for (int i = 0; i < alarms->size(); ++i) {
+    if (alarms->isActive(i)) {
+      snapshot.activeAlarms |= std::uint64_t{1} << i;
+    }
+  }
+  return snapshot;
+}
+
+void Simulator::restoreState(const SimulatorSnapshot &snapshot) {
+  if (snapshot.version != SimulatorSnapshot::VERSION) {
+    throw std::invalid_argument("Unsupported snapshot version " +
+                                std::to_string(snapshot.version));
+  }
+  if (snapshot.loopCount != controllers.size()) {
+    throw std::invalid_argument("Snapshot has " + std::to_string(snapshot.loopCount) +
+                                " controllers, simulator has " +
+                                std::to_string(controllers.size()));
+  }
+
+  time = snapshot.time;
+  stepCount = snapshot.step;
+  for (int i = 0; i < constants::TANK_STATE_SIZE; ++i) {
+    state(i) = snapshot.state[i];
+    measuredState(i) = snapshot.measuredState[i];
+    estimatedState(i) = snapshot.estimatedState[i];
+  }
+  for (int i = 0; i < constants::TANK_INPUT_SIZE; ++i) {
+    inputs(i) = snapshot.inputs[i];
+  }
+  for (int slot = 0; slot < controllers.size(); ++slot) {
+    const auto &loop = snapshot.loops[slot];
+    controllers.setGains(slot, loop.gains);
+    controllers.setSetpoint(slot, loop.setpoint);
+    controllers.setMeasured(slot, loop.measured);
+    controllers.setBias(slot, loop.bias);
+    controllers.setFeedforward(slot, loop.feedforward);
+    controllers.setLoopState(slot, loop.integral, loop.previousError, loop.output);
+  }
+
+  // The identifier continues its estimate; other auxiliary state restarts
+  // from the restored state, as after reset()
+  if (identifier) {
+    identifier->restore(snapshot.identifier);
+  }
+  if (estimator) {
+    estimator->reset(TankModel::StateVector(estimatedState));
+  }
+  for (auto &loop : predictiveLoops) {
+    loop.controller.reset();
+  }
+  for (int i = 0; i < static_cast<int>(performance.size()); ++i) {
+    restartPerformance(i);
+  }
+  for (auto &monitor : health) {
+    monitor.reset();
+  }
+  // Alarms resume as captured: no clear or raise events for the restore
+  gatherAlarmValues();
+  alarms->restore(alarmValues, snapshot.activeAlarms);
+
+  publishTelemetry(true);
+}
+
+double Simulator::measuredValue(int index) const {
+  const auto &ctrl = controllerConfig[index];
+  return ctrl.measuredSource == SignalRef::Source::Input ? inputs(ctrl.measuredIndex)
+                                                         : estimatedState(ctrl.measuredIndex);
 }
 
 int Simulator::getControllerCount() const {
-  return static_cast<int>(controllers.size());
+  return controllers.size();
+}
+
+const MPCController::SolveStats &Simulator::getMPCStats(int index) const {
+  if (index < 0 || index >= controllers.size()) {
+    throw std::out_of_range("Controller index " + std::to_string(index) +
+                            " out of bounds for " + std::to_string(controllers.size()) +
+                            " controller(s)");
+  }
+  const PredictiveLoop *loop = findPredictiveLoop(index);
+  if (loop == nullptr) {
+    throw std::invalid_argument("Controller " + std::to_string(index) +
+                                " is not an MPC controller");
+  }
+  return loop->controller.stats();
+}
+
+TankIdentifier::Estimate Simulator::getIdentifiedModel() const {
+  if (!identifier) {
+    throw std::invalid_argument("Model identification is not enabled");
+  }
+  return identifier->estimate();
+}
+
+std::vector<LoopPerformance::Snapshot> Simulator::getPerformance() const {
+  std::vector<LoopPerformance::Snapshot> snapshots;
+  snapshots.reserve(performance.size());
+  for (const auto &kpi : performance) {
+    snapshots.push_back(kpi.snapshot());
+  }
+  return snapshots;
+}
+
+std::vector<LoopHealth::Status> Simulator::getLoopHealth() const {
+  if (health.empty() && !controllerConfig.empty()) {
+    throw std::invalid_argument("Loop health monitoring is not enabled");
+  }
+  std::vector<LoopHealth::Status> statuses;
+  statuses.reserve(health.size());
+  for (const auto &monitor : health) {
+    statuses.push_back(monitor.status());
+  }
+  return statuses;
+}
+
+std::vector<AlarmEvent> Simulator::drainAlarmEvents() {
+  std::vector<AlarmEvent> events;
+  alarms->drainEvents(events);
+  return events;
+}
+
+std::vector<int> Simulator::getActiveAlarms() const {
+  std::vector<int> active;
+  for (int i = 0; i < alarms->size(); ++i) {
+    if (alarms->isActive(i)) {
+      active.push_back(i);
+    }
+  }
+  return active;
+}
+
+void Simulator::gatherAlarmValues() {
+  for (size_t i = 0; i < alarmSignals.size(); ++i) {
+    const SignalRef &signal = alarmSignals[i];
+    alarmValues[i] = signal.source == SignalRef::Source::State   ? estimatedState(signal.index)
+                     : signal.source == SignalRef::Source::Input ? inputs(signal.index)
+                                                                 : controllers.getOutput(signal.index);
+  }
+}
+
+namespace {
+
+std::int64_t steadyNanos() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+} // namespace
+
+bool Simulator::submitCommand(OperatorCommand command) {
+  command.enqueuedNanos = steadyNanos();
+  return commandQueue.tryPush(command);
+}
+
+bool Simulator::pollAppliedCommand(AppliedCommand &result) {
+  return commandResults && commandResults->tryPop(result);
+}
+
+int Simulator::applyPendingCommands() {
+  int count = 0;
+  OperatorCommand command;
+  while (commandQueue.tryPop(command)) {
+    applyCommand(command);
+    ++count;
+  }
+  return count;
+}
+
+const Simulator::CommandStats &Simulator::getCommandStats() const {
+  return commandStats;
+}
+
+void Simulator::applyCommand(const OperatorCommand &command) {
+  // Operator methods validate their arguments; a rejection is reported
+  // back to the producer instead of unwinding the stepping thread.
+  bool accepted = true;
+  try {
+    switch (command.type) {
+    case OperatorCommand::Type::SetSetpoint:
+      setSetpoint(command.index, command.value);
+      break;
+    case OperatorCommand::Type::SetInput:
+      setInput(command.index, command.value);
+      break;
+    case OperatorCommand::Type::SetGains:
+      setControllerGains(command.index, command.gains);
+      break;
+    case OperatorCommand::Type::Reset:
+      reset();
+      break;
+    case OperatorCommand::Type::SetSpeed:
+      throw std::invalid_argument("Speed is set on the session engine");
+    }
+  } catch (const std::exception &) {
+    accepted = false;
+  }
+
+  const double latency = (steadyNanos() - command.enqueuedNanos) * 1e-3;
+  ++commandStats.applied;
+  if (!accepted) {
+    ++commandStats.rejected;
+  }
+  commandStats.lastLatencyMicros = latency;
+  commandStats.meanLatencyMicros +=
+      (latency - commandStats.meanLatencyMicros) / commandStats.applied;
+  commandStats.maxLatencyMicros = std::max(commandStats.maxLatencyMicros, latency);
+
+  AppliedCommand result{command.id, command.type, command.index, accepted, time, latency};
+  if (commandResults && !commandResults->tryPush(result)) {
+    ++commandStats.resultsDropped;
+  }
+}
+
+TelemetryFrame Simulator::getTelemetry() const { return telemetry.read(); }
+
+Simulator::TelemetryRing::Cursor Simulator::subscribeTelemetry(bool from_oldest) const {
+  if (!telemetryStream) {
+    throw std::invalid_argument("Telemetry streaming is disabled in this simulator's config");
+  }
+  return from_oldest ? telemetryStream->subscribeOldest() : telemetryStream->subscribe();
+}
+
+Simulator::TelemetryRing::ReadStatus
+Simulator::readTelemetry(TelemetryRing::Cursor &cursor, TelemetryFrame &frame) const {
+  return telemetryStream ? telemetryStream->read(cursor, frame)
+                         : TelemetryRing::ReadStatus::Empty;
+}
+
+void Simulator::publishTelemetry(bool new_tick) {
+  TelemetryFrame frame{};
+  frame.step = stepCount;
+  frame.time = time;
+  frame.tankLevel = state(0);
+  frame.measuredLevel = estimatedState(0);
+  frame.inletFlow = inputs(constants::INPUT_INDEX_INLET_FLOW);
+  frame.outletFlow = model.getOutletFlow(state, inputs);
+  frame.valvePosition = inputs(constants::INPUT_INDEX_VALVE_POSITION);
+  frame.loopCount = std::min(controllers.size(), TelemetryFrame::MAX_LOOPS);
+  frame.activeAlarms = 0;
+  for (int i = 0; i < alarms->size(); ++i) {
+    frame.activeAlarms += alarms->isActive(i) ? 1 : 0;
+  }
+  for (int i = 0; i < frame.loopCount; ++i) {
+    int slot = schedule.slotOf()[i];
+    int output_index = controllerConfig[i].outputIndex;
+    frame.setpoint[i] = controllers.getSetpoint(slot);
+    frame.error[i] = frame.setpoint[i] - measuredValue(i);
+    frame.controllerOutput[i] =
+        output_index < 0 ? controllers.getOutput(slot) : inputs(output_index);
+  }
+  telemetry.write(frame);
+  if (new_tick && telemetryStream) {
+    telemetryStream->publish(frame);
+  }
+}
+
+void Simulator::restartPerformance(int index) {
+  int slot = schedule.slotOf()[index];
+  double output = controllerConfig[index].outputIndex >= 0
+                      ? inputs(controllerConfig[index].outputIndex)
+                      : controllers.getOutput(slot);
+  performance[index].restart(controllers.getSetpoint(slot), measuredValue(index), output);
+}
+
+const Simulator::PredictiveLoop *Simulator::findPredictiveLoop(int index) const {
+  for (const auto &loop : predictiveLoops) {
+    if (loop.index == index) {
+      return &loop;
+    }
+  }
+  return nullptr;
 }
 
 } // namespace tank_sim
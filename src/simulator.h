@@ -1,16 +1,40 @@
 #ifndef TANK_SIMULATOR_H
 #define TANK_SIMULATOR_H
 
+#include "alarm_evaluator.h"
+#include "broadcast_ring.h"
+#include "control_graph.h"
+#include "gain_schedule.h"
+#include "level_estimator.h"
+#include "loop_health.h"
+#include "loop_performance.h"
+#include "mpc_controller.h"
+#include "operator_command.h"
+#include "pid_bank.h"
 #include "pid_controller.h" // Include the PID controller header
+#include "seqlock.h"
+#include "simulator_snapshot.h"
+#include "spsc_ring.h"
 #include "stepper.h"
+#include "tank_identifier.h"
 #include "tank_model.h"
+#include "telemetry.h"
 #include <Eigen/src/Core/Matrix.h>
+#include <memory>
+#include <optional>
+#include <random>
 #include <vector>
 
 namespace tank_sim {
 
 class Simulator {
 public:
+  using TelemetryRing =
+      BroadcastRing<TelemetryFrame, constants::TELEMETRY_RING_CAPACITY>;
+
+  // Control law used by a controller slot
+  enum class ControllerType { PID, MPC };
+
   struct ControllerConfig {
     tank_sim::PIDController::Gains gains; // Use the existing Gains struct
     double bias;
@@ -18,8 +42,13 @@ public:
     double maxOutputLimit;
     double maxIntegralAccumulation;
     int measuredIndex;
-    int outputIndex;
+    int outputIndex;      // -1 = internal loop (e.g. cascade master)
     double initialSetpoint;
+    // Where measuredIndex points: the state vector (default) or the inputs
+    SignalRef::Source measuredSource = SignalRef::Source::State;
+    // MPC replaces the PID law; gains and integral limit are then unused
+    ControllerType type = ControllerType::PID;
+    tank_sim::MPCController::Settings mpc;
   };
 
   struct Config {
@@ -28,44 +57,183 @@ public:
     Eigen::VectorXd initialState;
     Eigen::VectorXd initialInputs;
     double dt;
+    // Cascade, ratio and feedforward connections between controllers
+    std::vector<ControlLink> controlLinks;
+    // Gain-scheduled controllers (at most one schedule per controller)
+    std::vector<GainScheduleConfig> gainSchedules;
+    // Level sensor noise standard deviation (m) and seed; 0 = ideal sensor
+    double sensorNoiseStdDev = 0.0;
+    unsigned int sensorNoiseSeed = 0;
+    // When set, controllers read an EKF estimate instead of the raw sensor
+    bool useEstimator = false;
+    tank_sim::LevelEstimator::Settings estimator;
+    // When set, an RLS identifier tracks area and k_v from the level the
+    // controllers read (prior: params)
+    bool identifyModel = false;
+    tank_sim::TankIdentifier::Settings identifier;
+    // Thresholds for the per-loop performance indices
+    tank_sim::LoopPerformance::Settings performance;
+    // When set, every loop runs oscillation and Harris-index detectors
+    bool monitorLoopHealth = false;
+    tank_sim::LoopHealth::Settings loopHealth;
+    // Limit alarms, evaluated at the end of every step
+    std::vector<AlarmEvaluator::Alarm> alarms;
+    // Cross-thread outputs (about 45 KB together). A simulator that one
+    // thread both commands and steps can leave them out.
+    bool streamTelemetry = true;       // per-step frame ring (subscribeTelemetry)
+    bool reportCommandResults = true;  // result ring (pollAppliedCommand)
   };
 
   // Constructor
   Simulator(const Config &config);
 
   void step();
+  // Advance by several timesteps at once: queued commands are applied
+  // before the first and one telemetry frame is published after the last
+  // (its step counter still counts every step). Throws
+  // std::invalid_argument if steps < 1.
+  void stepMany(int steps);
 
   // State getters (const methods - do not modify simulator state)
   double getTime() const;
   Eigen::VectorXd getState() const;
   Eigen::VectorXd getInputs() const;
+  Eigen::VectorXd getMeasuredState() const;   // raw (noisy) sensor reading
+  Eigen::VectorXd getEstimatedState() const;  // what controllers read
   double getSetpoint(int index) const;
   double getControllerOutput(int index) const;
   double getError(int index) const;
   int getControllerCount() const;
+  const tank_sim::MPCController::SolveStats &getMPCStats(int index) const;
+  tank_sim::TankIdentifier::Estimate getIdentifiedModel() const;
+  // KPIs of every controller (by config index), restarted on setSetpoint()
+  std::vector<tank_sim::LoopPerformance::Snapshot> getPerformance() const;
+  // Oscillation and performance flags of every controller (by config index)
+  std::vector<tank_sim::LoopHealth::Status> getLoopHealth() const;
+  // Alarm transitions since the last call, oldest first
+  std::vector<tank_sim::AlarmEvent> drainAlarmEvents();
+  // Indices (into Config.alarms) of the alarms currently active
+  std::vector<int> getActiveAlarms() const;
 
   // Operator control methods
   void setInput(int index, double value);
   void setSetpoint(int index, double value);
+  // Throws std::invalid_argument for MPC and gain-scheduled controllers
   void setControllerGains(int index, const tank_sim::PIDController::Gains &gains);
 
+  // Command queue. One producer thread submits operator commands and polls
+  // their results; the stepping thread applies them, in order, at the start
+  // of the next step() (or applyPendingCommands()). Neither side blocks.
+  struct CommandStats {
+    long long applied = 0;      // commands applied (accepted or rejected)
+    long long rejected = 0;     // commands whose operator method threw
+    long long resultsDropped = 0;  // results lost to a full result ring
+    double lastLatencyMicros = 0.0;
+    double meanLatencyMicros = 0.0;
+    double maxLatencyMicros = 0.0;
+  };
+  bool submitCommand(OperatorCommand command);  // producer; false if full
+  bool pollAppliedCommand(AppliedCommand &result);  // producer
+  int applyPendingCommands();  // stepping thread; returns commands applied
+  const CommandStats &getCommandStats() const;  // stepping thread
+
+  // Latest published frame. Safe to call from any thread while another
+  // thread steps the simulator; never blocks the stepping thread.
+  TelemetryFrame getTelemetry() const;
+  // Per-step frame stream. Each consumer keeps its own cursor and reads
+  // from its own thread; a consumer that falls behind by more than the
+  // ring capacity gets Overrun and skips ahead. The stepping thread never
+  // waits for consumers. Frames are published by step() and reset().
+  // subscribeTelemetry() throws std::invalid_argument unless
+  // Config.streamTelemetry is set.
+  TelemetryRing::Cursor subscribeTelemetry(bool from_oldest = false) const;
+  TelemetryRing::ReadStatus readTelemetry(TelemetryRing::Cursor &cursor,
+                                          TelemetryFrame &frame) const;
+
   // Utility method
   void reset();
 
+  // Binary snapshot of the dynamic state (stepping thread). captureState()
+  // throws std::invalid_argument with more than MAX_SNAPSHOT_LOOPS loops or
+  // MAX_SNAPSHOT_ALARMS alarms;
+  // restoreState() throws it if the snapshot does not fit this simulator's
+  // configuration. Restoring publishes a telemetry frame.
+  SimulatorSnapshot captureState() const;
+  void restoreState(const SimulatorSnapshot &snapshot);
+
   private:
 
   TankModel model;
   Stepper stepper;
-  std::vector<PIDController> controllers;
+  PIDBank controllers;  // All PID loops, structure-of-arrays layout
+  ControlSchedule schedule;  // Compiled execution order; bank slots follow it
   double time;
   Eigen::VectorXd state;
   Eigen::VectorXd inputs;
   Eigen::VectorXd initialState;
   Eigen::VectorXd initialInputs;
   double dt;
-  std::vector<double> setpoints;
-  std::vector<double> previousErrors;  // For error derivative calculation
   std::vector<ControllerConfig> controllerConfig;
+
+  // Sensor model and optional state estimator. Controllers read
+  // estimatedState, which equals measuredState when no estimator is used
+  // and equals state when the sensor is also noise-free.
+  double sensorNoiseStdDev;
+  unsigned int sensorNoiseSeed;
+  std::mt19937 sensorRng;
+  std::normal_distribution<double> sensorNoise;
+  Eigen::VectorXd measuredState;
+  Eigen::VectorXd estimatedState;
+  std::optional<LevelEstimator> estimator;
+  std::optional<TankIdentifier> identifier;
+
+  // Gain schedules, applied before the control schedule each step
+  struct ScheduledLoop {
+    GainSchedule table;
+    SignalRef variable;
+    int slot;
+  };
+  std::vector<ScheduledLoop> scheduledLoops;
+
+  // MPC loops occupy a bank slot with zero gains; their solution is written
+  // as the slot bias each step, so clamping, scatter and links still apply.
+  struct PredictiveLoop {
+    MPCController controller;
+    int index;
+    int slot;
+  };
+  std::vector<PredictiveLoop> predictiveLoops;
+
+  // Streaming KPIs, one per controller in config order
+  std::vector<LoopPerformance> performance;
+  // Loop health detectors, empty unless monitorLoopHealth is set
+  std::vector<LoopHealth> health;
+
+  // Alarm signals (controller outputs resolved to bank slots) and the
+  // values gathered for them each step
+  std::optional<AlarmEvaluator> alarms;
+  std::vector<SignalRef> alarmSignals;
+  std::vector<double> alarmValues;
+
+  // Operator command rings (the only members shared with the producer)
+  SpscRing<OperatorCommand, constants::COMMAND_QUEUE_CAPACITY> commandQueue;
+  // Allocated only when Config.reportCommandResults is set
+  std::unique_ptr<SpscRing<AppliedCommand, constants::COMMAND_QUEUE_CAPACITY>> commandResults;
+  CommandStats commandStats;
+
+  // Telemetry published for concurrent readers. Every other member is
+  // owned by the thread that calls step() and the operator methods.
+  std::uint64_t stepCount;
+  SeqLock<TelemetryFrame> telemetry;
+  std::unique_ptr<TelemetryRing> telemetryStream;  // when Config.streamTelemetry
+
+  double measuredValue(int index) const;
+  const PredictiveLoop *findPredictiveLoop(int index) const;
+  void restartPerformance(int index);
+  void gatherAlarmValues();
+  void advance();  // steps 1-8 of step(), without commands or publishing
+  void publishTelemetry(bool new_tick = false);
+  void applyCommand(const OperatorCommand &command);
 };
 
 } // namespace tank_sim
@@ -0,0 +1,66 @@
+#ifndef TANK_SIM_SIMULATOR_SNAPSHOT_H
+#define TANK_SIM_SIMULATOR_SNAPSHOT_H
+
+#include "constants.h"
+#include "pid_controller.h"
+#include "tank_identifier.h"
+#include <array>
+#include <cstdint>
+#include <type_traits>
+
+namespace tank_sim {
+
+/**
+ * @brief Binary snapshot of a Simulator's dynamic state.
+ *
+ * Fixed-size and trivially copyable, so it can be sent to another process
+ * or written to disk as raw bytes. It holds what a run needs to continue
+ * exactly: time and step count, plant state and inputs, the sensor and
+ * estimate readings, every PID loop's setpoint, gains and internal state
+ * (by bank slot), the model identifier's estimate and which alarms are
+ * active.
+ *
+ * Restore it into a Simulator built from the same Config. Restoring
+ * raises and clears no alarm; alarm delay timers, the state estimator,
+ * MPC warm starts, KPIs and loop-health detectors restart from the
+ * restored state, as they do after reset(). Sensor noise continues from
+ * the receiver's generator.
+ */
+struct SimulatorSnapshot {
+    static constexpr std::uint32_t VERSION = 2;
+    static constexpr int MAX_LOOPS = constants::MAX_SNAPSHOT_LOOPS;
+    static constexpr int MAX_ALARMS = constants::MAX_SNAPSHOT_ALARMS;
+
+    /**
+     * @brief One PID bank slot.
+     */
+    struct Loop {
+        double setpoint;
+        double measured;
+        double output;
+        double integral;
+        double previousError;
+        double bias;
+        double feedforward;
+        PIDController::Gains gains;
+    };
+
+    std::uint32_t version;
+    std::int32_t loopCount;   ///< Valid entries in loops
+    std::uint64_t step;       ///< Steps since construction or reset
+    double time;              ///< Simulation time (s)
+    std::array<double, constants::TANK_STATE_SIZE> state;
+    std::array<double, constants::TANK_STATE_SIZE> measuredState;
+    std::array<double, constants::TANK_STATE_SIZE> estimatedState;
+    std::array<double, constants::TANK_INPUT_SIZE> inputs;
+    std::array<Loop, MAX_LOOPS> loops;
+    TankIdentifier::State identifier;   ///< Meaningful when the model is identified
+    std::uint64_t activeAlarms;         ///< Bit i: alarm i is active
+};
+
+static_assert(std::is_trivially_copyable<SimulatorSnapshot>::value,
+              "SimulatorSnapshot is sent and stored as raw bytes");
+
+}  // namespace tank_sim
+
+#endif  // TANK_SIM_SIMULATOR_SNAPSHOT_H
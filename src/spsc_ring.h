@@ -0,0 +1,90 @@
+#ifndef TANK_SIM_SPSC_RING_H
+#define TANK_SIM_SPSC_RING_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+namespace tank_sim {
+
+/**
+ * @brief Bounded lock-free single-producer/single-consumer ring buffer.
+ *
+ * One thread calls tryPush(), one (other) thread calls tryPop(). Each side
+ * owns its index and reads the other's with acquire semantics only when its
+ * cached copy says the ring looks full (producer) or empty (consumer), so
+ * in steady state neither side touches the other's cache line. Neither call
+ * ever blocks or allocates.
+ *
+ * @tparam T Element type (copy-assignable)
+ * @tparam N Capacity, a power of two
+ */
+template <typename T, std::size_t N>
+class SpscRing {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "SPSC ring capacity must be a power of two");
+
+public:
+    SpscRing() : head_(0), cached_tail_(0), tail_(0), cached_head_(0) {}
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    /**
+     * @brief Append an element (producer thread only).
+     *
+     * @return false if the ring is full
+     */
+    bool tryPush(const T& value) {
+        const std::size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - cached_head_ == N) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            if (tail - cached_head_ == N) {
+                return false;
+            }
+        }
+        slots_[tail & (N - 1)] = value;
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Remove the oldest element (consumer thread only).
+     *
+     * @return false if the ring is empty
+     */
+    bool tryPop(T& out) {
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        if (head == cached_tail_) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            if (head == cached_tail_) {
+                return false;
+            }
+        }
+        out = slots_[head & (N - 1)];
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Number of queued elements; exact only when both sides are idle.
+     */
+    std::size_t sizeApprox() const {
+        return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+    }
+
+    static constexpr std::size_t capacity() { return N; }
+
+private:
+    // Consumer side
+    alignas(64) std::atomic<std::size_t> head_;
+    std::size_t cached_tail_;
+    // Producer side
+    alignas(64) std::atomic<std::size_t> tail_;
+    std::size_t cached_head_;
+
+    alignas(64) std::array<T, N> slots_;
+};
+
+}  // namespace tank_sim
+
+#endif  // TANK_SIM_SPSC_RING_H
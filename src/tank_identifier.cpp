@@ -0,0 +1,88 @@
+#include "tank_identifier.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace tank_sim {
+
+namespace {
+
+RecursiveLeastSquares<2> makeEstimator(const TankIdentifier::Settings& settings,
+                                       const TankModel::Parameters& prior) {
+    RecursiveLeastSquares<2>::Vector theta;
+    theta << 1.0 / prior.area, -prior.k_v / prior.area;
+    return RecursiveLeastSquares<2>(theta, settings.initialCovariance,
+                                    settings.forgettingFactor,
+                                    settings.maxCovarianceTrace);
+}
+
+}  // namespace
+
+TankIdentifier::TankIdentifier(const Settings& settings, const TankModel::Parameters& prior)
+    : settings_(settings), prior_(prior), rls_(makeEstimator(settings, prior)),
+      previous_level_(0.0), last_valve_(0.0), has_level_(false) {}
+
+void TankIdentifier::update(double level, double inlet_flow, double valve_position,
+                            double dt) {
+    if (has_level_) {
+        // Trapezoidal average of sqrt(h) over the sample
+        const double root_h = 0.5 * (std::sqrt(std::max(previous_level_, 0.0)) +
+                                     std::sqrt(std::max(level, 0.0)));
+        RecursiveLeastSquares<2>::Vector regressor;
+        regressor << inlet_flow, valve_position * root_h;
+        rls_.update(regressor, (level - previous_level_) / dt);
+    }
+    previous_level_ = level;
+    last_valve_ = valve_position;
+    has_level_ = true;
+}
+
+void TankIdentifier::reset() {
+    rls_ = makeEstimator(settings_, prior_);
+    previous_level_ = 0.0;
+    last_valve_ = 0.0;
+    has_level_ = false;
+}
+
+TankIdentifier::State TankIdentifier::state() const {
+    const auto& theta = rls_.parameters();
+    const auto& p = rls_.covariance();
+    return State{{theta(0), theta(1)},
+                 {p(0, 0), p(0, 1), p(1, 0), p(1, 1)},
+                 rls_.samples(),
+                 previous_level_,
+                 last_valve_,
+                 has_level_ ? 1 : 0};
+}
+
+void TankIdentifier::restore(const State& state) {
+    RecursiveLeastSquares<2>::Vector theta;
+    theta << state.parameters[0], state.parameters[1];
+    RecursiveLeastSquares<2>::Matrix p;
+    p << state.covariance[0], state.covariance[1], state.covariance[2], state.covariance[3];
+    rls_.restore(theta, p, state.samples);
+    previous_level_ = state.previousLevel;
+    last_valve_ = state.lastValve;
+    has_level_ = state.hasLevel != 0;
+}
+
+TankIdentifier::Estimate TankIdentifier::estimate() const {
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    const auto& theta = rls_.parameters();
+
+    Estimate result{nan, nan, nan, rls_.samples()};
+    if (theta(0) <= 0.0) {
+        return result;
+    }
+    result.area = 1.0 / theta(0);
+    result.k_v = -theta(1) / theta(0);
+
+    // tau = -1 / (d(dh/dt)/dh) = 2 A sqrt(h) / (k_v x)
+    const double gain = result.k_v * last_valve_;
+    if (gain > 0.0 && previous_level_ > 0.0) {
+        result.timeConstant = 2.0 * result.area * std::sqrt(previous_level_) / gain;
+    }
+    return result;
+}
+
+}  // namespace tank_sim
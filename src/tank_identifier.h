@@ -0,0 +1,108 @@
+#ifndef TANK_SIM_TANK_IDENTIFIER_H
+#define TANK_SIM_TANK_IDENTIFIER_H
+
+#include "constants.h"
+#include "recursive_least_squares.h"
+#include "tank_model.h"
+#include <array>
+#include <cstdint>
+
+namespace tank_sim {
+
+/**
+ * @brief Online identification of the tank's area and valve coefficient.
+ *
+ * The material balance is linear in two physical parameters:
+ *
+ *   dh/dt = (1/A) * q_in - (k_v/A) * x * sqrt(h)
+ *         = theta_1 * q_in + theta_2 * x * sqrt(h)
+ *
+ * Each sample the observed slope (h_k - h_{k-1}) / dt is regressed on
+ * q_in and x * sqrt(h) (trapezoidal average of sqrt(h) over the sample)
+ * with a two-parameter RecursiveLeastSquares. A = 1/theta_1,
+ * k_v = -theta_2/theta_1, and the linearized time constant at the current
+ * operating point is tau = 2 A sqrt(h) / (k_v x).
+ *
+ * A falling k_v estimate at constant area indicates a fouled valve.
+ * Only the previous level is stored; update() is O(1).
+ */
+class TankIdentifier {
+public:
+    /**
+     * @brief RLS settings.
+     */
+    struct Settings {
+        double forgettingFactor = constants::DEFAULT_RLS_FORGETTING_FACTOR;     ///< lambda in (0, 1]
+        double initialCovariance = constants::DEFAULT_RLS_INITIAL_COVARIANCE;   ///< Prior parameter variance
+        double maxCovarianceTrace = constants::DEFAULT_RLS_MAX_COVARIANCE_TRACE; ///< Windup limit on trace(P)
+    };
+
+    /**
+     * @brief Current identified model.
+     *
+     * Fields are NaN until the estimate is physically meaningful (positive
+     * area, valve open, non-empty tank for the time constant).
+     */
+    struct Estimate {
+        double area;          ///< Identified cross-sectional area (m²)
+        double k_v;           ///< Identified valve coefficient (m^2.5/s)
+        double timeConstant;  ///< Linearized time constant at the last sample (s)
+        long long samples;    ///< Samples used so far
+    };
+
+    /**
+     * @brief Construct an identifier starting from prior parameters.
+     *
+     * @param settings RLS settings
+     * @param prior Initial guess of the physical parameters
+     *
+     * @throws std::invalid_argument if the settings are invalid
+     */
+    TankIdentifier(const Settings& settings, const TankModel::Parameters& prior);
+
+    /**
+     * @brief Add one sample.
+     *
+     * @param level Level at the end of the sample (m)
+     * @param inlet_flow Inlet flow applied over the sample (m³/s)
+     * @param valve_position Valve position applied over the sample
+     * @param dt Sample time in seconds
+     */
+    void update(double level, double inlet_flow, double valve_position, double dt);
+
+    /**
+     * @brief Restart from the prior; the next sample only sets the level.
+     */
+    void reset();
+
+    /**
+     * @brief Everything update() depends on, as plain values (for snapshots).
+     */
+    struct State {
+        std::array<double, 2> parameters;   ///< RLS estimate (1/A, -k_v/A)
+        std::array<double, 4> covariance;   ///< RLS covariance, row-major
+        std::int64_t samples;
+        double previousLevel;
+        double lastValve;
+        std::int32_t hasLevel;
+    };
+
+    State state() const;
+
+    /// Continue from a State taken from an identifier with the same settings
+    void restore(const State& state);
+
+    Estimate estimate() const;
+
+private:
+    Settings settings_;
+    TankModel::Parameters prior_;
+    RecursiveLeastSquares<2> rls_;
+    double previous_level_;   ///< Level at the end of the last sample
+    double last_valve_;       ///< Valve position over the last sample
+    bool has_level_;
+};
+
+}  // namespace tank_sim
+
+#endif  // TANK_SIM_TANK_IDENTIFIER_H
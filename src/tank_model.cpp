@@ -1,4 +1,5 @@
 #include "tank_model.h"
+#include <algorithm>
 #include <cmath>
 #include <stdexcept>
 
@@ -58,6 +59,47 @@ double TankModel::getOutletFlow(
     return outletFlow(h, valve_position);
 }
 
+TankModel::StateVector TankModel::derivatives(
+    const StateVector& state,
+    const InputVector& inputs) const {
+    
+    // An estimated level can dip below zero; treat it as an empty tank
+    double h = std::max(state(0), 0.0);
+    StateVector derivative;
+    derivative(0) = (inputs(0) - outletFlow(h, inputs(1))) / area_;
+    return derivative;
+}
+
+TankModel::StateJacobian TankModel::stateJacobian(
+    const StateVector& state,
+    const InputVector& inputs) const {
+    
+    double h = std::max(state(0), constants::JACOBIAN_MIN_LEVEL);
+    double valve_position = inputs(1);
+    
+    // d/dh of -(k_v * x * sqrt(h)) / A
+    StateJacobian jacobian;
+    jacobian(0, 0) = -k_v_ * valve_position / (2.0 * area_ * std::sqrt(h));
+    return jacobian;
+}
+
+TankModel::InputJacobian TankModel::inputJacobian(
+    const StateVector& state,
+    const InputVector& /*inputs*/) const {
+    
+    double h = state(0);
+    
+    InputJacobian jacobian;
+    jacobian(0, constants::INPUT_INDEX_INLET_FLOW) = 1.0 / area_;
+    jacobian(0, constants::INPUT_INDEX_VALVE_POSITION) =
+        h > 0.0 ? -k_v_ * std::sqrt(h) / area_ : 0.0;
+    return jacobian;
+}
+
+TankModel::Parameters TankModel::getParameters() const {
+    return Parameters{area_, k_v_, max_height_};
+}
+
 double TankModel::outletFlow(double h, double valve_position) const {
     // Validate preconditions
     assert(h >= 0.0 && "Tank level must be non-negative");
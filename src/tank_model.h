@@ -1,6 +1,7 @@
 #ifndef TANK_SIM_TANK_MODEL_H
 #define TANK_SIM_TANK_MODEL_H
 
+#include "constants.h"
 #include <Eigen/Dense>
 
 namespace tank_sim {
@@ -21,6 +22,17 @@ namespace tank_sim {
  */
 class TankModel {
 public:
+    /// Fixed-size state and input vectors for allocation-free callers
+    using StateVector = Eigen::Matrix<double, constants::TANK_STATE_SIZE, 1>;
+    using InputVector = Eigen::Matrix<double, constants::TANK_INPUT_SIZE, 1>;
+
+    /// d(derivatives)/d(state), fixed size so callers need no heap allocation
+    using StateJacobian = Eigen::Matrix<double, constants::TANK_STATE_SIZE,
+                                        constants::TANK_STATE_SIZE>;
+    /// d(derivatives)/d(inputs)
+    using InputJacobian = Eigen::Matrix<double, constants::TANK_STATE_SIZE,
+                                        constants::TANK_INPUT_SIZE>;
+
     /**
      * @brief Configuration parameters for the tank model.
      */
@@ -64,6 +76,20 @@ public:
         const Eigen::VectorXd& state,
         const Eigen::VectorXd& inputs) const;
 
+    /**
+     * @brief Fixed-size overload of derivatives() that does not allocate.
+     *
+     * Used by per-tick estimators and controllers. Same equations; a
+     * negative level (possible in an estimate) gives zero outlet flow.
+     *
+     * @param state Current state vector [h]
+     * @param inputs Input vector [q_in, x]
+     * @return Derivative vector [dh/dt] in m/s
+     */
+    StateVector derivatives(
+        const StateVector& state,
+        const InputVector& inputs) const;
+
     /**
      * @brief Gets the current outlet flow rate for reporting/logging.
      * 
@@ -78,6 +104,41 @@ public:
         const Eigen::VectorXd& state,
         const Eigen::VectorXd& inputs) const;
 
+    /**
+     * @brief Analytic Jacobian of derivatives() with respect to the state.
+     *
+     *   d(dh/dt)/dh = -k_v * x / (2 * A * sqrt(h))
+     *
+     * The slope is evaluated at max(h, JACOBIAN_MIN_LEVEL) because it is
+     * unbounded at an empty tank.
+     *
+     * @param state Current state vector [h]
+     * @param inputs Input vector [q_in, x]
+     * @return 1x1 Jacobian
+     */
+    StateJacobian stateJacobian(
+        const StateVector& state,
+        const InputVector& inputs) const;
+
+    /**
+     * @brief Analytic Jacobian of derivatives() with respect to the inputs.
+     *
+     *   d(dh/dt)/dq_in = 1 / A
+     *   d(dh/dt)/dx    = -k_v * sqrt(h) / A   (0 for an empty tank)
+     *
+     * @param state Current state vector [h]
+     * @param inputs Input vector [q_in, x]
+     * @return 1x2 Jacobian
+     */
+    InputJacobian inputJacobian(
+        const StateVector& state,
+        const InputVector& inputs) const;
+
+    /**
+     * @brief Returns the physical parameters the model was built with.
+     */
+    Parameters getParameters() const;
+
 private:
     double area_;         ///< Cross-sectional area (m²)
     double k_v_;          ///< Valve coefficient (m^2.5/s)
@@ -0,0 +1,40 @@
+#ifndef TANK_SIM_TELEMETRY_H
+#define TANK_SIM_TELEMETRY_H
+
+#include "constants.h"
+#include <array>
+#include <cstdint>
+
+namespace tank_sim {
+
+/**
+ * @brief Fixed-size snapshot of one simulator step.
+ *
+ * Published by Simulator after every step and operator change, and read
+ * by other threads through Simulator::getTelemetry(). The frame is plain
+ * data (trivially copyable, no heap), so it can be copied through a SeqLock
+ * or into shared memory as is.
+ *
+ * Per-loop arrays hold the first loopCount controllers in config order;
+ * loopCount is capped at MAX_LOOPS.
+ */
+struct TelemetryFrame {
+    static constexpr int MAX_LOOPS = constants::MAX_TELEMETRY_LOOPS;
+
+    std::uint64_t step;        ///< Steps since construction or reset
+    double time;               ///< Simulation time (s)
+    double tankLevel;          ///< True level (m)
+    double measuredLevel;      ///< Level as read by the controllers (m)
+    double inletFlow;          ///< Inlet flow (m³/s)
+    double outletFlow;         ///< Outlet flow (m³/s)
+    double valvePosition;      ///< Valve position (0-1)
+    std::int32_t loopCount;    ///< Valid entries in the per-loop arrays
+    std::int32_t activeAlarms; ///< Number of alarms currently active
+    std::array<double, MAX_LOOPS> setpoint;
+    std::array<double, MAX_LOOPS> error;
+    std::array<double, MAX_LOOPS> controllerOutput;
+};
+
+}  // namespace tank_sim
+
+#endif  // TANK_SIM_TELEMETRY_H
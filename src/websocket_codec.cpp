@@ -0,0 +1,278 @@
+#include "websocket_codec.h"
+#include <cctype>
+#include <cstring>
+
+namespace tank_sim {
+
+namespace websocket {
+
+namespace {
+
+constexpr char GUID[] = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+
+std::uint32_t rotateLeft(std::uint32_t value, int bits) {
+    return (value << bits) | (value >> (32 - bits));
+}
+
+bool equalsIgnoreCase(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        if (std::tolower(static_cast<unsigned char>(a[i])) !=
+            std::tolower(static_cast<unsigned char>(b[i]))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool containsIgnoreCase(std::string_view haystack, std::string_view needle) {
+    for (std::size_t i = 0; i + needle.size() <= haystack.size(); ++i) {
+        if (equalsIgnoreCase(haystack.substr(i, needle.size()), needle)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::string_view trim(std::string_view text) {
+    while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) {
+        text.remove_prefix(1);
+    }
+    while (!text.empty() && (text.back() == ' ' || text.back() == '\t' || text.back() == '\r')) {
+        text.remove_suffix(1);
+    }
+    return text;
+}
+
+}  // namespace
+
+std::array<std::uint8_t, 20> sha1(std::string_view data) {
+    std::uint32_t h[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+
+    // Message plus 0x80, zero padding and the 64-bit bit length
+    const std::uint64_t bit_length = static_cast<std::uint64_t>(data.size()) * 8;
+    const std::size_t padded = ((data.size() + 8) / 64 + 1) * 64;
+    std::uint8_t block[64];
+    for (std::size_t offset = 0; offset < padded; offset += 64) {
+        for (std::size_t i = 0; i < 64; ++i) {
+            const std::size_t k = offset + i;
+            if (k < data.size()) {
+                block[i] = static_cast<std::uint8_t>(data[k]);
+            } else if (k == data.size()) {
+                block[i] = 0x80;
+            } else if (k >= padded - 8) {
+                block[i] = static_cast<std::uint8_t>(bit_length >> (8 * (padded - 1 - k)));
+            } else {
+                block[i] = 0;
+            }
+        }
+
+        std::uint32_t w[80];
+        for (int t = 0; t < 16; ++t) {
+            w[t] = (static_cast<std::uint32_t>(block[4 * t]) << 24) |
+                   (static_cast<std::uint32_t>(block[4 * t + 1]) << 16) |
+                   (static_cast<std::uint32_t>(block[4 * t + 2]) << 8) |
+                   static_cast<std::uint32_t>(block[4 * t + 3]);
+        }
+        for (int t = 16; t < 80; ++t) {
+            w[t] = rotateLeft(w[t - 3] ^ w[t - 8] ^ w[t - 14] ^ w[t - 16], 1);
+        }
+
+        std::uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+        for (int t = 0; t < 80; ++t) {
+            std::uint32_t f, k;
+            if (t < 20) {
+                f = (b & c) | (~b & d);
+                k = 0x5A827999;
+            } else if (t < 40) {
+                f = b ^ c ^ d;
+                k = 0x6ED9EBA1;
+            } else if (t < 60) {
+                f = (b & c) | (b & d) | (c & d);
+                k = 0x8F1BBCDC;
+            } else {
+                f = b ^ c ^ d;
+                k = 0xCA62C1D6;
+            }
+            const std::uint32_t temp = rotateLeft(a, 5) + f + e + k + w[t];
+            e = d;
+            d = c;
+            c = rotateLeft(b, 30);
+            b = a;
+            a = temp;
+        }
+        h[0] += a;
+        h[1] += b;
+        h[2] += c;
+        h[3] += d;
+        h[4] += e;
+    }
+
+    std::array<std::uint8_t, 20> digest;
+    for (int i = 0; i < 20; ++i) {
+        digest[i] = static_cast<std::uint8_t>(h[i / 4] >> (24 - 8 * (i % 4)));
+    }
+    return digest;
+}
+
+std::string base64Encode(const std::uint8_t* data, std::size_t size) {
+    static constexpr char ALPHABET[] =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string out;
+    out.reserve((size + 2) / 3 * 4);
+    for (std::size_t i = 0; i < size; i += 3) {
+        const std::uint32_t chunk = (static_cast<std::uint32_t>(data[i]) << 16) |
+                                    (i + 1 < size ? static_cast<std::uint32_t>(data[i + 1]) << 8 : 0) |
+                                    (i + 2 < size ? static_cast<std::uint32_t>(data[i + 2]) : 0);
+        out += ALPHABET[(chunk >> 18) & 0x3f];
+        out += ALPHABET[(chunk >> 12) & 0x3f];
+        out += i + 1 < size ? ALPHABET[(chunk >> 6) & 0x3f] : '=';
+        out += i + 2 < size ? ALPHABET[chunk & 0x3f] : '=';
+    }
+    return out;
+}
+
+std::string acceptKey(std::string_view client_key) {
+    std::string input(client_key);
+    input += GUID;
+    const auto digest = sha1(input);
+    return base64Encode(digest.data(), digest.size());
+}
+
+bool parseUpgradeRequest(std::string_view request, UpgradeRequest& out) {
+    // Request line: GET <target> HTTP/1.1
+    const std::size_t line_end = request.find("\r\n");
+    if (line_end == std::string_view::npos || request.substr(0, 4) != "GET ") {
+        return false;
+    }
+    const std::string_view line = request.substr(4, line_end - 4);
+    const std::size_t target_end = line.find(' ');
+    if (target_end == std::string_view::npos) {
+        return false;
+    }
+    const std::string_view target = line.substr(0, target_end);
+    const std::size_t query = target.find('?');
+    out.path = std::string(target.substr(0, query));
+    out.session.clear();
+    out.format.clear();
+    if (query != std::string_view::npos) {
+        std::string_view params = target.substr(query + 1);
+        while (!params.empty()) {
+            const std::size_t amp = params.find('&');
+            const std::string_view param = params.substr(0, amp);
+            if (param.substr(0, 8) == "session=") {
+                out.session = std::string(param.substr(8));
+            } else if (param.substr(0, 7) == "format=") {
+                out.format = std::string(param.substr(7));
+            }
+            params = amp == std::string_view::npos ? std::string_view() : params.substr(amp + 1);
+        }
+    }
+
+    // Headers until the blank line
+    bool upgrade = false;
+    out.key.clear();
+    std::size_t pos = line_end + 2;
+    while (pos < request.size()) {
+        const std::size_t end = request.find("\r\n", pos);
+        if (end == std::string_view::npos || end == pos) {
+            break;
+        }
+        const std::string_view header = request.substr(pos, end - pos);
+        const std::size_t colon = header.find(':');
+        if (colon != std::string_view::npos) {
+            const std::string_view name = trim(header.substr(0, colon));
+            const std::string_view value = trim(header.substr(colon + 1));
+            if (equalsIgnoreCase(name, "Upgrade")) {
+                upgrade = containsIgnoreCase(value, "websocket");
+            } else if (equalsIgnoreCase(name, "Sec-WebSocket-Key")) {
+                out.key = std::string(value);
+            }
+        }
+        pos = end + 2;
+    }
+    return upgrade && !out.key.empty();
+}
+
+std::string upgradeResponse(std::string_view client_key) {
+    return "HTTP/1.1 101 Switching Protocols\r\n"
+           "Upgrade: websocket\r\n"
+           "Connection: Upgrade\r\n"
+           "Sec-WebSocket-Accept: " +
+           acceptKey(client_key) + "\r\n\r\n";
+}
+
+std::size_t writeFrameHeader(char* out, Opcode opcode, std::size_t payload_size) {
+    out[0] = static_cast<char>(0x80 | opcode);
+    if (payload_size < 126) {
+        out[1] = static_cast<char>(payload_size);
+        return 2;
+    }
+    if (payload_size <= 0xffff) {
+        out[1] = 126;
+        out[2] = static_cast<char>(payload_size >> 8);
+        out[3] = static_cast<char>(payload_size);
+        return 4;
+    }
+    out[1] = 127;
+    for (int i = 0; i < 8; ++i) {
+        out[2 + i] = static_cast<char>(static_cast<std::uint64_t>(payload_size) >> (56 - 8 * i));
+    }
+    return 10;
+}
+
+ParseStatus parseClientFrame(const char* data, std::size_t size, FrameInfo& info) {
+    if (size < 2) {
+        return ParseStatus::Incomplete;
+    }
+    const auto* bytes = reinterpret_cast<const std::uint8_t*>(data);
+    info.fin = (bytes[0] & 0x80) != 0;
+    info.opcode = static_cast<Opcode>(bytes[0] & 0x0f);
+    const bool masked = (bytes[1] & 0x80) != 0;
+    if ((bytes[0] & 0x70) != 0 || !masked) {
+        return ParseStatus::Invalid;
+    }
+
+    std::size_t header = 2;
+    std::uint64_t length = bytes[1] & 0x7f;
+    if (length == 126) {
+        header = 4;
+        if (size < header) {
+            return ParseStatus::Incomplete;
+        }
+        length = (static_cast<std::uint64_t>(bytes[2]) << 8) | bytes[3];
+    } else if (length == 127) {
+        header = 10;
+        if (size < header) {
+            return ParseStatus::Incomplete;
+        }
+        length = 0;
+        for (int i = 0; i < 8; ++i) {
+            length = (length << 8) | bytes[2 + i];
+        }
+    }
+
+    // Control frames are short and never fragmented
+    if ((info.opcode & 0x8) != 0 && (!info.fin || length > 125)) {
+        return ParseStatus::Invalid;
+    }
+    if (size < header + 4) {
+        return ParseStatus::Incomplete;
+    }
+    std::memcpy(info.mask.data(), bytes + header, 4);
+    info.headerSize = header + 4;
+    info.payloadSize = length;
+    return ParseStatus::Ok;
+}
+
+void unmask(char* payload, std::size_t size, const std::array<std::uint8_t, 4>& mask) {
+    for (std::size_t i = 0; i < size; ++i) {
+        payload[i] = static_cast<char>(static_cast<std::uint8_t>(payload[i]) ^ mask[i & 3]);
+    }
+}
+
+}  // namespace websocket
+
+}  // namespace tank_sim
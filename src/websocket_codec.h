@@ -0,0 +1,103 @@
+#ifndef TANK_SIM_WEBSOCKET_CODEC_H
+#define TANK_SIM_WEBSOCKET_CODEC_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace tank_sim {
+
+/**
+ * @brief Socket-free pieces of the WebSocket protocol (RFC 6455).
+ *
+ * Enough of the protocol for the telemetry server: the HTTP upgrade
+ * handshake, unfragmented client frames (which are always masked) and
+ * server frames (never masked). Server frames carry no per-connection
+ * state, so one encoded frame can be written to any number of clients.
+ */
+namespace websocket {
+
+enum Opcode : std::uint8_t {
+    Continuation = 0x0,
+    Text = 0x1,
+    Binary = 0x2,
+    Close = 0x8,
+    Ping = 0x9,
+    Pong = 0xA
+};
+
+/// Longest header of a server frame (64-bit length, no mask)
+constexpr std::size_t MAX_SERVER_HEADER = 10;
+
+/// SHA-1 digest (FIPS 180-4); needed only for the handshake
+std::array<std::uint8_t, 20> sha1(std::string_view data);
+
+/// Standard base64 with padding
+std::string base64Encode(const std::uint8_t* data, std::size_t size);
+
+/// Sec-WebSocket-Accept value for a client's Sec-WebSocket-Key
+std::string acceptKey(std::string_view client_key);
+
+/**
+ * @brief The parts of an upgrade request the server routes on.
+ */
+struct UpgradeRequest {
+    std::string path;     ///< Request path without the query
+    std::string session;  ///< Value of the "session" query parameter, if any
+    std::string format;   ///< Value of the "format" query parameter, if any
+    std::string key;      ///< Sec-WebSocket-Key
+};
+
+/**
+ * @brief Parse a complete HTTP upgrade request (through the blank line).
+ *
+ * @return false unless it is a GET with Upgrade: websocket and a key
+ */
+bool parseUpgradeRequest(std::string_view request, UpgradeRequest& out);
+
+/// 101 Switching Protocols response for an accepted request
+std::string upgradeResponse(std::string_view client_key);
+
+/**
+ * @brief Write a server frame header.
+ *
+ * @param out At least MAX_SERVER_HEADER bytes
+ * @return Header size in bytes
+ */
+std::size_t writeFrameHeader(char* out, Opcode opcode, std::size_t payload_size);
+
+/**
+ * @brief Header fields of one client frame.
+ */
+struct FrameInfo {
+    bool fin;
+    Opcode opcode;
+    std::size_t headerSize;   ///< Bytes before the payload, mask included
+    std::uint64_t payloadSize;
+    std::array<std::uint8_t, 4> mask;
+};
+
+enum class ParseStatus {
+    Ok,          ///< info describes a frame whose header is complete
+    Incomplete,  ///< More bytes needed for the header
+    Invalid      ///< Protocol error: unmasked, reserved bits or bad control frame
+};
+
+/**
+ * @brief Parse the header of a client frame at the start of data.
+ *
+ * The payload may still be incomplete on Ok; compare headerSize +
+ * payloadSize with the bytes available.
+ */
+ParseStatus parseClientFrame(const char* data, std::size_t size, FrameInfo& info);
+
+/// Unmask a client payload in place
+void unmask(char* payload, std::size_t size, const std::array<std::uint8_t, 4>& mask);
+
+}  // namespace websocket
+
+}  // namespace tank_sim
+
+#endif  // TANK_SIM_WEBSOCKET_CODEC_H
@@ -32,11 +32,54 @@ __version__ = "0.1.0"
 import numpy as np
 
 from ._tank_sim import (
+    AlarmConfig,
+    AlarmEvent,
+    AlarmType,
+    AppliedCommand,
+    CatchUp,
+    CommandStats,
+    CheckpointWriter,
+    CommandType,
+    CompressedHistory,
+    ControlLink,
+    ControlLinkType,
     ControllerConfig,
+    ControllerType,
+    DeltaDecoder,
+    DeltaEncoder,
+    DeltaSettings,
+    EstimatorSettings,
+    FrameEncoder,
+    GainScheduleConfig,
+    GainSchedulePoint,
+    IdentifiedModel,
+    IdentifierSettings,
+    LoopHealthSettings,
+    LoopHealthStatus,
+    LoopPerformance,
+    MPCSettings,
+    MPCSolveStats,
+    OperatorCommand,
+    PacingStats,
+    ParameterEstimator,
+    ParameterEstimatorSettings,
+    ParameterFit,
+    PerformanceSettings,
     PIDGains,
+    RecordedData,
+    SignalRef,
+    SignalSource,
     Simulator,
     SimulatorConfig,
     TankModelParameters,
+    TelemetryFrame,
+    TelemetrySubscription,
+    SessionEngine,
+    SessionCheckpoint,
+    SessionSample,
+    ShardRouter,
+    SharedSessionStore,
+    SpeculationStats,
     get_version,
 )
 
@@ -114,5 +157,48 @@ __all__ = [
     "ControllerConfig",
     "TankModelParameters",
     "PIDGains",
+    "SignalSource",
+    "SignalRef",
+    "ControlLinkType",
+    "ControlLink",
+    "GainSchedulePoint",
+    "GainScheduleConfig",
+    "ControllerType",
+    "MPCSettings",
+    "MPCSolveStats",
+    "EstimatorSettings",
+    "IdentifierSettings",
+    "IdentifiedModel",
+    "PerformanceSettings",
+    "LoopPerformance",
+    "LoopHealthSettings",
+    "LoopHealthStatus",
+    "AlarmType",
+    "AlarmConfig",
+    "AlarmEvent",
+    "TelemetryFrame",
+    "TelemetrySubscription",
+    "SessionEngine",
+    "CatchUp",
+    "PacingStats",
+    "SpeculationStats",
+    "SessionCheckpoint",
+    "CheckpointWriter",
+    "CompressedHistory",
+    "SessionSample",
+    "ShardRouter",
+    "SharedSessionStore",
+    "FrameEncoder",
+    "DeltaSettings",
+    "DeltaEncoder",
+    "DeltaDecoder",
+    "CommandType",
+    "OperatorCommand",
+    "AppliedCommand",
+    "CommandStats",
+    "RecordedData",
+    "ParameterEstimator",
+    "ParameterEstimatorSettings",
+    "ParameterFit",
     "create_default_config",
 ]
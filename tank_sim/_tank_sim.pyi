@@ -1,13 +1,452 @@
 """Type stubs for the C++ extension module."""
 
+import enum
+from collections.abc import Iterable
+from typing import overload
+
 import numpy as np
 import numpy.typing as npt
 
+class SignalSource(enum.Enum):
+    STATE = ...
+    INPUT = ...
+    CONTROLLER_OUTPUT = ...
+
+class SignalRef:
+    source: SignalSource
+    index: int
+    def __init__(self, source: SignalSource = ..., index: int = ...) -> None: ...
+
+class ControlLinkType(enum.Enum):
+    CASCADE = ...
+    RATIO = ...
+    FEEDFORWARD = ...
+
+class ControlLink:
+    type: ControlLinkType
+    source: SignalRef
+    target: int
+    gain: float
+    bias: float
+
 class PIDGains:
     Kc: float
     tau_I: float
     tau_D: float
 
+class GainSchedulePoint:
+    x: float
+    gains: PIDGains
+    def __init__(self, x: float = ..., gains: PIDGains = ...) -> None: ...
+
+class GainScheduleConfig:
+    controller: int
+    variable: SignalRef
+    table: list[GainSchedulePoint]
+
+class ControllerType(enum.Enum):
+    PID = ...
+    MPC = ...
+
+class MPCSettings:
+    horizon: int
+    control_horizon: int
+    output_weight: float
+    move_weight: float
+    rho: float
+    max_iterations: int
+    tolerance: float
+
+class MPCSolveStats:
+    @property
+    def solves(self) -> int: ...
+    @property
+    def last_micros(self) -> float: ...
+    @property
+    def mean_micros(self) -> float: ...
+    @property
+    def max_micros(self) -> float: ...
+    @property
+    def last_iterations(self) -> int: ...
+    @property
+    def last_converged(self) -> bool: ...
+
+class EstimatorSettings:
+    process_noise: float
+    measurement_noise: float
+    initial_variance: float
+
+class IdentifierSettings:
+    forgetting_factor: float
+    initial_covariance: float
+    max_covariance_trace: float
+
+class IdentifiedModel:
+    @property
+    def area(self) -> float: ...
+    @property
+    def k_v(self) -> float: ...
+    @property
+    def time_constant(self) -> float: ...
+    @property
+    def samples(self) -> int: ...
+
+class PerformanceSettings:
+    settling_band: float
+    rise_low: float
+    rise_high: float
+
+class LoopPerformance:
+    @property
+    def elapsed(self) -> float: ...
+    @property
+    def step(self) -> float: ...
+    @property
+    def iae(self) -> float: ...
+    @property
+    def ise(self) -> float: ...
+    @property
+    def itae(self) -> float: ...
+    @property
+    def overshoot(self) -> float: ...
+    @property
+    def rise_time(self) -> float: ...
+    @property
+    def settling_time(self) -> float: ...
+    @property
+    def valve_travel(self) -> float: ...
+
+class LoopHealthSettings:
+    window: int
+    crossings: int
+    noise_band: float
+    regularity_threshold: float
+    spectral_threshold: float
+    ar_order: int
+    delay: int
+    harris_threshold: float
+
+class LoopHealthStatus:
+    @property
+    def oscillating(self) -> bool: ...
+    @property
+    def poor_performance(self) -> bool: ...
+    @property
+    def period(self) -> float: ...
+    @property
+    def regularity(self) -> float: ...
+    @property
+    def peak_period(self) -> float: ...
+    @property
+    def peak_fraction(self) -> float: ...
+    @property
+    def harris_index(self) -> float: ...
+    @property
+    def error_std_dev(self) -> float: ...
+    @property
+    def samples(self) -> int: ...
+
+class AlarmType(enum.Enum):
+    HIGH = ...
+    LOW = ...
+    RATE_OF_CHANGE = ...
+
+class AlarmConfig:
+    signal: SignalRef
+    type: AlarmType
+    limit: float
+    deadband: float
+    on_delay: float
+    off_delay: float
+
+class AlarmEvent:
+    @property
+    def alarm(self) -> int: ...
+    @property
+    def active(self) -> bool: ...
+    @property
+    def time(self) -> float: ...
+    @property
+    def value(self) -> float: ...
+
+class TelemetryFrame:
+    @property
+    def step(self) -> int: ...
+    @property
+    def time(self) -> float: ...
+    @property
+    def tank_level(self) -> float: ...
+    @property
+    def measured_level(self) -> float: ...
+    @property
+    def inlet_flow(self) -> float: ...
+    @property
+    def outlet_flow(self) -> float: ...
+    @property
+    def valve_position(self) -> float: ...
+    @property
+    def loop_count(self) -> int: ...
+    @property
+    def active_alarms(self) -> int: ...
+    @property
+    def setpoint(self) -> list[float]: ...
+    @property
+    def error(self) -> list[float]: ...
+    @property
+    def controller_output(self) -> list[float]: ...
+
+class FrameEncoder:
+    def __init__(self) -> None: ...
+    def encode_json(self, frame: TelemetryFrame) -> bytes: ...
+    def encode_binary(self, frame: TelemetryFrame) -> bytes: ...
+    def json_view(self, frame: TelemetryFrame) -> memoryview: ...
+    def binary_view(self, frame: TelemetryFrame) -> memoryview: ...
+    @staticmethod
+    def decode_binary(data: bytes) -> TelemetryFrame: ...
+    @staticmethod
+    def binary_size(loop_count: int) -> int: ...
+
+class DeltaSettings:
+    keyframe_interval: int
+    quantum: float
+    def __init__(self) -> None: ...
+
+class DeltaEncoder:
+    @overload
+    def __init__(self) -> None: ...
+    @overload
+    def __init__(self, settings: DeltaSettings) -> None: ...
+    def encode(self, frame: TelemetryFrame) -> bytes: ...
+    def force_keyframe(self) -> None: ...
+    @property
+    def last_was_keyframe(self) -> bool: ...
+
+class DeltaDecoder:
+    def __init__(self, quantum: float = 1e-6) -> None: ...
+    def decode(self, data: bytes) -> TelemetryFrame: ...
+    @property
+    def synchronized(self) -> bool: ...
+    def reset(self) -> None: ...
+
+class TelemetrySubscription:
+    def poll(self, max_frames: int = 0) -> list[TelemetryFrame]: ...
+    @property
+    def lost(self) -> int: ...
+
+class CatchUp(enum.Enum):
+    BURST = ...
+    SKIP = ...
+    REBASE = ...
+
+class PacingStats:
+    @property
+    def ticks(self) -> int: ...
+    @property
+    def skipped(self) -> int: ...
+    @property
+    def rebased(self) -> int: ...
+    @property
+    def mean_lateness_micros(self) -> float: ...
+    @property
+    def max_lateness_micros(self) -> float: ...
+    @property
+    def histogram(self) -> list[int]: ...
+    @property
+    def realtime(self) -> bool: ...
+    def percentile_micros(self, fraction: float) -> float: ...
+
+class SpeculationStats:
+    @property
+    def computed_steps(self) -> int: ...
+    @property
+    def served_ticks(self) -> int: ...
+    @property
+    def discarded_ticks(self) -> int: ...
+
+class SessionEngine:
+    def __init__(self, config: SimulatorConfig, max_sessions: int = 1000) -> None: ...
+    def start(
+        self,
+        tick_period: float = 1.0,
+        catch_up: CatchUp = ...,
+        realtime: bool = False,
+        cpu: int = -1,
+    ) -> None: ...
+    def stop(self) -> None: ...
+    def fileno(self) -> int: ...
+    def drain(self, max_frames: int = 0) -> list[tuple[int, float, str]]: ...
+    def join(self, session_key: int) -> None: ...
+    def leave(self, session_key: int) -> None: ...
+    def submit(self, session_key: int, command: OperatorCommand) -> None: ...
+    def export_session(self, session_key: int) -> None: ...
+    def take_exports(self) -> list[tuple[int, float, bytes | None]]: ...
+    def import_session(
+        self, session_key: int, snapshot: bytes, subscribers: int = 1, speed: float = 1.0
+    ) -> None: ...
+    @staticmethod
+    def session_key(name: str) -> int: ...
+    @property
+    def running(self) -> bool: ...
+    @property
+    def ticks(self) -> int: ...
+    @property
+    def session_count(self) -> int: ...
+    @property
+    def lost(self) -> int: ...
+    @property
+    def pacing_stats(self) -> PacingStats: ...
+    def attach_store(self, store: SharedSessionStore | None) -> None: ...
+    def enable_speculation(self, ticks: int) -> None: ...
+    @property
+    def speculation_stats(self) -> SpeculationStats: ...
+
+class SessionSample:
+    def __init__(
+        self,
+        time: float,
+        tank_level: float,
+        setpoint: float,
+        inlet_flow: float,
+        outlet_flow: float,
+        valve_position: float,
+        error: float,
+        controller_output: float,
+    ) -> None: ...
+    @property
+    def time(self) -> float: ...
+    @property
+    def tank_level(self) -> float: ...
+    @property
+    def setpoint(self) -> float: ...
+    @property
+    def inlet_flow(self) -> float: ...
+    @property
+    def outlet_flow(self) -> float: ...
+    @property
+    def valve_position(self) -> float: ...
+    @property
+    def error(self) -> float: ...
+    @property
+    def controller_output(self) -> float: ...
+
+class SharedSessionStore:
+    def __init__(self, name: str, slots: int) -> None: ...
+    @staticmethod
+    def attach(name: str) -> SharedSessionStore: ...
+    @staticmethod
+    def unlink(name: str) -> bool: ...
+    @property
+    def name(self) -> str: ...
+    @property
+    def slot_count(self) -> int: ...
+    def sessions(self) -> list[dict[str, int]]: ...
+    def latest(self, session_key: int) -> TelemetryFrame | None: ...
+    def history(self, session_key: int, since: float = ...) -> list[SessionSample]: ...
+    def reclaim_dead(self) -> int: ...
+
+class CompressedHistory:
+    def __init__(self) -> None: ...
+    def __len__(self) -> int: ...
+    @property
+    def nbytes(self) -> int: ...
+    def samples(self) -> list[SessionSample]: ...
+
+class CheckpointWriter:
+    def __init__(self) -> None: ...
+    def add(
+        self,
+        name: str,
+        simulator: Simulator,
+        history: Iterable[TelemetryFrame],
+        earlier: CompressedHistory | None = None,
+        metadata: bytes = b"",
+    ) -> None: ...
+    def add_snapshot(
+        self,
+        name: str,
+        snapshot: bytes,
+        history: Iterable[SessionSample],
+        metadata: bytes = b"",
+    ) -> None: ...
+    def __len__(self) -> int: ...
+    def write(self, path: str, threads: int = 0) -> int: ...
+
+class SessionCheckpoint:
+    def __init__(self, path: str) -> None: ...
+    def __len__(self) -> int: ...
+    def name(self, index: int) -> str: ...
+    def metadata(self, index: int) -> bytes: ...
+    def restore(self, index: int, simulator: Simulator) -> None: ...
+    def snapshot(self, index: int) -> bytes: ...
+    def history(self, index: int) -> CompressedHistory: ...
+
+class ShardRouter:
+    def __init__(self, socket_paths: list[str]) -> None: ...
+    def add_shard(self, socket_path: str) -> int: ...
+    def fileno(self) -> int: ...
+    def drain(self) -> list[tuple[int, float, str]]: ...
+    def join(self, session_key: int) -> None: ...
+    def leave(self, session_key: int) -> None: ...
+    def submit(self, session_key: int, command: OperatorCommand) -> None: ...
+    def migrate(self, session_key: int, shard: int) -> bool: ...
+    def drain_shard(self, shard: int) -> int: ...
+    def rebalance(self) -> int: ...
+    def export_session(self, session_key: int) -> bool: ...
+    def take_exports(self) -> list[tuple[int, float, bytes | None]]: ...
+    def import_session(
+        self, session_key: int, snapshot: bytes, subscribers: int = 1, speed: float = 1.0
+    ) -> None: ...
+    def shard_of(self, session_key: int) -> int: ...
+    def sessions_on(self, shard: int) -> int: ...
+    @property
+    def session_count(self) -> int: ...
+    @property
+    def shard_count(self) -> int: ...
+    @property
+    def migrations_in_flight(self) -> int: ...
+
+class CommandType(enum.Enum):
+    SET_SETPOINT = ...
+    SET_INPUT = ...
+    SET_GAINS = ...
+    RESET = ...
+    SET_SPEED = ...
+
+class OperatorCommand:
+    type: CommandType
+    index: int
+    value: float
+    gains: PIDGains
+    id: int
+
+class AppliedCommand:
+    @property
+    def id(self) -> int: ...
+    @property
+    def type(self) -> CommandType: ...
+    @property
+    def index(self) -> int: ...
+    @property
+    def accepted(self) -> bool: ...
+    @property
+    def time(self) -> float: ...
+    @property
+    def latency_micros(self) -> float: ...
+
+class CommandStats:
+    @property
+    def applied(self) -> int: ...
+    @property
+    def rejected(self) -> int: ...
+    @property
+    def results_dropped(self) -> int: ...
+    @property
+    def last_latency_micros(self) -> float: ...
+    @property
+    def mean_latency_micros(self) -> float: ...
+    @property
+    def max_latency_micros(self) -> float: ...
+
 class ControllerConfig:
     gains: PIDGains
     bias: float
@@ -17,6 +456,9 @@ class ControllerConfig:
     measured_index: int
     output_index: int
     initial_setpoint: float
+    measured_source: SignalSource
+    type: ControllerType
+    mpc: MPCSettings
 
 class TankModelParameters:
     area: float
@@ -29,13 +471,29 @@ class SimulatorConfig:
     dt: float
     initial_state: npt.NDArray[np.float64]
     initial_inputs: npt.NDArray[np.float64]
+    control_links: list[ControlLink]
+    gain_schedules: list[GainScheduleConfig]
+    sensor_noise_std: float
+    sensor_noise_seed: int
+    use_estimator: bool
+    estimator: EstimatorSettings
+    identify_model: bool
+    identifier: IdentifierSettings
+    performance: PerformanceSettings
+    monitor_loop_health: bool
+    loop_health: LoopHealthSettings
+    alarms: list[AlarmConfig]
+    stream_telemetry: bool
+    report_command_results: bool
 
 class Simulator:
     def __init__(self, config: SimulatorConfig) -> None: ...
-    def step(self) -> None: ...
+    def step(self, steps: int = 1) -> None: ...
     def reset(self) -> None: ...
     def get_state(self) -> npt.NDArray[np.float64]: ...
     def get_inputs(self) -> npt.NDArray[np.float64]: ...
+    def get_measured_state(self) -> npt.NDArray[np.float64]: ...
+    def get_estimated_state(self) -> npt.NDArray[np.float64]: ...
     def get_time(self) -> float: ...
     def get_setpoint(self, index: int) -> float: ...
     def get_error(self, index: int) -> float: ...
@@ -43,5 +501,55 @@ class Simulator:
     def set_setpoint(self, index: int, value: float) -> None: ...
     def set_input(self, index: int, value: float) -> None: ...
     def set_controller_gains(self, index: int, gains: PIDGains) -> None: ...
+    def get_mpc_stats(self, index: int) -> MPCSolveStats: ...
+    def get_identified_model(self) -> IdentifiedModel: ...
+    def get_performance(self) -> list[LoopPerformance]: ...
+    def get_loop_health(self) -> list[LoopHealthStatus]: ...
+    def drain_alarm_events(self) -> list[AlarmEvent]: ...
+    def get_active_alarms(self) -> list[int]: ...
+    def submit_command(self, command: OperatorCommand) -> bool: ...
+    def poll_applied_commands(self) -> list[AppliedCommand]: ...
+    def apply_pending_commands(self) -> int: ...
+    def get_command_stats(self) -> CommandStats: ...
+    def get_telemetry(self) -> TelemetryFrame: ...
+    def subscribe_telemetry(self, from_oldest: bool = False) -> TelemetrySubscription: ...
+    def capture_state(self) -> bytes: ...
+    def restore_state(self, snapshot: bytes) -> None: ...
+
+class RecordedData:
+    dt: float
+    inlet_flow: list[float]
+    valve_position: list[float]
+    level: list[float]
+
+class ParameterEstimatorSettings:
+    max_iterations: int
+    tolerance: float
+    initial_damping: float
+
+class ParameterFit:
+    @property
+    def params(self) -> TankModelParameters: ...
+    @property
+    def rms_residual(self) -> float: ...
+    @property
+    def iterations(self) -> int: ...
+    @property
+    def converged(self) -> bool: ...
+
+class ParameterEstimator:
+    @overload
+    def __init__(self) -> None: ...
+    @overload
+    def __init__(self, settings: ParameterEstimatorSettings) -> None: ...
+    def estimate(
+        self, data: RecordedData, initial_guess: TankModelParameters
+    ) -> ParameterFit: ...
+    def estimate_many(
+        self,
+        data: list[RecordedData],
+        initial_guesses: list[TankModelParameters],
+        threads: int = 0,
+    ) -> list[ParameterFit]: ...
 
 def get_version() -> str: ...
@@ -16,6 +16,11 @@ Tests serve dual purposes:
 2. Provide usage examples for Python users
 """
 
+import json
+import math
+import struct
+import threading
+
 import numpy as np
 import pytest
 
@@ -812,3 +817,648 @@ class TestEdgeCases:
 
         with pytest.raises((ValueError, RuntimeError)):
             tank_sim.Simulator(config)
+
+
+class TestControlLinks:
+    """Tests for cascade, ratio and feedforward control links."""
+
+    def test_feedforward_link_shifts_output(self, default_config):
+        """Verify a feedforward link adds gain * (signal - nominal) to the output.
+
+        Uses a P-only controller so the shift is exactly the feedforward term.
+        """
+        controller = default_config.controllers[0]
+        controller.gains.tau_I = 0.0
+        controller.gains.tau_D = 0.0
+        default_config.controllers = [controller]
+        baseline = tank_sim.Simulator(default_config)
+
+        link = tank_sim.ControlLink()
+        link.type = tank_sim.ControlLinkType.FEEDFORWARD
+        link.source = tank_sim.SignalRef(tank_sim.SignalSource.INPUT, 0)
+        link.target = 0
+        link.gain = 0.4
+        link.bias = 1.0
+        default_config.control_links = [link]
+        with_ff = tank_sim.Simulator(default_config)
+
+        for sim in (baseline, with_ff):
+            sim.set_input(0, 1.2)
+            sim.step()
+
+        shift = with_ff.get_controller_output(0) - baseline.get_controller_output(0)
+        assert shift == pytest.approx(0.4 * 0.2)
+
+    def test_cyclic_links_rejected(self, default_config):
+        """Verify a controller cannot drive its own setpoint."""
+        link = tank_sim.ControlLink()
+        link.type = tank_sim.ControlLinkType.CASCADE
+        link.source = tank_sim.SignalRef(tank_sim.SignalSource.CONTROLLER_OUTPUT, 0)
+        link.target = 0
+        link.gain = 1.0
+        link.bias = 0.0
+        default_config.control_links = [link]
+
+        with pytest.raises((ValueError, RuntimeError)):
+            tank_sim.Simulator(default_config)
+
+
+class TestMPC:
+    """Tests for the model predictive controller type."""
+
+    def test_mpc_tracks_setpoint_and_reports_stats(self, default_config):
+        """Verify an MPC controller reaches a new setpoint within output limits."""
+        controller = default_config.controllers[0]
+        controller.type = tank_sim.ControllerType.MPC
+        default_config.controllers = [controller]
+        sim = tank_sim.Simulator(default_config)
+        sim.set_setpoint(0, 3.0)
+
+        for _ in range(600):
+            sim.step()
+            assert 0.0 <= sim.get_inputs()[1] <= 1.0
+
+        assert sim.get_state()[0] == pytest.approx(3.0, abs=1e-3)
+        stats = sim.get_mpc_stats(0)
+        assert stats.solves == 600
+        assert stats.last_converged
+        assert stats.mean_micros > 0.0
+
+    def test_mpc_has_no_pid_gains(self, default_config):
+        """Verify PID-only operations are rejected for an MPC controller."""
+        controller = default_config.controllers[0]
+        controller.type = tank_sim.ControllerType.MPC
+        default_config.controllers = [controller]
+        sim = tank_sim.Simulator(default_config)
+
+        with pytest.raises(ValueError):
+            sim.set_controller_gains(0, tank_sim.PIDGains())
+
+
+class TestEstimator:
+    """Tests for sensor noise and the level estimator."""
+
+    def test_estimator_filters_sensor_noise(self, default_config):
+        """Verify the estimate tracks the true level better than the sensor."""
+        default_config.sensor_noise_std = 0.05
+        default_config.sensor_noise_seed = 1
+        default_config.use_estimator = True
+        default_config.estimator.measurement_noise = 0.05**2
+        sim = tank_sim.Simulator(default_config)
+
+        raw_sq = 0.0
+        est_sq = 0.0
+        for _ in range(500):
+            sim.step()
+            level = sim.get_state()[0]
+            raw_sq += (sim.get_measured_state()[0] - level) ** 2
+            est_sq += (sim.get_estimated_state()[0] - level) ** 2
+
+        assert est_sq < 0.25 * raw_sq
+
+
+class TestIdentifier:
+    """Tests for online model identification."""
+
+    def test_identifier_recovers_model(self, default_config):
+        """Verify area and k_v are recovered under setpoint excitation."""
+        default_config.identify_model = True
+        sim = tank_sim.Simulator(default_config)
+
+        for cycle in range(10):
+            sim.set_setpoint(0, 3.0 if cycle % 2 == 0 else 2.0)
+            sim.set_input(0, 1.2 if cycle % 3 == 0 else 0.8)
+            for _ in range(100):
+                sim.step()
+
+        model = sim.get_identified_model()
+        assert model.samples == 1000
+        assert model.area == pytest.approx(default_config.model_params.area, rel=0.01)
+        assert model.k_v == pytest.approx(default_config.model_params.k_v, rel=0.01)
+
+    def test_identifier_disabled_raises(self, default_config):
+        """Verify reading the model without identification enabled fails."""
+        sim = tank_sim.Simulator(default_config)
+        with pytest.raises(ValueError):
+            sim.get_identified_model()
+
+
+class TestPerformance:
+    """Tests for the streaming loop performance indices."""
+
+    def test_setpoint_step_indices(self, default_config):
+        """Verify a setpoint step yields rise, settling and integral indices."""
+        sim = tank_sim.Simulator(default_config)
+        sim.set_setpoint(0, 3.0)
+        for _ in range(1500):
+            sim.step()
+
+        kpi = sim.get_performance()[0]
+        assert kpi.step == pytest.approx(0.5, abs=1e-6)
+        assert kpi.elapsed == pytest.approx(1500.0)
+        assert kpi.iae > 0.0
+        assert kpi.valve_travel > 0.0
+        assert not math.isnan(kpi.rise_time)
+        assert not math.isnan(kpi.settling_time)
+
+    def test_reset_restarts_indices(self, default_config):
+        """Verify reset() clears the accumulated indices."""
+        sim = tank_sim.Simulator(default_config)
+        sim.set_setpoint(0, 3.0)
+        for _ in range(10):
+            sim.step()
+        sim.reset()
+
+        kpi = sim.get_performance()[0]
+        assert kpi.elapsed == 0.0
+        assert kpi.iae == 0.0
+
+
+class TestLoopHealth:
+    """Tests for online oscillation and performance monitoring."""
+
+    def test_aggressive_loop_flagged(self, default_config):
+        """Verify excessive integral action is flagged as oscillating."""
+        default_config.monitor_loop_health = True
+        controller = default_config.controllers[0]
+        controller.gains.tau_I = 0.5
+        default_config.controllers = [controller]
+        sim = tank_sim.Simulator(default_config)
+        sim.set_setpoint(0, 3.0)
+        for _ in range(2000):
+            sim.step()
+
+        health = sim.get_loop_health()[0]
+        assert health.oscillating
+        assert health.poor_performance
+        assert health.period > 0.0
+
+    def test_monitoring_disabled_raises(self, default_config):
+        """Verify reading loop health without monitoring enabled fails."""
+        sim = tank_sim.Simulator(default_config)
+        with pytest.raises(ValueError):
+            sim.get_loop_health()
+
+
+class TestAlarms:
+    """Tests for limit alarms and transition events."""
+
+    def test_high_alarm_emits_single_event(self, default_config):
+        """Verify a level rise raises one event and reset clears it."""
+        alarm = tank_sim.AlarmConfig()
+        alarm.signal = tank_sim.SignalRef(tank_sim.SignalSource.STATE, 0)
+        alarm.type = tank_sim.AlarmType.HIGH
+        alarm.limit = 2.6
+        alarm.deadband = 0.05
+        default_config.alarms = [alarm]
+        sim = tank_sim.Simulator(default_config)
+
+        sim.set_setpoint(0, 3.0)
+        for _ in range(300):
+            sim.step()
+
+        events = sim.drain_alarm_events()
+        assert len(events) == 1
+        assert events[0].alarm == 0
+        assert events[0].active
+        assert sim.get_active_alarms() == [0]
+        assert sim.drain_alarm_events() == []
+
+        sim.reset()
+        cleared = sim.drain_alarm_events()
+        assert len(cleared) == 1
+        assert not cleared[0].active
+
+    def test_invalid_alarm_rejected(self, default_config):
+        """Verify a negative deadband is rejected."""
+        alarm = tank_sim.AlarmConfig()
+        alarm.signal = tank_sim.SignalRef(tank_sim.SignalSource.STATE, 0)
+        alarm.type = tank_sim.AlarmType.HIGH
+        alarm.limit = 2.6
+        alarm.deadband = -1.0
+        default_config.alarms = [alarm]
+        with pytest.raises(ValueError):
+            tank_sim.Simulator(default_config)
+
+
+class TestTelemetry:
+    """Tests for the published telemetry frame."""
+
+    def test_frame_matches_getters(self, steady_state_simulator):
+        """Verify the frame carries the values of the last step."""
+        sim = steady_state_simulator
+        sim.set_setpoint(0, 3.0)
+        for _ in range(10):
+            sim.step()
+
+        frame = sim.get_telemetry()
+        assert frame.step == 10
+        assert frame.time == pytest.approx(sim.get_time())
+        assert frame.tank_level == pytest.approx(sim.get_state()[0])
+        assert frame.loop_count == 1
+        assert frame.setpoint == [3.0]
+        assert frame.controller_output[0] == pytest.approx(sim.get_controller_output(0))
+
+    def test_reader_thread_sees_consistent_frames(self, steady_state_simulator):
+        """Verify a reader thread never sees a half-written frame."""
+        sim = steady_state_simulator
+        stop = threading.Event()
+        bad = []
+
+        def read():
+            while not stop.is_set():
+                frame = sim.get_telemetry()
+                if frame.time != pytest.approx(frame.step * 1.0):
+                    bad.append(frame.step)
+
+        reader = threading.Thread(target=read)
+        reader.start()
+        for _ in range(2000):
+            sim.step()
+        stop.set()
+        reader.join()
+        assert bad == []
+
+    def test_subscriptions_receive_every_step(self, steady_state_simulator):
+        """Verify each subscription gets each step's frame, in order."""
+        sim = steady_state_simulator
+        first = sim.subscribe_telemetry()
+        for _ in range(5):
+            sim.step()
+        second = sim.subscribe_telemetry(from_oldest=True)
+        sim.step()
+
+        assert [f.step for f in first.poll()] == [1, 2, 3, 4, 5, 6]
+        assert [f.step for f in second.poll()] == [0, 1, 2, 3, 4, 5, 6]
+        assert first.poll() == []
+        assert first.lost == 0
+
+    def test_slow_subscription_counts_lost_frames(self, steady_state_simulator):
+        """Verify a subscription that falls behind skips ahead."""
+        sim = steady_state_simulator
+        sub = sim.subscribe_telemetry()
+        for _ in range(1000):
+            sim.step()
+
+        frames = sub.poll()
+        assert sub.lost + len(frames) == 1000
+        assert sub.lost > 0
+        assert frames[-1].step == 1000
+        steps = [f.step for f in frames]
+        assert steps == list(range(steps[0], 1001))
+
+
+class TestFrameEncoder:
+    """Tests for native frame serialization."""
+
+    def test_json_matches_state_message(self, steady_state_simulator):
+        """Verify the JSON has the frontend's state schema and exact values."""
+        sim = steady_state_simulator
+        sim.set_setpoint(0, 3.0)
+        for _ in range(5):
+            sim.step()
+        frame = sim.get_telemetry()
+
+        message = json.loads(tank_sim.FrameEncoder().encode_json(frame))
+        assert message["type"] == "state"
+        assert message["data"] == {
+            "time": frame.time,
+            "tank_level": frame.tank_level,
+            "setpoint": 3.0,
+            "inlet_flow": frame.inlet_flow,
+            "outlet_flow": frame.outlet_flow,
+            "valve_position": frame.valve_position,
+            "error": frame.error[0],
+            "controller_output": frame.controller_output[0],
+        }
+
+    def test_binary_layout_and_round_trip(self, steady_state_simulator):
+        """Verify the little-endian record layout and decoding."""
+        sim = steady_state_simulator
+        sim.step()
+        frame = sim.get_telemetry()
+        encoder = tank_sim.FrameEncoder()
+
+        record = encoder.encode_binary(frame)
+        assert len(record) == tank_sim.FrameEncoder.binary_size(1)
+        kind, version, loops, alarms, step = struct.unpack_from("<BBHiQ", record)
+        assert (kind, version, loops, alarms, step) == (1, 1, 1, 0, 1)
+        time, level = struct.unpack_from("<2d", record, 16)
+        assert (time, level) == (frame.time, frame.tank_level)
+
+        decoded = tank_sim.FrameEncoder.decode_binary(encoder.binary_view(frame))
+        assert decoded.tank_level == frame.tank_level
+        assert decoded.controller_output == frame.controller_output
+
+        with pytest.raises(ValueError):
+            tank_sim.FrameEncoder.decode_binary(record[:-1])
+
+
+class TestDeltaFrames:
+    """Tests for delta-encoded frame streams."""
+
+    def test_stream_round_trips_with_keyframes(self, steady_state_simulator):
+        """Verify keyframe spacing, record sizes and decoded values."""
+        sim = steady_state_simulator
+        settings = tank_sim.DeltaSettings()
+        settings.keyframe_interval = 10
+        encoder = tank_sim.DeltaEncoder(settings)
+        decoder = tank_sim.DeltaDecoder(settings.quantum)
+        sim.set_setpoint(0, 3.0)
+
+        keyframes = 0
+        for _ in range(30):
+            sim.step()
+            frame = sim.get_telemetry()
+            record = encoder.encode(frame)
+            if encoder.last_was_keyframe:
+                keyframes += 1
+            else:
+                assert len(record) < tank_sim.FrameEncoder.binary_size(1)
+            decoded = decoder.decode(record)
+            assert decoded.step == frame.step
+            assert decoded.tank_level == pytest.approx(frame.tank_level, abs=1e-6)
+        assert keyframes == 3
+
+    def test_delta_before_keyframe_is_rejected(self, steady_state_simulator):
+        """Verify a decoder that missed the keyframe raises."""
+        sim = steady_state_simulator
+        encoder = tank_sim.DeltaEncoder()
+        encoder.encode(sim.get_telemetry())
+        sim.step()
+        delta = encoder.encode(sim.get_telemetry())
+
+        decoder = tank_sim.DeltaDecoder()
+        assert not decoder.synchronized
+        with pytest.raises(ValueError):
+            decoder.decode(delta)
+
+
+class TestCommandQueue:
+    """Tests for queued operator commands."""
+
+    def test_commands_apply_on_next_step(self, steady_state_simulator):
+        """Verify queued commands take effect in order at the next step."""
+        sim = steady_state_simulator
+        setpoint = tank_sim.OperatorCommand()
+        setpoint.type = tank_sim.CommandType.SET_SETPOINT
+        setpoint.index = 0
+        setpoint.value = 3.0
+        setpoint.id = 1
+        bad = tank_sim.OperatorCommand()
+        bad.type = tank_sim.CommandType.SET_INPUT
+        bad.index = 9
+        bad.id = 2
+        assert sim.submit_command(setpoint)
+        assert sim.submit_command(bad)
+
+        assert sim.get_setpoint(0) == 2.5
+        sim.step()
+        assert sim.get_setpoint(0) == 3.0
+
+        results = sim.poll_applied_commands()
+        assert [r.id for r in results] == [1, 2]
+        assert results[0].accepted
+        assert results[0].time == 0.0
+        assert not results[1].accepted
+        stats = sim.get_command_stats()
+        assert stats.applied == 2
+        assert stats.rejected == 1
+
+
+class TestSessionEngine:
+    """Tests for the natively ticked session engine and its wakeup descriptor."""
+
+    def test_drain_after_signal_returns_each_sessions_frames(self, default_config):
+        """Verify one readable signal yields the frames of every session."""
+        import select
+
+        engine = tank_sim.SessionEngine(default_config, max_sessions=4)
+        plant = tank_sim.SessionEngine.session_key("plant")
+        other = tank_sim.SessionEngine.session_key("other")
+        engine.join(plant)
+        engine.join(other)
+        setpoint = tank_sim.OperatorCommand()
+        setpoint.type = tank_sim.CommandType.SET_SETPOINT
+        setpoint.value = 3.0
+        engine.submit(plant, setpoint)
+
+        engine.start(tick_period=0.01)
+        try:
+            readable, _, _ = select.select([engine.fileno()], [], [], 2.0)
+            assert readable
+            frames = engine.drain()
+        finally:
+            engine.stop()
+        assert not engine.running
+
+        assert {key for key, _, _ in frames} == {plant, other}
+        for key, time, message in frames:
+            state = json.loads(message)
+            assert state["type"] == "state"
+            assert state["data"]["time"] == time
+            assert state["data"]["setpoint"] == (3.0 if key == plant else 2.5)
+        assert engine.session_count == 2
+        assert engine.ticks >= 1
+
+    def test_invalid_period_and_double_start_rejected(self, default_config):
+        """Verify start() validates the period and refuses to run twice."""
+        engine = tank_sim.SessionEngine(default_config)
+        with pytest.raises(ValueError):
+            engine.start(tick_period=0.0)
+        engine.start(tick_period=60.0)
+        try:
+            with pytest.raises(RuntimeError):
+                engine.start()
+        finally:
+            engine.stop()
+
+    def test_pacing_stats_count_every_tick(self, default_config):
+        """Verify the lateness histogram covers every tick and the catch-up policy is accepted."""
+        import time
+
+        engine = tank_sim.SessionEngine(default_config)
+        assert engine.pacing_stats.ticks == 0
+        engine.start(tick_period=0.005, catch_up=tank_sim.CatchUp.SKIP)
+        time.sleep(0.1)
+        engine.stop()
+
+        stats = engine.pacing_stats
+        assert stats.ticks == engine.ticks
+        assert stats.ticks >= 10
+        assert sum(stats.histogram) == stats.ticks
+        assert stats.max_lateness_micros >= stats.mean_lateness_micros
+        assert stats.percentile_micros(0.5) <= stats.percentile_micros(0.99)
+        assert not stats.realtime
+        with pytest.raises(ValueError):
+            engine.start(tick_period=0.005, realtime=True, cpu=-2)
+
+
+class TestSharedSessionStore:
+    """Tests for reading engine sessions through shared memory."""
+
+    def test_attached_store_sees_the_engine_sessions(self, default_config):
+        """Verify another store object on the same name reads exported sessions."""
+        import os
+        import select
+
+        name = f"/tank_sim_pytest_{os.getpid()}"
+        store = tank_sim.SharedSessionStore(name, slots=4)
+        try:
+            reader = tank_sim.SharedSessionStore.attach(name)
+            engine = tank_sim.SessionEngine(default_config)
+            engine.attach_store(store)
+            key = tank_sim.SessionEngine.session_key("shared:plant")
+            engine.join(key)
+            assert reader.latest(key) is None
+
+            engine.start(tick_period=0.01)
+            try:
+                readable, _, _ = select.select([engine.fileno()], [], [], 2.0)
+                assert readable
+                with pytest.raises(RuntimeError):
+                    engine.attach_store(None)
+            finally:
+                engine.stop()
+
+            frame = reader.latest(key)
+            assert frame is not None
+            history = reader.history(key)
+            assert history[-1].time == frame.time
+            assert history[-1].setpoint == 2.5
+            assert reader.history(key, since=frame.time) == []
+            assert [s["session_key"] for s in reader.sessions()] == [key]
+            assert reader.sessions()[0]["owner_pid"] == os.getpid()
+        finally:
+            tank_sim.SharedSessionStore.unlink(name)
+
+    def test_invalid_names_and_missing_segments_rejected(self):
+        """Verify bad names raise ValueError and absent segments RuntimeError."""
+        with pytest.raises(ValueError):
+            tank_sim.SharedSessionStore("no_slash", slots=4)
+        with pytest.raises(RuntimeError):
+            tank_sim.SharedSessionStore.attach("/tank_sim_pytest_missing")
+
+
+class TestStateSnapshots:
+    """Tests for capturing and restoring simulator state."""
+
+    def test_restored_simulator_continues_identically(self, default_config):
+        """Verify a fresh simulator restored from a snapshot follows the original."""
+        sim = tank_sim.Simulator(default_config)
+        sim.set_setpoint(0, 3.0)
+        for _ in range(20):
+            sim.step()
+        snapshot = sim.capture_state()
+        assert isinstance(snapshot, bytes)
+
+        copy = tank_sim.Simulator(default_config)
+        copy.restore_state(snapshot)
+        assert copy.get_time() == sim.get_time()
+        assert copy.get_setpoint(0) == 3.0
+        for _ in range(20):
+            sim.step()
+            copy.step()
+            assert copy.get_state()[0] == sim.get_state()[0]
+
+    def test_foreign_snapshots_rejected(self, default_config):
+        """Verify truncated snapshots and other configurations raise ValueError."""
+        sim = tank_sim.Simulator(default_config)
+        with pytest.raises(ValueError):
+            sim.restore_state(b"not a snapshot")
+
+        default_config.controllers = []
+        snapshot = tank_sim.Simulator(default_config).capture_state()
+        with pytest.raises(ValueError):
+            sim.restore_state(snapshot)
+
+
+class TestShardRouter:
+    """Tests for the shard router's argument checks."""
+
+    def test_needs_reachable_shards(self, tmp_path):
+        """Verify an empty list raises ValueError and a missing shard RuntimeError."""
+        with pytest.raises(ValueError):
+            tank_sim.ShardRouter([])
+        with pytest.raises(RuntimeError):
+            tank_sim.ShardRouter([str(tmp_path / "missing.sock")])
+
+
+class TestSessionCheckpoint:
+    """Tests for writing and restoring session checkpoints."""
+
+    def test_sessions_resume_with_their_history(self, default_config, tmp_path):
+        """Verify a checkpointed session restores its state, metadata and history."""
+        sim = tank_sim.Simulator(default_config)
+        frames = []
+        for _ in range(50):
+            sim.step()
+            frames.append(sim.get_telemetry())
+
+        writer = tank_sim.CheckpointWriter()
+        writer.add("plant", sim, frames, metadata=b'{"inlet_mode": "constant"}')
+        path = str(tmp_path / "sessions.ckp")
+        assert writer.write(path) > 0
+
+        checkpoint = tank_sim.SessionCheckpoint(path)
+        assert len(checkpoint) == 1
+        assert checkpoint.name(0) == "plant"
+        assert checkpoint.metadata(0) == b'{"inlet_mode": "constant"}'
+        copy = tank_sim.Simulator(default_config)
+        checkpoint.restore(0, copy)
+        assert copy.get_time() == sim.get_time()
+        history = checkpoint.history(0)
+        assert len(history) == 50
+        assert [s.time for s in history.samples()] == [f.time for f in frames]
+        assert history.samples()[-1].tank_level == frames[-1].tank_level
+
+    def test_invalid_files_rejected(self, default_config, tmp_path):
+        """Verify missing or foreign files raise RuntimeError and bad indices IndexError."""
+        with pytest.raises(RuntimeError):
+            tank_sim.SessionCheckpoint(str(tmp_path / "missing.ckp"))
+        junk = tmp_path / "junk.ckp"
+        junk.write_bytes(b"not a checkpoint at all, just some bytes")
+        with pytest.raises(RuntimeError):
+            tank_sim.SessionCheckpoint(str(junk))
+
+        writer = tank_sim.CheckpointWriter()
+        writer.add("plant", tank_sim.Simulator(default_config), [])
+        path = str(tmp_path / "sessions.ckp")
+        writer.write(path)
+        with pytest.raises(IndexError):
+            tank_sim.SessionCheckpoint(path).name(1)
+
+
+class TestParameterEstimator:
+    """Tests for offline calibration from recorded data."""
+
+    def test_estimate_many_recovers_parameters(self, default_config):
+        """Verify recorded open-loop runs are fitted back to their parameters."""
+        default_config.controllers = []
+        sim = tank_sim.Simulator(default_config)
+        level, inlet_flow, valve_position = [], [], []
+        for k in range(600):
+            if k % 150 == 0:
+                sim.set_input(0, 1.3 if k % 300 == 0 else 0.7)
+            level.append(float(sim.get_state()[0]))
+            inlet_flow.append(float(sim.get_inputs()[0]))
+            valve_position.append(float(sim.get_inputs()[1]))
+            sim.step()
+
+        # pybind11 converts lists by value, so assign them whole
+        record = tank_sim.RecordedData()
+        record.dt = default_config.dt
+        record.level = level
+        record.inlet_flow = inlet_flow
+        record.valve_position = valve_position
+
+        guess = tank_sim.TankModelParameters()
+        guess.area = 80.0
+        guess.k_v = 2.0
+        guess.max_height = 5.0
+        fits = tank_sim.ParameterEstimator().estimate_many([record, record], [guess, guess], 2)
+
+        for fit in fits:
+            assert fit.converged
+            assert fit.params.area == pytest.approx(default_config.model_params.area, rel=1e-4)
+            assert fit.params.k_v == pytest.approx(default_config.model_params.k_v, rel=1e-4)
@@ -0,0 +1,181 @@
+#include <gtest/gtest.h>
+#include <Eigen/Dense>
+#include <stdexcept>
+#include <vector>
+#include "../src/alarm_evaluator.h"
+#include "../src/simulator.h"
+#include "../src/constants.h"
+
+using namespace tank_sim;
+using namespace tank_sim::constants;
+
+namespace {
+
+AlarmEvaluator::Alarm makeAlarm(AlarmEvaluator::Type type, double limit, double deadband = 0.0,
+                                double on_delay = 0.0, double off_delay = 0.0) {
+    AlarmEvaluator::Alarm alarm;
+    alarm.signal = SignalRef{SignalRef::Source::State, 0};
+    alarm.type = type;
+    alarm.limit = limit;
+    alarm.deadband = deadband;
+    alarm.onDelay = on_delay;
+    alarm.offDelay = off_delay;
+    return alarm;
+}
+
+// Feed a series of values to a single-alarm evaluator; returns the events
+std::vector<AlarmEvent> run(AlarmEvaluator& evaluator, const std::vector<double>& series) {
+    double time = 0.0;
+    for (double v : series) {
+        time += 1.0;
+        evaluator.evaluate({v}, time, 1.0);
+    }
+    std::vector<AlarmEvent> events;
+    evaluator.drainEvents(events);
+    return events;
+}
+
+}  // namespace
+
+TEST(AlarmEvaluatorTest, RejectsInvalidAlarms) {
+    EXPECT_THROW(AlarmEvaluator({makeAlarm(AlarmEvaluator::Type::High, 1.0, -0.1)}),
+                 std::invalid_argument);
+    EXPECT_THROW(AlarmEvaluator({makeAlarm(AlarmEvaluator::Type::High, 1.0, 0.0, -1.0)}),
+                 std::invalid_argument);
+    EXPECT_THROW(AlarmEvaluator({makeAlarm(AlarmEvaluator::Type::RateOfChange, 0.0)}),
+                 std::invalid_argument);
+    EXPECT_THROW(AlarmEvaluator({}, 0), std::invalid_argument);
+}
+
+TEST(AlarmEvaluatorTest, HighAlarmWithDeadbandEmitsOnlyTransitions) {
+    AlarmEvaluator evaluator({makeAlarm(AlarmEvaluator::Type::High, 4.0, 0.2)});
+    evaluator.reset({3.0}, 0.0);
+
+    // Chatter between 3.85 and 4.05 only raises once; clears below 3.8
+    auto events = run(evaluator, {3.9, 4.05, 3.9, 4.05, 3.85, 3.79, 3.9});
+    ASSERT_EQ(events.size(), 2u);
+    EXPECT_TRUE(events[0].active);
+    EXPECT_DOUBLE_EQ(events[0].time, 2.0);
+    EXPECT_DOUBLE_EQ(events[0].value, 4.05);
+    EXPECT_FALSE(events[1].active);
+    EXPECT_DOUBLE_EQ(events[1].time, 6.0);
+    EXPECT_FALSE(evaluator.isActive(0));
+}
+
+TEST(AlarmEvaluatorTest, LowAlarmMirrorsHigh) {
+    AlarmEvaluator evaluator({makeAlarm(AlarmEvaluator::Type::Low, 1.0, 0.1)});
+    evaluator.reset({2.0}, 0.0);
+
+    auto events = run(evaluator, {1.5, 0.9, 1.05, 1.11});
+    ASSERT_EQ(events.size(), 2u);
+    EXPECT_TRUE(events[0].active);
+    EXPECT_DOUBLE_EQ(events[0].time, 2.0);
+    EXPECT_FALSE(events[1].active);
+    EXPECT_DOUBLE_EQ(events[1].time, 4.0);
+}
+
+TEST(AlarmEvaluatorTest, OnAndOffDelaysSuppressShortExcursions) {
+    AlarmEvaluator evaluator({makeAlarm(AlarmEvaluator::Type::High, 4.0, 0.0, 3.0, 2.0)});
+    evaluator.reset({3.0}, 0.0);
+
+    // Two samples high: no alarm. Three samples high: raised on the third.
+    // One sample low: stays active. Two samples low: cleared on the second.
+    auto events = run(evaluator, {5.0, 5.0, 3.0, 5.0, 5.0, 5.0, 3.0, 5.0, 3.0, 3.0});
+    ASSERT_EQ(events.size(), 2u);
+    EXPECT_TRUE(events[0].active);
+    EXPECT_DOUBLE_EQ(events[0].time, 6.0);
+    EXPECT_FALSE(events[1].active);
+    EXPECT_DOUBLE_EQ(events[1].time, 10.0);
+}
+
+TEST(AlarmEvaluatorTest, RateOfChangeUsesAbsoluteRate) {
+    AlarmEvaluator evaluator({makeAlarm(AlarmEvaluator::Type::RateOfChange, 0.5, 0.1)});
+    evaluator.reset({2.0}, 0.0);
+
+    auto events = run(evaluator, {2.1, 1.4, 0.95, 0.7, 0.7});
+    ASSERT_EQ(events.size(), 2u);
+    EXPECT_TRUE(events[0].active);
+    EXPECT_DOUBLE_EQ(events[0].time, 2.0);
+    EXPECT_NEAR(events[0].value, 0.7, 1e-12);
+    EXPECT_FALSE(events[1].active);
+    EXPECT_DOUBLE_EQ(events[1].time, 4.0);  // |rate| 0.25 < 0.4
+}
+
+TEST(AlarmEvaluatorTest, EventRingDropsOldest) {
+    AlarmEvaluator evaluator({makeAlarm(AlarmEvaluator::Type::High, 0.0)}, 4);
+    evaluator.reset({-1.0}, 0.0);
+
+    auto events = run(evaluator, {1.0, -1.0, 1.0, -1.0, 1.0, -1.0});
+    ASSERT_EQ(events.size(), 4u);
+    EXPECT_DOUBLE_EQ(events.front().time, 3.0);
+    EXPECT_DOUBLE_EQ(events.back().time, 6.0);
+    EXPECT_EQ(evaluator.droppedEvents(), 2);
+    EXPECT_EQ(evaluator.pendingEvents(), 0);
+}
+
+TEST(AlarmEvaluatorTest, SimulatorRaisesAndClearsLevelAlarm) {
+    Simulator::Config config;
+    config.params = TankModel::Parameters{DEFAULT_TANK_AREA, DEFAULT_VALVE_COEFFICIENT,
+                                          TANK_MAX_HEIGHT};
+    config.initialState = Eigen::VectorXd(1);
+    config.initialState << TANK_NOMINAL_HEIGHT;
+    config.initialInputs = Eigen::VectorXd(2);
+    config.initialInputs << TEST_INLET_FLOW, TEST_VALVE_POSITION;
+    config.dt = TEST_DT;
+    config.alarms.push_back(makeAlarm(AlarmEvaluator::Type::High, TANK_NOMINAL_HEIGHT + 0.1, 0.02));
+
+    Simulator sim(config);
+    sim.setInput(INPUT_INDEX_INLET_FLOW, 1.5);
+    for (int k = 0; k < 60; ++k) {
+        sim.step();
+    }
+    auto raised = sim.drainAlarmEvents();
+    ASSERT_EQ(raised.size(), 1u);
+    EXPECT_TRUE(raised[0].active);
+    EXPECT_EQ(sim.getActiveAlarms(), std::vector<int>{0});
+    EXPECT_TRUE(sim.drainAlarmEvents().empty());
+
+    // Reset clears the alarm with an event
+    sim.reset();
+    auto cleared = sim.drainAlarmEvents();
+    ASSERT_EQ(cleared.size(), 1u);
+    EXPECT_FALSE(cleared[0].active);
+    EXPECT_TRUE(sim.getActiveAlarms().empty());
+
+    config.alarms[0].signal = SignalRef{SignalRef::Source::ControllerOutput, 0};
+    EXPECT_THROW(Simulator{config}, std::invalid_argument);
+}
+
+TEST(AlarmEvaluatorTest, RestoredSnapshotKeepsActiveAlarmsWithoutEvents) {
+    Simulator::Config config;
+    config.params = TankModel::Parameters{DEFAULT_TANK_AREA, DEFAULT_VALVE_COEFFICIENT,
+                                          TANK_MAX_HEIGHT};
+    config.initialState = Eigen::VectorXd(1);
+    config.initialState << TANK_NOMINAL_HEIGHT;
+    config.initialInputs = Eigen::VectorXd(2);
+    config.initialInputs << TEST_INLET_FLOW, TEST_VALVE_POSITION;
+    config.dt = TEST_DT;
+    config.alarms.push_back(makeAlarm(AlarmEvaluator::Type::High, TANK_NOMINAL_HEIGHT + 0.1, 0.02));
+
+    Simulator sim(config);
+    sim.setInput(INPUT_INDEX_INLET_FLOW, 1.5);
+    for (int k = 0; k < 60; ++k) {
+        sim.step();
+    }
+    ASSERT_EQ(sim.drainAlarmEvents().size(), 1u);
+    const SimulatorSnapshot snapshot = sim.captureState();
+
+    // Into a fresh simulator: active at once, no raise event
+    Simulator copy(config);
+    copy.restoreState(snapshot);
+    EXPECT_EQ(copy.getActiveAlarms(), std::vector<int>{0});
+    EXPECT_TRUE(copy.drainAlarmEvents().empty());
+    copy.step();
+    EXPECT_TRUE(copy.drainAlarmEvents().empty());
+
+    // Into the running simulator: no clear-then-raise
+    sim.restoreState(snapshot);
+    sim.step();
+    EXPECT_TRUE(sim.drainAlarmEvents().empty());
+    EXPECT_EQ(sim.getActiveAlarms(), std::vector<int>{0});
+}
@@ -0,0 +1,223 @@
+#include <gtest/gtest.h>
+#include <Eigen/Dense>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include "../src/broadcast_ring.h"
+#include "../src/simulator.h"
+#include "../src/telemetry.h"
+#include "../src/constants.h"
+
+using namespace tank_sim;
+using namespace tank_sim::constants;
+
+namespace {
+
+// Payload whose words must all agree; a torn read mixes two values
+struct Pattern {
+    std::array<std::uint64_t, 21> words;
+};
+
+Pattern makePattern(std::uint64_t value) {
+    Pattern p;
+    p.words.fill(value);
+    return p;
+}
+
+bool consistent(const Pattern& p) {
+    for (auto w : p.words) {
+        if (w != p.words[0]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+using Ring = BroadcastRing<Pattern, 16>;
+
+}  // namespace
+
+TEST(BroadcastRingTest, EveryConsumerSeesValuesInOrder) {
+    Ring ring;
+    Ring::Cursor a = ring.subscribe();
+    Ring::Cursor b = ring.subscribe();
+    Pattern out;
+    EXPECT_EQ(ring.read(a, out), Ring::ReadStatus::Empty);
+
+    for (std::uint64_t k = 1; k <= 10; ++k) {
+        ring.publish(makePattern(k));
+    }
+    EXPECT_EQ(ring.published(), 10u);
+
+    // Each cursor reads independently of the other
+    for (std::uint64_t k = 1; k <= 10; ++k) {
+        ASSERT_EQ(ring.read(a, out), Ring::ReadStatus::Ok);
+        EXPECT_EQ(out.words[0], k);
+    }
+    EXPECT_EQ(ring.read(a, out), Ring::ReadStatus::Empty);
+    ASSERT_EQ(ring.read(b, out), Ring::ReadStatus::Ok);
+    EXPECT_EQ(out.words[0], 1u);
+
+    // A late subscriber starts after the latest value
+    Ring::Cursor late = ring.subscribe();
+    EXPECT_EQ(ring.read(late, out), Ring::ReadStatus::Empty);
+    ring.publish(makePattern(11));
+    ASSERT_EQ(ring.read(late, out), Ring::ReadStatus::Ok);
+    EXPECT_EQ(out.words[0], 11u);
+    EXPECT_EQ(a.lost + b.lost + late.lost, 0u);
+}
+
+TEST(BroadcastRingTest, SlowConsumerDetectsOverrun) {
+    Ring ring;
+    Ring::Cursor cursor = ring.subscribe();
+    for (std::uint64_t k = 0; k < 40; ++k) {
+        ring.publish(makePattern(k));
+    }
+
+    // Only the last N - 1 values are retained
+    Pattern out;
+    ASSERT_EQ(ring.read(cursor, out), Ring::ReadStatus::Overrun);
+    EXPECT_EQ(cursor.lost, 40u - 15u);
+    ASSERT_EQ(ring.read(cursor, out), Ring::ReadStatus::Ok);
+    EXPECT_EQ(out.words[0], 25u);
+
+    Ring::Cursor oldest = ring.subscribeOldest();
+    ASSERT_EQ(ring.read(oldest, out), Ring::ReadStatus::Ok);
+    EXPECT_EQ(out.words[0], 25u);
+    EXPECT_EQ(oldest.lost, 0u);
+}
+
+TEST(BroadcastRingTest, ConcurrentConsumersNeverSeeTornOrReorderedValues) {
+    BroadcastRing<Pattern, 64> ring;
+    constexpr std::uint64_t COUNT = 200000;
+    std::atomic<int> ready{0};
+    std::atomic<int> errors{0};
+
+    // Every value is either read or counted as lost, exactly once
+    std::vector<std::uint64_t> accounted(4, 0);
+    std::vector<std::thread> consumers;
+    for (int c = 0; c < 4; ++c) {
+        consumers.emplace_back([&, c]() {
+            auto cursor = ring.subscribe();
+            ++ready;
+            std::uint64_t expected = 0;
+            std::uint64_t read = 0;
+            Pattern out;
+            while (expected < COUNT) {
+                auto status = ring.read(cursor, out);
+                if (status == decltype(ring)::ReadStatus::Ok) {
+                    if (!consistent(out) || out.words[0] < expected) {
+                        ++errors;
+                    }
+                    expected = out.words[0] + 1;
+                    ++read;
+                } else if (status == decltype(ring)::ReadStatus::Empty) {
+                    std::this_thread::yield();
+                }
+            }
+            accounted[c] = read + cursor.lost;
+        });
+    }
+
+    while (ready.load() < 4) {
+        std::this_thread::yield();
+    }
+    for (std::uint64_t k = 0; k < COUNT; ++k) {
+        ring.publish(makePattern(k));
+    }
+    for (auto& t : consumers) {
+        t.join();
+    }
+
+    EXPECT_EQ(errors.load(), 0);
+    for (auto total : accounted) {
+        EXPECT_EQ(total, COUNT);
+    }
+}
+
+TEST(BroadcastRingTest, SimulatorStreamsOneFramePerStep) {
+    Simulator::Config config;
+    config.params = TankModel::Parameters{DEFAULT_TANK_AREA, DEFAULT_VALVE_COEFFICIENT,
+                                          TANK_MAX_HEIGHT};
+    config.initialState = Eigen::VectorXd(1);
+    config.initialState << TANK_NOMINAL_HEIGHT;
+    config.initialInputs = Eigen::VectorXd(2);
+    config.initialInputs << TEST_INLET_FLOW, TEST_VALVE_POSITION;
+    config.dt = TEST_DT;
+
+    Simulator::ControllerConfig ctrl;
+    ctrl.gains = PIDController::Gains{-1.0, 10.0, 0.0};
+    ctrl.bias = TEST_VALVE_POSITION;
+    ctrl.minOutputLimit = 0.0;
+    ctrl.maxOutputLimit = 1.0;
+    ctrl.maxIntegralAccumulation = 10.0;
+    ctrl.measuredIndex = 0;
+    ctrl.outputIndex = 1;
+    ctrl.initialSetpoint = TANK_NOMINAL_HEIGHT;
+    config.controllerConfig.push_back(ctrl);
+
+    Simulator sim(config);
+
+    // The initial frame is retained for late subscribers
+    auto history = sim.subscribeTelemetry(true);
+    TelemetryFrame frame;
+    ASSERT_EQ(sim.readTelemetry(history, frame), Simulator::TelemetryRing::ReadStatus::Ok);
+    EXPECT_EQ(frame.step, 0u);
+
+    // Setpoint changes update the latest frame but are not new ticks
+    auto live = sim.subscribeTelemetry();
+    sim.setSetpoint(0, TANK_NOMINAL_HEIGHT + 0.5);
+    EXPECT_EQ(sim.readTelemetry(live, frame), Simulator::TelemetryRing::ReadStatus::Empty);
+
+    std::atomic<bool> done{false};
+    std::atomic<int> gaps{0};
+    std::uint64_t received = 0;
+    auto cursor = sim.subscribeTelemetry();
+    std::thread consumer([&]() {
+        std::uint64_t last = 0;
+        TelemetryFrame f;
+        for (;;) {
+            const bool finished = done.load(std::memory_order_acquire);
+            auto status = sim.readTelemetry(cursor, f);
+            if (status == Simulator::TelemetryRing::ReadStatus::Ok) {
+                if (f.step != last + 1 || f.time != f.step * TEST_DT) {
+                    ++gaps;
+                }
+                last = f.step;
+                ++received;
+            } else if (status == Simulator::TelemetryRing::ReadStatus::Overrun) {
+                last = cursor.next - 1;  // frame k of the stream is step k
+            } else if (finished) {
+                break;
+            }
+        }
+        received += cursor.lost;
+    });
+
+    for (int k = 0; k < 3000; ++k) {
+        sim.step();
+    }
+    done.store(true, std::memory_order_release);
+    consumer.join();
+
+    EXPECT_EQ(gaps.load(), 0);
+    EXPECT_EQ(received, 3000u);
+
+    // Steps and the reset are all in the stream, in order
+    sim.reset();
+    int steps = 0;
+    for (;;) {
+        auto status = sim.readTelemetry(live, frame);
+        if (status == Simulator::TelemetryRing::ReadStatus::Empty) {
+            break;
+        }
+        if (status == Simulator::TelemetryRing::ReadStatus::Ok) {
+            ++steps;
+        }
+    }
+    EXPECT_EQ(live.lost, 3001u - (TELEMETRY_RING_CAPACITY - 1));
+    EXPECT_EQ(frame.step, 0u);
+    EXPECT_EQ(steps, TELEMETRY_RING_CAPACITY - 1);
+}
@@ -0,0 +1,44 @@
+#ifndef TANK_SIM_TEST_CONFIGS_H
+#define TANK_SIM_TEST_CONFIGS_H
+
+#include <Eigen/Dense>
+#include "../src/simulator.h"
+#include "../src/constants.h"
+
+namespace tank_sim {
+
+/**
+ * @brief One tank at its nominal level with a reverse-acting PI(D) level loop.
+ *
+ * The configuration the engine, transport and storage tests run their
+ * sessions with.
+ *
+ * @param tau_D Derivative time of the loop (s); 0 for PI
+ */
+inline Simulator::Config tankConfig(double tau_D = 0.0) {
+    using namespace constants;
+    Simulator::Config config;
+    config.params = TankModel::Parameters{DEFAULT_TANK_AREA, DEFAULT_VALVE_COEFFICIENT,
+                                          TANK_MAX_HEIGHT};
+    config.initialState = Eigen::VectorXd(1);
+    config.initialState << TANK_NOMINAL_HEIGHT;
+    config.initialInputs = Eigen::VectorXd(2);
+    config.initialInputs << TEST_INLET_FLOW, TEST_VALVE_POSITION;
+    config.dt = TEST_DT;
+
+    Simulator::ControllerConfig ctrl;
+    ctrl.gains = PIDController::Gains{-1.0, 10.0, tau_D};
+    ctrl.bias = TEST_VALVE_POSITION;
+    ctrl.minOutputLimit = 0.0;
+    ctrl.maxOutputLimit = 1.0;
+    ctrl.maxIntegralAccumulation = 10.0;
+    ctrl.measuredIndex = 0;
+    ctrl.outputIndex = 1;
+    ctrl.initialSetpoint = TANK_NOMINAL_HEIGHT;
+    config.controllerConfig.push_back(ctrl);
+    return config;
+}
+
+}  // namespace tank_sim
+
+#endif  // TANK_SIM_TEST_CONFIGS_H
@@ -0,0 +1,185 @@
+#include <gtest/gtest.h>
+#include <Eigen/Dense>
+#include "../src/control_graph.h"
+#include "../src/simulator.h"
+#include "../src/constants.h"
+
+using namespace tank_sim;
+using namespace tank_sim::constants;
+
+namespace {
+
+SignalRef stateSignal(int index) { return {SignalRef::Source::State, index}; }
+SignalRef inputSignal(int index) { return {SignalRef::Source::Input, index}; }
+SignalRef controllerOutput(int index) { return {SignalRef::Source::ControllerOutput, index}; }
+
+Simulator::ControllerConfig levelController() {
+    Simulator::ControllerConfig ctrl;
+    ctrl.gains = PIDController::Gains{-1.0, 10.0, 0.0};  // reverse-acting
+    ctrl.bias = 0.5;
+    ctrl.minOutputLimit = 0.0;
+    ctrl.maxOutputLimit = 1.0;
+    ctrl.maxIntegralAccumulation = 10.0;
+    ctrl.measuredIndex = 0;
+    ctrl.outputIndex = 1;
+    ctrl.initialSetpoint = TANK_NOMINAL_HEIGHT;
+    return ctrl;
+}
+
+Simulator::Config steadyStateConfig() {
+    Simulator::Config config;
+    config.params = TankModel::Parameters{DEFAULT_TANK_AREA, DEFAULT_VALVE_COEFFICIENT,
+                                          TANK_MAX_HEIGHT};
+    config.initialState = Eigen::VectorXd(1);
+    config.initialState << TANK_NOMINAL_HEIGHT;
+    config.initialInputs = Eigen::VectorXd(2);
+    config.initialInputs << TEST_INLET_FLOW, TEST_VALVE_POSITION;
+    config.dt = TEST_DT;
+    return config;
+}
+
+}  // namespace
+
+// Test: Without links the schedule is the identity order and one pass
+TEST(ControlScheduleTest, IndependentLoopsCompileToSinglePass) {
+    ControlSchedule schedule = ControlSchedule::compile(
+        {stateSignal(0), stateSignal(0), stateSignal(0)}, {}, 1, 2);
+
+    EXPECT_EQ(schedule.loopOrder(), (std::vector<int>{0, 1, 2}));
+    ASSERT_EQ(schedule.ops().size(), 1u);
+    EXPECT_EQ(schedule.ops()[0].kind, ControlSchedule::Op::Kind::Compute);
+    EXPECT_EQ(schedule.ops()[0].target, 0);
+    EXPECT_EQ(schedule.ops()[0].end, 3);
+}
+
+// Test: Masters are scheduled before the loops they drive
+TEST(ControlScheduleTest, CascadeOrdersMasterFirst) {
+    // Controller 0 is the slave of controller 2, which is the slave of 1
+    std::vector<ControlLink> links = {
+        {ControlLink::Type::Cascade, controllerOutput(2), 0, 1.0, 0.0},
+        {ControlLink::Type::Cascade, controllerOutput(1), 2, 1.0, 0.0},
+    };
+    ControlSchedule schedule = ControlSchedule::compile(
+        {stateSignal(0), stateSignal(0), stateSignal(0)}, links, 1, 2);
+
+    EXPECT_EQ(schedule.loopOrder(), (std::vector<int>{1, 2, 0}));
+    EXPECT_EQ(schedule.slotOf(), (std::vector<int>{2, 0, 1}));
+
+    int computes = 0;
+    for (const auto& op : schedule.ops()) {
+        if (op.kind == ControlSchedule::Op::Kind::SetSetpoint) {
+            // Source slot must already have been computed
+            EXPECT_LT(op.sourceIndex, op.target);
+        }
+        computes += op.kind == ControlSchedule::Op::Kind::Compute;
+    }
+    EXPECT_EQ(computes, 3);
+}
+
+// Test: Invalid networks are rejected at compile time
+TEST(ControlScheduleTest, RejectsInvalidNetworks) {
+    std::vector<SignalRef> two = {stateSignal(0), stateSignal(0)};
+
+    std::vector<ControlLink> cycle = {
+        {ControlLink::Type::Cascade, controllerOutput(0), 1, 1.0, 0.0},
+        {ControlLink::Type::Cascade, controllerOutput(1), 0, 1.0, 0.0},
+    };
+    EXPECT_THROW(ControlSchedule::compile(two, cycle, 1, 2), std::invalid_argument);
+
+    std::vector<ControlLink> two_setpoints = {
+        {ControlLink::Type::Ratio, inputSignal(0), 1, 2.0, 0.0},
+        {ControlLink::Type::Cascade, controllerOutput(0), 1, 1.0, 0.0},
+    };
+    EXPECT_THROW(ControlSchedule::compile(two, two_setpoints, 1, 2), std::invalid_argument);
+
+    std::vector<ControlLink> bad_cascade = {
+        {ControlLink::Type::Cascade, inputSignal(0), 1, 1.0, 0.0},
+    };
+    EXPECT_THROW(ControlSchedule::compile(two, bad_cascade, 1, 2), std::invalid_argument);
+
+    std::vector<ControlLink> bad_target = {
+        {ControlLink::Type::Feedforward, inputSignal(0), 5, 1.0, 0.0},
+    };
+    EXPECT_THROW(ControlSchedule::compile(two, bad_target, 1, 2), std::invalid_argument);
+
+    EXPECT_THROW(ControlSchedule::compile({controllerOutput(0)}, {}, 1, 2),
+                 std::invalid_argument);
+}
+
+// Test: Ratio link makes the setpoint track a scaled input
+TEST(ControlScheduleTest, RatioSetpointFollowsSignal) {
+    Simulator::Config config = steadyStateConfig();
+    config.controllerConfig.push_back(levelController());
+    config.controlLinks.push_back(
+        {ControlLink::Type::Ratio, inputSignal(INPUT_INDEX_INLET_FLOW), 0, 2.0, 0.5});
+
+    Simulator sim(config);
+    sim.setInput(INPUT_INDEX_INLET_FLOW, 1.1);
+    sim.step();
+
+    EXPECT_DOUBLE_EQ(sim.getSetpoint(0), 2.0 * 1.1 + 0.5);
+}
+
+// Test: Feedforward shifts the output by gain * (signal - nominal)
+TEST(ControlScheduleTest, FeedforwardShiftsOutput) {
+    Simulator::Config config = steadyStateConfig();
+    Simulator::ControllerConfig ctrl = levelController();
+    ctrl.gains.tau_I = 0.0;  // P-only so the shift is exact
+    config.controllerConfig.push_back(ctrl);
+
+    Simulator baseline(config);
+
+    config.controlLinks.push_back(
+        {ControlLink::Type::Feedforward, inputSignal(INPUT_INDEX_INLET_FLOW), 0, 0.4,
+         TEST_INLET_FLOW});
+    Simulator with_ff(config);
+
+    baseline.setInput(INPUT_INDEX_INLET_FLOW, 1.2);
+    with_ff.setInput(INPUT_INDEX_INLET_FLOW, 1.2);
+    baseline.step();
+    with_ff.step();
+
+    EXPECT_NEAR(with_ff.getControllerOutput(0) - baseline.getControllerOutput(0),
+                0.4 * (1.2 - TEST_INLET_FLOW), 1e-12);
+}
+
+// Test: Cascade slave receives the master output in the same step
+TEST(ControlScheduleTest, CascadeDrivesSlaveSetpoint) {
+    Simulator::Config config = steadyStateConfig();
+
+    // Slave listed first: inlet flow loop measuring and writing q_in
+    Simulator::ControllerConfig slave = levelController();
+    slave.gains = PIDController::Gains{0.5, 5.0, 0.0};
+    slave.bias = TEST_INLET_FLOW;
+    slave.maxOutputLimit = 2.0;
+    slave.measuredSource = SignalRef::Source::Input;
+    slave.measuredIndex = INPUT_INDEX_INLET_FLOW;
+    slave.outputIndex = INPUT_INDEX_INLET_FLOW;
+    slave.initialSetpoint = TEST_INLET_FLOW;
+
+    // Master: level loop producing a flow setpoint, not writing any input
+    Simulator::ControllerConfig master = levelController();
+    master.gains = PIDController::Gains{1.0, 0.0, 0.0};  // direct-acting on inflow
+    master.bias = TEST_INLET_FLOW;
+    master.maxOutputLimit = 2.0;
+    master.outputIndex = -1;
+
+    config.controllerConfig = {slave, master};
+    config.controlLinks.push_back(
+        {ControlLink::Type::Cascade, controllerOutput(1), 0, 1.0, 0.0});
+
+    Simulator sim(config);
+    sim.setSetpoint(1, 3.0);
+    sim.step();
+
+    // Master output is bias + Kc * error, and becomes the slave setpoint
+    double master_output = sim.getControllerOutput(1);
+    EXPECT_NEAR(master_output, TEST_INLET_FLOW + (3.0 - sim.getState()(0)), 1e-9);
+    EXPECT_DOUBLE_EQ(sim.getSetpoint(0), master_output);
+
+    // Level rises toward the master setpoint over time
+    for (int i = 0; i < 600; ++i) {
+        sim.step();
+    }
+    EXPECT_GT(sim.getState()(0), TANK_NOMINAL_HEIGHT + 0.1);
+}
@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <poll.h>
+#include "../src/engine_thread.h"
+#include "../src/constants.h"
+#include "test_configs.h"
+
+using namespace tank_sim;
+using namespace tank_sim::constants;
+
+namespace {
+
+bool readable(int fd, int timeout_ms) {
+    pollfd entry{fd, POLLIN, 0};
+    return poll(&entry, 1, timeout_ms) == 1 && (entry.revents & POLLIN);
+}
+
+}  // namespace
+
+TEST(TickSignalTest, CoalescesNotificationsUntilConsumed) {
+    TickSignal signal;
+    EXPECT_FALSE(readable(signal.fd(), 0));
+    EXPECT_EQ(signal.consume(), 0u);
+
+    signal.notify();
+    signal.notify();
+    signal.notify();
+    EXPECT_TRUE(readable(signal.fd(), 0));
+    EXPECT_EQ(signal.consume(), 3u);
+    EXPECT_FALSE(readable(signal.fd(), 0));
+}
+
+TEST(EngineThreadTest, SignalsOncePerTickAndFramesAreReady) {
+    auto engine = std::make_unique<SessionEngine>(tankConfig(), 10);
+    auto& queue = engine->addProducer();
+    SessionEngine::Request join{};
+    join.type = SessionEngine::Request::Type::Join;
+    for (const char* name : {"a", "b", "c"}) {
+        join.sessionKey = SessionEngine::sessionKey(name);
+        queue.tryPush(join);
+    }
+    auto cursor = engine->frames().subscribe();
+
+    TickSignal signal;
+    EngineThread thread(*engine, 0.002);
+    thread.addSignal(signal);
+    thread.start();
+    ASSERT_TRUE(readable(signal.fd(), 2000));
+    while (thread.ticks() < 5) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    thread.stop();
+    EXPECT_FALSE(thread.running());
+
+    // Every completed tick notified once and published one frame per session
+    const std::uint64_t ticks = thread.ticks();
+    EXPECT_EQ(signal.consume(), ticks);
+    std::uint64_t frames = 0;
+    SessionEngine::EncodedFrame frame;
+    while (engine->frames().read(cursor, frame) == SessionEngine::FrameRing::ReadStatus::Ok) {
+        ++frames;
+    }
+    EXPECT_EQ(frames, 3 * ticks);
+}
+
+TEST(EngineThreadTest, ComputesSessionsAheadBetweenTicks) {
+    auto engine = std::make_unique<SessionEngine>(tankConfig(), 10);
+    engine->enableSpeculation(16);
+    SessionEngine::Request join{};
+    join.type = SessionEngine::Request::Type::Join;
+    join.sessionKey = SessionEngine::sessionKey("plant");
+    engine->addProducer().tryPush(join);
+    auto cursor = engine->frames().subscribe();
+
+    EngineThread thread(*engine, 0.002);
+    thread.start();
+    while (thread.ticks() < 10) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    thread.stop();
+
+    // Frames came from the buffer (all but the first, unless the thread was
+    // descheduled past its idle budget) and stay one step apart
+    const auto stats = engine->speculationStats();
+    EXPECT_GT(stats.servedTicks, 0u);
+    EXPECT_LT(stats.servedTicks, thread.ticks());
+    EXPECT_GE(stats.computedSteps, stats.servedTicks);
+    SessionEngine::EncodedFrame frame;
+    double expected = 0.0;
+    while (engine->frames().read(cursor, frame) == SessionEngine::FrameRing::ReadStatus::Ok) {
+        expected += TEST_DT;
+        EXPECT_DOUBLE_EQ(frame.time, expected);
+    }
+    EXPECT_DOUBLE_EQ(expected, thread.ticks() * TEST_DT);
+}
+
+TEST(EngineThreadTest, StopDoesNotWaitForTheNextTick) {
+    auto engine = std::make_unique<SessionEngine>(tankConfig(), 10);
+    EngineThread thread(*engine, 60.0);
+    thread.start();
+    thread.start();  // no-op while running
+
+    const auto before = std::chrono::steady_clock::now();
+    thread.stop();
+    EXPECT_LT(std::chrono::steady_clock::now() - before, std::chrono::seconds(1));
+    EXPECT_EQ(thread.ticks(), 0u);
+    thread.stop();  // idempotent
+}
+
+TEST(EngineThreadTest, RejectsNonPositivePeriod) {
+    auto engine = std::make_unique<SessionEngine>(tankConfig(), 10);
+    EXPECT_THROW(EngineThread(*engine, 0.0), std::invalid_argument);
+    EXPECT_THROW(EngineThread(*engine, -1.0), std::invalid_argument);
+}
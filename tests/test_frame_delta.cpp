@@ -0,0 +1,167 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include "../src/frame_delta.h"
+#include "../src/simulator.h"
+#include "../src/constants.h"
+#include "test_configs.h"
+
+using namespace tank_sim;
+using namespace tank_sim::constants;
+
+namespace {
+
+TelemetryFrame sampleFrame() {
+    TelemetryFrame frame{};
+    frame.step = 1;
+    frame.time = 1.0;
+    frame.tankLevel = 2.5;
+    frame.measuredLevel = 2.5;
+    frame.inletFlow = 1.0;
+    frame.outletFlow = 1.0;
+    frame.valvePosition = 0.5;
+    frame.loopCount = 1;
+    frame.setpoint[0] = 2.5;
+    frame.controllerOutput[0] = 0.5;
+    return frame;
+}
+
+}  // namespace
+
+TEST(FrameDeltaTest, KeyframesAtIntervalAndDeltasBetween) {
+    DeltaEncoder::Settings settings;
+    settings.keyframeInterval = 4;
+    DeltaEncoder encoder(settings);
+    TelemetryFrame frame = sampleFrame();
+
+    std::string kinds;
+    for (int k = 0; k < 9; ++k) {
+        const std::string_view record = encoder.encode(frame);
+        kinds += encoder.lastWasKeyframe() ? 'K' : 'd';
+        EXPECT_EQ(static_cast<unsigned char>(record[0]),
+                  encoder.lastWasKeyframe() ? FrameEncoder::BINARY_KIND_STATE
+                                            : DeltaEncoder::BINARY_KIND_DELTA);
+        ++frame.step;
+        frame.time += 1.0;
+    }
+    EXPECT_EQ(kinds, "KdddKdddK");
+
+    // A client joining, a reset and a new loop count all get a keyframe
+    encoder.encode(frame);
+    encoder.forceKeyframe();
+    frame.step += 1;
+    encoder.encode(frame);
+    EXPECT_TRUE(encoder.lastWasKeyframe());
+    frame.step = 0;
+    encoder.encode(frame);
+    EXPECT_TRUE(encoder.lastWasKeyframe());
+    frame.step = 1;
+    frame.loopCount = 2;
+    encoder.encode(frame);
+    EXPECT_TRUE(encoder.lastWasKeyframe());
+}
+
+TEST(FrameDeltaTest, UnchangedChannelsCostNothing) {
+    DeltaEncoder encoder;
+    TelemetryFrame frame = sampleFrame();
+    encoder.encode(frame);
+
+    frame.step += 1;
+    EXPECT_EQ(encoder.encode(frame).size(), DeltaEncoder::DELTA_HEADER_SIZE + 1);
+
+    // One small change: header, step, one-byte delta
+    frame.step += 1;
+    frame.tankLevel += 2e-6;
+    const std::string_view record = encoder.encode(frame);
+    EXPECT_EQ(record.size(), DeltaEncoder::DELTA_HEADER_SIZE + 2);
+    EXPECT_EQ(static_cast<unsigned char>(record[4]), 1u << 1);
+}
+
+TEST(FrameDeltaTest, DecodedStreamStaysWithinHalfQuantum) {
+    Simulator sim(tankConfig(1.0));
+    DeltaEncoder encoder;
+    DeltaDecoder decoder;
+    sim.setSetpoint(0, TANK_NOMINAL_HEIGHT + 0.7);
+
+    std::size_t delta_bytes = 0;
+    int deltas = 0;
+    double worst = 0.0;
+    for (int k = 0; k < 2000; ++k) {
+        sim.step();
+        if (k == 1000) {
+            sim.setInput(0, TEST_INLET_FLOW * 1.1);
+        }
+        const TelemetryFrame frame = sim.getTelemetry();
+        const std::string_view record = encoder.encode(frame);
+        if (!encoder.lastWasKeyframe()) {
+            delta_bytes += record.size();
+            ++deltas;
+        }
+
+        const TelemetryFrame decoded = decoder.decode(record.data(), record.size());
+        ASSERT_EQ(decoded.step, frame.step);
+        worst = std::max({worst, std::abs(decoded.time - frame.time),
+                          std::abs(decoded.tankLevel - frame.tankLevel),
+                          std::abs(decoded.inletFlow - frame.inletFlow),
+                          std::abs(decoded.outletFlow - frame.outletFlow),
+                          std::abs(decoded.error[0] - frame.error[0]),
+                          std::abs(decoded.controllerOutput[0] - frame.controllerOutput[0])});
+    }
+
+    // Error is bounded by the quantum (with rounding slack) and never drifts
+    EXPECT_LE(worst, 0.5 * DEFAULT_DELTA_QUANTUM * (1.0 + 1e-6));
+    const double mean_delta = static_cast<double>(delta_bytes) / deltas;
+    EXPECT_LT(mean_delta, FrameEncoder::binarySize(1) / 3.0);
+}
+
+TEST(FrameDeltaTest, NonFiniteValuesFallBackToKeyframes) {
+    DeltaEncoder encoder;
+    DeltaDecoder decoder;
+    TelemetryFrame frame = sampleFrame();
+    std::string_view record = encoder.encode(frame);
+    decoder.decode(record.data(), record.size());
+
+    frame.step += 1;
+    frame.error[0] = std::numeric_limits<double>::quiet_NaN();
+    record = encoder.encode(frame);
+    EXPECT_TRUE(encoder.lastWasKeyframe());
+    EXPECT_TRUE(std::isnan(decoder.decode(record.data(), record.size()).error[0]));
+
+    frame.step += 1;
+    frame.error[0] = 1e30;
+    record = encoder.encode(frame);
+    EXPECT_TRUE(encoder.lastWasKeyframe());
+    EXPECT_EQ(decoder.decode(record.data(), record.size()).error[0], 1e30);
+}
+
+TEST(FrameDeltaTest, DecoderRejectsInvalidStreams) {
+    EXPECT_THROW(DeltaDecoder(0.0), std::invalid_argument);
+    DeltaEncoder::Settings settings;
+    settings.keyframeInterval = 0;
+    EXPECT_THROW(DeltaEncoder{settings}, std::invalid_argument);
+
+    DeltaEncoder encoder;
+    TelemetryFrame frame = sampleFrame();
+    const std::string keyframe(encoder.encode(frame));
+    frame.step += 1;
+    frame.tankLevel += 0.01;
+    const std::string delta(encoder.encode(frame));
+
+    DeltaDecoder decoder;
+    EXPECT_FALSE(decoder.synchronized());
+    EXPECT_THROW(decoder.decode(delta.data(), delta.size()), std::invalid_argument);
+    decoder.decode(keyframe.data(), keyframe.size());
+    EXPECT_TRUE(decoder.synchronized());
+    EXPECT_THROW(decoder.decode(delta.data(), delta.size() - 1), std::invalid_argument);
+
+    // The failed record left the reference untouched
+    const TelemetryFrame decoded = decoder.decode(delta.data(), delta.size());
+    EXPECT_NEAR(decoded.tankLevel, frame.tankLevel, DEFAULT_DELTA_QUANTUM);
+    EXPECT_EQ(decoded.step, frame.step);
+
+    std::string wrong_loops = delta;
+    wrong_loops[2] = 3;
+    EXPECT_THROW(decoder.decode(wrong_loops.data(), wrong_loops.size()), std::invalid_argument);
+}
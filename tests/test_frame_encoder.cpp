@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include "../src/frame_encoder.h"
+#include "../src/constants.h"
+
+using namespace tank_sim;
+using namespace tank_sim::constants;
+
+namespace {
+
+TelemetryFrame sampleFrame() {
+    TelemetryFrame frame{};
+    frame.step = 42;
+    frame.time = 42.0;
+    frame.tankLevel = 2.5;
+    frame.measuredLevel = 2.4999;
+    frame.inletFlow = 1.0;
+    frame.outletFlow = 0.1 + 0.2;
+    frame.valvePosition = 0.5;
+    frame.loopCount = 2;
+    frame.activeAlarms = 3;
+    frame.setpoint = {3.0, 1.5};
+    frame.error = {0.5, -1e-7};
+    frame.controllerOutput = {0.25, 0.75};
+    return frame;
+}
+
+/// Number following "key": in a JSON message
+double jsonNumber(const std::string& json, const std::string& key) {
+    const auto pos = json.find("\"" + key + "\":");
+    EXPECT_NE(pos, std::string::npos) << key;
+    return std::strtod(json.c_str() + pos + key.size() + 3, nullptr);
+}
+
+}  // namespace
+
+TEST(FrameEncoderTest, JsonMatchesFrontendSchema) {
+    FrameEncoder encoder;
+    TelemetryFrame frame = sampleFrame();
+    frame.outletFlow = 1.0;
+    frame.error[0] = 0.5;
+
+    EXPECT_EQ(std::string(encoder.json(frame)),
+              "{\"type\":\"state\",\"data\":{\"time\":42.0,\"tank_level\":2.5,"
+              "\"setpoint\":3.0,\"inlet_flow\":1.0,\"outlet_flow\":1.0,"
+              "\"valve_position\":0.5,\"error\":0.5,\"controller_output\":0.25}}");
+}
+
+TEST(FrameEncoderTest, JsonNumbersRoundTripExactly) {
+    const TelemetryFrame frame = sampleFrame();
+    char buffer[FrameEncoder::MAX_JSON_SIZE];
+    const std::string json(buffer, FrameEncoder::writeJson(frame, buffer));
+
+    EXPECT_EQ(jsonNumber(json, "outlet_flow"), frame.outletFlow);
+    EXPECT_NE(json.find("0.30000000000000004"), std::string::npos);
+    EXPECT_EQ(jsonNumber(json, "error"), frame.error[0]);
+
+    // Extreme values stay within the buffer bound
+    TelemetryFrame worst = frame;
+    worst.time = -std::numeric_limits<double>::denorm_min();
+    worst.tankLevel = -2.2250738585072014e-308;
+    worst.setpoint[0] = -1.7976931348623157e308;
+    worst.inletFlow = -1.2345678901234567e-100;
+    const std::size_t size = FrameEncoder::writeJson(worst, buffer);
+    EXPECT_LT(size, FrameEncoder::MAX_JSON_SIZE);
+    const std::string extreme(buffer, size);
+    EXPECT_EQ(jsonNumber(extreme, "tank_level"), worst.tankLevel);
+    EXPECT_EQ(jsonNumber(extreme, "setpoint"), worst.setpoint[0]);
+}
+
+TEST(FrameEncoderTest, JsonHandlesMissingLoopsAndNonFiniteValues) {
+    FrameEncoder encoder;
+    TelemetryFrame frame = sampleFrame();
+    frame.loopCount = 0;
+    frame.tankLevel = std::numeric_limits<double>::quiet_NaN();
+
+    const std::string json(encoder.json(frame));
+    EXPECT_NE(json.find("\"tank_level\":null"), std::string::npos);
+    EXPECT_NE(json.find("\"setpoint\":0.0,"), std::string::npos);
+    EXPECT_NE(json.find("\"controller_output\":0.0}}"), std::string::npos);
+}
+
+TEST(FrameEncoderTest, BinaryLayoutIsLittleEndian) {
+    FrameEncoder encoder;
+    const TelemetryFrame frame = sampleFrame();
+    const std::string_view record = encoder.binary(frame);
+
+    ASSERT_EQ(record.size(), FrameEncoder::binarySize(2));
+    EXPECT_EQ(record.size(), 16u + 8u * (6u + 6u));
+    EXPECT_EQ(static_cast<unsigned char>(record[0]), FrameEncoder::BINARY_KIND_STATE);
+    EXPECT_EQ(static_cast<unsigned char>(record[1]), FrameEncoder::BINARY_VERSION);
+    EXPECT_EQ(record[2], 2);
+    EXPECT_EQ(record[3], 0);
+    EXPECT_EQ(record[4], 3);
+    EXPECT_EQ(record[8], 42);
+    EXPECT_EQ(record[9], 0);
+
+    // time = 42.0 = 0x4045000000000000
+    EXPECT_EQ(static_cast<unsigned char>(record[16 + 7]), 0x40u);
+    EXPECT_EQ(static_cast<unsigned char>(record[16 + 6]), 0x45u);
+    EXPECT_EQ(record[16], 0);
+}
+
+TEST(FrameEncoderTest, BinaryRoundTrips) {
+    const TelemetryFrame frame = sampleFrame();
+    char buffer[FrameEncoder::MAX_BINARY_SIZE];
+    const std::size_t size = FrameEncoder::writeBinary(frame, buffer);
+
+    const TelemetryFrame decoded = FrameEncoder::readBinary(buffer, size);
+    EXPECT_EQ(decoded.step, frame.step);
+    EXPECT_EQ(decoded.time, frame.time);
+    EXPECT_EQ(decoded.measuredLevel, frame.measuredLevel);
+    EXPECT_EQ(decoded.outletFlow, frame.outletFlow);
+    EXPECT_EQ(decoded.loopCount, 2);
+    EXPECT_EQ(decoded.activeAlarms, 3);
+    EXPECT_EQ(decoded.error[1], frame.error[1]);
+    EXPECT_EQ(decoded.controllerOutput[1], frame.controllerOutput[1]);
+
+    EXPECT_THROW(FrameEncoder::readBinary(buffer, size - 1), std::invalid_argument);
+    EXPECT_THROW(FrameEncoder::readBinary(buffer, 8), std::invalid_argument);
+    buffer[1] = 9;
+    EXPECT_THROW(FrameEncoder::readBinary(buffer, size), std::invalid_argument);
+}
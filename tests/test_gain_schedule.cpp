@@ -0,0 +1,147 @@
+#include <gtest/gtest.h>
+#include <Eigen/Dense>
+#include <cmath>
+#include "../src/gain_schedule.h"
+#include "../src/pid_bank.h"
+#include "../src/simulator.h"
+#include "../src/constants.h"
+
+using namespace tank_sim;
+using namespace tank_sim::constants;
+
+namespace {
+
+// Gentler control at low level, tighter at high level
+std::vector<GainSchedule::Point> levelTable() {
+    return {
+        {1.0, {-0.5, 20.0, 0.0}},
+        {2.5, {-1.0, 10.0, 0.0}},
+        {4.0, {-2.0, 5.0, 1.0}},
+    };
+}
+
+}  // namespace
+
+// Test: Linear interpolation between breakpoints
+TEST(GainScheduleTest, InterpolatesBetweenBreakpoints) {
+    GainSchedule schedule(levelTable());
+
+    PIDController::Gains at_node = schedule.lookup(2.5);
+    EXPECT_DOUBLE_EQ(at_node.Kc, -1.0);
+    EXPECT_DOUBLE_EQ(at_node.tau_I, 10.0);
+
+    PIDController::Gains midway = schedule.lookup(3.25);
+    EXPECT_DOUBLE_EQ(midway.Kc, -1.5);
+    EXPECT_DOUBLE_EQ(midway.tau_I, 7.5);
+    EXPECT_DOUBLE_EQ(midway.tau_D, 0.5);
+}
+
+// Test: Values outside the table clamp to the end points
+TEST(GainScheduleTest, ClampsOutsideRange) {
+    GainSchedule schedule(levelTable());
+
+    EXPECT_DOUBLE_EQ(schedule.lookup(-3.0).Kc, -0.5);
+    EXPECT_DOUBLE_EQ(schedule.lookup(1.0).Kc, -0.5);
+    EXPECT_DOUBLE_EQ(schedule.lookup(9.0).Kc, -2.0);
+
+    GainSchedule single(std::vector<GainSchedule::Point>{{0.0, {1.0, 2.0, 3.0}}});
+    EXPECT_DOUBLE_EQ(single.lookup(5.0).tau_D, 3.0);
+}
+
+// Test: The cached bracket follows a slowly moving variable
+TEST(GainScheduleTest, CachedBracketTracksVariable) {
+    GainSchedule schedule(levelTable());
+
+    schedule.lookup(1.5);
+    EXPECT_EQ(schedule.bracket(), 0);
+    schedule.lookup(3.0);
+    EXPECT_EQ(schedule.bracket(), 1);
+    schedule.lookup(3.9);
+    EXPECT_EQ(schedule.bracket(), 1);
+    schedule.lookup(1.01);
+    EXPECT_EQ(schedule.bracket(), 0);
+}
+
+// Test: Invalid tables are rejected
+TEST(GainScheduleTest, RejectsInvalidTables) {
+    EXPECT_THROW(GainSchedule(std::vector<GainSchedule::Point>{}), std::invalid_argument);
+    EXPECT_THROW(GainSchedule({{1.0, {1.0, 1.0, 0.0}}, {1.0, {1.0, 1.0, 0.0}}}),
+                 std::invalid_argument);
+    EXPECT_THROW(GainSchedule(std::vector<GainSchedule::Point>{{1.0, {1.0, -1.0, 0.0}}}),
+                 std::invalid_argument);
+    EXPECT_THROW(GainSchedule({{1.0, {1.0, 0.0, 0.0}}, {2.0, {1.0, 5.0, 0.0}}}),
+                 std::invalid_argument);
+}
+
+// Test: Bumpless gain change preserves the integral contribution
+TEST(GainScheduleTest, BumplessGainChangePreservesIntegralTerm) {
+    PIDBank bank;
+    bank.addLoop({-1.0, 10.0, 0.0}, 0.5, 0.0, 1.0, 10.0, 0, 0, 2.6);
+    bank.addLoop({-1.0, 10.0, 0.0}, 0.5, 0.0, 1.0, 10.0, 0, 1, 2.6);
+
+    Eigen::VectorXd state(1);
+    state << 2.5;
+    Eigen::VectorXd inputs = Eigen::VectorXd::Zero(2);
+    for (int k = 0; k < 5; ++k) {
+        bank.update(state, inputs, TEST_DT);
+    }
+    const double integral_before = bank.getIntegralState(0);
+    ASSERT_NE(integral_before, 0.0);
+
+    // Halving tau_I would double the integral term without rescaling
+    bank.setGains(0, {-1.0, 5.0, 0.0});
+    bank.setGainsBumpless(1, {-1.0, 5.0, 0.0});
+
+    EXPECT_DOUBLE_EQ(bank.getIntegralState(0), integral_before);
+    EXPECT_DOUBLE_EQ(-1.0 / 5.0 * bank.getIntegralState(1),
+                     -1.0 / 10.0 * integral_before);
+
+    // Next output of the bumpless loop only differs by the new error
+    // accumulation; the plain loop jumps by the doubled integral term.
+    const double previous_output = inputs(1);
+    bank.update(state, inputs, TEST_DT);
+    EXPECT_NEAR(inputs(1) - previous_output, -1.0 / 10.0 * 0.1 * TEST_DT, 1e-9);
+    EXPECT_GT(std::abs(inputs(0) - previous_output), 0.01);
+}
+
+// Test: Simulator applies the scheduled gains for the current level
+TEST(GainScheduleTest, SimulatorSchedulesByLevel) {
+    Simulator::Config config;
+    config.params = TankModel::Parameters{DEFAULT_TANK_AREA, DEFAULT_VALVE_COEFFICIENT,
+                                          TANK_MAX_HEIGHT};
+    config.initialState = Eigen::VectorXd(1);
+    config.initialState << TANK_NOMINAL_HEIGHT;
+    config.initialInputs = Eigen::VectorXd(2);
+    config.initialInputs << TEST_INLET_FLOW, TEST_VALVE_POSITION;
+    config.dt = TEST_DT;
+
+    Simulator::ControllerConfig ctrl;
+    ctrl.gains = PIDController::Gains{-1.0, 10.0, 0.0};
+    ctrl.bias = 0.5;
+    ctrl.minOutputLimit = 0.0;
+    ctrl.maxOutputLimit = 1.0;
+    ctrl.maxIntegralAccumulation = 10.0;
+    ctrl.measuredIndex = 0;
+    ctrl.outputIndex = 1;
+    ctrl.initialSetpoint = 3.5;
+    config.controllerConfig.push_back(ctrl);
+    config.gainSchedules.push_back({0, {SignalRef::Source::State, 0}, levelTable()});
+
+    Simulator sim(config);
+    for (int i = 0; i < 400; ++i) {
+        sim.step();
+    }
+
+    // Still converges to a setpoint in the high-gain region
+    EXPECT_NEAR(sim.getState()(0), 3.5, 0.1);
+
+    // Manual gains would be overwritten by the schedule on the next step
+    EXPECT_THROW(sim.setControllerGains(0, {-5.0, 5.0, 0.0}), std::invalid_argument);
+
+    // Invalid attachments are rejected
+    config.gainSchedules[0].controller = 3;
+    EXPECT_THROW(Simulator bad(config), std::invalid_argument);
+    config.gainSchedules[0].controller = 0;
+    config.gainSchedules[0].variable = {SignalRef::Source::ControllerOutput, 0};
+    EXPECT_THROW(Simulator bad(config), std::invalid_argument);
+}
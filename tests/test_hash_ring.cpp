@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+#include <map>
+#include <stdexcept>
+#include <vector>
+#include "../src/hash_ring.h"
+#include "../src/session_engine.h"
+
+using namespace tank_sim;
+
+namespace {
+
+constexpr int KEYS = 10000;
+
+std::uint64_t key(int i) { return SessionEngine::sessionKey("session-" + std::to_string(i)); }
+
+}  // namespace
+
+TEST(HashRingTest, SpreadsKeysOverAllShards) {
+    HashRing ring;
+    for (int shard = 0; shard < 4; ++shard) {
+        ring.addShard(shard);
+    }
+    std::map<int, int> counts;
+    for (int i = 0; i < KEYS; ++i) {
+        ++counts[ring.shardFor(key(i))];
+    }
+    ASSERT_EQ(counts.size(), 4u);
+    for (const auto& [shard, count] : counts) {
+        EXPECT_GT(count, KEYS / 4 * 7 / 10) << "shard " << shard;
+        EXPECT_LT(count, KEYS / 4 * 13 / 10) << "shard " << shard;
+    }
+}
+
+TEST(HashRingTest, AddingAShardMovesOnlyItsShareOfKeys) {
+    HashRing ring;
+    for (int shard = 0; shard < 3; ++shard) {
+        ring.addShard(shard);
+    }
+    std::vector<int> before(KEYS);
+    for (int i = 0; i < KEYS; ++i) {
+        before[i] = ring.shardFor(key(i));
+    }
+
+    ring.addShard(3);
+    int moved = 0;
+    for (int i = 0; i < KEYS; ++i) {
+        const int owner = ring.shardFor(key(i));
+        if (owner != before[i]) {
+            EXPECT_EQ(owner, 3);   // Keys only move to the new shard
+            ++moved;
+        }
+    }
+    EXPECT_GT(moved, KEYS / 4 * 7 / 10);
+    EXPECT_LT(moved, KEYS / 4 * 13 / 10);
+
+    // Removing it again restores the previous owners
+    ring.removeShard(3);
+    for (int i = 0; i < KEYS; ++i) {
+        ASSERT_EQ(ring.shardFor(key(i)), before[i]);
+    }
+}
+
+TEST(HashRingTest, ValidatesShards) {
+    HashRing ring(8);
+    EXPECT_TRUE(ring.empty());
+    EXPECT_THROW(ring.shardFor(1), std::logic_error);
+    EXPECT_THROW(HashRing(0), std::invalid_argument);
+    EXPECT_THROW(ring.addShard(-1), std::invalid_argument);
+
+    ring.addShard(5);
+    EXPECT_THROW(ring.addShard(5), std::invalid_argument);
+    EXPECT_TRUE(ring.contains(5));
+    EXPECT_EQ(ring.shards(), std::vector<int>{5});
+    EXPECT_EQ(ring.shardFor(42), 5);
+    ring.removeShard(7);
+    ring.removeShard(5);
+    EXPECT_TRUE(ring.empty());
+}
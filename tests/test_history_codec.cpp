@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+#include "../src/history_codec.h"
+
+using namespace tank_sim;
+
+namespace {
+
+/// Two hours of a tank settling after a setpoint change, then a noisy inlet
+std::vector<SessionSample> recordedHistory(int count) {
+    std::vector<SessionSample> samples;
+    double level = 2.5;
+    for (int k = 0; k < count; ++k) {
+        SessionSample s{};
+        s.time = (k + 1) * 1.0;
+        s.setpoint = k < 100 ? 2.5 : 3.0;
+        level += 0.05 * (s.setpoint - level);
+        s.tankLevel = level;
+        s.inletFlow = k < 3600 ? 1.0 : 1.0 + 0.05 * std::sin(0.37 * k);
+        s.valvePosition = 0.5 - 0.1 * (s.setpoint - level);
+        s.outletFlow = 1.2649 * s.valvePosition * std::sqrt(level);
+        s.error = s.setpoint - level;
+        s.controllerOutput = s.valvePosition;
+        samples.push_back(s);
+    }
+    return samples;
+}
+
+bool sameBits(double a, double b) { return std::memcmp(&a, &b, sizeof(double)) == 0; }
+
+}  // namespace
+
+TEST(CompressedHistoryTest, RoundTripsEverySampleBitForBit) {
+    const auto samples = recordedHistory(7200);
+    const CompressedHistory history(samples);
+    EXPECT_EQ(history.size(), samples.size());
+
+    const auto decoded = CompressedHistory::fromBytes(history.bytes()).decode();
+    ASSERT_EQ(decoded.size(), samples.size());
+    for (std::size_t i = 0; i < samples.size(); ++i) {
+        ASSERT_TRUE(sameBits(decoded[i].time, samples[i].time)) << i;
+        ASSERT_TRUE(sameBits(decoded[i].tankLevel, samples[i].tankLevel)) << i;
+        ASSERT_TRUE(sameBits(decoded[i].setpoint, samples[i].setpoint)) << i;
+        ASSERT_TRUE(sameBits(decoded[i].inletFlow, samples[i].inletFlow)) << i;
+        ASSERT_TRUE(sameBits(decoded[i].outletFlow, samples[i].outletFlow)) << i;
+        ASSERT_TRUE(sameBits(decoded[i].valvePosition, samples[i].valvePosition)) << i;
+        ASSERT_TRUE(sameBits(decoded[i].error, samples[i].error)) << i;
+        ASSERT_TRUE(sameBits(decoded[i].controllerOutput, samples[i].controllerOutput)) << i;
+    }
+}
+
+TEST(CompressedHistoryTest, SteadyStateCostsAboutABitPerField) {
+    // A session at steady state: every field repeats, time accumulates dt
+    std::vector<SessionSample> samples(7200, SessionSample{0.0, 2.5, 2.5, 1.0, 1.0, 0.5, 0.0, 0.5});
+    double time = 0.0;
+    for (auto& sample : samples) {
+        time += 0.1;
+        sample.time = time;
+    }
+    const CompressedHistory history(samples);
+    // 8 fields x 7200 samples as raw doubles would be 460,800 bytes
+    EXPECT_LT(history.bytes().size(), 7200u * 2);
+    const auto decoded = history.decode();
+    EXPECT_TRUE(sameBits(decoded.back().time, samples.back().time));
+
+    // Real data still compresses well below raw size
+    const CompressedHistory recorded(recordedHistory(7200));
+    EXPECT_LT(recorded.bytes().size(), 7200u * sizeof(SessionSample) / 2);
+}
+
+TEST(CompressedHistoryTest, HandlesSpecialValuesAndEmptyHistory) {
+    std::vector<SessionSample> samples(3, SessionSample{});
+    samples[0].time = 1.0;
+    samples[1].time = 2.0;
+    samples[1].error = -0.0;
+    samples[2].time = 4.0;
+    samples[2].tankLevel = std::numeric_limits<double>::infinity();
+    samples[2].error = std::numeric_limits<double>::denorm_min();
+    const auto decoded = CompressedHistory(samples).decode();
+    EXPECT_TRUE(sameBits(decoded[1].error, -0.0));
+    EXPECT_TRUE(std::isinf(decoded[2].tankLevel));
+    EXPECT_TRUE(sameBits(decoded[2].error, samples[2].error));
+    EXPECT_EQ(decoded[2].time, 4.0);
+
+    const CompressedHistory empty;
+    EXPECT_EQ(empty.size(), 0u);
+    EXPECT_TRUE(CompressedHistory::fromBytes(empty.bytes()).decode().empty());
+}
+
+TEST(CompressedHistoryTest, RejectsCorruptBlocks) {
+    const CompressedHistory history(recordedHistory(100));
+    EXPECT_THROW(CompressedHistory::fromBytes("ab"), std::invalid_argument);
+
+    // A truncated stream runs out of bits
+    const std::string truncated = history.bytes().substr(0, history.bytes().size() / 2);
+    EXPECT_THROW(CompressedHistory::fromBytes(truncated).decode(), std::invalid_argument);
+
+    // A sample count the block cannot hold
+    std::string inflated = history.bytes();
+    const std::uint32_t count = 1u << 30;
+    std::memcpy(&inflated[0], &count, sizeof(count));
+    EXPECT_THROW(CompressedHistory::fromBytes(inflated), std::invalid_argument);
+}
@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+#include <Eigen/Dense>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include "../src/extended_kalman_filter.h"
+#include "../src/level_estimator.h"
+#include "../src/simulator.h"
+#include "../src/constants.h"
+
+using namespace tank_sim;
+using namespace tank_sim::constants;
+
+namespace {
+
+Simulator::Config noisyConfig(double noise_stddev, bool use_estimator) {
+    Simulator::Config config;
+    config.params = TankModel::Parameters{DEFAULT_TANK_AREA, DEFAULT_VALVE_COEFFICIENT,
+                                          TANK_MAX_HEIGHT};
+    config.initialState = Eigen::VectorXd(1);
+    config.initialState << TANK_NOMINAL_HEIGHT;
+    config.initialInputs = Eigen::VectorXd(2);
+    config.initialInputs << TEST_INLET_FLOW, TEST_VALVE_POSITION;
+    config.dt = TEST_DT;
+
+    Simulator::ControllerConfig ctrl;
+    ctrl.gains = PIDController::Gains{-1.0, 10.0, 0.0};  // reverse-acting
+    ctrl.bias = TEST_VALVE_POSITION;
+    ctrl.minOutputLimit = 0.0;
+    ctrl.maxOutputLimit = 1.0;
+    ctrl.maxIntegralAccumulation = 10.0;
+    ctrl.measuredIndex = 0;
+    ctrl.outputIndex = 1;
+    ctrl.initialSetpoint = TANK_NOMINAL_HEIGHT;
+    config.controllerConfig.push_back(ctrl);
+
+    config.sensorNoiseStdDev = noise_stddev;
+    config.sensorNoiseSeed = 42;
+    config.useEstimator = use_estimator;
+    config.estimator.measurementNoise = noise_stddev * noise_stddev;
+    return config;
+}
+
+}  // namespace
+
+// Test: Scalar update matches the closed-form Kalman gain
+TEST(ExtendedKalmanFilterTest, ScalarUpdateMatchesClosedForm) {
+    using Filter = ExtendedKalmanFilter<1, 1>;
+    Filter filter(Filter::StateVector(0.0), Filter::StateMatrix(1.0),
+                  Filter::StateMatrix(0.0), Filter::MeasurementCovariance(1.0));
+
+    filter.update(Filter::MeasurementVector(2.0), Filter::MeasurementVector(0.0),
+                  Filter::MeasurementMatrix(1.0));
+
+    // K = P / (P + R) = 0.5
+    EXPECT_DOUBLE_EQ(filter.state()(0), 1.0);
+    EXPECT_DOUBLE_EQ(filter.covariance()(0, 0), 0.5);
+    EXPECT_DOUBLE_EQ(filter.innovation()(0), 2.0);
+}
+
+// Test: A two-state filter recovers an unmeasured velocity
+TEST(ExtendedKalmanFilterTest, EstimatesUnmeasuredState) {
+    using Filter = ExtendedKalmanFilter<2, 1>;
+    const double dt = 0.1;
+    const double velocity = 0.3;
+    Filter::StateMatrix transition;
+    transition << 1.0, dt, 0.0, 1.0;
+    Filter::MeasurementMatrix observation;
+    observation << 1.0, 0.0;
+
+    Filter filter(Filter::StateVector::Zero(), Filter::StateMatrix::Identity(),
+                  Filter::StateMatrix::Identity() * 1e-8,
+                  Filter::MeasurementCovariance(1e-4));
+
+    std::mt19937 rng(7);
+    std::normal_distribution<double> noise(0.0, 0.01);
+    for (int k = 1; k <= 500; ++k) {
+        filter.predict(transition * filter.state(), transition);
+        double z = velocity * k * dt + noise(rng);
+        filter.update(Filter::MeasurementVector(z), observation * filter.state(),
+                      observation);
+    }
+
+    EXPECT_NEAR(filter.state()(1), velocity, 0.01);
+    // Joseph form keeps the covariance symmetric
+    EXPECT_DOUBLE_EQ(filter.covariance()(0, 1), filter.covariance()(1, 0));
+    EXPECT_GT(filter.covariance().determinant(), 0.0);
+}
+
+// Test: Invalid noise models are rejected
+TEST(ExtendedKalmanFilterTest, RejectsInvalidNoise) {
+    LevelEstimator::Settings settings;
+    settings.measurementNoise = 0.0;
+    EXPECT_THROW(LevelEstimator(settings, TankModel::StateVector(1.0)),
+                 std::invalid_argument);
+
+    settings = LevelEstimator::Settings{};
+    settings.processNoise = -1.0;
+    EXPECT_THROW(LevelEstimator(settings, TankModel::StateVector(1.0)),
+                 std::invalid_argument);
+
+    Simulator::Config config = noisyConfig(0.05, true);
+    config.sensorNoiseStdDev = -0.1;
+    EXPECT_THROW(Simulator{config}, std::invalid_argument);
+}
+
+// Test: With an ideal sensor the controllers see the true state
+TEST(LevelEstimatorTest, IdealSensorPassesStateThrough) {
+    Simulator sim(noisyConfig(0.0, false));
+    sim.setSetpoint(0, 3.0);
+    for (int i = 0; i < 50; ++i) {
+        sim.step();
+        ASSERT_EQ(sim.getMeasuredState()(0), sim.getState()(0));
+        ASSERT_EQ(sim.getEstimatedState()(0), sim.getState()(0));
+    }
+}
+
+// Test: The estimate is closer to the true level than the raw sensor
+TEST(LevelEstimatorTest, FiltersSensorNoiseInClosedLoop) {
+    const double sigma = 0.05;
+    Simulator sim(noisyConfig(sigma, true));
+    sim.setSetpoint(0, 3.0);
+
+    double raw_sq = 0.0;
+    double est_sq = 0.0;
+    const int steps = 1000;
+    for (int i = 0; i < steps; ++i) {
+        sim.step();
+        double h = sim.getState()(0);
+        raw_sq += std::pow(sim.getMeasuredState()(0) - h, 2);
+        est_sq += std::pow(sim.getEstimatedState()(0) - h, 2);
+    }
+
+    double raw_rms = std::sqrt(raw_sq / steps);
+    double est_rms = std::sqrt(est_sq / steps);
+    EXPECT_NEAR(raw_rms, sigma, 0.2 * sigma);
+    EXPECT_LT(est_rms, 0.5 * raw_rms);
+    EXPECT_NEAR(sim.getState()(0), 3.0, 0.05);
+}
+
+// Test: Seeded noise and the estimator replay identically after reset
+TEST(LevelEstimatorTest, ResetReplaysNoiseSequence) {
+    Simulator sim(noisyConfig(0.05, true));
+    std::vector<double> first;
+    for (int i = 0; i < 20; ++i) {
+        sim.step();
+        first.push_back(sim.getEstimatedState()(0));
+    }
+
+    sim.reset();
+    EXPECT_DOUBLE_EQ(sim.getEstimatedState()(0), TANK_NOMINAL_HEIGHT);
+    for (int i = 0; i < 20; ++i) {
+        sim.step();
+        EXPECT_DOUBLE_EQ(sim.getEstimatedState()(0), first[i]);
+    }
+}
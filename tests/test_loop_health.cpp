@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+#include <Eigen/Dense>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include "../src/loop_health.h"
+#include "../src/simulator.h"
+#include "../src/constants.h"
+
+using namespace tank_sim;
+using namespace tank_sim::constants;
+
+namespace {
+
+Simulator::Config monitoredConfig(double integral_time) {
+    Simulator::Config config;
+    config.params = TankModel::Parameters{DEFAULT_TANK_AREA, DEFAULT_VALVE_COEFFICIENT,
+                                          TANK_MAX_HEIGHT};
+    config.initialState = Eigen::VectorXd(1);
+    config.initialState << TANK_NOMINAL_HEIGHT;
+    config.initialInputs = Eigen::VectorXd(2);
+    config.initialInputs << TEST_INLET_FLOW, TEST_VALVE_POSITION;
+    config.dt = TEST_DT;
+    config.monitorLoopHealth = true;
+
+    Simulator::ControllerConfig ctrl;
+    ctrl.gains = PIDController::Gains{-1.0, integral_time, 0.0};  // reverse-acting
+    ctrl.bias = TEST_VALVE_POSITION;
+    ctrl.minOutputLimit = 0.0;
+    ctrl.maxOutputLimit = 1.0;
+    ctrl.maxIntegralAccumulation = 10.0;
+    ctrl.measuredIndex = 0;
+    ctrl.outputIndex = 1;
+    ctrl.initialSetpoint = TANK_NOMINAL_HEIGHT;
+    config.controllerConfig.push_back(ctrl);
+    return config;
+}
+
+}  // namespace
+
+TEST(LoopHealthTest, RejectsInvalidSettings) {
+    LoopHealth::Settings window;
+    window.window = 4;
+    EXPECT_THROW(LoopHealth{window}, std::invalid_argument);
+
+    LoopHealth::Settings order;
+    order.arOrder = 0;
+    EXPECT_THROW(LoopHealth{order}, std::invalid_argument);
+
+    LoopHealth::Settings delay;
+    delay.delay = 0;
+    EXPECT_THROW(LoopHealth{delay}, std::invalid_argument);
+}
+
+TEST(LoopHealthTest, DetectsSustainedSinusoid) {
+    LoopHealth health{LoopHealth::Settings{}};
+    const double period = 40.0;
+    for (int k = 0; k < 1000; ++k) {
+        health.update(0.1 * std::sin(TWO_PI * k / period), 1.0);
+    }
+
+    auto status = health.status();
+    EXPECT_TRUE(status.oscillating);
+    EXPECT_NEAR(status.period, period, 1.0);
+    EXPECT_GT(status.regularity, 5.0);
+    EXPECT_GT(status.peakFraction, 0.8);
+    // Bin resolution is window / k: 256 / 6 = 42.7 s
+    EXPECT_NEAR(status.peakPeriod, period, 5.0);
+    EXPECT_NEAR(status.errorStdDev, 0.1 / std::sqrt(2.0), 0.005);
+}
+
+TEST(LoopHealthTest, WhiteNoiseIsNotOscillatingAndAtBenchmark) {
+    LoopHealth health{LoopHealth::Settings{}};
+    std::mt19937 rng(7);
+    std::normal_distribution<double> noise(0.0, 0.05);
+    for (int k = 0; k < 2000; ++k) {
+        health.update(noise(rng), 1.0);
+    }
+
+    auto status = health.status();
+    EXPECT_FALSE(status.oscillating);
+    EXPECT_FALSE(status.poorPerformance);
+    // White noise is already minimum variance
+    EXPECT_GT(status.harrisIndex, 0.8);
+}
+
+TEST(LoopHealthTest, SluggishResponseHasLowHarrisIndex) {
+    // Heavily filtered noise: e_t = 0.95 e_{t-1} + w_t has eta = 1 - 0.95^2
+    LoopHealth health{LoopHealth::Settings{}};
+    std::mt19937 rng(11);
+    std::normal_distribution<double> noise(0.0, 0.05);
+    double error = 0.0;
+    for (int k = 0; k < 5000; ++k) {
+        error = 0.95 * error + noise(rng);
+        health.update(error, 1.0);
+    }
+
+    auto status = health.status();
+    EXPECT_TRUE(status.poorPerformance);
+    EXPECT_NEAR(status.harrisIndex, 1.0 - 0.95 * 0.95, 0.05);
+}
+
+TEST(LoopHealthTest, QuietLoopAndResetClearFlags) {
+    LoopHealth health{LoopHealth::Settings{}};
+    for (int k = 0; k < 600; ++k) {
+        health.update(0.1 * std::sin(TWO_PI * k / 30.0), 1.0);
+    }
+    ASSERT_TRUE(health.status().oscillating);
+
+    // Oscillation dies out: crossings stop and the window goes quiet
+    for (int k = 0; k < 300; ++k) {
+        health.update(0.0, 1.0);
+    }
+    auto quiet = health.status();
+    EXPECT_FALSE(quiet.oscillating);
+    EXPECT_TRUE(std::isnan(quiet.regularity));
+    EXPECT_TRUE(std::isnan(quiet.harrisIndex));
+
+    health.reset();
+    EXPECT_EQ(health.status().samples, 0);
+    EXPECT_TRUE(std::isnan(health.status().errorStdDev));
+}
+
+TEST(LoopHealthTest, SimulatorFlagsAggressiveLoop) {
+    // Far too much integral action leaves a sustained limit cycle against
+    // the valve limits; the nominal tuning settles.
+    Simulator aggressive(monitoredConfig(0.5));
+    Simulator nominal(monitoredConfig(10.0));
+    aggressive.setSetpoint(0, TANK_NOMINAL_HEIGHT + 0.5);
+    nominal.setSetpoint(0, TANK_NOMINAL_HEIGHT + 0.5);
+    for (int k = 0; k < 2000; ++k) {
+        aggressive.step();
+        nominal.step();
+    }
+
+    auto bad = aggressive.getLoopHealth()[0];
+    EXPECT_TRUE(bad.oscillating);
+    EXPECT_TRUE(bad.poorPerformance);
+    EXPECT_FALSE(nominal.getLoopHealth()[0].oscillating);
+    EXPECT_FALSE(nominal.getLoopHealth()[0].poorPerformance);
+
+    Simulator::Config plain = monitoredConfig(10.0);
+    plain.monitorLoopHealth = false;
+    Simulator unmonitored(plain);
+    EXPECT_THROW(unmonitored.getLoopHealth(), std::invalid_argument);
+}
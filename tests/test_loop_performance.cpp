@@ -0,0 +1,151 @@
+#include <gtest/gtest.h>
+#include <Eigen/Dense>
+#include <cmath>
+#include <stdexcept>
+#include "../src/loop_performance.h"
+#include "../src/simulator.h"
+#include "../src/constants.h"
+
+using namespace tank_sim;
+using namespace tank_sim::constants;
+
+namespace {
+
+// Level setpoint loop on the nominal tank, as in the simulator tests
+Simulator::Config levelLoopConfig() {
+    Simulator::Config config;
+    config.params = TankModel::Parameters{DEFAULT_TANK_AREA, DEFAULT_VALVE_COEFFICIENT,
+                                          TANK_MAX_HEIGHT};
+    config.initialState = Eigen::VectorXd(1);
+    config.initialState << TANK_NOMINAL_HEIGHT;
+    config.initialInputs = Eigen::VectorXd(2);
+    config.initialInputs << TEST_INLET_FLOW, TEST_VALVE_POSITION;
+    config.dt = TEST_DT;
+
+    Simulator::ControllerConfig ctrl;
+    ctrl.gains = PIDController::Gains{-1.0, 10.0, 0.0};  // reverse-acting
+    ctrl.bias = TEST_VALVE_POSITION;
+    ctrl.minOutputLimit = 0.0;
+    ctrl.maxOutputLimit = 1.0;
+    ctrl.maxIntegralAccumulation = 10.0;
+    ctrl.measuredIndex = 0;
+    ctrl.outputIndex = 1;
+    ctrl.initialSetpoint = TANK_NOMINAL_HEIGHT;
+    config.controllerConfig.push_back(ctrl);
+    return config;
+}
+
+}  // namespace
+
+TEST(LoopPerformanceTest, RejectsInvalidSettings) {
+    LoopPerformance::Settings band;
+    band.settlingBand = 0.0;
+    EXPECT_THROW(LoopPerformance{band}, std::invalid_argument);
+
+    LoopPerformance::Settings rise;
+    rise.riseLow = 0.9;
+    rise.riseHigh = 0.1;
+    EXPECT_THROW(LoopPerformance{rise}, std::invalid_argument);
+}
+
+TEST(LoopPerformanceTest, IntegralsOfConstantError) {
+    LoopPerformance kpi{LoopPerformance::Settings{}};
+    kpi.restart(1.0, 0.0, 0.0);
+    for (int k = 0; k < 10; ++k) {
+        kpi.update(1.0, 0.5, 0.0, 0.1);
+    }
+
+    auto s = kpi.snapshot();
+    EXPECT_NEAR(s.elapsed, 1.0, 1e-12);
+    EXPECT_NEAR(s.step, 1.0, 1e-12);
+    EXPECT_NEAR(s.iae, 0.5, 1e-12);
+    EXPECT_NEAR(s.ise, 0.25, 1e-12);
+    // sum_k (0.1 k) * 0.5 * 0.1 for k = 1..10
+    EXPECT_NEAR(s.itae, 0.275, 1e-12);
+    EXPECT_TRUE(std::isnan(s.riseTime));
+    EXPECT_TRUE(std::isnan(s.settlingTime));
+}
+
+TEST(LoopPerformanceTest, StepResponseIndices) {
+    LoopPerformance kpi{LoopPerformance::Settings{}};
+    kpi.restart(1.0, 0.0, 0.0);
+
+    // Ramp through 10% at t=1 and 90% at t=9, overshoot to 1.2, settle at t=14
+    const double trace[] = {0.05, 0.1, 0.5, 0.8, 0.85, 0.88, 0.89, 0.895, 0.9,
+                            1.1,  1.2, 1.1, 1.05, 1.03, 1.01, 1.0,  1.0};
+    for (double y : trace) {
+        kpi.update(1.0, y, 0.0, 1.0);
+    }
+
+    auto s = kpi.snapshot();
+    EXPECT_NEAR(s.riseTime, 7.0, 1e-12);  // 9 - 2
+    EXPECT_NEAR(s.overshoot, 0.2, 1e-12);
+    EXPECT_NEAR(s.settlingTime, 14.0, 1e-12);
+
+    // Leaving the band clears the settling time until the loop returns
+    kpi.update(1.0, 0.9, 0.0, 1.0);
+    EXPECT_TRUE(std::isnan(kpi.snapshot().settlingTime));
+    kpi.update(1.0, 1.0, 0.0, 1.0);
+    EXPECT_NEAR(kpi.snapshot().settlingTime, 18.0, 1e-12);
+}
+
+TEST(LoopPerformanceTest, DownwardStepAndValveTravel) {
+    LoopPerformance kpi{LoopPerformance::Settings{}};
+    kpi.restart(0.0, 1.0, 0.5);
+
+    kpi.update(0.0, 0.5, 0.7, 1.0);
+    kpi.update(0.0, -0.1, 0.4, 1.0);
+    kpi.update(0.0, 0.0, 0.4, 1.0);
+
+    auto s = kpi.snapshot();
+    EXPECT_NEAR(s.step, -1.0, 1e-12);
+    EXPECT_NEAR(s.overshoot, 0.1, 1e-12);
+    EXPECT_NEAR(s.riseTime, 1.0, 1e-12);
+    EXPECT_NEAR(s.valveTravel, 0.5, 1e-12);  // 0.2 + 0.3 + 0
+}
+
+TEST(LoopPerformanceTest, ZeroStepOnlyAccumulatesIntegrals) {
+    LoopPerformance kpi{LoopPerformance::Settings{}};
+    kpi.restart(1.0, 1.0, 0.0);
+    kpi.update(1.0, 1.1, 0.0, 1.0);
+
+    auto s = kpi.snapshot();
+    EXPECT_NEAR(s.iae, 0.1, 1e-12);
+    EXPECT_EQ(s.overshoot, 0.0);
+    EXPECT_TRUE(std::isnan(s.riseTime));
+    EXPECT_TRUE(std::isnan(s.settlingTime));
+}
+
+TEST(LoopPerformanceTest, SimulatorRestartsOnSetpointChange) {
+    Simulator sim(levelLoopConfig());
+    for (int k = 0; k < 10; ++k) {
+        sim.step();
+    }
+    auto initial = sim.getPerformance();
+    ASSERT_EQ(initial.size(), 1u);
+    EXPECT_NEAR(initial[0].elapsed, 10 * TEST_DT, 1e-9);
+    EXPECT_NEAR(initial[0].step, 0.0, 1e-12);
+
+    sim.setSetpoint(0, TANK_NOMINAL_HEIGHT + 0.5);
+    for (int k = 0; k < 3000; ++k) {
+        sim.step();
+    }
+    auto s = sim.getPerformance()[0];
+    EXPECT_NEAR(s.elapsed, 3000 * TEST_DT, 1e-6);
+    EXPECT_NEAR(s.step, 0.5, 1e-4);
+    EXPECT_GT(s.iae, 0.0);
+    EXPECT_GT(s.valveTravel, 0.0);
+    EXPECT_FALSE(std::isnan(s.riseTime));
+    EXPECT_FALSE(std::isnan(s.settlingTime));
+
+    // Re-sending the same setpoint keeps the KPIs
+    sim.setSetpoint(0, TANK_NOMINAL_HEIGHT + 0.5);
+    auto kept = sim.getPerformance()[0];
+    EXPECT_DOUBLE_EQ(kept.elapsed, s.elapsed);
+    EXPECT_DOUBLE_EQ(kept.iae, s.iae);
+    EXPECT_DOUBLE_EQ(kept.riseTime, s.riseTime);
+
+    sim.reset();
+    EXPECT_EQ(sim.getPerformance()[0].elapsed, 0.0);
+    EXPECT_EQ(sim.getPerformance()[0].iae, 0.0);
+}
@@ -0,0 +1,158 @@
+#include <gtest/gtest.h>
+#include <Eigen/Dense>
+#include <stdexcept>
+#include "../src/mpc_controller.h"
+#include "../src/simulator.h"
+#include "../src/constants.h"
+
+using namespace tank_sim;
+using namespace tank_sim::constants;
+
+namespace {
+
+Simulator::ControllerConfig mpcLevelController() {
+    Simulator::ControllerConfig ctrl;
+    ctrl.gains = PIDController::Gains{0.0, 0.0, 0.0};
+    ctrl.bias = TEST_VALVE_POSITION;
+    ctrl.minOutputLimit = 0.0;
+    ctrl.maxOutputLimit = 1.0;
+    ctrl.maxIntegralAccumulation = 0.0;
+    ctrl.measuredIndex = 0;
+    ctrl.outputIndex = 1;
+    ctrl.initialSetpoint = TANK_NOMINAL_HEIGHT;
+    ctrl.type = Simulator::ControllerType::MPC;
+    return ctrl;
+}
+
+Simulator::Config mpcConfig() {
+    Simulator::Config config;
+    config.params = TankModel::Parameters{DEFAULT_TANK_AREA, DEFAULT_VALVE_COEFFICIENT,
+                                          TANK_MAX_HEIGHT};
+    config.initialState = Eigen::VectorXd(1);
+    config.initialState << TANK_NOMINAL_HEIGHT;
+    config.initialInputs = Eigen::VectorXd(2);
+    config.initialInputs << TEST_INLET_FLOW, TEST_VALVE_POSITION;
+    config.dt = TEST_DT;
+    config.controllerConfig.push_back(mpcLevelController());
+    return config;
+}
+
+}  // namespace
+
+// Test: Invalid settings are rejected at construction
+TEST(MPCControllerTest, RejectsInvalidSettings) {
+    MPCController::Settings settings;
+    EXPECT_NO_THROW(MPCController(settings, 0, 1, 0.0, 1.0));
+
+    MPCController::Settings bad = settings;
+    bad.horizon = 0;
+    EXPECT_THROW(MPCController(bad, 0, 1, 0.0, 1.0), std::invalid_argument);
+
+    bad = settings;
+    bad.controlHorizon = settings.horizon + 1;
+    EXPECT_THROW(MPCController(bad, 0, 1, 0.0, 1.0), std::invalid_argument);
+
+    bad = settings;
+    bad.moveWeight = -1.0;
+    EXPECT_THROW(MPCController(bad, 0, 1, 0.0, 1.0), std::invalid_argument);
+
+    bad = settings;
+    bad.rho = 0.0;
+    EXPECT_THROW(MPCController(bad, 0, 1, 0.0, 1.0), std::invalid_argument);
+
+    EXPECT_THROW(MPCController(settings, 0, 2, 0.0, 1.0), std::invalid_argument);
+    EXPECT_THROW(MPCController(settings, 0, 1, 1.0, 0.0), std::invalid_argument);
+}
+
+// Test: At equilibrium on setpoint the plan holds the current output
+TEST(MPCControllerTest, HoldsAtEquilibrium) {
+    TankModel model(TankModel::Parameters{DEFAULT_TANK_AREA, DEFAULT_VALVE_COEFFICIENT,
+                                          TANK_MAX_HEIGHT});
+    // Valve position that balances the inlet flow at nominal level
+    double x_eq = TEST_INLET_FLOW / (DEFAULT_VALVE_COEFFICIENT * std::sqrt(TANK_NOMINAL_HEIGHT));
+    Eigen::VectorXd state(1);
+    state << TANK_NOMINAL_HEIGHT;
+    Eigen::VectorXd inputs(2);
+    inputs << TEST_INLET_FLOW, x_eq;
+
+    MPCController mpc(MPCController::Settings{}, 0, 1, 0.0, 1.0);
+    double u = mpc.compute(model, state, inputs, TANK_NOMINAL_HEIGHT, TEST_DT);
+
+    EXPECT_NEAR(u, x_eq, 1e-5);
+    for (int j = 0; j < mpc.plan().size(); ++j) {
+        EXPECT_NEAR(mpc.plan()(j), x_eq, 1e-5);
+    }
+    EXPECT_TRUE(mpc.stats().lastConverged);
+}
+
+// Test: A large setpoint step drives the output onto its bound
+TEST(MPCControllerTest, RespectsOutputBounds) {
+    TankModel model(TankModel::Parameters{DEFAULT_TANK_AREA, DEFAULT_VALVE_COEFFICIENT,
+                                          TANK_MAX_HEIGHT});
+    Eigen::VectorXd state(1);
+    state << TANK_NOMINAL_HEIGHT;
+    Eigen::VectorXd inputs(2);
+    inputs << TEST_INLET_FLOW, TEST_VALVE_POSITION;
+
+    MPCController mpc(MPCController::Settings{}, 0, 1, 0.1, 0.9);
+    // Far above the level: close the valve as far as allowed
+    EXPECT_DOUBLE_EQ(mpc.compute(model, state, inputs, TANK_MAX_HEIGHT, TEST_DT), 0.1);
+    // Far below the level: open it as far as allowed
+    EXPECT_DOUBLE_EQ(mpc.compute(model, state, inputs, 0.0, TEST_DT), 0.9);
+    for (int j = 0; j < mpc.plan().size(); ++j) {
+        EXPECT_GE(mpc.plan()(j), 0.1);
+        EXPECT_LE(mpc.plan()(j), 0.9);
+    }
+}
+
+// Test: MPC in the Simulator tracks a setpoint step and records latency
+TEST(MPCControllerTest, SimulatorTracksSetpoint) {
+    Simulator sim(mpcConfig());
+    sim.setSetpoint(0, 3.0);
+
+    for (int i = 0; i < 600; ++i) {
+        sim.step();
+        double valve = sim.getInputs()(1);
+        ASSERT_GE(valve, 0.0);
+        ASSERT_LE(valve, 1.0);
+    }
+
+    EXPECT_NEAR(sim.getState()(0), 3.0, 1e-3);
+    const MPCController::SolveStats &stats = sim.getMPCStats(0);
+    EXPECT_EQ(stats.solves, 600);
+    EXPECT_TRUE(stats.lastConverged);
+    EXPECT_GT(stats.maxMicros, 0.0);
+    EXPECT_LE(stats.meanMicros, stats.maxMicros);
+
+    // Reset restarts cold but keeps the statistics
+    sim.reset();
+    EXPECT_DOUBLE_EQ(sim.getInputs()(1), TEST_VALVE_POSITION);
+    EXPECT_EQ(sim.getMPCStats(0).solves, 600);
+}
+
+// Test: Invalid MPC placements in the Simulator are rejected
+TEST(MPCControllerTest, SimulatorRejectsInvalidUse) {
+    Simulator::Config config = mpcConfig();
+    config.controllerConfig[0].outputIndex = -1;
+    EXPECT_THROW(Simulator{config}, std::invalid_argument);
+
+    config = mpcConfig();
+    config.controllerConfig.push_back(mpcLevelController());
+    config.controllerConfig[1].type = Simulator::ControllerType::PID;
+    config.controlLinks.push_back(
+        {ControlLink::Type::Ratio, {SignalRef::Source::Input, 0}, 0, 1.0, 0.0});
+    EXPECT_THROW(Simulator{config}, std::invalid_argument);
+
+    config = mpcConfig();
+    config.gainSchedules.push_back(
+        {0, {SignalRef::Source::State, 0}, {{0.0, {-1.0, 10.0, 0.0}}}});
+    EXPECT_THROW(Simulator{config}, std::invalid_argument);
+
+    config = mpcConfig();
+    config.controllerConfig.push_back(mpcLevelController());
+    config.controllerConfig[1].type = Simulator::ControllerType::PID;
+    Simulator sim(config);
+    EXPECT_THROW(sim.setControllerGains(0, {-1.0, 10.0, 0.0}), std::invalid_argument);
+    EXPECT_THROW(sim.getMPCStats(1), std::invalid_argument);
+    EXPECT_THROW(sim.getMPCStats(2), std::out_of_range);
+}
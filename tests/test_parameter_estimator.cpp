@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+#include <Eigen/Dense>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include "../src/parameter_estimator.h"
+#include "../src/simulator.h"
+#include "../src/constants.h"
+
+using namespace tank_sim;
+using namespace tank_sim::constants;
+
+namespace {
+
+// Record an open-loop run with stepped inlet flow and valve position
+RecordedData recordTank(double area, double k_v, int samples, double noise_stddev = 0.0) {
+    Simulator::Config config;
+    config.params = TankModel::Parameters{area, k_v, TANK_MAX_HEIGHT};
+    config.initialState = Eigen::VectorXd(1);
+    config.initialState << TANK_NOMINAL_HEIGHT;
+    config.initialInputs = Eigen::VectorXd(2);
+    config.initialInputs << TEST_INLET_FLOW, TEST_VALVE_POSITION;
+    config.dt = TEST_DT;
+    Simulator sim(config);
+
+    std::mt19937 rng(3);
+    std::normal_distribution<double> noise(0.0, 1.0);
+    RecordedData data{TEST_DT, {}, {}, {}};
+    for (int k = 0; k < samples; ++k) {
+        if (k % 150 == 0) {
+            sim.setInput(0, k % 300 == 0 ? 1.3 : 0.7);
+        }
+        if (k % 200 == 0) {
+            sim.setInput(1, k % 400 == 0 ? 0.4 : 0.6);
+        }
+        data.level.push_back(sim.getState()(0) + noise_stddev * noise(rng));
+        data.inletFlow.push_back(sim.getInputs()(0));
+        data.valvePosition.push_back(sim.getInputs()(1));
+        sim.step();
+    }
+    return data;
+}
+
+}  // namespace
+
+// Test: Noise-free data recovers the true parameters from a poor guess
+TEST(ParameterEstimatorTest, RecoversParametersExactly) {
+    RecordedData data = recordTank(DEFAULT_TANK_AREA, DEFAULT_VALVE_COEFFICIENT, 1200);
+    ParameterEstimator estimator;
+
+    ParameterEstimator::Result result =
+        estimator.estimate(data, TankModel::Parameters{60.0, 3.0, TANK_MAX_HEIGHT});
+
+    EXPECT_TRUE(result.converged);
+    EXPECT_NEAR(result.params.area, DEFAULT_TANK_AREA, 1e-6 * DEFAULT_TANK_AREA);
+    EXPECT_NEAR(result.params.k_v, DEFAULT_VALVE_COEFFICIENT, 1e-6 * DEFAULT_VALVE_COEFFICIENT);
+    EXPECT_DOUBLE_EQ(result.params.max_height, TANK_MAX_HEIGHT);
+    EXPECT_LT(result.rmsResidual, 1e-8);
+}
+
+// Test: With sensor noise the fit is unbiased and residual matches the noise
+TEST(ParameterEstimatorTest, FitsNoisyData) {
+    const double sigma = 0.01;
+    RecordedData data = recordTank(DEFAULT_TANK_AREA, DEFAULT_VALVE_COEFFICIENT, 1200, sigma);
+    ParameterEstimator estimator;
+
+    ParameterEstimator::Result result =
+        estimator.estimate(data, TankModel::Parameters{100.0, 1.0, TANK_MAX_HEIGHT});
+
+    EXPECT_NEAR(result.params.area, DEFAULT_TANK_AREA, 0.01 * DEFAULT_TANK_AREA);
+    EXPECT_NEAR(result.params.k_v, DEFAULT_VALVE_COEFFICIENT, 0.01 * DEFAULT_VALVE_COEFFICIENT);
+    EXPECT_NEAR(result.rmsResidual, sigma, 0.2 * sigma);
+}
+
+// Test: Parallel fits match sequential fits, in input order
+TEST(ParameterEstimatorTest, EstimateManyMatchesSequential) {
+    std::vector<RecordedData> data;
+    std::vector<TankModel::Parameters> guesses;
+    for (int i = 0; i < 8; ++i) {
+        data.push_back(recordTank(80.0 + 10.0 * i, 1.0 + 0.1 * i, 600));
+        guesses.push_back(TankModel::Parameters{100.0, 1.5, TANK_MAX_HEIGHT});
+    }
+    ParameterEstimator estimator;
+
+    std::vector<ParameterEstimator::Result> results = estimator.estimateMany(data, guesses, 4);
+
+    ASSERT_EQ(results.size(), data.size());
+    for (size_t i = 0; i < data.size(); ++i) {
+        ParameterEstimator::Result single = estimator.estimate(data[i], guesses[i]);
+        EXPECT_DOUBLE_EQ(results[i].params.area, single.params.area);
+        EXPECT_DOUBLE_EQ(results[i].params.k_v, single.params.k_v);
+        EXPECT_NEAR(results[i].params.area, 80.0 + 10.0 * i, 1e-4);
+    }
+}
+
+// Test: Invalid records, guesses and settings are rejected
+TEST(ParameterEstimatorTest, RejectsInvalidInput) {
+    ParameterEstimator estimator;
+    TankModel::Parameters guess{100.0, 1.0, TANK_MAX_HEIGHT};
+
+    RecordedData short_record{1.0, {1.0}, {0.5}, {2.5}};
+    EXPECT_THROW(estimator.estimate(short_record, guess), std::invalid_argument);
+
+    RecordedData mismatched{1.0, {1.0, 1.0}, {0.5}, {2.5, 2.5}};
+    EXPECT_THROW(estimator.estimate(mismatched, guess), std::invalid_argument);
+
+    RecordedData good = recordTank(DEFAULT_TANK_AREA, DEFAULT_VALVE_COEFFICIENT, 10);
+    EXPECT_THROW(estimator.estimate(good, TankModel::Parameters{0.0, 1.0, 5.0}),
+                 std::invalid_argument);
+
+    // An error in one parallel fit is reported to the caller
+    EXPECT_THROW(estimator.estimateMany({good, mismatched}, {guess, guess}, 2),
+                 std::invalid_argument);
+    EXPECT_THROW(estimator.estimateMany({good}, {}, 2), std::invalid_argument);
+
+    ParameterEstimator::Settings settings;
+    settings.maxIterations = 0;
+    EXPECT_THROW(ParameterEstimator{settings}, std::invalid_argument);
+}
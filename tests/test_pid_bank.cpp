@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+#include <Eigen/Dense>
+#include <cmath>
+#include "../src/pid_bank.h"
+#include "../src/pid_controller.h"
+#include "../src/constants.h"
+
+using namespace tank_sim;
+using namespace tank_sim::constants;
+
+// Test: A single bank loop reproduces PIDController exactly
+TEST(PIDBankTest, MatchesPIDControllerForSingleLoop) {
+    PIDController::Gains gains{-1.0, DEFAULT_PID_INTEGRAL_TIME, DEFAULT_PID_DERIVATIVE_TIME};
+    PIDController pid(gains, DEFAULT_PID_BIAS, DEFAULT_PID_MIN_OUTPUT,
+                      DEFAULT_PID_MAX_OUTPUT, DEFAULT_PID_MAX_INTEGRAL);
+
+    PIDBank bank;
+    bank.addLoop(gains, DEFAULT_PID_BIAS, DEFAULT_PID_MIN_OUTPUT,
+                 DEFAULT_PID_MAX_OUTPUT, DEFAULT_PID_MAX_INTEGRAL, 0, 1, 2.5);
+
+    Eigen::VectorXd state(1);
+    Eigen::VectorXd inputs(2);
+    inputs << TEST_INLET_FLOW, TEST_VALVE_POSITION;
+
+    double previous_error = 0.0;
+    for (int k = 0; k < 200; ++k) {
+        // Excursion large enough to hit both saturation limits
+        state(0) = 2.5 + 1.5 * std::sin(0.05 * k);
+        double error = 2.5 - state(0);
+        double expected = pid.compute(error, (error - previous_error) / TEST_DT, TEST_DT);
+        previous_error = error;
+
+        bank.update(state, inputs, TEST_DT);
+
+        EXPECT_DOUBLE_EQ(inputs(1), expected);
+        EXPECT_DOUBLE_EQ(bank.getIntegralState(0), pid.getIntegralState());
+    }
+}
+
+// Test: Gather/scatter plan routes each loop independently
+TEST(PIDBankTest, GatherScatterRoutesLoops) {
+    PIDController::Gains p_only{2.0, 0.0, 0.0};
+
+    PIDBank bank;
+    bank.addLoop(p_only, 0.0, -10.0, 10.0, DEFAULT_PID_MAX_INTEGRAL, 1, 0, 1.0);
+    bank.addLoop(p_only, 0.0, -10.0, 10.0, DEFAULT_PID_MAX_INTEGRAL, 0, 2, 0.0);
+    ASSERT_EQ(bank.size(), 2);
+
+    Eigen::VectorXd state(2);
+    state << 0.5, 0.25;
+    Eigen::VectorXd inputs = Eigen::VectorXd::Zero(3);
+
+    bank.update(state, inputs, TEST_DT);
+
+    EXPECT_DOUBLE_EQ(inputs(0), 2.0 * (1.0 - 0.25));  // loop 0 reads state[1]
+    EXPECT_DOUBLE_EQ(inputs(1), 0.0);                 // untouched
+    EXPECT_DOUBLE_EQ(inputs(2), 2.0 * (0.0 - 0.5));   // loop 1 reads state[0]
+}
+
+// Test: Anti-windup freezes the integral while saturated
+TEST(PIDBankTest, AntiWindupWhileSaturated) {
+    PIDController::Gains gains{DEFAULT_PID_PROPORTIONAL_GAIN, DEFAULT_PID_INTEGRAL_TIME, 0.0};
+
+    PIDBank bank;
+    bank.addLoop(gains, DEFAULT_PID_BIAS, DEFAULT_PID_MIN_OUTPUT,
+                 DEFAULT_PID_MAX_OUTPUT, DEFAULT_PID_MAX_INTEGRAL, 0, 0, 100.0);
+
+    Eigen::VectorXd state = Eigen::VectorXd::Zero(1);
+    Eigen::VectorXd inputs = Eigen::VectorXd::Zero(1);
+    for (int k = 0; k < 10; ++k) {
+        bank.update(state, inputs, TEST_DT);
+    }
+
+    EXPECT_DOUBLE_EQ(inputs(0), DEFAULT_PID_MAX_OUTPUT);
+    EXPECT_DOUBLE_EQ(bank.getIntegralState(0), 0.0);
+}
+
+// Test: reset() clears integral state and previous error only
+TEST(PIDBankTest, ResetClearsLoopState) {
+    PIDController::Gains gains{0.01, DEFAULT_PID_INTEGRAL_TIME, 0.0};
+
+    PIDBank bank;
+    bank.addLoop(gains, DEFAULT_PID_BIAS, DEFAULT_PID_MIN_OUTPUT,
+                 DEFAULT_PID_MAX_OUTPUT, DEFAULT_PID_MAX_INTEGRAL, 0, 0, 1.0);
+
+    Eigen::VectorXd state = Eigen::VectorXd::Zero(1);
+    Eigen::VectorXd inputs = Eigen::VectorXd::Zero(1);
+    bank.update(state, inputs, TEST_DT);
+    EXPECT_GT(bank.getIntegralState(0), 0.0);
+    EXPECT_DOUBLE_EQ(bank.getPreviousError(0), 1.0);
+
+    bank.reset();
+    EXPECT_DOUBLE_EQ(bank.getIntegralState(0), 0.0);
+    EXPECT_DOUBLE_EQ(bank.getPreviousError(0), 0.0);
+    EXPECT_DOUBLE_EQ(bank.getSetpoint(0), 1.0);
+}
+
+// Test: Invalid loop parameters are rejected
+TEST(PIDBankTest, RejectsInvalidParameters) {
+    PIDBank bank;
+    EXPECT_THROW(bank.addLoop({1.0, -1.0, 0.0}, 0.0, 0.0, 1.0, 1.0, 0, 0, 0.0),
+                 std::invalid_argument);
+    EXPECT_THROW(bank.addLoop({1.0, 1.0, 0.0}, 0.0, 1.0, 0.0, 1.0, 0, 0, 0.0),
+                 std::invalid_argument);
+    EXPECT_THROW(bank.addLoop({1.0, 1.0, 0.0}, 0.0, 0.0, 1.0, 1.0, -2, 0, 0.0),
+                 std::invalid_argument);
+    EXPECT_EQ(bank.size(), 0);
+
+    bank.addLoop({1.0, 1.0, 0.0}, 0.0, 0.0, 1.0, 1.0, 0, 0, 0.0);
+    EXPECT_THROW(bank.setGains(0, {1.0, 1.0, -0.5}), std::invalid_argument);
+}
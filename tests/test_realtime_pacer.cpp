@@ -0,0 +1,160 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cmath>
+#include <future>
+#include <stdexcept>
+#include <thread>
+#include "../src/realtime_pacer.h"
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+using namespace tank_sim;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+RealtimePacer::Settings pacing(double period, RealtimePacer::CatchUp catch_up) {
+    RealtimePacer::Settings settings;
+    settings.period = period;
+    settings.catchUp = catch_up;
+    return settings;
+}
+
+void busyFor(std::chrono::milliseconds duration) {
+    std::this_thread::sleep_for(duration);
+}
+
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+}  // namespace
+
+TEST(RealtimePacerTest, WorkDoesNotShiftLaterTicks) {
+    // 40 ticks of 5 ms with 2 ms of work each: "work, then sleep" would
+    // take 280 ms, absolute deadlines take 200 ms
+    RealtimePacer pacer(pacing(0.005, RealtimePacer::CatchUp::Burst));
+    const auto start = Clock::now();
+    pacer.start();
+    for (int i = 0; i < 40; ++i) {
+        ASSERT_TRUE(pacer.wait());
+        busyFor(std::chrono::milliseconds(2));
+    }
+    const double elapsed = secondsSince(start);
+    EXPECT_GE(elapsed, 0.200);
+    EXPECT_LT(elapsed, 0.240);
+
+    const auto stats = pacer.stats();
+    EXPECT_EQ(stats.ticks, 40u);
+    EXPECT_EQ(stats.skipped, 0u);
+    std::uint64_t counted = 0;
+    for (std::uint64_t count : stats.histogram) {
+        counted += count;
+    }
+    EXPECT_EQ(counted, 40u);
+    EXPECT_GE(stats.maxLatenessMicros, stats.meanLatenessMicros);
+    EXPECT_FALSE(stats.realtime);
+}
+
+TEST(RealtimePacerTest, CatchUpPoliciesHandleAStall) {
+    const auto stall = std::chrono::milliseconds(48);   // misses 4 deadlines of 10 ms
+
+    // Burst: the missed ticks run back to back, none is dropped
+    RealtimePacer burst(pacing(0.010, RealtimePacer::CatchUp::Burst));
+    burst.start();
+    ASSERT_TRUE(burst.wait());
+    busyFor(stall);
+    const auto resumed = Clock::now();
+    int immediate = 0;
+    while (secondsSince(resumed) < 0.002 && burst.wait()) {
+        ++immediate;
+    }
+    EXPECT_GE(immediate, 4);
+    EXPECT_EQ(burst.stats().skipped, 0u);
+
+    // Skip: one late tick now, the rest dropped, then back on the grid
+    RealtimePacer skip(pacing(0.010, RealtimePacer::CatchUp::Skip));
+    const auto start = Clock::now();
+    skip.start();
+    ASSERT_TRUE(skip.wait());
+    busyFor(stall);
+    ASSERT_TRUE(skip.wait());
+    EXPECT_GE(skip.stats().skipped, 3u);
+    ASSERT_TRUE(skip.wait());
+    const double on_grid = secondsSince(start) / 0.010;
+    EXPECT_NEAR(on_grid, std::round(on_grid), 0.3);
+
+    // Rebase: the late tick runs now and the grid restarts from it
+    RealtimePacer rebase(pacing(0.010, RealtimePacer::CatchUp::Rebase));
+    rebase.start();
+    ASSERT_TRUE(rebase.wait());
+    busyFor(stall);
+    ASSERT_TRUE(rebase.wait());
+    const auto restarted = Clock::now();
+    ASSERT_TRUE(rebase.wait());
+    // A full period after the late tick, not at once as the old grid would
+    // have it; sleeps never end early, so only the lower bound is checked
+    EXPECT_GE(secondsSince(restarted), 0.009);
+    const auto stats = rebase.stats();
+    EXPECT_EQ(stats.ticks, 3u);
+    EXPECT_EQ(stats.rebased, 1u);
+    EXPECT_EQ(stats.skipped, 0u);
+}
+
+TEST(RealtimePacerTest, CancelWakesALongWait) {
+    RealtimePacer pacer(pacing(30.0, RealtimePacer::CatchUp::Burst));
+    pacer.start();
+    const auto start = Clock::now();
+    auto waiter = std::async(std::launch::async, [&pacer]() { return pacer.wait(); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    pacer.cancel();
+    EXPECT_FALSE(waiter.get());
+    EXPECT_LT(secondsSince(start), 0.5);
+    EXPECT_EQ(pacer.stats().ticks, 0u);
+}
+
+TEST(RealtimePacerTest, PercentilesAndSettings) {
+    RealtimePacer::Stats stats;
+    EXPECT_EQ(stats.percentileMicros(0.99), 0.0);
+    stats.histogram[0] = 90;   // < 1 us
+    stats.histogram[5] = 9;    // [16, 32) us
+    stats.histogram[10] = 1;   // [512, 1024) us
+    EXPECT_EQ(stats.percentileMicros(0.5), 1.0);
+    EXPECT_EQ(stats.percentileMicros(0.99), 32.0);
+    EXPECT_EQ(stats.percentileMicros(1.0), 1024.0);
+    EXPECT_TRUE(std::isinf(RealtimePacer::bucketUpperMicros(constants::PACER_LATENESS_BUCKETS - 1)));
+
+    EXPECT_EQ(RealtimePacer::catchUpFromName("skip"), RealtimePacer::CatchUp::Skip);
+    EXPECT_THROW(RealtimePacer::catchUpFromName("sometimes"), std::invalid_argument);
+
+    EXPECT_THROW(RealtimePacer(pacing(0.0, RealtimePacer::CatchUp::Burst)),
+                 std::invalid_argument);
+    RealtimePacer::Settings settings;
+    settings.priority = 100;
+    EXPECT_THROW(RealtimePacer::validate(settings), std::invalid_argument);
+    settings.priority = constants::PACER_RT_PRIORITY;
+    settings.cpu = -2;
+    EXPECT_THROW(RealtimePacer::validate(settings), std::invalid_argument);
+}
+
+TEST(RealtimePacerTest, RealtimeRequestReportsItsOutcome) {
+    // Usually refused without CAP_SYS_NICE; the pacer must work either way
+    RealtimePacer::Settings settings = pacing(0.002, RealtimePacer::CatchUp::Skip);
+    settings.realtime = true;
+    settings.cpu = 0;
+    RealtimePacer pacer(settings);
+    std::thread thread([&pacer]() {
+        const bool entered = pacer.enterRealtime();
+        EXPECT_EQ(pacer.stats().realtime, entered);
+        pacer.start();
+        for (int i = 0; i < 5; ++i) {
+            EXPECT_TRUE(pacer.wait());
+        }
+    });
+    thread.join();
+    EXPECT_EQ(pacer.stats().ticks, 5u);
+#ifdef __linux__
+    munlockall();   // mlockall applies to the whole test process
+#endif
+}
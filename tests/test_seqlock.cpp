@@ -0,0 +1,147 @@
+#include <gtest/gtest.h>
+#include <Eigen/Dense>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include "../src/seqlock.h"
+#include "../src/simulator.h"
+#include "../src/telemetry.h"
+#include "../src/constants.h"
+
+using namespace tank_sim;
+using namespace tank_sim::constants;
+
+namespace {
+
+// Payload whose words must all agree; a torn read mixes two values
+struct Pattern {
+    std::array<std::uint64_t, 37> words;
+};
+
+Pattern makePattern(std::uint64_t value) {
+    Pattern p;
+    p.words.fill(value);
+    return p;
+}
+
+bool consistent(const Pattern& p) {
+    for (auto w : p.words) {
+        if (w != p.words[0]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+TEST(SeqLockTest, ReadReturnsLatestWrite) {
+    SeqLock<Pattern> lock;
+    EXPECT_EQ(lock.version(), 0u);
+    EXPECT_EQ(lock.read().words[0], 0u);
+
+    lock.write(makePattern(7));
+    lock.write(makePattern(9));
+    Pattern out;
+    ASSERT_TRUE(lock.tryRead(out));
+    EXPECT_EQ(out.words[5], 9u);
+    EXPECT_EQ(lock.version(), 2u);
+}
+
+TEST(SeqLockTest, ConcurrentReadersNeverSeeTornValues) {
+    SeqLock<Pattern> lock;
+    std::atomic<bool> done{false};
+    std::atomic<int> torn{0};
+    std::atomic<long long> reads{0};
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 3; ++r) {
+        readers.emplace_back([&]() {
+            std::uint64_t last = 0;
+            while (!done.load(std::memory_order_acquire)) {
+                Pattern p = lock.read();
+                if (!consistent(p) || p.words[0] < last) {
+                    ++torn;
+                }
+                last = p.words[0];
+                ++reads;
+            }
+        });
+    }
+
+    for (std::uint64_t k = 1; k <= 200000; ++k) {
+        lock.write(makePattern(k));
+    }
+    done.store(true, std::memory_order_release);
+    for (auto& t : readers) {
+        t.join();
+    }
+
+    EXPECT_EQ(torn.load(), 0);
+    EXPECT_GT(reads.load(), 0);
+    EXPECT_EQ(lock.read().words[0], 200000u);
+}
+
+TEST(SeqLockTest, SimulatorPublishesFramesToReaderThread) {
+    Simulator::Config config;
+    config.params = TankModel::Parameters{DEFAULT_TANK_AREA, DEFAULT_VALVE_COEFFICIENT,
+                                          TANK_MAX_HEIGHT};
+    config.initialState = Eigen::VectorXd(1);
+    config.initialState << TANK_NOMINAL_HEIGHT;
+    config.initialInputs = Eigen::VectorXd(2);
+    config.initialInputs << TEST_INLET_FLOW, TEST_VALVE_POSITION;
+    config.dt = TEST_DT;
+
+    Simulator::ControllerConfig ctrl;
+    ctrl.gains = PIDController::Gains{-1.0, 10.0, 0.0};
+    ctrl.bias = TEST_VALVE_POSITION;
+    ctrl.minOutputLimit = 0.0;
+    ctrl.maxOutputLimit = 1.0;
+    ctrl.maxIntegralAccumulation = 10.0;
+    ctrl.measuredIndex = 0;
+    ctrl.outputIndex = 1;
+    ctrl.initialSetpoint = TANK_NOMINAL_HEIGHT;
+    config.controllerConfig.push_back(ctrl);
+
+    Simulator sim(config);
+    TelemetryFrame initial = sim.getTelemetry();
+    EXPECT_EQ(initial.step, 0u);
+    EXPECT_EQ(initial.loopCount, 1);
+    EXPECT_DOUBLE_EQ(initial.tankLevel, TANK_NOMINAL_HEIGHT);
+    EXPECT_DOUBLE_EQ(initial.setpoint[0], TANK_NOMINAL_HEIGHT);
+
+    // The reader checks each frame is internally consistent: time matches
+    // the step count, and error matches setpoint - level
+    std::atomic<bool> done{false};
+    std::atomic<int> inconsistent{0};
+    std::thread reader([&]() {
+        std::uint64_t last = 0;
+        while (!done.load(std::memory_order_acquire)) {
+            TelemetryFrame f = sim.getTelemetry();
+            if (f.step < last || f.time != f.step * TEST_DT ||
+                std::abs(f.error[0] - (f.setpoint[0] - f.measuredLevel)) > 1e-12) {
+                ++inconsistent;
+            }
+            last = f.step;
+        }
+    });
+
+    sim.setSetpoint(0, TANK_NOMINAL_HEIGHT + 0.5);
+    for (int k = 0; k < 5000; ++k) {
+        sim.step();
+    }
+    done.store(true, std::memory_order_release);
+    reader.join();
+
+    EXPECT_EQ(inconsistent.load(), 0);
+    TelemetryFrame last = sim.getTelemetry();
+    EXPECT_EQ(last.step, 5000u);
+    EXPECT_DOUBLE_EQ(last.tankLevel, sim.getState()(0));
+    EXPECT_DOUBLE_EQ(last.controllerOutput[0], sim.getControllerOutput(0));
+
+    sim.reset();
+    EXPECT_EQ(sim.getTelemetry().step, 0u);
+}
@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include "../src/session_checkpoint.h"
+#include "../src/simulator.h"
+#include "../src/constants.h"
+#include "test_configs.h"
+
+using namespace tank_sim;
+using namespace tank_sim::constants;
+
+namespace {
+
+/// Session "plant-<i>" stepped i+1 times after a setpoint change, with its history
+SessionCheckpoint::Session runSession(int i, Simulator& sim) {
+    SessionCheckpoint::Session session;
+    session.name = "plant-" + std::to_string(i);
+    session.metadata = "{\"inlet_mode\":\"constant\"}";
+    sim.setSetpoint(0, 2.5 + 0.01 * i);
+    for (int k = 0; k <= i; ++k) {
+        sim.step();
+        session.history.push_back(SessionSample::fromFrame(sim.getTelemetry()));
+    }
+    session.snapshot = sim.captureState();
+    return session;
+}
+
+/// Checkpoint path per test, removed afterwards
+class SessionCheckpointTest : public ::testing::Test {
+protected:
+    std::string path;
+
+    void SetUp() override {
+        path = "/tmp/tank_sim_checkpoint_" + std::to_string(getpid()) + "_" +
+               ::testing::UnitTest::GetInstance()->current_test_info()->name();
+    }
+    void TearDown() override { ::unlink(path.c_str()); }
+};
+
+}  // namespace
+
+TEST_F(SessionCheckpointTest, RestoredSessionsContinueWhereTheyStopped) {
+    const Simulator::Config config = tankConfig();
+    std::vector<std::unique_ptr<Simulator>> originals;
+    std::vector<SessionCheckpoint::Session> sessions;
+    for (int i = 0; i < 50; ++i) {
+        originals.push_back(std::make_unique<Simulator>(config));
+        sessions.push_back(runSession(i, *originals.back()));
+    }
+    const std::uint64_t bytes = SessionCheckpoint::write(path, sessions, 4);
+    EXPECT_GT(bytes, 0u);
+    EXPECT_NE(::access((path + ".tmp").c_str(), F_OK), 0);
+
+    const SessionCheckpoint checkpoint(path);
+    ASSERT_EQ(checkpoint.size(), 50);
+    for (int i = 0; i < checkpoint.size(); ++i) {
+        EXPECT_EQ(checkpoint.name(i), sessions[i].name);
+        EXPECT_EQ(checkpoint.metadata(i), sessions[i].metadata);
+        const auto history = checkpoint.history(i).decode();
+        ASSERT_EQ(history.size(), static_cast<std::size_t>(i + 1));
+        EXPECT_EQ(history.back().time, sessions[i].history.back().time);
+        EXPECT_EQ(history.back().setpoint, sessions[i].history.back().setpoint);
+
+        Simulator restored(config);
+        restored.restoreState(checkpoint.snapshot(i));
+        originals[i]->step();
+        restored.step();
+        EXPECT_EQ(restored.getTime(), originals[i]->getTime());
+        EXPECT_EQ(restored.getState()(0), originals[i]->getState()(0));
+    }
+    EXPECT_THROW(checkpoint.name(50), std::out_of_range);
+}
+
+TEST_F(SessionCheckpointTest, KeepsTheNewestHistoryAcrossCheckpoints) {
+    Simulator sim(tankConfig());
+    SessionCheckpoint::Session session = runSession(0, sim);
+    session.history.clear();
+    for (int k = 0; k < CHECKPOINT_HISTORY_CAPACITY - 100; ++k) {
+        sim.step();
+        session.history.push_back(SessionSample::fromFrame(sim.getTelemetry()));
+    }
+    SessionCheckpoint::write(path, {session});
+
+    // Restored history plus 300 new samples: the oldest 200 are dropped
+    SessionCheckpoint::Session next;
+    {
+        const SessionCheckpoint checkpoint(path);
+        next.name = std::string(checkpoint.name(0));
+        next.earlier = checkpoint.history(0);
+        next.snapshot = checkpoint.snapshot(0);
+    }
+    for (int k = 0; k < 300; ++k) {
+        sim.step();
+        next.history.push_back(SessionSample::fromFrame(sim.getTelemetry()));
+    }
+    SessionCheckpoint::write(path, {next});
+
+    const SessionCheckpoint checkpoint(path);
+    const auto history = checkpoint.history(0).decode();
+    ASSERT_EQ(history.size(), static_cast<std::size_t>(CHECKPOINT_HISTORY_CAPACITY));
+    EXPECT_EQ(history.back().time, sim.getTime());
+    EXPECT_EQ(history.front().time, sim.getTime() - (CHECKPOINT_HISTORY_CAPACITY - 1) * TEST_DT);
+}
+
+TEST_F(SessionCheckpointTest, RejectsMissingTruncatedAndForeignFiles) {
+    EXPECT_THROW(SessionCheckpoint("/nonexistent/checkpoint"), std::runtime_error);
+    EXPECT_THROW(SessionCheckpoint::write("/nonexistent/checkpoint", {}), std::runtime_error);
+
+    { std::ofstream(path) << "not a checkpoint at all, but long enough for a header"; }
+    EXPECT_THROW(SessionCheckpoint{path}, std::runtime_error);
+
+    Simulator sim(tankConfig());
+    SessionCheckpoint::write(path, {runSession(3, sim)});
+    ASSERT_EQ(::truncate(path.c_str(), 200), 0);
+    EXPECT_THROW(SessionCheckpoint{path}, std::runtime_error);
+
+    // An empty checkpoint is valid
+    SessionCheckpoint::write(path, {});
+    EXPECT_EQ(SessionCheckpoint(path).size(), 0);
+}
@@ -0,0 +1,403 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "../src/session_engine.h"
+#include "../src/constants.h"
+#include "test_configs.h"
+
+using namespace tank_sim;
+using namespace tank_sim::constants;
+
+namespace {
+
+SessionEngine::Request request(SessionEngine::Request::Type type, const std::string& name) {
+    SessionEngine::Request r{};
+    r.type = type;
+    r.sessionKey = SessionEngine::sessionKey(name);
+    return r;
+}
+
+}  // namespace
+
+TEST(SessionEngineTest, SessionsLiveFromFirstJoinToLastLeave) {
+    auto engine = std::make_unique<SessionEngine>(tankConfig(), 2);
+    auto& queue = engine->addProducer();
+    using Type = SessionEngine::Request::Type;
+
+    queue.tryPush(request(Type::Join, "plant"));
+    queue.tryPush(request(Type::Join, "plant"));
+    queue.tryPush(request(Type::Join, "other"));
+    queue.tryPush(request(Type::Join, "third"));  // over the limit, ignored
+    EXPECT_EQ(engine->tick(), 2);
+    EXPECT_EQ(engine->sessionCount(), 2);
+    EXPECT_EQ(engine->frames().published(), 2u);
+
+    queue.tryPush(request(Type::Leave, "plant"));
+    queue.tryPush(request(Type::Leave, "other"));
+    engine->tick();
+    EXPECT_EQ(engine->sessionCount(), 1);
+    queue.tryPush(request(Type::Leave, "plant"));
+    EXPECT_EQ(engine->tick(), 0);
+    EXPECT_EQ(engine->sessionCount(), 0);
+
+    EXPECT_THROW(SessionEngine(tankConfig(), 0), std::invalid_argument);
+}
+
+TEST(SessionEngineTest, ReservationsBoundSessionsBeforeTheTick) {
+    auto engine = std::make_unique<SessionEngine>(tankConfig(), 2);
+    auto& first = engine->addProducer();
+    auto& second = engine->addProducer();
+    using Type = SessionEngine::Request::Type;
+
+    // Two front ends admit at once; sessionCount() still says 0
+    ASSERT_TRUE(engine->reserveSession());
+    first.tryPush(request(Type::ReservedJoin, "plant"));
+    ASSERT_TRUE(engine->reserveSession());
+    second.tryPush(request(Type::ReservedJoin, "plant"));   // same shared session
+    EXPECT_FALSE(engine->reserveSession());
+    EXPECT_EQ(engine->sessionCount(), 0);
+    engine->tick();
+    EXPECT_EQ(engine->sessionCount(), 1);
+
+    // The second join handed its room back; plain joins take rooms too
+    first.tryPush(request(Type::Join, "other"));
+    engine->tick();
+    EXPECT_EQ(engine->sessionCount(), 2);
+    EXPECT_FALSE(engine->reserveSession());
+
+    // A destroyed session frees its room
+    first.tryPush(request(Type::Leave, "other"));
+    engine->tick();
+    EXPECT_TRUE(engine->reserveSession());
+}
+
+TEST(SessionEngineTest, PublishesOneWebSocketFramePerSessionAndTick) {
+    auto engine = std::make_unique<SessionEngine>(tankConfig(), 10);
+    auto& first = engine->addProducer();
+    auto& second = engine->addProducer();
+    using Type = SessionEngine::Request::Type;
+    first.tryPush(request(Type::Join, "a"));
+    second.tryPush(request(Type::Join, "b"));
+
+    auto cursor = engine->frames().subscribe();
+    engine->tick();
+    engine->tick();
+
+    std::set<std::uint64_t> keys;
+    SessionEngine::EncodedFrame frame;
+    int frames = 0;
+    while (engine->frames().read(cursor, frame) == SessionEngine::FrameRing::ReadStatus::Ok) {
+        keys.insert(frame.sessionKey);
+        ++frames;
+
+        const std::string_view bytes = frame.bytes();
+        ASSERT_GE(bytes.size(), 4u);
+        EXPECT_EQ(static_cast<unsigned char>(bytes[0]), 0x81u);
+        EXPECT_EQ(static_cast<unsigned char>(bytes[1]), 126u);
+        const std::size_t length = (static_cast<unsigned char>(bytes[2]) << 8) |
+                                   static_cast<unsigned char>(bytes[3]);
+        EXPECT_EQ(length + 4, bytes.size());
+        EXPECT_EQ(bytes.substr(4, 24), "{\"type\":\"state\",\"data\":{");
+        EXPECT_EQ(frame.payload(), bytes.substr(4));
+        EXPECT_DOUBLE_EQ(frame.time, frames <= 2 ? TEST_DT : 2 * TEST_DT);
+    }
+    EXPECT_EQ(frames, 4);
+    EXPECT_EQ(keys, (std::set<std::uint64_t>{SessionEngine::sessionKey("a"),
+                                             SessionEngine::sessionKey("b")}));
+}
+
+TEST(SessionEngineTest, CommandsReachOnlyTheirSession) {
+    auto engine = std::make_unique<SessionEngine>(tankConfig(), 10);
+    auto& queue = engine->addProducer();
+    using Type = SessionEngine::Request::Type;
+    queue.tryPush(request(Type::Join, "a"));
+    queue.tryPush(request(Type::Join, "b"));
+
+    SessionEngine::Request command = request(Type::Command, "a");
+    std::string error;
+    ASSERT_TRUE(SessionEngine::parseClientMessage("{\"type\": \"setpoint\", \"value\": 4.0}",
+                                                  command.command, error));
+    queue.tryPush(command);
+
+    auto cursor = engine->frames().subscribe();
+    engine->tick();
+    SessionEngine::EncodedFrame frame;
+    int checked = 0;
+    while (engine->frames().read(cursor, frame) == SessionEngine::FrameRing::ReadStatus::Ok) {
+        const bool is_a = frame.sessionKey == SessionEngine::sessionKey("a");
+        const std::string expected = is_a ? "\"setpoint\":4.0," : "\"setpoint\":2.5,";
+        EXPECT_NE(std::string(frame.bytes()).find(expected), std::string::npos);
+        ++checked;
+    }
+    EXPECT_EQ(checked, 2);
+}
+
+TEST(SessionEngineTest, ExportedSessionsContinueOnAnotherEngine) {
+    using Type = SessionEngine::Request::Type;
+    auto source = std::make_unique<SessionEngine>(tankConfig(), 10);
+    auto target = std::make_unique<SessionEngine>(tankConfig(), 10);
+    auto& source_queue = source->addProducer();
+    auto& target_queue = target->addProducer();
+    source_queue.tryPush(request(Type::Join, "a"));
+    source_queue.tryPush(request(Type::Join, "a"));
+    SessionEngine::Request command = request(Type::Command, "a");
+    command.command.type = OperatorCommand::Type::SetSetpoint;
+    command.command.value = 3.0;
+    source_queue.tryPush(command);
+    for (int i = 0; i < 3; ++i) {
+        source->tick();
+    }
+
+    // Export removes the session at the next tick, without stepping it
+    source_queue.tryPush(request(Type::Export, "a"));
+    source_queue.tryPush(request(Type::Export, "unknown"));
+    EXPECT_EQ(source->tick(), 0);
+    EXPECT_EQ(source->sessionCount(), 0);
+    std::vector<SessionEngine::Transfer> exports = source->takeExports();
+    ASSERT_EQ(exports.size(), 2u);
+    EXPECT_EQ(exports[0].subscribers, 2);
+    EXPECT_EQ(exports[0].snapshot.time, 3.0 * TEST_DT);
+    EXPECT_EQ(exports[1].subscribers, 0);
+    EXPECT_TRUE(source->takeExports().empty());
+
+    // The import comes before requests queued after it
+    target->importSession(exports[0]);
+    target_queue.tryPush(request(Type::Leave, "a"));
+    auto cursor = target->frames().subscribe();
+    EXPECT_EQ(target->tick(), 1);
+    EXPECT_EQ(target->sessionCount(), 1);
+    SessionEngine::EncodedFrame frame;
+    ASSERT_EQ(target->frames().read(cursor, frame), SessionEngine::FrameRing::ReadStatus::Ok);
+    EXPECT_EQ(frame.time, 4.0 * TEST_DT);
+    EXPECT_NE(std::string(frame.bytes()).find("\"setpoint\":3.0,"), std::string::npos);
+
+    // Snapshots of another configuration are refused
+    SessionEngine::Transfer bad = exports[0];
+    bad.snapshot.loopCount = 2;
+    EXPECT_THROW(target->importSession(bad), std::invalid_argument);
+}
+
+TEST(SessionEngineTest, CommandsQueuedAheadOfAnExportMoveWithTheSession) {
+    using Type = SessionEngine::Request::Type;
+    auto source = std::make_unique<SessionEngine>(tankConfig(), 10);
+    auto target = std::make_unique<SessionEngine>(tankConfig(), 10);
+    auto& queue = source->addProducer();
+    queue.tryPush(request(Type::Join, "a"));
+    source->tick();
+
+    // Command and Export land in the same tick
+    SessionEngine::Request command = request(Type::Command, "a");
+    command.command.type = OperatorCommand::Type::SetSetpoint;
+    command.command.value = 3.7;
+    queue.tryPush(command);
+    queue.tryPush(request(Type::Export, "a"));
+    source->tick();
+    std::vector<SessionEngine::Transfer> exports = source->takeExports();
+    ASSERT_EQ(exports.size(), 1u);
+    EXPECT_EQ(exports[0].snapshot.time, TEST_DT);
+
+    target->importSession(exports[0]);
+    auto cursor = target->frames().subscribe();
+    EXPECT_EQ(target->tick(), 1);
+    SessionEngine::EncodedFrame frame;
+    ASSERT_EQ(target->frames().read(cursor, frame), SessionEngine::FrameRing::ReadStatus::Ok);
+    EXPECT_EQ(frame.telemetry.setpoint[0], 3.7);
+}
+
+TEST(SessionEngineTest, ParsesTheWsProtocolMessages) {
+    OperatorCommand command;
+    std::string error;
+
+    ASSERT_TRUE(SessionEngine::parseClientMessage(
+        "{\"type\":\"pid\",\"Kc\":2.0,\"tau_I\":120,\"tau_D\":-1.5e1}", command, error));
+    EXPECT_EQ(command.type, OperatorCommand::Type::SetGains);
+    EXPECT_DOUBLE_EQ(command.gains.tau_I, 120.0);
+    EXPECT_DOUBLE_EQ(command.gains.tau_D, -15.0);
+
+    ASSERT_TRUE(SessionEngine::parseClientMessage("{\"type\":\"inlet_flow\",\"value\":0.9}",
+                                                  command, error));
+    EXPECT_EQ(command.type, OperatorCommand::Type::SetInput);
+    EXPECT_EQ(command.index, 0);
+    ASSERT_TRUE(SessionEngine::parseClientMessage("{\"type\":\"reset\"}", command, error));
+    EXPECT_EQ(command.type, OperatorCommand::Type::Reset);
+
+    EXPECT_FALSE(SessionEngine::parseClientMessage("{invalid json", command, error));
+    EXPECT_EQ(error, "Invalid JSON format");
+    EXPECT_FALSE(SessionEngine::parseClientMessage("{\"type\":\"setpoint\"}", command, error));
+    EXPECT_EQ(error, "Missing 'value' field");
+    EXPECT_FALSE(SessionEngine::parseClientMessage("{\"type\":\"pid\",\"Kc\":1}", command, error));
+    EXPECT_EQ(error, "Missing PID gain fields (Kc, tau_I, tau_D)");
+    EXPECT_FALSE(SessionEngine::parseClientMessage("{\"type\":\"bogus\"}", command, error));
+    EXPECT_EQ(error, "Unknown message type: bogus");
+
+    ASSERT_TRUE(SessionEngine::parseClientMessage("{\"type\":\"speed\",\"value\":25}",
+                                                  command, error));
+    EXPECT_EQ(command.type, OperatorCommand::Type::SetSpeed);
+    EXPECT_EQ(command.value, 25.0);
+    ASSERT_TRUE(SessionEngine::parseClientMessage("{\"type\":\"speed\",\"value\":\"max\"}",
+                                                  command, error));
+    EXPECT_TRUE(std::isinf(command.value));
+    EXPECT_FALSE(SessionEngine::parseClientMessage("{\"type\":\"speed\",\"value\":0}",
+                                                   command, error));
+    EXPECT_EQ(error, "Speed must be a positive number or \"max\"");
+}
+
+TEST(SessionEngineTest, SessionsRunAtTheirOwnSpeed) {
+    using Type = SessionEngine::Request::Type;
+    auto engine = std::make_unique<SessionEngine>(tankConfig(), 10);
+    auto& queue = engine->addProducer();
+    auto speed = [&queue](const std::string& name, double value) {
+        SessionEngine::Request r = request(Type::Command, name);
+        r.command.type = OperatorCommand::Type::SetSpeed;
+        r.command.value = value;
+        queue.tryPush(r);
+    };
+    queue.tryPush(request(Type::Join, "fast"));
+    queue.tryPush(request(Type::Join, "slow"));
+    queue.tryPush(request(Type::Join, "max"));
+    speed("fast", 50.0);
+    speed("slow", 0.25);
+    speed("max", std::numeric_limits<double>::infinity());
+
+    // Every session publishes at most one frame per tick, whatever its speed
+    auto cursor = engine->frames().subscribe();
+    int published = 0;
+    for (int i = 0; i < 8; ++i) {
+        published += engine->tick();
+    }
+    EXPECT_EQ(published, 8 + 2 + 8);
+    EXPECT_EQ(engine->frames().published(), static_cast<std::uint64_t>(published));
+
+    std::unordered_map<std::uint64_t, double> latest;
+    SessionEngine::EncodedFrame frame;
+    while (engine->frames().read(cursor, frame) == SessionEngine::FrameRing::ReadStatus::Ok) {
+        latest[frame.sessionKey] = frame.time;
+    }
+    EXPECT_DOUBLE_EQ(latest[SessionEngine::sessionKey("fast")], 400 * TEST_DT);
+    EXPECT_DOUBLE_EQ(latest[SessionEngine::sessionKey("slow")], 2 * TEST_DT);
+    EXPECT_DOUBLE_EQ(latest[SessionEngine::sessionKey("max")],
+                     8 * ENGINE_MAX_STEPS_PER_TICK * TEST_DT);
+
+    // The speed moves with an exported session; NaN leaves it unchanged
+    speed("fast", std::nan(""));
+    queue.tryPush(request(Type::Export, "fast"));
+    engine->tick();
+    std::vector<SessionEngine::Transfer> exports = engine->takeExports();
+    ASSERT_EQ(exports.size(), 1u);
+    EXPECT_EQ(exports[0].speed, 50.0);
+
+    auto target = std::make_unique<SessionEngine>(tankConfig(), 10);
+    target->importSession(exports[0]);
+    auto target_cursor = target->frames().subscribe();
+    target->tick();
+    ASSERT_EQ(target->frames().read(target_cursor, frame),
+              SessionEngine::FrameRing::ReadStatus::Ok);
+    EXPECT_DOUBLE_EQ(frame.time, 450 * TEST_DT);
+}
+
+namespace {
+
+// Payloads published by one tick, in ring order
+std::vector<std::string> tickPayloads(SessionEngine& engine) {
+    auto cursor = engine.frames().subscribe();
+    engine.tick();
+    std::vector<std::string> payloads;
+    SessionEngine::EncodedFrame frame;
+    while (engine.frames().read(cursor, frame) == SessionEngine::FrameRing::ReadStatus::Ok) {
+        payloads.emplace_back(frame.payload());
+    }
+    return payloads;
+}
+
+}  // namespace
+
+TEST(SessionEngineTest, SpeculationServesTheSameFramesAndRollsBackOnCommands) {
+    using Type = SessionEngine::Request::Type;
+    auto live = std::make_unique<SessionEngine>(tankConfig(), 10);
+    auto ahead = std::make_unique<SessionEngine>(tankConfig(), 10);
+    ahead->enableSpeculation(8);
+    auto& live_queue = live->addProducer();
+    auto& ahead_queue = ahead->addProducer();
+    auto both = [&](const SessionEngine::Request& r) {
+        live_queue.tryPush(r);
+        ahead_queue.tryPush(r);
+    };
+    SessionEngine::Request speed = request(Type::Command, "slow");
+    speed.command.type = OperatorCommand::Type::SetSpeed;
+    speed.command.value = 0.5;
+    SessionEngine::Request setpoint = request(Type::Command, "plant");
+    setpoint.command.type = OperatorCommand::Type::SetSetpoint;
+    setpoint.command.value = 3.0;
+
+    both(request(Type::Join, "plant"));
+    both(request(Type::Join, "slow"));
+    both(speed);
+    for (int i = 0; i < 30; ++i) {
+        if (i == 13) {
+            both(setpoint);   // mid-buffer: the speculative tail is discarded
+        }
+        ASSERT_EQ(tickPayloads(*ahead), tickPayloads(*live)) << "tick " << i;
+        EXPECT_EQ(live->speculate(1000), 0);
+        ahead->speculate(1000);
+    }
+
+    const auto stats = ahead->speculationStats();
+    EXPECT_GT(stats.servedTicks, 20u);
+    EXPECT_GT(stats.discardedTicks, 0u);
+
+    // An export hands over the served state, not the speculative one
+    ahead->speculate(1000);
+    ahead_queue.tryPush(request(Type::Export, "plant"));
+    ahead->tick();
+    std::vector<SessionEngine::Transfer> exports = ahead->takeExports();
+    ASSERT_EQ(exports.size(), 1u);
+    EXPECT_DOUBLE_EQ(exports[0].snapshot.time, 30 * TEST_DT);
+}
+
+TEST(SessionEngineTest, SpeculationTopsUpPartlyServedBuffers) {
+    auto engine = std::make_unique<SessionEngine>(tankConfig(), 10);
+    engine->enableSpeculation(8);
+    engine->addProducer().tryPush(request(SessionEngine::Request::Type::Join, "plant"));
+    engine->tick();
+    EXPECT_EQ(engine->speculate(1000), 8);
+    EXPECT_EQ(engine->speculate(1000), 0);
+
+    // Only the served ticks are computed again, after the buffered ones
+    for (int i = 0; i < 3; ++i) {
+        engine->tick();
+    }
+    EXPECT_EQ(engine->speculate(1000), 3);
+    const auto stats = engine->speculationStats();
+    EXPECT_EQ(stats.computedSteps, 11u);
+    EXPECT_EQ(stats.servedTicks, 3u);
+    EXPECT_EQ(stats.discardedTicks, 0u);
+    for (int i = 0; i < 8; ++i) {
+        ASSERT_EQ(tickPayloads(*engine).size(), 1u);
+    }
+    EXPECT_EQ(engine->speculationStats().servedTicks, 11u);
+}
+
+TEST(SessionEngineTest, SpeculationNeedsAnExactRollback) {
+    EXPECT_TRUE(SessionEngine::canSpeculate(tankConfig()));
+    Simulator::Config noisy = tankConfig();
+    noisy.sensorNoiseStdDev = 0.01;
+    EXPECT_FALSE(SessionEngine::canSpeculate(noisy));
+    Simulator::Config predictive = tankConfig();
+    predictive.controllerConfig[0].type = Simulator::ControllerType::MPC;
+    EXPECT_FALSE(SessionEngine::canSpeculate(predictive));
+
+    auto engine = std::make_unique<SessionEngine>(noisy, 10);
+    EXPECT_THROW(engine->enableSpeculation(-1), std::invalid_argument);
+    EXPECT_THROW(engine->enableSpeculation(MAX_ENGINE_SPECULATION_TICKS + 1),
+                 std::invalid_argument);
+    engine->enableSpeculation(8);
+    engine->addProducer().tryPush(request(SessionEngine::Request::Type::Join, "plant"));
+    engine->tick();
+    EXPECT_EQ(engine->speculate(1000), 0);
+}
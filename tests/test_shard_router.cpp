@@ -0,0 +1,218 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include "../src/engine_shard.h"
+#include "../src/shard_router.h"
+#include "../src/constants.h"
+#include "test_configs.h"
+
+using namespace tank_sim;
+using namespace tank_sim::constants;
+
+namespace {
+
+constexpr double TICK_PERIOD = 0.005;   ///< Wall seconds per engine tick
+constexpr int SHARDS = 2;
+
+OperatorCommand setpoint(double value) {
+    OperatorCommand command{};
+    command.type = OperatorCommand::Type::SetSetpoint;
+    command.value = value;
+    return command;
+}
+
+/// Two engine shards served from threads, as separate processes would be
+class ShardRouterTest : public ::testing::Test {
+protected:
+    std::vector<std::string> paths;
+    std::vector<std::unique_ptr<SessionEngine>> engines;
+    std::vector<std::unique_ptr<EngineShard>> shards;
+    std::vector<std::thread> threads;
+    std::map<std::uint64_t, std::vector<ShardRouter::Frame>> received;
+
+    void SetUp() override {
+        for (int i = 0; i < SHARDS; ++i) {
+            paths.push_back("/tmp/tank_shard_test_" + std::to_string(getpid()) + "_" +
+                            std::to_string(i) + ".sock");
+            engines.push_back(std::make_unique<SessionEngine>(tankConfig(), 100));
+            shards.push_back(
+                std::make_unique<EngineShard>(*engines.back(), paths.back(), TICK_PERIOD));
+            threads.emplace_back([shard = shards.back().get()] { shard->run(); });
+        }
+    }
+
+    void TearDown() override {
+        for (auto& shard : shards) {
+            shard->stop();
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    /// Poll until the condition holds; false after five seconds
+    bool pollUntil(ShardRouter& router, const std::function<bool()>& done) {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (!done()) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                return false;
+            }
+            for (auto& frame : router.poll(10)) {
+                received[frame.sessionKey].push_back(std::move(frame));
+            }
+        }
+        return true;
+    }
+
+    std::size_t framesOf(std::uint64_t key) { return received[key].size(); }
+
+    /// Frame times step by dt without a gap or a repeat
+    void expectContinuous(std::uint64_t key) {
+        const auto& frames = received[key];
+        for (std::size_t i = 1; i < frames.size(); ++i) {
+            ASSERT_DOUBLE_EQ(frames[i].time - frames[i - 1].time, TEST_DT) << "frame " << i;
+        }
+    }
+};
+
+}  // namespace
+
+TEST_F(ShardRouterTest, RoutesSessionsToTheirRingOwner) {
+    ShardRouter router(paths);
+    EXPECT_EQ(router.shardCount(), SHARDS);
+    const std::uint64_t key = SessionEngine::sessionKey("plant");
+    router.join(key);
+    ASSERT_TRUE(pollUntil(router, [&] { return framesOf(key) >= 3; }));
+
+    const int owner = router.shardOf(key);
+    EXPECT_EQ(engines[owner]->sessionCount(), 1);
+    EXPECT_EQ(engines[1 - owner]->sessionCount(), 0);
+    EXPECT_EQ(router.sessionsOn(owner), 1);
+
+    router.submit(key, setpoint(3.0));
+    ASSERT_TRUE(pollUntil(router, [&] {
+        return received[key].back().message.find("\"setpoint\":3.0,") != std::string::npos;
+    }));
+    expectContinuous(key);
+
+    router.leave(key);
+    EXPECT_EQ(router.sessionCount(), 0);
+    ASSERT_TRUE(pollUntil(router, [&] { return engines[owner]->sessionCount() == 0; }));
+}
+
+TEST_F(ShardRouterTest, MigrationKeepsFramesContinuousAndCommandsInOrder) {
+    ShardRouter router(paths);
+    const std::uint64_t key = SessionEngine::sessionKey("plant");
+    router.join(key);
+    router.join(key);
+    router.submit(key, setpoint(3.0));
+    ASSERT_TRUE(pollUntil(router, [&] { return framesOf(key) >= 5; }));
+
+    const int source = router.shardOf(key);
+    const int target = 1 - source;
+    EXPECT_THROW(router.migrate(key, 7), std::invalid_argument);
+    EXPECT_FALSE(router.migrate(key, source));
+    ASSERT_TRUE(router.migrate(key, target));
+    EXPECT_FALSE(router.migrate(key, target));
+
+    // Requests sent while the session moves act on the moved state
+    router.submit(key, setpoint(3.5));
+    router.leave(key);
+    EXPECT_EQ(router.migrationsInFlight(), 1);
+    ASSERT_TRUE(pollUntil(router, [&] { return router.migrationsInFlight() == 0; }));
+    EXPECT_EQ(router.shardOf(key), target);
+
+    const std::size_t migrated_at = framesOf(key);
+    ASSERT_TRUE(pollUntil(router, [&] { return framesOf(key) >= migrated_at + 5; }));
+    EXPECT_EQ(engines[source]->sessionCount(), 0);
+    EXPECT_EQ(engines[target]->sessionCount(), 1);
+    EXPECT_NE(received[key].back().message.find("\"setpoint\":3.5,"), std::string::npos);
+    expectContinuous(key);
+
+    // The replayed Leave left one subscriber; the last Leave ends the session
+    router.leave(key);
+    ASSERT_TRUE(pollUntil(router, [&] { return engines[target]->sessionCount() == 0; }));
+}
+
+TEST_F(ShardRouterTest, DrainingAShardMovesAllItsSessions) {
+    ShardRouter router(paths);
+    std::vector<std::uint64_t> keys;
+    for (int i = 0; i < 8; ++i) {
+        keys.push_back(SessionEngine::sessionKey("plant-" + std::to_string(i)));
+        router.join(keys.back());
+    }
+    ASSERT_TRUE(pollUntil(router, [&] {
+        return engines[0]->sessionCount() + engines[1]->sessionCount() == 8;
+    }));
+    const int on_zero = router.sessionsOn(0);
+
+    EXPECT_EQ(router.drainShard(0), on_zero);
+    EXPECT_THROW(router.drainShard(1), std::logic_error);
+    ASSERT_TRUE(pollUntil(router, [&] {
+        return router.migrationsInFlight() == 0 && engines[1]->sessionCount() == 8;
+    }));
+    EXPECT_EQ(router.sessionsOn(0), 0);
+    EXPECT_EQ(router.sessionsOn(1), 8);
+    EXPECT_EQ(engines[0]->sessionCount(), 0);
+    // New sessions avoid the drained shard
+    EXPECT_EQ(router.shardOf(SessionEngine::sessionKey("new")), 1);
+
+    received.clear();
+    ASSERT_TRUE(pollUntil(router, [&] {
+        for (auto key : keys) {
+            if (framesOf(key) < 3) {
+                return false;
+            }
+        }
+        return true;
+    }));
+    for (auto key : keys) {
+        expectContinuous(key);
+    }
+}
+
+TEST_F(ShardRouterTest, ExportedSessionsReturnToTheCallerAndImportAgain) {
+    ShardRouter router(paths);
+    const std::uint64_t key = SessionEngine::sessionKey("plant");
+    router.join(key);
+    router.submit(key, setpoint(3.0));
+    ASSERT_TRUE(pollUntil(router, [&] { return framesOf(key) >= 5; }));
+    const int owner = router.shardOf(key);
+
+    EXPECT_FALSE(router.exportSession(SessionEngine::sessionKey("other")));
+    ASSERT_TRUE(router.exportSession(key));
+    EXPECT_FALSE(router.exportSession(key));
+    std::vector<SessionEngine::Transfer> exports;
+    ASSERT_TRUE(pollUntil(router, [&] {
+        for (const auto& transfer : router.takeExports()) {
+            exports.push_back(transfer);
+        }
+        return !exports.empty();
+    }));
+    ASSERT_EQ(exports.size(), 1u);
+    EXPECT_EQ(exports[0].sessionKey, key);
+    EXPECT_EQ(exports[0].subscribers, 1);
+    EXPECT_EQ(router.sessionCount(), 0);
+    EXPECT_EQ(router.migrationsInFlight(), 0);
+    EXPECT_EQ(engines[owner]->sessionCount(), 0);
+
+    // The imported session continues where the export left it
+    const double exported_at = exports[0].snapshot.time;
+    received.clear();
+    router.importSession(exports[0]);
+    EXPECT_EQ(router.sessionCount(), 1);
+    ASSERT_TRUE(pollUntil(router, [&] { return framesOf(key) >= 3; }));
+    EXPECT_DOUBLE_EQ(received[key].front().time, exported_at + TEST_DT);
+    EXPECT_NE(received[key].back().message.find("\"setpoint\":3.0,"), std::string::npos);
+    expectContinuous(key);
+
+    router.leave(key);
+    ASSERT_TRUE(pollUntil(router, [&] { return engines[owner]->sessionCount() == 0; }));
+}
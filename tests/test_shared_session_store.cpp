@@ -0,0 +1,224 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "../src/shared_session_store.h"
+#include "../src/session_engine.h"
+#include "../src/constants.h"
+#include "test_configs.h"
+
+using namespace tank_sim;
+using namespace tank_sim::constants;
+
+namespace {
+
+constexpr double ALL = -std::numeric_limits<double>::infinity();
+
+TelemetryFrame frameAt(double time) {
+    TelemetryFrame frame{};
+    frame.time = time;
+    frame.tankLevel = TANK_NOMINAL_HEIGHT;
+    frame.loopCount = 1;
+    frame.setpoint[0] = TANK_NOMINAL_HEIGHT;
+    frame.controllerOutput[0] = TEST_VALVE_POSITION;
+    return frame;
+}
+
+/// Unique segment per test, removed afterwards
+class SharedSessionStoreTest : public ::testing::Test {
+protected:
+    std::string name;
+
+    void SetUp() override {
+        name = "/tank_sim_test_" + std::to_string(getpid()) + "_" +
+               ::testing::UnitTest::GetInstance()->current_test_info()->name();
+    }
+    void TearDown() override { SharedSessionStore::unlink(name); }
+};
+
+}  // namespace
+
+TEST_F(SharedSessionStoreTest, ReaderSeesTheWritersSessions) {
+    SharedSessionStore writer(name, 4);
+    SharedSessionStore reader(name);
+    EXPECT_EQ(reader.slotCount(), 4);
+
+    const int slot = writer.claim(42);
+    ASSERT_EQ(slot, 0);
+    EXPECT_EQ(reader.find(42), 0);
+    TelemetryFrame frame;
+    EXPECT_FALSE(reader.latest(42, frame));  // Claimed, nothing published yet
+
+    for (int i = 1; i <= 3; ++i) {
+        writer.publish(slot, frameAt(i * TEST_DT));
+    }
+    ASSERT_TRUE(reader.latest(42, frame));
+    EXPECT_DOUBLE_EQ(frame.time, 3 * TEST_DT);
+
+    const auto history = reader.history(42, ALL);
+    ASSERT_EQ(history.size(), 3u);
+    EXPECT_DOUBLE_EQ(history.front().time, TEST_DT);
+    EXPECT_DOUBLE_EQ(history.back().setpoint, TANK_NOMINAL_HEIGHT);
+    EXPECT_DOUBLE_EQ(history.back().controllerOutput, TEST_VALVE_POSITION);
+    EXPECT_EQ(reader.history(42, 1.5 * TEST_DT).size(), 2u);
+
+    const auto sessions = reader.sessions();
+    ASSERT_EQ(sessions.size(), 1u);
+    EXPECT_EQ(sessions[0].sessionKey, 42u);
+    EXPECT_EQ(sessions[0].ownerPid, static_cast<int>(getpid()));
+    EXPECT_EQ(sessions[0].frames, 3u);
+
+    // A session is exported once, whichever process asks
+    EXPECT_EQ(reader.claim(42), -1);
+
+    writer.release(slot);
+    EXPECT_EQ(reader.find(42), -1);
+    EXPECT_FALSE(reader.latest(42, frame));
+    EXPECT_TRUE(reader.history(42, ALL).empty());
+}
+
+TEST_F(SharedSessionStoreTest, ReusedSlotsAndResetsStartAFreshHistory) {
+    SharedSessionStore store(name, 1);
+    int slot = store.claim(1);
+    const int total = SESSION_STORE_HISTORY_CAPACITY + 10;
+    for (int i = 1; i <= total; ++i) {
+        store.publish(slot, frameAt(i));
+    }
+    const auto history = store.history(1, ALL);
+    ASSERT_EQ(history.size(), static_cast<size_t>(SESSION_STORE_HISTORY_CAPACITY - 1));
+    EXPECT_DOUBLE_EQ(history.back().time, total);
+    EXPECT_EQ(store.claim(2), -1);  // Full
+
+    store.restartHistory(slot);
+    EXPECT_TRUE(store.history(1, ALL).empty());
+    store.publish(slot, frameAt(0.5));
+    EXPECT_EQ(store.history(1, ALL).size(), 1u);
+
+    store.release(slot);
+    slot = store.claim(2);
+    EXPECT_EQ(slot, 0);
+    TelemetryFrame frame;
+    EXPECT_FALSE(store.latest(2, frame));
+    EXPECT_TRUE(store.history(2, ALL).empty());
+}
+
+TEST_F(SharedSessionStoreTest, ConcurrentClaimsOfOneKeyHaveOneWinner) {
+    // Two claims race while another session frees slot 0, so one of them
+    // can land above a slot the other takes only after it was scanned
+    SharedSessionStore store(name, 4);
+    std::atomic<int> round{0};
+    std::atomic<int> done{0};
+    int results[2] = {-1, -1};
+    const int rounds = 2000;
+
+    auto claimer = [&](int id) {
+        SharedSessionStore attached(name);
+        for (int r = 1; r <= rounds; ++r) {
+            while (round.load() < r) std::this_thread::yield();
+            results[id] = attached.claim(7);
+            done.fetch_add(1);
+        }
+    };
+    std::vector<std::thread> threads;
+    threads.emplace_back(claimer, 0);
+    threads.emplace_back(claimer, 1);
+
+    int badRounds = 0;
+    for (int r = 1; r <= rounds; ++r) {
+        const int blocker = store.claim(1);
+        done.store(0);
+        round.store(r);
+        if (blocker >= 0) store.release(blocker);
+        while (done.load() < 2) std::this_thread::yield();
+
+        badRounds += (results[0] >= 0) + (results[1] >= 0) != 1;
+        for (int slot : results) {
+            if (slot >= 0) store.release(slot);
+        }
+    }
+    for (auto& thread : threads) thread.join();
+    EXPECT_EQ(badRounds, 0);
+}
+
+TEST_F(SharedSessionStoreTest, RejectsBadNamesAndMismatchedSegments) {
+    EXPECT_THROW(SharedSessionStore("no_slash", 4), std::invalid_argument);
+    EXPECT_THROW(SharedSessionStore("/a/b", 4), std::invalid_argument);
+    EXPECT_THROW(SharedSessionStore(name, 0), std::invalid_argument);
+    EXPECT_THROW(SharedSessionStore{name}, std::runtime_error);  // Does not exist
+
+    SharedSessionStore store(name, 4);
+    EXPECT_THROW(SharedSessionStore(name, 8), std::runtime_error);
+    EXPECT_NO_THROW(SharedSessionStore(name, 4));
+    EXPECT_THROW(store.claim(0), std::invalid_argument);
+
+    EXPECT_TRUE(SharedSessionStore::unlink(name));
+    EXPECT_FALSE(SharedSessionStore::unlink(name));
+}
+
+TEST_F(SharedSessionStoreTest, ReclaimsTheSlotsOfExitedOwners) {
+    SharedSessionStore store(name, 4);
+    const int own = store.claim(1);
+
+    const pid_t child = fork();
+    ASSERT_GE(child, 0);
+    if (child == 0) {
+        SharedSessionStore attached(name);
+        const int slot = attached.claim(2);
+        attached.publish(slot, frameAt(TEST_DT));
+        _exit(slot >= 0 ? 0 : 1);
+    }
+    int status = 0;
+    ASSERT_EQ(waitpid(child, &status, 0), child);
+    ASSERT_EQ(WEXITSTATUS(status), 0);
+
+    // The child's session outlives it until someone reclaims it
+    TelemetryFrame frame;
+    EXPECT_TRUE(store.latest(2, frame));
+    EXPECT_EQ(store.reclaimDead(), 1);
+    EXPECT_EQ(store.find(2), -1);
+    EXPECT_EQ(store.find(1), own);  // Live owners keep their slots
+    EXPECT_EQ(store.reclaimDead(), 0);
+}
+
+TEST_F(SharedSessionStoreTest, SessionEngineExportsItsSessions) {
+    SharedSessionStore store(name, 4);
+    auto engine = std::make_unique<SessionEngine>(tankConfig(), 10);
+    engine->attachStore(&store);
+    auto& queue = engine->addProducer();
+    const std::uint64_t key = SessionEngine::sessionKey("shared:plant");
+
+    queue.tryPush({SessionEngine::Request::Type::Join, key, {}});
+    for (int i = 0; i < 3; ++i) {
+        engine->tick();
+    }
+    SharedSessionStore reader(name);
+    TelemetryFrame frame;
+    ASSERT_TRUE(reader.latest(key, frame));
+    EXPECT_DOUBLE_EQ(frame.time, 3 * TEST_DT);
+    EXPECT_EQ(reader.history(key, ALL).size(), 3u);
+
+    OperatorCommand reset;
+    reset.type = OperatorCommand::Type::Reset;
+    queue.tryPush({SessionEngine::Request::Type::Command, key, reset});
+    engine->tick();
+    const auto history = reader.history(key, ALL);
+    ASSERT_EQ(history.size(), 1u);
+    EXPECT_DOUBLE_EQ(history[0].time, TEST_DT);
+
+    queue.tryPush({SessionEngine::Request::Type::Leave, key, {}});
+    engine->tick();
+    EXPECT_EQ(reader.find(key), -1);
+
+    // Sessions alive when the engine goes away are released too
+    queue.tryPush({SessionEngine::Request::Type::Join, key, {}});
+    engine->tick();
+    EXPECT_EQ(reader.find(key), 0);
+    engine.reset();
+    EXPECT_EQ(reader.find(key), -1);
+}
@@ -603,3 +603,111 @@ TEST_F(SimulatorTest, DerivativeAction) {
     EXPECT_GE(sim_no_deriv.getControllerOutput(0), 0.0);
     EXPECT_LE(sim_no_deriv.getControllerOutput(0), 1.0);
 }
+
+// Test: State snapshot - a restored simulator continues exactly like the original
+TEST_F(SimulatorTest, RestoredSnapshotContinuesIdentically) {
+    Simulator::Config config = createSteadyStateConfig();
+    config.controllerConfig[0].gains.tau_D = 2.0;  // previous error matters too
+    Simulator sim(config);
+    sim.setSetpoint(0, 3.0);
+    sim.setInput(0, 1.2);
+    for (int i = 0; i < 25; ++i) {
+        sim.step();
+    }
+
+    const SimulatorSnapshot snapshot = sim.captureState();
+    EXPECT_EQ(snapshot.loopCount, 1);
+    EXPECT_EQ(snapshot.step, 25u);
+
+    // A fresh simulator with the same configuration picks up the state
+    Simulator copy(config);
+    copy.restoreState(snapshot);
+    EXPECT_EQ(copy.getTime(), sim.getTime());
+    EXPECT_EQ(copy.getSetpoint(0), 3.0);
+    EXPECT_EQ(copy.getTelemetry().time, sim.getTime());
+
+    for (int i = 0; i < 25; ++i) {
+        sim.step();
+        copy.step();
+        ASSERT_EQ(copy.getState()(0), sim.getState()(0));
+        ASSERT_EQ(copy.getControllerOutput(0), sim.getControllerOutput(0));
+    }
+    EXPECT_EQ(copy.getTime(), sim.getTime());
+}
+
+// Test: State snapshot - the identified model continues instead of restarting
+TEST_F(SimulatorTest, RestoredSnapshotCarriesTheIdentifiedModel) {
+    Simulator::Config config = createSteadyStateConfig();
+    config.identifyModel = true;
+    Simulator sim(config);
+    sim.setSetpoint(0, 3.0);
+    for (int i = 0; i < 40; ++i) {
+        sim.step();
+    }
+
+    Simulator copy(config);
+    copy.restoreState(sim.captureState());
+    EXPECT_EQ(copy.getIdentifiedModel().samples, sim.getIdentifiedModel().samples);
+    for (int i = 0; i < 10; ++i) {
+        sim.step();
+        copy.step();
+    }
+    const auto original = sim.getIdentifiedModel();
+    const auto restored = copy.getIdentifiedModel();
+    EXPECT_EQ(restored.samples, original.samples);
+    EXPECT_EQ(restored.area, original.area);
+    EXPECT_EQ(restored.k_v, original.k_v);
+}
+
+// Test: State snapshot - snapshots from another configuration are rejected
+TEST_F(SimulatorTest, RestoreRejectsMismatchedSnapshot) {
+    Simulator sim(createSteadyStateConfig());
+    SimulatorSnapshot snapshot = sim.captureState();
+
+    snapshot.loopCount = 2;
+    EXPECT_THROW(sim.restoreState(snapshot), std::invalid_argument);
+    snapshot.loopCount = 1;
+    snapshot.version = SimulatorSnapshot::VERSION + 1;
+    EXPECT_THROW(sim.restoreState(snapshot), std::invalid_argument);
+}
+
+// Test: Multi-step - a batch equals the same number of single steps but
+// publishes one frame
+TEST_F(SimulatorTest, StepManyMatchesSingleSteps) {
+    Simulator::Config config = createSteadyStateConfig();
+    Simulator batched(config);
+    Simulator single(config);
+    auto cursor = batched.subscribeTelemetry();
+
+    OperatorCommand command{};
+    command.type = OperatorCommand::Type::SetSetpoint;
+    command.value = 3.0;
+    ASSERT_TRUE(batched.submitCommand(command));
+    single.setSetpoint(0, 3.0);
+
+    batched.stepMany(40);
+    for (int i = 0; i < 40; ++i) {
+        single.step();
+    }
+    EXPECT_EQ(batched.getTime(), single.getTime());
+    EXPECT_EQ(batched.getState()(0), single.getState()(0));
+    EXPECT_EQ(batched.getControllerOutput(0), single.getControllerOutput(0));
+
+    TelemetryFrame frame;
+    ASSERT_EQ(batched.readTelemetry(cursor, frame), Simulator::TelemetryRing::ReadStatus::Ok);
+    EXPECT_EQ(frame.step, 40u);
+    EXPECT_EQ(frame.setpoint[0], 3.0);
+    EXPECT_EQ(batched.readTelemetry(cursor, frame), Simulator::TelemetryRing::ReadStatus::Empty);
+
+    EXPECT_THROW(batched.stepMany(0), std::invalid_argument);
+
+    // Speed belongs to the session engine; a simulator rejects it
+    command.type = OperatorCommand::Type::SetSpeed;
+    ASSERT_TRUE(batched.submitCommand(command));
+    batched.step();
+    AppliedCommand result{};
+    ASSERT_TRUE(batched.pollAppliedCommand(result));   // the setpoint
+    ASSERT_TRUE(batched.pollAppliedCommand(result));
+    EXPECT_EQ(result.type, OperatorCommand::Type::SetSpeed);
+    EXPECT_FALSE(result.accepted);
+}
@@ -0,0 +1,187 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include "../src/spsc_ring.h"
+#include "../src/simulator.h"
+#include "../src/constants.h"
+#include "test_configs.h"
+
+using namespace tank_sim;
+using namespace tank_sim::constants;
+
+namespace {
+
+OperatorCommand setpointCommand(std::uint64_t id, double value) {
+    OperatorCommand command;
+    command.type = OperatorCommand::Type::SetSetpoint;
+    command.index = 0;
+    command.value = value;
+    command.id = id;
+    return command;
+}
+
+}  // namespace
+
+TEST(SpscRingTest, FifoUntilFull) {
+    SpscRing<int, 4> ring;
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(ring.tryPush(i));
+    }
+    EXPECT_FALSE(ring.tryPush(99));
+    EXPECT_EQ(ring.sizeApprox(), 4u);
+
+    int value = -1;
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_TRUE(ring.tryPop(value));
+        EXPECT_EQ(value, i);
+    }
+    EXPECT_FALSE(ring.tryPop(value));
+
+    // Indices wrap past the capacity
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_TRUE(ring.tryPush(i));
+        ASSERT_TRUE(ring.tryPop(value));
+        EXPECT_EQ(value, i);
+    }
+}
+
+TEST(SpscRingTest, ConcurrentTransferPreservesOrder) {
+    SpscRing<std::uint64_t, 64> ring;
+    constexpr std::uint64_t COUNT = 500000;
+
+    std::thread producer([&]() {
+        for (std::uint64_t i = 1; i <= COUNT; ++i) {
+            while (!ring.tryPush(i)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    std::uint64_t expected = 1;
+    bool ordered = true;
+    while (expected <= COUNT) {
+        std::uint64_t value;
+        if (ring.tryPop(value)) {
+            ordered = ordered && value == expected;
+            ++expected;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    EXPECT_TRUE(ordered);
+}
+
+TEST(SpscRingTest, SimulatorAppliesCommandsAtStartOfStep) {
+    Simulator sim(tankConfig());
+    sim.step();
+
+    ASSERT_TRUE(sim.submitCommand(setpointCommand(1, 3.0)));
+    OperatorCommand bad = setpointCommand(2, 1.0);
+    bad.index = 7;
+    ASSERT_TRUE(sim.submitCommand(bad));
+    OperatorCommand input;
+    input.type = OperatorCommand::Type::SetInput;
+    input.index = INPUT_INDEX_INLET_FLOW;
+    input.value = 1.2;
+    input.id = 3;
+    ASSERT_TRUE(sim.submitCommand(input));
+
+    // Nothing changes until the stepping thread drains the queue
+    EXPECT_DOUBLE_EQ(sim.getSetpoint(0), TANK_NOMINAL_HEIGHT);
+    sim.step();
+    EXPECT_DOUBLE_EQ(sim.getSetpoint(0), 3.0);
+    EXPECT_DOUBLE_EQ(sim.getInputs()(INPUT_INDEX_INLET_FLOW), 1.2);
+
+    std::vector<AppliedCommand> results;
+    AppliedCommand result;
+    while (sim.pollAppliedCommand(result)) {
+        results.push_back(result);
+    }
+    ASSERT_EQ(results.size(), 3u);
+    EXPECT_EQ(results[0].id, 1u);
+    EXPECT_TRUE(results[0].accepted);
+    EXPECT_DOUBLE_EQ(results[0].time, TEST_DT);  // took effect before the second step
+    EXPECT_EQ(results[1].id, 2u);
+    EXPECT_FALSE(results[1].accepted);
+    EXPECT_EQ(results[2].id, 3u);
+    EXPECT_GE(results[2].latencyMicros, 0.0);
+
+    const auto& stats = sim.getCommandStats();
+    EXPECT_EQ(stats.applied, 3);
+    EXPECT_EQ(stats.rejected, 1);
+    EXPECT_GE(stats.maxLatencyMicros, stats.meanLatencyMicros);
+}
+
+TEST(SpscRingTest, SingleThreadedSimulatorLeavesOutResultAndFrameRings) {
+    Simulator::Config config = tankConfig();
+    config.reportCommandResults = false;
+    config.streamTelemetry = false;
+    Simulator sim(config);
+
+    // Commands still apply and count, but no result is kept or dropped
+    for (int k = 1; k <= 2 * COMMAND_QUEUE_CAPACITY; ++k) {
+        ASSERT_TRUE(sim.submitCommand(setpointCommand(k, 3.0)));
+        sim.step();
+    }
+    AppliedCommand result;
+    EXPECT_FALSE(sim.pollAppliedCommand(result));
+    EXPECT_EQ(sim.getCommandStats().applied, 2 * COMMAND_QUEUE_CAPACITY);
+    EXPECT_EQ(sim.getCommandStats().resultsDropped, 0);
+    EXPECT_DOUBLE_EQ(sim.getSetpoint(0), 3.0);
+
+    // The latest frame is still published; the per-step stream is not
+    EXPECT_EQ(sim.getTelemetry().step, static_cast<std::uint64_t>(2 * COMMAND_QUEUE_CAPACITY));
+    EXPECT_THROW(sim.subscribeTelemetry(), std::invalid_argument);
+}
+
+TEST(SpscRingTest, ProducerThreadDrivesSteppingThread) {
+    Simulator sim(tankConfig());
+    std::atomic<bool> stepping{true};
+    std::thread stepper([&]() {
+        while (stepping.load(std::memory_order_acquire)) {
+            sim.step();
+        }
+        sim.applyPendingCommands();
+    });
+
+    // Producer: setpoint ramp, then a reset
+    int submitted = 0;
+    for (int k = 1; k <= 100; ++k) {
+        while (!sim.submitCommand(setpointCommand(k, TANK_NOMINAL_HEIGHT + 0.001 * k))) {
+            std::this_thread::yield();
+        }
+        ++submitted;
+    }
+    OperatorCommand reset;
+    reset.type = OperatorCommand::Type::Reset;
+    reset.id = 101;
+    while (!sim.submitCommand(reset)) {
+        std::this_thread::yield();
+    }
+    ++submitted;
+
+    std::vector<AppliedCommand> results;
+    while (static_cast<int>(results.size()) < submitted) {
+        AppliedCommand result;
+        if (sim.pollAppliedCommand(result)) {
+            results.push_back(result);
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    stepping.store(false, std::memory_order_release);
+    stepper.join();
+
+    // Applied in submission order, at non-decreasing simulation times
+    for (size_t i = 0; i < results.size(); ++i) {
+        EXPECT_EQ(results[i].id, i + 1);
+        EXPECT_TRUE(results[i].accepted);
+    }
+    for (size_t i = 1; i + 1 < results.size(); ++i) {
+        EXPECT_GE(results[i].time, results[i - 1].time);
+    }
+    EXPECT_DOUBLE_EQ(results.back().time, 0.0);  // reset takes effect at t = 0
+}
@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+#include <Eigen/Dense>
+#include <cmath>
+#include <stdexcept>
+#include "../src/recursive_least_squares.h"
+#include "../src/tank_identifier.h"
+#include "../src/simulator.h"
+#include "../src/constants.h"
+
+using namespace tank_sim;
+using namespace tank_sim::constants;
+
+namespace {
+
+Simulator::Config identifiedConfig() {
+    Simulator::Config config;
+    config.params = TankModel::Parameters{DEFAULT_TANK_AREA, DEFAULT_VALVE_COEFFICIENT,
+                                          TANK_MAX_HEIGHT};
+    config.initialState = Eigen::VectorXd(1);
+    config.initialState << TANK_NOMINAL_HEIGHT;
+    config.initialInputs = Eigen::VectorXd(2);
+    config.initialInputs << TEST_INLET_FLOW, TEST_VALVE_POSITION;
+    config.dt = TEST_DT;
+
+    Simulator::ControllerConfig ctrl;
+    ctrl.gains = PIDController::Gains{-1.0, 10.0, 0.0};  // reverse-acting
+    ctrl.bias = TEST_VALVE_POSITION;
+    ctrl.minOutputLimit = 0.0;
+    ctrl.maxOutputLimit = 1.0;
+    ctrl.maxIntegralAccumulation = 10.0;
+    ctrl.measuredIndex = 0;
+    ctrl.outputIndex = 1;
+    ctrl.initialSetpoint = TANK_NOMINAL_HEIGHT;
+    config.controllerConfig.push_back(ctrl);
+    return config;
+}
+
+// Drive the loop with setpoint and inlet steps so both regressors move
+void exciteLoop(Simulator& sim, int cycles) {
+    for (int c = 0; c < cycles; ++c) {
+        sim.setSetpoint(0, c % 2 == 0 ? 3.0 : 2.0);
+        sim.setInput(0, c % 3 == 0 ? 1.2 : 0.8);
+        for (int i = 0; i < 100; ++i) {
+            sim.step();
+        }
+    }
+}
+
+}  // namespace
+
+// Test: Noise-free linear data is fitted exactly
+TEST(RecursiveLeastSquaresTest, RecoversLinearModel) {
+    RecursiveLeastSquares<2> rls(RecursiveLeastSquares<2>::Vector::Zero(), 1e6, 1.0, 1e7);
+    for (int k = 0; k < 50; ++k) {
+        RecursiveLeastSquares<2>::Vector phi(1.0, std::sin(0.3 * k));
+        rls.update(phi, 2.0 - 0.5 * phi(1));
+    }
+    EXPECT_NEAR(rls.parameters()(0), 2.0, 1e-6);
+    EXPECT_NEAR(rls.parameters()(1), -0.5, 1e-6);
+    EXPECT_EQ(rls.samples(), 50);
+}
+
+// Test: Covariance stays bounded without excitation
+TEST(RecursiveLeastSquaresTest, LimitsCovarianceWindup) {
+    RecursiveLeastSquares<2> rls(RecursiveLeastSquares<2>::Vector::Zero(), 1.0, 0.9, 5.0);
+    RecursiveLeastSquares<2>::Vector phi(1.0, 1.0);  // never changes direction
+    for (int k = 0; k < 1000; ++k) {
+        rls.update(phi, 1.0);
+    }
+    EXPECT_LE(rls.covariance().trace(), 5.0 + 1e-12);
+    EXPECT_NEAR(rls.parameters().sum(), 1.0, 1e-3);
+}
+
+// Test: Invalid settings are rejected
+TEST(RecursiveLeastSquaresTest, RejectsInvalidSettings) {
+    using Rls = RecursiveLeastSquares<2>;
+    EXPECT_THROW(Rls(Rls::Vector::Zero(), 1.0, 0.0, 1.0), std::invalid_argument);
+    EXPECT_THROW(Rls(Rls::Vector::Zero(), 1.0, 1.5, 1.0), std::invalid_argument);
+    EXPECT_THROW(Rls(Rls::Vector::Zero(), 0.0, 0.99, 1.0), std::invalid_argument);
+}
+
+// Test: The identifier recovers area and k_v from a wrong prior
+TEST(TankIdentifierTest, ConvergesFromWrongPrior) {
+    Simulator sim(identifiedConfig());
+    TankIdentifier identifier(TankIdentifier::Settings{},
+                              TankModel::Parameters{80.0, 2.0, TANK_MAX_HEIGHT});
+
+    identifier.update(sim.getState()(0), sim.getInputs()(0), sim.getInputs()(1), TEST_DT);
+    for (int c = 0; c < 20; ++c) {
+        sim.setSetpoint(0, c % 2 == 0 ? 3.0 : 2.0);
+        sim.setInput(0, c % 3 == 0 ? 1.2 : 0.8);
+        for (int i = 0; i < 100; ++i) {
+            Eigen::VectorXd applied = sim.getInputs();
+            sim.step();
+            identifier.update(sim.getState()(0), applied(0), applied(1), TEST_DT);
+        }
+    }
+
+    TankIdentifier::Estimate estimate = identifier.estimate();
+    EXPECT_NEAR(estimate.area, DEFAULT_TANK_AREA, 0.01 * DEFAULT_TANK_AREA);
+    EXPECT_NEAR(estimate.k_v, DEFAULT_VALVE_COEFFICIENT, 0.01 * DEFAULT_VALVE_COEFFICIENT);
+    EXPECT_EQ(estimate.samples, 2000);
+
+    double x = sim.getInputs()(1);
+    double expected_tau = 2.0 * DEFAULT_TANK_AREA * std::sqrt(sim.getState()(0)) /
+                          (DEFAULT_VALVE_COEFFICIENT * x);
+    EXPECT_NEAR(estimate.timeConstant, expected_tau, 0.02 * expected_tau);
+}
+
+// Test: The Simulator runs the identifier every step
+TEST(TankIdentifierTest, SimulatorTracksModel) {
+    Simulator::Config config = identifiedConfig();
+    EXPECT_THROW(Simulator(config).getIdentifiedModel(), std::invalid_argument);
+
+    config.identifyModel = true;
+    Simulator sim(config);
+    exciteLoop(sim, 10);
+
+    TankIdentifier::Estimate estimate = sim.getIdentifiedModel();
+    EXPECT_EQ(estimate.samples, 1000);
+    EXPECT_NEAR(estimate.area, DEFAULT_TANK_AREA, 0.01 * DEFAULT_TANK_AREA);
+    EXPECT_NEAR(estimate.k_v, DEFAULT_VALVE_COEFFICIENT, 0.01 * DEFAULT_VALVE_COEFFICIENT);
+
+    sim.reset();
+    EXPECT_EQ(sim.getIdentifiedModel().samples, 0);
+}
@@ -142,3 +142,32 @@ TEST_F(TankModelTest, FullValveOpening) {
     
     EXPECT_NEAR(outlet_flow, expected, TANK_STATE_TOLERANCE);
 }
+
+// Test: Analytic Jacobians match central finite differences
+TEST_F(TankModelTest, JacobiansMatchFiniteDifferences) {
+    Eigen::VectorXd state(1);
+    state << TANK_NOMINAL_HEIGHT;
+    Eigen::VectorXd inputs(2);
+    inputs << TEST_INLET_FLOW, TEST_VALVE_POSITION;
+    const double eps = 1e-6;
+
+    Eigen::VectorXd up = state, down = state;
+    up(0) += eps;
+    down(0) -= eps;
+    double dfdh = (model.derivatives(up, inputs)(0) - model.derivatives(down, inputs)(0)) / (2.0 * eps);
+    EXPECT_NEAR(model.stateJacobian(state, inputs)(0, 0), dfdh, 1e-8);
+
+    TankModel::InputJacobian jacobian = model.inputJacobian(state, inputs);
+    for (int j = 0; j < 2; ++j) {
+        Eigen::VectorXd in_up = inputs, in_down = inputs;
+        in_up(j) += eps;
+        in_down(j) -= eps;
+        double dfdu = (model.derivatives(state, in_up)(0) - model.derivatives(state, in_down)(0)) / (2.0 * eps);
+        EXPECT_NEAR(jacobian(0, j), dfdu, 1e-8);
+    }
+
+    // Near an empty tank the level slope is evaluated at the floor level
+    state << 0.0;
+    EXPECT_TRUE(std::isfinite(model.stateJacobian(state, inputs)(0, 0)));
+    EXPECT_DOUBLE_EQ(model.inputJacobian(state, inputs)(0, 1), 0.0);
+}
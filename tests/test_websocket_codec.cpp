@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+#include <array>
+#include <cstdint>
+#include <string>
+#include "../src/websocket_codec.h"
+
+using namespace tank_sim;
+
+namespace {
+
+std::string hex(const std::array<std::uint8_t, 20>& digest) {
+    static constexpr char DIGITS[] = "0123456789abcdef";
+    std::string out;
+    for (auto byte : digest) {
+        out += DIGITS[byte >> 4];
+        out += DIGITS[byte & 0xf];
+    }
+    return out;
+}
+
+}  // namespace
+
+TEST(WebSocketCodecTest, Sha1AndBase64MatchReferenceVectors) {
+    EXPECT_EQ(hex(websocket::sha1("abc")), "a9993e364706816aba3e25717850c26c9cd0d89d");
+    EXPECT_EQ(hex(websocket::sha1("")), "da39a3ee5e6b4b0d3255bfef95601890afd80709");
+    // Two-block message (56 bytes forces a second padding block)
+    EXPECT_EQ(hex(websocket::sha1("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq")),
+              "84983e441c3bd26ebaae4aa1f95129e5e54670f1");
+
+    const std::uint8_t data[] = {'f', 'o', 'o', 'b', 'a', 'r'};
+    EXPECT_EQ(websocket::base64Encode(data, 6), "Zm9vYmFy");
+    EXPECT_EQ(websocket::base64Encode(data, 4), "Zm9vYg==");
+    EXPECT_EQ(websocket::base64Encode(data, 5), "Zm9vYmE=");
+}
+
+TEST(WebSocketCodecTest, HandshakeFollowsRfc6455Example) {
+    const std::string request =
+        "GET /ws?session=plant&x=1&format=delta HTTP/1.1\r\n"
+        "Host: server.example.com\r\n"
+        "upgrade: WebSocket\r\n"
+        "Connection: Upgrade\r\n"
+        "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+        "Sec-WebSocket-Version: 13\r\n\r\n";
+    websocket::UpgradeRequest upgrade;
+    ASSERT_TRUE(websocket::parseUpgradeRequest(request, upgrade));
+    EXPECT_EQ(upgrade.path, "/ws");
+    EXPECT_EQ(upgrade.session, "plant");
+    EXPECT_EQ(upgrade.format, "delta");
+    EXPECT_EQ(websocket::acceptKey(upgrade.key), "s3pPLMBiTxaQ9kYGzzhZRbK+xOo=");
+
+    const std::string response = websocket::upgradeResponse(upgrade.key);
+    EXPECT_EQ(response.substr(0, 34), "HTTP/1.1 101 Switching Protocols\r\n");
+    EXPECT_NE(response.find("Sec-WebSocket-Accept: s3pPLMBiTxaQ9kYGzzhZRbK+xOo=\r\n"),
+              std::string::npos);
+
+    EXPECT_FALSE(websocket::parseUpgradeRequest("GET /ws HTTP/1.1\r\nHost: x\r\n\r\n", upgrade));
+    EXPECT_FALSE(websocket::parseUpgradeRequest("POST /ws HTTP/1.1\r\n\r\n", upgrade));
+}
+
+TEST(WebSocketCodecTest, ParsesMaskedClientFrames) {
+    // RFC 6455 section 5.7: masked "Hello"
+    std::string frame = "\x81\x85\x37\xfa\x21\x3d\x7f\x9f\x4d\x51\x58";
+    websocket::FrameInfo info;
+    EXPECT_EQ(websocket::parseClientFrame(frame.data(), 1, info),
+              websocket::ParseStatus::Incomplete);
+    EXPECT_EQ(websocket::parseClientFrame(frame.data(), 5, info),
+              websocket::ParseStatus::Incomplete);
+    ASSERT_EQ(websocket::parseClientFrame(frame.data(), frame.size(), info),
+              websocket::ParseStatus::Ok);
+    EXPECT_TRUE(info.fin);
+    EXPECT_EQ(info.opcode, websocket::Text);
+    EXPECT_EQ(info.headerSize, 6u);
+    ASSERT_EQ(info.payloadSize, 5u);
+    websocket::unmask(&frame[info.headerSize], 5, info.mask);
+    EXPECT_EQ(frame.substr(info.headerSize), "Hello");
+
+    // Unmasked client frames and long control frames are protocol errors
+    const std::string unmasked = "\x81\x05Hello";
+    EXPECT_EQ(websocket::parseClientFrame(unmasked.data(), unmasked.size(), info),
+              websocket::ParseStatus::Invalid);
+    const std::string long_ping = std::string("\x89\xfe\x00\x80", 4) + "mask";
+    EXPECT_EQ(websocket::parseClientFrame(long_ping.data(), long_ping.size(), info),
+              websocket::ParseStatus::Invalid);
+}
+
+TEST(WebSocketCodecTest, WritesServerHeadersForEachLengthForm) {
+    char header[websocket::MAX_SERVER_HEADER];
+    ASSERT_EQ(websocket::writeFrameHeader(header, websocket::Text, 5), 2u);
+    EXPECT_EQ(static_cast<unsigned char>(header[0]), 0x81u);
+    EXPECT_EQ(header[1], 5);
+
+    ASSERT_EQ(websocket::writeFrameHeader(header, websocket::Text, 300), 4u);
+    EXPECT_EQ(header[1], 126);
+    EXPECT_EQ(static_cast<unsigned char>(header[2]), 1u);
+    EXPECT_EQ(static_cast<unsigned char>(header[3]), 44u);
+
+    ASSERT_EQ(websocket::writeFrameHeader(header, websocket::Binary, 70000), 10u);
+    EXPECT_EQ(static_cast<unsigned char>(header[0]), 0x82u);
+    EXPECT_EQ(header[1], 127);
+    EXPECT_EQ(static_cast<unsigned char>(header[7]), 0x01u);
+    EXPECT_EQ(static_cast<unsigned char>(header[8]), 0x11u);
+    EXPECT_EQ(static_cast<unsigned char>(header[9]), 0x70u);
+}